@@ -4,6 +4,30 @@
  * @brief <b> Implementation of main application </b>
  * @version 0.1
  * @date 2022-04-06
+ * @date 2026-10-18 Save captured YUV420 buffer without YUV444 conversion
+ * @date 2026-10-18 Add option for asynchronous writer threads
+ * @date 2026-10-18 Add option for io_uring output sink
+ * @date 2026-10-18 Add option for recording to a segmented frame log
+ * @date 2026-10-18 Add option for recording to an AVI file
+ * @date 2026-10-18 Add option for raw YUV output to files and pipes
+ * @date 2026-10-18 Add option for lossless image formats
+ * @date 2026-10-18 Add option for parallel JPEG encoder threads
+ * @date 2026-10-18 Add options for adaptive JPEG quality
+ * @date 2026-10-18 Add options for downscaled images and EXIF thumbnails
+ * @date 2026-10-18 Capture and save through explicit contexts
+ * @date 2026-10-18 Add option for serving captures over a Unix domain socket
+ * @date 2026-10-18 Add option for publishing frames into a shared memory ring
+ * @date 2026-10-18 Add option for declarative processing pipelines
+ * @date 2026-10-18 Add option for running pipeline stages on threads of their own
+ * @date 2026-10-18 Add option for pipeline deadlines degrading or dropping late frames
+ * @date 2026-10-19 Add options for low latency capture of the newest frame and buffer count
+ * @date 2026-10-19 Add option for exporting stage timing histograms
+ * @date 2026-10-19 Add option for tracing stages per frame in Chrome trace format
+ * @date 2026-10-19 Hand the capture time of the saved frame to the outputs
+ * @date 2026-10-19 Capture, save and serve through the library interface only
+ * @date 2026-10-19 Reject deadlines which are not a number
+ * @date 2026-10-19 Add options for the overflow policy and fdatasync batch of writer threads
+ * @date 2026-10-19 Use the status type of the library interface
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -15,13 +39,10 @@
 
 #include <getopt.h>
 #include <signal.h>
-#include <math.h>
-#include "PiCam.h"
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 #include "PiCam_App.h"
-#include "ColorConversion.h"
-#include "write.h"
-#include "Convolutions.h"
-#include "Edit.h"
 
 /*============================[  Global Variables  ]====================================*/
 
@@ -29,11 +50,29 @@
  *  @{
  */
 
-/** Global buffer to save image */
-struct buffer Image_Save;
+/** Camera settings */
+PiCamLib_Config cameraConfig;
 
-/** Global buffer to store grayscale image */
-struct buffer Image_grayscale;
+/** Outputs of saved images */
+PiCamLib_Outputs outputConfig;
+
+/** Processing pipeline of saved images, spec NULL to save frames as captured */
+PiCamLib_Pipeline pipelineConfig;
+
+/** Timing and tracing of stages, files NULL to neither time nor trace */
+PiCamLib_Diagnostics diagnosticsConfig;
+
+/** Filename of the saved image, prefix of frames in continuous capture */
+char* filename = NULL;
+
+/** Flag to save every frame until SIGINT */
+int continuous = 0;
+
+/** Path of the socket serving captures, NULL to capture once */
+char* servePath = NULL;
+
+/** Opened camera, stopped by the signal handler */
+PiCamLib* volatile App_Camera = NULL;
 
 /** @}*/
 
@@ -53,6 +92,29 @@ static const struct option long_options [] =
 	{ "interval",   required_argument,      NULL,           'I' },
 	{ "version",	no_argument,			NULL,			'v' },
 	{ "continuous",	no_argument,			NULL,			'c' },
+	{ "writers",	required_argument,		NULL,			'w' },
+	{ "uring",		no_argument,			NULL,			'U' },
+	{ "log",		required_argument,		NULL,			'L' },
+	{ "avi",		required_argument,		NULL,			'A' },
+	{ "overflow",	required_argument,		NULL,			'O' },
+	{ "sync",		required_argument,		NULL,			'Y' },
+	{ "raw",		required_argument,		NULL,			'R' },
+	{ "format",		required_argument,		NULL,			'F' },
+	{ "encoding",	required_argument,		NULL,			'e' },
+	{ "jobs",		required_argument,		NULL,			'j' },
+	{ "bitrate",	required_argument,		NULL,			'b' },
+	{ "budget",		required_argument,		NULL,			't' },
+	{ "preview",	required_argument,		NULL,			'P' },
+	{ "thumbnail",	no_argument,			NULL,			'T' },
+	{ "serve",		required_argument,		NULL,			'S' },
+	{ "shm",		required_argument,		NULL,			'M' },
+	{ "pipeline",	required_argument,		NULL,			'p' },
+	{ "queue",		required_argument,		NULL,			'Q' },
+	{ "deadline",	required_argument,		NULL,			'D' },
+	{ "latest",		no_argument,			NULL,			'l' },
+	{ "buffers",	required_argument,		NULL,			'B' },
+	{ "metrics",	required_argument,		NULL,			'm' },
+	{ "trace",		required_argument,		NULL,			'x' },
 	{ 0, 0, 0, 0 }
 };
 
@@ -77,6 +139,41 @@ void usage(FILE* fp, int argc, char** argv)
 		"-H | --height        Set image height\n"
 		"-I | --interval      Set frame interval (fps) (-1 to skip)\n"
 		"-c | --continuous    Do continuos capture, stop with SIGINT.\n"
+		"-w | --writers       Number of writer threads (0-4), 0 writes synchronously\n"
+		"-U | --uring         Write images with io_uring\n"
+		"-L | --log prefix    Append images to frame log segments with path prefix\n"
+		"-A | --avi file      Record images of continuous capture into an MJPEG AVI file\n"
+		"-O | --overflow pol  Image dropped when the queue of -w, -U, -L or -A is full:\n"
+		"                     block, newest or oldest [oldest]\n"
+		"-Y | --sync n        fdatasync images of -w in batches of n (0-64), 0 leaves\n"
+		"                     writeback to the kernel [0]\n"
+		"-R | --raw path      Write uncompressed frames to a file or FIFO, - for stdout\n"
+		"-F | --format fmt    Layout of uncompressed frames: y4m, i420 or nv12 [y4m]\n"
+		"-e | --encoding fmt  File format of images: jpg, qoi, pgm or ppm [jpg]\n"
+		"-j | --jobs          Number of JPEG encoder threads (0-8), 0 encodes on capture thread\n"
+		"-b | --bitrate kB/s  Adapt JPEG quality up to -q to a data rate in kilobytes per second\n"
+		"-t | --budget ms     Adapt JPEG quality and DCT to an encode time per image\n"
+		"-P | --preview list  Also save JPEG images downscaled by 2, 4, 8 or 16, e.g. 2,4,8\n"
+		"-T | --thumbnail     Embed an EXIF thumbnail into JPEG images\n"
+		"-S | --serve socket  Keep streaming and send images requested on a Unix socket\n"
+		"-M | --shm socket    Publish frames into shared memory handed out on a Unix socket\n"
+		"-p | --pipeline spec Process images by stages, e.g. convert=gray,blur,edge,encode=90,sink\n"
+		"                     or @file, stages: convert=gray|yuv420|yuv444|rgb, blur, mean,\n"
+		"                     median[=3|5], edge[=sobel|canny], rotate=deg, resize=WxH[:nearest],\n"
+		"                     encode[=quality], sink\n"
+		"-Q | --queue depth   Run each pipeline stage on its own thread with depth frames in\n"
+		"                     flight (2-16), :block, :newest or :oldest selects the frame\n"
+		"                     dropped when all are busy, e.g. 4:oldest [block]\n"
+		"-D | --deadline n    Bound pipeline latency to n frame intervals after capture, late\n"
+		"                     frames run cheaper stages and skip stages marked with ?, or\n"
+		"                     :drop drops them, e.g. 1.5:drop [degrade]\n"
+		"-l | --latest        Read only the newest frame, frames which waited are skipped\n"
+		"-B | --buffers n     Number of capture buffers (2-32), 2 for the lowest latency [3]\n"
+		"-m | --metrics file  Export stage timing histograms in Prometheus text format every\n"
+		"                     :seconds, on SIGUSR1 and at exit, e.g. picam.prom:30 [10]\n"
+		"-x | --trace file    Trace stages per frame in Chrome trace format, the last :events\n"
+		"                     of each thread are written on SIGUSR2 and at exit,\n"
+		"                     e.g. picam.json:100000 [32768]\n"
 		"-v | --version       Print version\n"
 		"",
 		argv[0]);
@@ -88,6 +185,7 @@ void ParseArguments(int argc, char **argv)
 	for (;;) 
 	{
 		int index, c = 0;
+		char* policy;
 		c = getopt_long(argc, argv, short_options, long_options, &index);
 		if (-1 == c)
 			break;
@@ -99,7 +197,7 @@ void ParseArguments(int argc, char **argv)
 
 			case 'd':
 				/* In case of multiple camera, sets capture device */
-				deviceName = optarg;
+				cameraConfig.device = optarg;
 				break;
 
 			case 'h':
@@ -114,30 +212,219 @@ void ParseArguments(int argc, char **argv)
 
 			case 'q':
 				/* Sets saved image JPEG quality */
-				jpegQuality = atoi(optarg);
+				cameraConfig.quality = atoi(optarg);
 				break;
 
 			case 'W':
 				/* Sets captured image width */
-				width = atoi(optarg);
+				cameraConfig.width = atoi(optarg);
 				break;
 
 			case 'H':
 				/* Sets captured image height */
-				height = atoi(optarg);
+				cameraConfig.height = atoi(optarg);
 				break;
 				
 			case 'I':
 				/* Sets fps */
-				fps = atoi(optarg);
+				cameraConfig.fps = atoi(optarg);
 				break;
 
 			case 'c':
 				/* Sets flag for continuous capture */
 				continuous = 1;
-				InstallSIGINTHandler();
+				break;
+
+			case 'w':
+				/* Sets number of writer threads of the output sink */
+				outputConfig.writers = atoi(optarg);
+				break;
+
+			case 'U':
+				/* Sets flag to write images with io_uring */
+				outputConfig.uring = 1;
+				break;
+
+			case 'L':
+				/* Sets path prefix of frame log segments */
+				outputConfig.log = optarg;
 				break;
 				
+			case 'A':
+				/* Sets filename of the AVI recording */
+				outputConfig.avi = optarg;
+				break;
+
+			case 'O':
+				/* Sets the image dropped when the queue of the writer threads is full */
+				if (0 == strcmp(optarg, "block"))
+					outputConfig.policy = PICAMLIB_QUEUE_BLOCK;
+				else if (0 == strcmp(optarg, "newest"))
+					outputConfig.policy = PICAMLIB_QUEUE_DROP_NEWEST;
+				else if (0 == strcmp(optarg, "oldest"))
+					outputConfig.policy = PICAMLIB_QUEUE_DROP_OLDEST;
+				else
+				{
+					usage(stderr, argc, argv);
+					exit(EXIT_FAILURE);
+				}
+				break;
+
+			case 'Y':
+				/* Sets number of images synchronized together by a writer thread */
+				outputConfig.sync_batch = atoi(optarg);
+				break;
+
+			case 'R':
+				/* Sets path of the raw output */
+				outputConfig.raw = optarg;
+				break;
+
+			case 'F':
+				/* Sets layout of frames written to the raw output */
+				if (0 == strcmp(optarg, "y4m"))
+					outputConfig.raw_format = PICAMLIB_RAW_Y4M;
+				else if (0 == strcmp(optarg, "i420"))
+					outputConfig.raw_format = PICAMLIB_RAW_I420;
+				else if (0 == strcmp(optarg, "nv12"))
+					outputConfig.raw_format = PICAMLIB_RAW_NV12;
+				else
+				{
+					usage(stderr, argc, argv);
+					exit(EXIT_FAILURE);
+				}
+				break;
+
+			case 'e':
+				/* Sets file format of saved images */
+				if (0 == strcmp(optarg, "jpg"))
+					cameraConfig.format = PICAMLIB_JPEG;
+				else if (0 == strcmp(optarg, "qoi"))
+					cameraConfig.format = PICAMLIB_QOI;
+				else if (0 == strcmp(optarg, "pgm"))
+					cameraConfig.format = PICAMLIB_PGM;
+				else if (0 == strcmp(optarg, "ppm"))
+					cameraConfig.format = PICAMLIB_PPM;
+				else
+				{
+					usage(stderr, argc, argv);
+					exit(EXIT_FAILURE);
+				}
+				break;
+
+			case 'j':
+				/* Sets number of JPEG encoder threads */
+				outputConfig.jobs = atoi(optarg);
+				break;
+
+			case 'b':
+				/* Sets target data rate of saved images */
+				outputConfig.bitrate = atoi(optarg);
+				break;
+
+			case 't':
+				/* Sets encode time budget per image */
+				outputConfig.budget = atof(optarg);
+				break;
+
+			case 'P':
+				/* Sets downscaled images, one bit per halving */
+				outputConfig.scales = ParseScales(optarg);
+				if (outputConfig.scales < 0)
+				{
+					usage(stderr, argc, argv);
+					exit(EXIT_FAILURE);
+				}
+				break;
+
+			case 'T':
+				/* Embeds thumbnails into JPEG images */
+				outputConfig.thumbnail = 1;
+				break;
+
+			case 'S':
+				/* Sets path of the socket serving captures */
+				servePath = optarg;
+				break;
+
+			case 'M':
+				/* Sets path of the socket handing out the shared memory ring */
+				outputConfig.shm = optarg;
+				break;
+
+			case 'p':
+				/* Sets declaration of the processing pipeline */
+				pipelineConfig.spec = optarg;
+				break;
+
+			case 'Q':
+				/* Sets frames in flight between pipeline stage threads and the drop policy */
+				pipelineConfig.depth = (int)strtol(optarg, &policy, 10);
+				if (0 == strcmp(policy, ":newest"))
+					pipelineConfig.policy = PICAMLIB_QUEUE_DROP_NEWEST;
+				else if (0 == strcmp(policy, ":oldest"))
+					pipelineConfig.policy = PICAMLIB_QUEUE_DROP_OLDEST;
+				else if ('\0' != *policy && 0 != strcmp(policy, ":block"))
+				{
+					usage(stderr, argc, argv);
+					exit(EXIT_FAILURE);
+				}
+				break;
+
+			case 'D':
+				/* Sets latency bound of pipeline frames and the action for late frames */
+				pipelineConfig.deadline = strtof(optarg, &policy);
+				if (policy == optarg)
+				{
+					usage(stderr, argc, argv);
+					exit(EXIT_FAILURE);
+				}
+				if (0 == strcmp(policy, ":drop"))
+					pipelineConfig.deadline_policy = PICAMLIB_DEADLINE_DROP;
+				else if ('\0' != *policy && 0 != strcmp(policy, ":degrade"))
+				{
+					usage(stderr, argc, argv);
+					exit(EXIT_FAILURE);
+				}
+				break;
+
+			case 'l':
+				/* Sets flag for reading only the newest of the ready frames */
+				cameraConfig.latest = 1;
+				break;
+
+			case 'B':
+				/* Sets number of capture buffers */
+				cameraConfig.buffers = (unsigned int)atoi(optarg);
+				if (cameraConfig.buffers < PICAMLIB_BUFFERS_MIN || cameraConfig.buffers > PICAMLIB_BUFFERS_MAX)
+				{
+					usage(stderr, argc, argv);
+					exit(EXIT_FAILURE);
+				}
+				break;
+
+			case 'm':
+				/* Sets file and period of stage timing exports */
+				diagnosticsConfig.metrics = optarg;
+				policy = strrchr(optarg, ':');
+				if (NULL != policy)
+				{
+					*policy++ = '\0';
+					diagnosticsConfig.metrics_period_s = atoi(policy);
+				}
+				break;
+
+			case 'x':
+				/* Sets file and events per thread of traces */
+				diagnosticsConfig.trace = optarg;
+				policy = strrchr(optarg, ':');
+				if (NULL != policy)
+				{
+					*policy++ = '\0';
+					diagnosticsConfig.trace_events = atoi(policy);
+				}
+				break;
+
 			case 'v':
 				/* Prints version information */
 				printf("Version V0.1.0 \nDate: 2022-04-12\n");
@@ -153,6 +440,48 @@ void ParseArguments(int argc, char **argv)
 }
 
 
+int ParseScales(char* list)
+{
+	int scales = 0;
+	char* divisor;
+
+	/** Each divisor selects one pyramid level, 2 is the first */
+	for (divisor = strtok(list, ","); NULL != divisor; divisor = strtok(NULL, ","))
+	{
+		int d = atoi(divisor);
+		int level = (2 == d) ? 0 : (4 == d) ? 1 : (8 == d) ? 2 : (16 == d) ? 3 : -1;
+
+		if (level < 0)
+			return -1;
+		scales |= 1 << level;
+	}
+
+	return scales;
+}
+
+
+void StopApp(int sig_id)
+{
+	static const char message[] = "Stoping capture\n";
+
+	(void)sig_id;
+	(void)!write(STDOUT_FILENO, message, sizeof(message) - 1);
+	PiCamLib_Stop(App_Camera);
+}
+
+
+void InstallStopHandler(void)
+{
+	struct sigaction sa;
+
+	/** Without SA_RESTART the signals interrupt the wait of the server */
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = StopApp;
+	sigaction(SIGINT, &sa, NULL);
+	sigaction(SIGTERM, &sa, NULL);
+}
+
+
 void CheckValidationFilename (char* fname, int argc, char** argv)
 {
 	/** Checks for required parameters and prints help if not in order */
@@ -186,26 +515,78 @@ void CheckValidationFilename (char* fname, int argc, char** argv)
    
 int main(int argc, char **argv)
 {
+	PiCamLib* camera;
+	PiCamLib_Status status;
+
+	/* Defaults are set before options override them */
+	PiCamLib_DefaultConfig(&cameraConfig);
+	PiCamLib_DefaultOutputs(&outputConfig);
+	PiCamLib_DefaultPipeline(&pipelineConfig);
+	PiCamLib_DefaultDiagnostics(&diagnosticsConfig);
+
 	ParseArguments(argc, argv);
-	CheckValidationFilename (filename, argc, argv);
-	CheckContinuousFlag(continuous);
-	pixel_format = V4L2_PIX_FMT_YUV420;
-	
-	OpenCamera();
-	InitCamera();
-	StartCapture();
-	CaptureFrame();
-	StopCapture();
-	DeInitCamera();
-	CloseCamera();
-	
-	Image_Save.start = malloc(width*height*3);
-	Image_grayscale.start = malloc(width*height);
-	memcpy(Image_grayscale.start, Image_Buffer.start, width*height);	
-	Convert_YUV420toYUV444(width, height, Image_Buffer.start, Image_Save.start);
-	writejpegimageYUV(width, height, Image_Save.start, filename);
-
-	exit(EXIT_SUCCESS);
+
+	/* Serving keeps the camera streaming, images are sent to clients instead of files */
+	if (NULL != servePath && continuous)
+	{
+		fprintf(stderr, "Continuous capture cannot be combined with serving captures\n\n");
+		usage(stderr, argc, argv);
+		exit(EXIT_FAILURE);
+	}
+
+	if (NULL == servePath)
+		CheckValidationFilename (filename, argc, argv);
+
+	if (NULL == pipelineConfig.spec && (pipelineConfig.depth > 0 || pipelineConfig.deadline > 0))
+	{
+		fprintf(stderr, "Stage threads and deadlines require a processing pipeline\n\n");
+		usage(stderr, argc, argv);
+		exit(EXIT_FAILURE);
+	}
+
+	/* Timing starts before the camera is opened, so every frame is measured */
+	if (PICAMLIB_OK != PiCamLib_StartDiagnostics(&diagnosticsConfig))
+		exit(EXIT_FAILURE);
+
+	camera = PiCamLib_Open(&cameraConfig);
+	if (NULL == camera)
+	{
+		PiCamLib_StopDiagnostics();
+		exit(EXIT_FAILURE);
+	}
+
+	App_Camera = camera;
+	if (continuous || NULL != servePath)
+		InstallStopHandler();
+
+	if (NULL != servePath)
+	{
+		fprintf(stderr, "Serving captures on %s\n", servePath);
+		status = PiCamLib_Serve(camera, servePath);
+	}
+	else
+	{
+		status = PiCamLib_SetOutputs(camera, &outputConfig);
+		if (PICAMLIB_OK == status && NULL != pipelineConfig.spec)
+		{
+			status = PiCamLib_SetPipeline(camera, &pipelineConfig);
+			PiCamLib_PrintPipeline(camera, stderr);
+		}
+		if (PICAMLIB_OK == status)
+			status = PiCamLib_Record(camera, filename, continuous);
+	}
+
+	PiCamLib_PrintStats(camera, stderr);
+
+	/* Pending images are written before the camera is closed */
+	App_Camera = NULL;
+	if (PICAMLIB_OK != PiCamLib_Close(camera))
+		status = PICAMLIB_ERROR;
+
+	/* Final export after all writer threads finished */
+	PiCamLib_StopDiagnostics();
+
+	exit((PICAMLIB_OK == status) ? EXIT_SUCCESS : EXIT_FAILURE);
 	return EXIT_SUCCESS;
 }
 
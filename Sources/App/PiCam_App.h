@@ -4,6 +4,25 @@
  * @brief <b> Header file for main application </b>
  * @version 
  * @date 2022-04-06 
+ * @date 2026-10-18 Add option for asynchronous writer threads
+ * @date 2026-10-18 Add option for io_uring output sink
+ * @date 2026-10-18 Add option for recording to a segmented frame log
+ * @date 2026-10-18 Add option for recording to an AVI file
+ * @date 2026-10-18 Add option for raw YUV output to files and pipes
+ * @date 2026-10-18 Add option for lossless image formats
+ * @date 2026-10-18 Add option for parallel JPEG encoder threads
+ * @date 2026-10-18 Add options for adaptive JPEG quality
+ * @date 2026-10-18 Add options for downscaled images and EXIF thumbnails
+ * @date 2026-10-18 Add option for serving captures over a Unix domain socket
+ * @date 2026-10-18 Add option for publishing frames into a shared memory ring
+ * @date 2026-10-18 Add option for declarative processing pipelines
+ * @date 2026-10-18 Add option for running pipeline stages on threads of their own
+ * @date 2026-10-18 Add option for pipeline deadlines degrading or dropping late frames
+ * @date 2026-10-19 Add options for low latency capture of the newest frame and buffer count
+ * @date 2026-10-19 Add option for exporting stage timing histograms
+ * @date 2026-10-19 Add option for tracing stages per frame
+ * @date 2026-10-19 Capture, save and serve through the library interface only
+ * @date 2026-10-19 Add options for the overflow policy and fdatasync batch of writer threads
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -20,6 +39,7 @@
 
 #include <stddef.h>
 #include <stdio.h>
+#include "PiCamLib.h"
 
 /*============================[  Defines  ]==============================================*/
 
@@ -30,7 +50,7 @@
  */
 
 /** Usage of arguments passed to application for option */
-const char short_options [] = "d:ho:q:W:H:I:vc";
+const char short_options [] = "d:ho:q:W:H:I:vcw:UL:A:O:Y:R:F:e:j:b:t:P:TS:M:p:Q:D:lB:m:x:";
 
 /** @} */
 
@@ -59,6 +79,30 @@ void ParseArguments(int argc, char **argv);
  */
 void usage(FILE* fp, int argc, char** argv);
 
+/**
+ * @brief   Helper function to parse a comma separated list of downscaling divisors.
+ * 
+ * @param[inout] list   Divisors 2, 4, 8 or 16, modified while parsing
+ * 
+ * @return int  Bit mask with bit n set for divisor 2^(n+1), -1 for an invalid divisor
+ * 
+ */
+int ParseScales(char* list);
+
+/**
+ * @brief   Signal handler stopping continuous capture or the capture server.
+ * 
+ * @param[in] sig_id    Signal ID
+ * 
+ */
+void StopApp(int sig_id);
+
+/**
+ * @brief   Installs StopApp for SIGINT and SIGTERM.
+ * 
+ */
+void InstallStopHandler(void);
+
 /**
  * @brief   Checks if the filename has been provided for the CLI when running the PiCam library. 
  * 
@@ -0,0 +1,166 @@
+/**
+ * @file BoundedQueue.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of thread-safe bounded queue </b>
+ * @version
+ * @date 2026-10-18 Initial template for bounded queue with overflow policies
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "BoundedQueue.h"
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** Allocates the ring and creates the synchronization objects.
+ */
+Std_ReturnType BoundedQueue_Init(BoundedQueue* queue, int capacity)
+{
+    Std_ReturnType validate = E_OK;
+
+    validate += ValidateParam(queue);
+    validate += (capacity > 0) ? E_OK : E_NOT_OK;
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    queue->items = calloc(capacity, sizeof(void*));
+    if (NULL == queue->items)
+        return E_NOT_OK;
+
+    queue->capacity = capacity;
+    queue->head = 0;
+    queue->count = 0;
+    queue->closed = 0;
+    queue->pushed = 0;
+    queue->dropped = 0;
+    queue->high_water = 0;
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->not_empty, NULL);
+    pthread_cond_init(&queue->not_full, NULL);
+
+    return E_OK;
+
+}/* End of function BoundedQueue_Init */
+
+/** Destroys the synchronization objects and frees the ring.
+ */
+void BoundedQueue_DeInit(BoundedQueue* queue)
+{
+    pthread_cond_destroy(&queue->not_full);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_mutex_destroy(&queue->lock);
+    free(queue->items);
+    queue->items = NULL;
+    queue->capacity = 0;
+    queue->count = 0;
+
+}/* End of function BoundedQueue_DeInit */
+
+/** Appends at the tail of the ring. A full queue waits, rejects the item or overwrites the
+ * head depending on the policy.
+ */
+Std_ReturnType BoundedQueue_Push(BoundedQueue* queue, void* item, Queue_Policy policy, void** evicted)
+{
+    Std_ReturnType status = E_OK;
+
+    if (NULL != evicted)
+        *evicted = NULL;
+
+    pthread_mutex_lock(&queue->lock);
+
+    if (QUEUE_BLOCK == policy)
+    {
+        while (queue->count == queue->capacity && !queue->closed)
+            pthread_cond_wait(&queue->not_full, &queue->lock);
+    }
+
+    if (queue->closed)
+    {
+        status = E_NOT_OK;
+    }
+    else if (queue->count == queue->capacity)
+    {
+        if (QUEUE_DROP_OLDEST == policy && NULL != evicted)
+        {
+            *evicted = queue->items[queue->head];
+            queue->head = (queue->head + 1) % queue->capacity;
+            queue->count--;
+        }
+        else
+        {
+            status = E_NOT_OK;
+        }
+        queue->dropped++;
+    }
+
+    if (E_OK == status)
+    {
+        queue->items[(queue->head + queue->count) % queue->capacity] = item;
+        queue->count++;
+        queue->pushed++;
+        if (queue->count > queue->high_water)
+            queue->high_water = queue->count;
+        pthread_cond_signal(&queue->not_empty);
+    }
+
+    pthread_mutex_unlock(&queue->lock);
+
+    return status;
+
+}/* End of function BoundedQueue_Push */
+
+/** Removes the head of the ring, waiting while the queue is empty and open if requested.
+ */
+void* BoundedQueue_Pop(BoundedQueue* queue, int wait)
+{
+    void* item = NULL;
+
+    pthread_mutex_lock(&queue->lock);
+
+    while (wait && 0 == queue->count && !queue->closed)
+        pthread_cond_wait(&queue->not_empty, &queue->lock);
+
+    if (queue->count > 0)
+    {
+        item = queue->items[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        pthread_cond_signal(&queue->not_full);
+    }
+
+    pthread_mutex_unlock(&queue->lock);
+
+    return item;
+
+}/* End of function BoundedQueue_Pop */
+
+/** Marks the queue closed and wakes all waiting producers and consumers.
+ */
+void BoundedQueue_Close(BoundedQueue* queue)
+{
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = 1;
+    pthread_cond_broadcast(&queue->not_empty);
+    pthread_cond_broadcast(&queue->not_full);
+    pthread_mutex_unlock(&queue->lock);
+
+}/* End of function BoundedQueue_Close */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
@@ -0,0 +1,140 @@
+/**
+ * @file BoundedQueue.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for thread-safe bounded queue </b>
+ * @version
+ * @date 2026-10-18 Initial template for bounded queue with overflow policies
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef BOUNDEDQUEUE_H
+#define  BOUNDEDQUEUE_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <pthread.h>
+#include "Common_PiCam.h"
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Enumeration of actions when an item is pushed to a full queue */
+typedef enum
+{
+    /** Wait until a consumer removes an item */
+    QUEUE_BLOCK,
+    /** Reject the pushed item */
+    QUEUE_DROP_NEWEST,
+    /** Remove the oldest queued item to make room for the pushed item */
+    QUEUE_DROP_OLDEST
+} Queue_Policy;
+
+/** First in first out queue of pointers with fixed capacity, shared by producer and consumer
+ *  threads.
+ */
+typedef struct
+{
+    /** Ring of queued items */
+    void** items;
+    /** Maximum number of queued items */
+    int capacity;
+    /** Index of the oldest item */
+    int head;
+    /** Number of queued items */
+    int count;
+    /** Set when no further items are accepted */
+    int closed;
+    /** Total number of items pushed */
+    unsigned long pushed;
+    /** Total number of items dropped by the overflow policy */
+    unsigned long dropped;
+    /** Highest number of queued items observed */
+    int high_water;
+    /** Lock protecting the queue */
+    pthread_mutex_t lock;
+    /** Signalled when an item is pushed or the queue is closed */
+    pthread_cond_t not_empty;
+    /** Signalled when an item is removed or the queue is closed */
+    pthread_cond_t not_full;
+} BoundedQueue;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Initializes an empty queue.
+ *
+ * @param[inout] queue      Queue to initialize
+ * @param[in] capacity      Maximum number of queued items
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType BoundedQueue_Init(BoundedQueue* queue, int capacity);
+
+/**
+ * @brief   Releases a queue. Items still queued are not released.
+ *
+ * @param[inout] queue  Queue to release
+ *
+ */
+void BoundedQueue_DeInit(BoundedQueue* queue);
+
+/**
+ * @brief   Appends an item to the queue, applying the overflow policy if the queue is full.
+ *
+ * @param[inout] queue      Queue
+ * @param[in] item          Item to append, must not be NULL
+ * @param[in] policy        Action if the queue is full
+ * @param[out] evicted      Item removed by QUEUE_DROP_OLDEST, NULL otherwise. May be NULL if
+ *                          the policy is not QUEUE_DROP_OLDEST.
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Item queued
+ * @retval E_NOT_OK         Item rejected because the queue is full or closed
+ *
+ */
+Std_ReturnType BoundedQueue_Push(BoundedQueue* queue, void* item, Queue_Policy policy, void** evicted);
+
+/**
+ * @brief   Removes the oldest item from the queue.
+ *
+ * @param[inout] queue  Queue
+ * @param[in] wait      1 to wait for an item, 0 to return immediately
+ *
+ * @return void*        Oldest item, NULL if the queue is empty and either wait is 0 or the
+ *                      queue is closed
+ *
+ */
+void* BoundedQueue_Pop(BoundedQueue* queue, int wait);
+
+/**
+ * @brief   Closes the queue. Further pushes are rejected, waiting threads are woken up and
+ *          consumers receive the remaining items before NULL.
+ *
+ * @param[inout] queue  Queue to close
+ *
+ */
+void BoundedQueue_Close(BoundedQueue* queue);
+
+/** @} */
+
+#endif /** BOUNDEDQUEUE_H **/
+
+/*==============================[  End of File  ]======================================*/
@@ -5,6 +5,9 @@
  * @version 
  * @date 2022-03-27 Initial template for common utilities
  * @date 2022-04-02 Update validate function for ValidateValue
+ * @date 2026-10-18 Add planar image descriptor
+ * @date 2026-10-18 Add packed YUV444 pixel format
+ * @date 2026-10-19 Add blocking of process signals in worker threads
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -16,6 +19,8 @@
 
 #include <stddef.h>
 #include <stdio.h>
+#include <signal.h>
+#include <pthread.h>
 #include "Common_PiCam.h"
 
 /*===========================[  Function definitions  ]===================================*/
@@ -62,6 +67,80 @@ Std_ReturnType ValidateImageSize(int width, int height)
     
 }/** End of function ValidateImageSize */
 
+
+size_t Image_SetPlanar(Image_Planar* image, Image_Format format, int width, int height, unsigned char* buffer)
+{
+    size_t luma = (size_t)width * height;
+    size_t chroma = (size_t)((width + 1) / 2) * ((height + 1) / 2);
+    size_t size = 0;
+
+    image->format = format;
+    image->width = width;
+    image->height = height;
+    image->plane[0] = buffer;
+    image->plane[1] = NULL;
+    image->plane[2] = NULL;
+    image->stride[0] = width;
+    image->stride[1] = 0;
+    image->stride[2] = 0;
+
+    switch (format)
+    {
+        case PIXFMT_YUV420:
+            image->stride[1] = (width + 1) / 2;
+            image->stride[2] = (width + 1) / 2;
+            image->plane[1] = (NULL != buffer) ? buffer + luma : NULL;
+            image->plane[2] = (NULL != buffer) ? buffer + luma + chroma : NULL;
+            size = luma + 2 * chroma;
+            break;
+
+        case PIXFMT_NV12:
+            image->stride[1] = 2 * ((width + 1) / 2);
+            image->plane[1] = (NULL != buffer) ? buffer + luma : NULL;
+            size = luma + 2 * chroma;
+            break;
+
+        case PIXFMT_YUYV:
+            image->stride[0] = 2 * width;
+            size = 2 * luma;
+            break;
+
+        case PIXFMT_RGB24:
+        case PIXFMT_BGR24:
+        case PIXFMT_YUV444:
+            image->stride[0] = 3 * width;
+            size = 3 * luma;
+            break;
+
+        case PIXFMT_RGBA:
+            image->stride[0] = 4 * width;
+            size = 4 * luma;
+            break;
+
+        case PIXFMT_GRAY:
+        default:
+            size = luma;
+            break;
+    }
+
+    return size;
+
+}/** End of function Image_SetPlanar */
+
+
+void Thread_BlockSignals(void)
+{
+    sigset_t mask;
+
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigaddset(&mask, SIGUSR1);
+    sigaddset(&mask, SIGUSR2);
+    pthread_sigmask(SIG_BLOCK, &mask, NULL);
+
+}/** End of function Thread_BlockSignals */
+
 /** @} */
 
 /*==============================[  End of File  ]===========================================*/
@@ -5,6 +5,11 @@
  * @version 
  * @date 2022-03-27 Initial template for common utilities
  * @date 2022-04-02 Update validate function for ValidateValue
+ * @date 2026-10-18 Add compile time SIMD selection macros
+ * @date 2026-10-18 Add planar image descriptor
+ * @date 2026-10-18 Add packed YUV444 pixel format
+ * @date 2026-10-18 Move capture flag and image buffer into the capture context
+ * @date 2026-10-19 Add blocking of process signals in worker threads
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -19,6 +24,7 @@
 
 /*===========================[  Inclusions  ]============================================*/
 
+#include <stddef.h>
 #include <sys/time.h>
 
 /*============================[  Defines  ]==============================================*/
@@ -33,6 +39,27 @@
 /** Macro to indicate function returned with unexpected operation */
 #define E_NOT_OK    (1u)
 
+/** Set to 1 if the target supports 64-bit ARM Advanced SIMD (NEON) instructions */
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define PICAM_SIMD_NEON     (1)
+#else
+#define PICAM_SIMD_NEON     (0)
+#endif
+
+/** Set to 1 if the target supports x86 SSE2 instructions */
+#if defined(__SSE2__)
+#define PICAM_SIMD_SSE2     (1)
+#else
+#define PICAM_SIMD_SSE2     (0)
+#endif
+
+/** Set to 1 if the build enables x86 AVX2 instructions, for example with -mavx2 */
+#if defined(__AVX2__)
+#define PICAM_SIMD_AVX2     (1)
+#else
+#define PICAM_SIMD_AVX2     (0)
+#endif
+
 /** @} */
 
 /** \addtogroup function_macros Function Macros	  
@@ -63,19 +90,41 @@ struct buffer {
     struct timeval timestamp;
 };
 
-/** @} */
-
-/*============================[  Global Variables  ]=====================================*/
-
-/** \addtogroup global_variables Global Variables	  
- *  @{
- */
-
-/** Flag to store information whether ti capture continuous frame or not */
-int continuous;
-
-/** Global buffer to store the image to implement desired algorithms and to save it */
-struct buffer Image_Buffer;
+/** Enumeration of pixel formats of an image */
+typedef enum
+{
+    /** Planar Y, U and V with 2x2 subsampled chroma (I420), same as V4L2_PIX_FMT_YUV420 */
+    PIXFMT_YUV420,
+    /** Planar Y and interleaved UV with 2x2 subsampled chroma */
+    PIXFMT_NV12,
+    /** Packed Y0 U Y1 V with horizontally subsampled chroma */
+    PIXFMT_YUYV,
+    /** Single luminance plane */
+    PIXFMT_GRAY,
+    /** Packed R G B, 3 bytes per pixel */
+    PIXFMT_RGB24,
+    /** Packed B G R, 3 bytes per pixel */
+    PIXFMT_BGR24,
+    /** Packed R G B A, 4 bytes per pixel */
+    PIXFMT_RGBA,
+    /** Packed Y U V without subsampling, 3 bytes per pixel */
+    PIXFMT_YUV444
+} Image_Format;
+
+/** Structure describing an image with up to three planes */
+typedef struct
+{
+    /** Pixel format of the image */
+    Image_Format format;
+    /** Width of the image */
+    int width;
+    /** Height of the image */
+    int height;
+    /** Pointers to the starting pixel position of each plane, unused planes are NULL */
+    unsigned char* plane[3];
+    /** Number of bytes between starting positions of two consecutive rows of each plane */
+    int stride[3];
+} Image_Planar;
 
 /** @} */
 
@@ -124,6 +173,28 @@ Std_ReturnType ValidateParam(void* Param);
  */
 Std_ReturnType ValidateImageSize(int width, int height);
 
+/**
+ * @brief Function to describe a contiguous image buffer without row padding as planar image.
+ * 
+ * @param[inout] image  Planar image descriptor to populate
+ * @param[in] format    Pixel format of the image
+ * @param[in] width     Width of the image
+ * @param[in] height    Height of the image
+ * @param[in] buffer    Pointer to the start of the image buffer
+ * 
+ * @return size_t   Size of the image buffer in bytes
+ * 
+ */
+size_t Image_SetPlanar(Image_Planar* image, Image_Format format, int width, int height, unsigned char* buffer);
+
+/**
+ * @brief Function to block SIGINT, SIGTERM, SIGUSR1 and SIGUSR2 in the calling thread. Worker
+ *        threads call it first, so these signals are handled by a thread of the application
+ *        and do not interrupt system calls of the workers.
+ * 
+ */
+void Thread_BlockSignals(void);
+
 /** @} */
 
 #endif /** COMMON_PICAM_H **/
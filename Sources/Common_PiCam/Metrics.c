@@ -0,0 +1,383 @@
+/**
+ * @file Metrics.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of timing histograms of processing stages exported in Prometheus format </b>
+ * @version
+ * @date 2026-10-19 Initial template for stage timing histograms
+ * @date 2026-10-19 Stages are traced per frame while tracing is enabled
+ * @date 2026-10-19 Keep private helpers out of the header, the exporter blocks signals
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include "Metrics.h"
+#include "Trace.h"
+
+/*============================[  Global Variables  ]====================================*/
+
+/** \addtogroup global_variables
+ *  @{
+ */
+
+/** Set while stages are timed */
+static int Metrics_Enabled = 0;
+
+/** Timings of all threads which timed a stage, threads are only added */
+static Metrics_Thread* Metrics_Threads = NULL;
+
+/** Timings of the calling thread */
+static __thread Metrics_Thread* Metrics_Own = NULL;
+
+/** Configuration of exports */
+static Metrics_Config Metrics_Settings;
+
+/** Event waking the export thread, -1 while stopped */
+static int Metrics_Event = -1;
+
+/** Set to end the export thread */
+static int Metrics_Stopping = 0;
+
+/** Export thread */
+static pthread_t Metrics_Exporter;
+
+/** SIGUSR1 action replaced while exporting */
+static struct sigaction Metrics_OldAction;
+
+/** Names of the stages in exported metrics */
+static const char* const Metrics_Names[METRIC_STAGES] =
+{
+    "capture", "convert", "gaussian", "mean", "median", "edge", "encode", "write"
+};
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function returning the timings of the calling thread, registering them on
+ *          first use.
+ *
+ * @return Metrics_Thread*  Timings of the thread, NULL if out of memory
+ *
+ */
+static inline Metrics_Thread* Metrics_Local(void);
+
+/**
+ * @brief   Helper function writing the metrics to a temporary file renamed over the path, so
+ *          scrapers never read a partial file.
+ *
+ * @param[in] path  Path of the file
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType Metrics_WriteFile(const char* path);
+
+/**
+ * @brief   Signal handler of SIGUSR1 waking the export thread.
+ *
+ * @param[in] sig_id    Signal ID
+ *
+ */
+static void Metrics_Signal(int sig_id);
+
+/**
+ * @brief   Thread function exporting the metrics periodically and on SIGUSR1.
+ *
+ * @param[in] arg   Unused
+ *
+ * @return void*    NULL
+ *
+ */
+static void* Metrics_Worker(void* arg);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** The timings are never released, so the counts of finished threads stay in the totals.
+ */
+static inline Metrics_Thread* Metrics_Local(void)
+{
+    Metrics_Thread* local = Metrics_Own;
+
+    if (NULL != local)
+        return local;
+
+    local = calloc(1, sizeof(Metrics_Thread));
+    if (NULL == local)
+        return NULL;
+
+    local->next = __atomic_load_n(&Metrics_Threads, __ATOMIC_ACQUIRE);
+    while (!__atomic_compare_exchange_n(&Metrics_Threads, &local->next, local, 1, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE))
+        ;
+
+    Metrics_Own = local;
+    return local;
+
+}/* End of function Metrics_Local */
+
+/** Scrapers reading the file meanwhile see the previous export.
+ */
+static inline Std_ReturnType Metrics_WriteFile(const char* path)
+{
+    char temp[4096];
+    FILE* fp;
+    int failed;
+
+    if ((size_t)snprintf(temp, sizeof(temp), "%s.tmp", path) >= sizeof(temp))
+        return E_NOT_OK;
+
+    fp = fopen(temp, "w");
+    if (NULL == fp)
+        return E_NOT_OK;
+
+    Metrics_Print(fp);
+    failed = ferror(fp);
+    if (0 != fclose(fp) || failed || 0 != rename(temp, path))
+    {
+        unlink(temp);
+        return E_NOT_OK;
+    }
+
+    return E_OK;
+
+}/* End of function Metrics_WriteFile */
+
+/** Only writes to the event, which is safe in a signal handler.
+ */
+static void Metrics_Signal(int sig_id)
+{
+    uint64_t one = 1;
+    int saved = errno;
+
+    (void)sig_id;
+    if (-1 != Metrics_Event)
+        (void)!write(Metrics_Event, &one, sizeof(one));
+    errno = saved;
+
+}/* End of function Metrics_Signal */
+
+/** The period restarts after an export on SIGUSR1.
+ */
+static void* Metrics_Worker(void* arg)
+{
+    struct pollfd pfd = { Metrics_Event, POLLIN, 0 };
+    int timeout = (Metrics_Settings.period_s > 0) ? Metrics_Settings.period_s * 1000 : -1;
+
+    (void)arg;
+    Thread_BlockSignals();
+
+    while (!__atomic_load_n(&Metrics_Stopping, __ATOMIC_ACQUIRE))
+    {
+        uint64_t value;
+        int r = poll(&pfd, 1, timeout);
+
+        if (r < 0 && EINTR != errno)
+            break;
+        if (r > 0)
+            (void)!read(Metrics_Event, &value, sizeof(value));
+        if (r < 0 || __atomic_load_n(&Metrics_Stopping, __ATOMIC_ACQUIRE))
+            continue;
+
+        if (E_OK != Metrics_WriteFile(Metrics_Settings.path))
+            fprintf(stderr, "Could not export metrics to %s\n", Metrics_Settings.path);
+    }
+
+    return NULL;
+
+}/* End of function Metrics_Worker */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** Costs two loads while neither timing nor tracing is enabled.
+ */
+int64_t Metrics_Begin(void)
+{
+    struct timespec ts;
+
+    if (!__atomic_load_n(&Metrics_Enabled, __ATOMIC_RELAXED) && !Trace_Enabled())
+        return 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+
+}/* End of function Metrics_Begin */
+
+/** The owning thread is the only writer, so plain increments stored atomically suffice and
+ * no thread waits for another. Traced stages are also added to the trace of the thread.
+ */
+void Metrics_End(Metric_Stage stage, int64_t start)
+{
+    Metrics_Thread* local;
+    struct timespec ts;
+    uint64_t ns, us;
+    int i = 0;
+
+    if (0 == start || (unsigned int)stage >= METRIC_STAGES)
+        return;
+
+    Trace_End(Metrics_Names[stage], start);
+    if (!__atomic_load_n(&Metrics_Enabled, __ATOMIC_RELAXED))
+        return;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ns = (uint64_t)((int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec - start);
+
+    local = Metrics_Local();
+    if (NULL == local)
+        return;
+
+    us = (ns + 999) / 1000;
+    if (us > 1)
+        i = 64 - __builtin_clzll(us - 1);
+    if (i > METRICS_BUCKETS - 1)
+        i = METRICS_BUCKETS - 1;
+
+    __atomic_store_n(&local->bucket[stage][i], local->bucket[stage][i] + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&local->sum_ns[stage], local->sum_ns[stage] + ns, __ATOMIC_RELAXED);
+    __atomic_store_n(&local->count[stage], local->count[stage] + 1, __ATOMIC_RELAXED);
+
+}/* End of function Metrics_End */
+
+/** Buckets are cumulative with upper bounds in seconds as Prometheus expects. Threads may
+ * record meanwhile, so a count can be slightly ahead of its buckets.
+ */
+void Metrics_Print(FILE* fp)
+{
+    const Metrics_Thread* head = __atomic_load_n(&Metrics_Threads, __ATOMIC_ACQUIRE);
+    int s, i;
+
+    fprintf(fp, "# HELP picam_stage_duration_seconds Processing time per stage\n");
+    fprintf(fp, "# TYPE picam_stage_duration_seconds histogram\n");
+
+    for (s = 0; s < METRIC_STAGES; s++)
+    {
+        uint64_t cumulative = 0, count = 0, sum_ns = 0;
+        const Metrics_Thread* t;
+
+        for (i = 0; i < METRICS_BUCKETS; i++)
+        {
+            for (t = head; NULL != t; t = t->next)
+                cumulative += __atomic_load_n(&t->bucket[s][i], __ATOMIC_RELAXED);
+
+            if (i < METRICS_BUCKETS - 1)
+                fprintf(fp, "picam_stage_duration_seconds_bucket{stage=\"%s\",le=\"%.6f\"} %llu\n",
+                        Metrics_Names[s], (double)(1u << i) / 1e6, (unsigned long long)cumulative);
+            else
+                fprintf(fp, "picam_stage_duration_seconds_bucket{stage=\"%s\",le=\"+Inf\"} %llu\n",
+                        Metrics_Names[s], (unsigned long long)cumulative);
+        }
+
+        for (t = head; NULL != t; t = t->next)
+        {
+            count += __atomic_load_n(&t->count[s], __ATOMIC_RELAXED);
+            sum_ns += __atomic_load_n(&t->sum_ns[s], __ATOMIC_RELAXED);
+        }
+
+        fprintf(fp, "picam_stage_duration_seconds_sum{stage=\"%s\"} %.9f\n", Metrics_Names[s], (double)sum_ns / 1e9);
+        fprintf(fp, "picam_stage_duration_seconds_count{stage=\"%s\"} %llu\n", Metrics_Names[s], (unsigned long long)count);
+    }
+
+}/* End of function Metrics_Print */
+
+/** The handler is process wide. The library threads block SIGUSR1, so it interrupts a
+ *  thread of the application; SA_RESTART restarts its read and write calls, but poll and
+ *  select still fail with EINTR.
+ */
+Std_ReturnType Metrics_Start(const Metrics_Config* config)
+{
+    Std_ReturnType validate = E_OK;
+    struct sigaction sa;
+
+    validate += ValidateParam((void*)config);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateParam((void*)config->path);
+        validate += (config->period_s >= 0) ? E_OK : E_NOT_OK;
+        validate += (-1 == Metrics_Event) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    Metrics_Settings = *config;
+    Metrics_Event = eventfd(0, EFD_CLOEXEC);
+    if (-1 == Metrics_Event)
+        return E_NOT_OK;
+
+    __atomic_store_n(&Metrics_Stopping, 0, __ATOMIC_RELEASE);
+    if (0 != pthread_create(&Metrics_Exporter, NULL, Metrics_Worker, NULL))
+    {
+        close(Metrics_Event);
+        Metrics_Event = -1;
+        return E_NOT_OK;
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = Metrics_Signal;
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &sa, &Metrics_OldAction);
+
+    __atomic_store_n(&Metrics_Enabled, 1, __ATOMIC_RELAXED);
+    return E_OK;
+
+}/* End of function Metrics_Start */
+
+/** The previous SIGUSR1 action is restored before the event is closed.
+ */
+void Metrics_Stop(void)
+{
+    uint64_t one = 1;
+
+    if (-1 == Metrics_Event)
+        return;
+
+    sigaction(SIGUSR1, &Metrics_OldAction, NULL);
+    __atomic_store_n(&Metrics_Stopping, 1, __ATOMIC_RELEASE);
+    (void)!write(Metrics_Event, &one, sizeof(one));
+    pthread_join(Metrics_Exporter, NULL);
+
+    close(Metrics_Event);
+    Metrics_Event = -1;
+
+    if (E_OK != Metrics_WriteFile(Metrics_Settings.path))
+        fprintf(stderr, "Could not export metrics to %s\n", Metrics_Settings.path);
+
+}/* End of function Metrics_Stop */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
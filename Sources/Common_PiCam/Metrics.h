@@ -0,0 +1,152 @@
+/**
+ * @file Metrics.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for timing histograms of processing stages exported in Prometheus format </b>
+ * @version
+ * @date 2026-10-19 Initial template for stage timing histograms
+ * @date 2026-10-19 Stages are traced per frame while tracing is enabled
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef METRICS_H
+#define  METRICS_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include "Common_PiCam.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Number of histogram buckets, bucket i counts times up to 2^i microseconds, the last one
+ *  all longer times */
+#define METRICS_BUCKETS         (26)
+
+/** Default period of exports in seconds */
+#define METRICS_PERIOD_S        (10)
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Enumeration of timed processing stages */
+typedef enum
+{
+    /** Dequeue and copy of a captured frame */
+    METRIC_CAPTURE,
+    /** Color conversion */
+    METRIC_CONVERT,
+    /** Gaussian filter */
+    METRIC_GAUSSIAN,
+    /** Mean filter */
+    METRIC_MEAN,
+    /** Median filter */
+    METRIC_MEDIAN,
+    /** Edge detection */
+    METRIC_EDGE,
+    /** Image encoding */
+    METRIC_ENCODE,
+    /** Writing a file */
+    METRIC_WRITE,
+    /** Number of stages */
+    METRIC_STAGES
+} Metric_Stage;
+
+/** Timings recorded by one thread. Only the owning thread writes them, exports read them
+ *  without locks.
+ */
+typedef struct Metrics_Thread
+{
+    /** Number of timed runs per stage */
+    uint64_t count[METRIC_STAGES];
+    /** Total time per stage in nanoseconds */
+    uint64_t sum_ns[METRIC_STAGES];
+    /** Number of runs per stage and bucket */
+    uint64_t bucket[METRIC_STAGES][METRICS_BUCKETS];
+    /** Next registered thread */
+    struct Metrics_Thread* next;
+} Metrics_Thread;
+
+/** Configuration of metrics exports */
+typedef struct
+{
+    /** Path of the Prometheus text file, replaced on every export */
+    const char* path;
+    /** Seconds between exports, 0 to export on SIGUSR1 and at stop only */
+    int period_s;
+} Metrics_Config;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Starts timing of a stage.
+ *
+ * @return int64_t  Start time in nanoseconds, 0 if neither timing nor tracing is enabled
+ *
+ */
+int64_t Metrics_Begin(void);
+
+/**
+ * @brief   Ends timing of a stage and adds the time to the histogram and the trace of the
+ *          calling thread.
+ *
+ * @param[in] stage Timed stage
+ * @param[in] start Start time returned by Metrics_Begin, 0 records nothing
+ *
+ */
+void Metrics_End(Metric_Stage stage, int64_t start);
+
+/**
+ * @brief   Prints the histograms of all threads summed per stage in Prometheus text format.
+ *
+ * @param[in] fp    Output stream
+ *
+ */
+void Metrics_Print(FILE* fp);
+
+/**
+ * @brief   Enables timing, installs the SIGUSR1 handler and starts the export thread.
+ *
+ * @param[in] config    Configuration of exports
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType Metrics_Start(const Metrics_Config* config);
+
+/**
+ * @brief   Stops the export thread and exports the final metrics. Timing stays enabled for
+ *          threads still running.
+ *
+ */
+void Metrics_Stop(void);
+
+/** @} */
+
+#endif /** METRICS_H **/
+
+/*==============================[  End of File  ]======================================*/
@@ -0,0 +1,432 @@
+/**
+ * @file Trace.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of frame level tracing of processing stages in Chrome trace format </b>
+ * @version
+ * @date 2026-10-19 Initial template for frame level tracing
+ * @date 2026-10-19 Keep private helpers out of the header, the dumper blocks signals
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include "Trace.h"
+
+/*============================[  Global Variables  ]====================================*/
+
+/** \addtogroup global_variables
+ *  @{
+ */
+
+/** Set while events are recorded */
+static int Trace_Active = 0;
+
+/** Rings of all threads which recorded an event, threads are only added */
+static Trace_Thread* Trace_Threads = NULL;
+
+/** Ring of the calling thread */
+static __thread Trace_Thread* Trace_Own = NULL;
+
+/** Frame processed by the calling thread */
+static __thread uint32_t Trace_Frame = 0;
+
+/** Configuration of tracing */
+static Trace_Config Trace_Settings;
+
+/** Event waking the dump thread, -1 while stopped */
+static int Trace_Event_Fd = -1;
+
+/** Set to end the dump thread */
+static int Trace_Stopping = 0;
+
+/** Dump thread */
+static pthread_t Trace_Dumper;
+
+/** SIGUSR2 action replaced while tracing */
+static struct sigaction Trace_OldAction;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function returning the ring of the calling thread, registering it on first
+ *          use.
+ *
+ * @return Trace_Thread*    Ring of the thread, NULL if out of memory
+ *
+ */
+static inline Trace_Thread* Trace_Local(void);
+
+/**
+ * @brief   Helper function adding an event to the ring of the calling thread.
+ *
+ * @param[in] name          Name of the stage
+ * @param[in] begin_ns      Begin in nanoseconds
+ * @param[in] duration_ns   Duration in nanoseconds, -1 for an instant event
+ *
+ */
+static inline void Trace_Record(const char* name, int64_t begin_ns, int64_t duration_ns);
+
+/**
+ * @brief   Helper function printing the events of all threads as Chrome trace JSON.
+ *
+ * @param[in] fp    Output stream
+ *
+ */
+static inline void Trace_Print(FILE* fp);
+
+/**
+ * @brief   Signal handler of SIGUSR2 waking the dump thread.
+ *
+ * @param[in] sig_id    Signal ID
+ *
+ */
+static void Trace_Signal(int sig_id);
+
+/**
+ * @brief   Thread function dumping the trace on SIGUSR2.
+ *
+ * @param[in] arg   Unused
+ *
+ * @return void*    NULL
+ *
+ */
+static void* Trace_Worker(void* arg);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** Rings are never released, so events of finished threads stay in the dumps.
+ */
+static inline Trace_Thread* Trace_Local(void)
+{
+    Trace_Thread* local = Trace_Own;
+    uint64_t size = TRACE_EVENTS_MIN;
+
+    if (NULL != local)
+        return local;
+
+    while (size < (uint64_t)Trace_Settings.events)
+        size <<= 1;
+
+    local = calloc(1, sizeof(Trace_Thread));
+    if (NULL == local)
+        return NULL;
+
+    local->event = calloc(size, sizeof(Trace_Event));
+    if (NULL == local->event)
+    {
+        free(local);
+        return NULL;
+    }
+
+    local->mask = size - 1;
+    local->tid = (int)syscall(SYS_gettid);
+    local->next = __atomic_load_n(&Trace_Threads, __ATOMIC_ACQUIRE);
+    while (!__atomic_compare_exchange_n(&Trace_Threads, &local->next, local, 1, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE))
+        ;
+
+    Trace_Own = local;
+    return local;
+
+}/* End of function Trace_Local */
+
+/** The fence orders the head of the previous event before the slot is overwritten, so a dump
+ * which read a partly written slot also sees the head which marks it as overwritten.
+ */
+static inline void Trace_Record(const char* name, int64_t begin_ns, int64_t duration_ns)
+{
+    Trace_Thread* local = Trace_Local();
+    Trace_Event* event;
+
+    if (NULL == local)
+        return;
+
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    event = &local->event[local->head & local->mask];
+    event->name = name;
+    event->begin_ns = begin_ns;
+    event->duration_ns = duration_ns;
+    event->frame = Trace_Frame;
+    __atomic_store_n(&local->head, local->head + 1, __ATOMIC_RELEASE);
+
+}/* End of function Trace_Record */
+
+/** Stages are complete events with a duration, timestamps are microseconds of CLOCK_MONOTONIC
+ * as the capture timestamps. Events which threads overwrite while they are printed are left
+ * out.
+ */
+static inline void Trace_Print(FILE* fp)
+{
+    const Trace_Thread* t;
+    int pid = (int)getpid();
+    const char* separator = "";
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    for (t = __atomic_load_n(&Trace_Threads, __ATOMIC_ACQUIRE); NULL != t; t = t->next)
+    {
+        uint64_t head = __atomic_load_n(&t->head, __ATOMIC_ACQUIRE);
+        uint64_t i = (head > t->mask + 1) ? head - t->mask - 1 : 0;
+
+        for (; i < head; i++)
+        {
+            Trace_Event event = t->event[i & t->mask];
+
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&t->head, __ATOMIC_RELAXED) - i > t->mask || NULL == event.name)
+                continue;
+
+            if (event.duration_ns < 0)
+                fprintf(fp, "%s{\"name\":\"%s\",\"cat\":\"picam\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,"
+                        "\"pid\":%d,\"tid\":%d,\"args\":{\"frame\":%u}}", separator, event.name,
+                        (double)event.begin_ns / 1e3, pid, t->tid, event.frame);
+            else
+                fprintf(fp, "%s{\"name\":\"%s\",\"cat\":\"picam\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                        "\"pid\":%d,\"tid\":%d,\"args\":{\"frame\":%u}}", separator, event.name,
+                        (double)event.begin_ns / 1e3, (double)event.duration_ns / 1e3, pid, t->tid, event.frame);
+            separator = ",\n";
+        }
+    }
+
+    fprintf(fp, "\n]}\n");
+
+}/* End of function Trace_Print */
+
+/** Only writes to the event, which is safe in a signal handler.
+ */
+static void Trace_Signal(int sig_id)
+{
+    uint64_t one = 1;
+    int saved = errno;
+
+    (void)sig_id;
+    if (-1 != Trace_Event_Fd)
+        (void)!write(Trace_Event_Fd, &one, sizeof(one));
+    errno = saved;
+
+}/* End of function Trace_Signal */
+
+/** Dumps run here, so the threads recording events never wait for the file.
+ */
+static void* Trace_Worker(void* arg)
+{
+    struct pollfd pfd = { Trace_Event_Fd, POLLIN, 0 };
+
+    (void)arg;
+    Thread_BlockSignals();
+
+    while (!__atomic_load_n(&Trace_Stopping, __ATOMIC_ACQUIRE))
+    {
+        uint64_t value;
+        int r = poll(&pfd, 1, -1);
+
+        if (r < 0 && EINTR != errno)
+            break;
+        if (r <= 0)
+            continue;
+
+        (void)!read(Trace_Event_Fd, &value, sizeof(value));
+        if (__atomic_load_n(&Trace_Stopping, __ATOMIC_ACQUIRE))
+            break;
+
+        if (E_OK != Trace_Dump(Trace_Settings.path))
+            fprintf(stderr, "Could not dump trace to %s\n", Trace_Settings.path);
+    }
+
+    return NULL;
+
+}/* End of function Trace_Worker */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** Costs a single load while disabled.
+ */
+int64_t Trace_Begin(void)
+{
+    struct timespec ts;
+
+    if (!__atomic_load_n(&Trace_Active, __ATOMIC_RELAXED))
+        return 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+
+}/* End of function Trace_Begin */
+
+/** Events begun before tracing was disabled are still recorded.
+ */
+void Trace_End(const char* name, int64_t begin_ns)
+{
+    struct timespec ts;
+
+    if (0 == begin_ns || !__atomic_load_n(&Trace_Active, __ATOMIC_RELAXED))
+        return;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    Trace_Record(name, begin_ns, (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec - begin_ns);
+
+}/* End of function Trace_End */
+
+/** Instants mark decisions such as dropped frames between the stages.
+ */
+void Trace_Instant(const char* name)
+{
+    int64_t now = Trace_Begin();
+
+    if (0 != now)
+        Trace_Record(name, now, -1);
+
+}/* End of function Trace_Instant */
+
+/** Lets callers skip preparing events while disabled.
+ */
+int Trace_Enabled(void)
+{
+    return __atomic_load_n(&Trace_Active, __ATOMIC_RELAXED);
+
+}/* End of function Trace_Enabled */
+
+/** A thread local store, cheap enough to set for every frame while disabled.
+ */
+void Trace_SetFrame(uint32_t frame)
+{
+    Trace_Frame = frame;
+
+}/* End of function Trace_SetFrame */
+
+/** Threads handing a frame to another thread pass this along with it.
+ */
+uint32_t Trace_GetFrame(void)
+{
+    return Trace_Frame;
+
+}/* End of function Trace_GetFrame */
+
+/** Viewers reading the file meanwhile see the previous dump.
+ */
+Std_ReturnType Trace_Dump(const char* path)
+{
+    char temp[4096];
+    FILE* fp;
+    int failed;
+
+    if (NULL == path || (size_t)snprintf(temp, sizeof(temp), "%s.tmp", path) >= sizeof(temp))
+        return E_NOT_OK;
+
+    fp = fopen(temp, "w");
+    if (NULL == fp)
+        return E_NOT_OK;
+
+    Trace_Print(fp);
+    failed = ferror(fp);
+    if (0 != fclose(fp) || failed || 0 != rename(temp, path))
+    {
+        unlink(temp);
+        return E_NOT_OK;
+    }
+
+    return E_OK;
+
+}/* End of function Trace_Dump */
+
+/** Library threads block SIGUSR2, so the signal lands in an application thread. SA_RESTART
+ *  only restarts its interrupted reads and writes; poll and select there still see EINTR.
+ */
+Std_ReturnType Trace_Start(const Trace_Config* config)
+{
+    Std_ReturnType validate = E_OK;
+    struct sigaction sa;
+
+    validate += ValidateParam((void*)config);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateParam((void*)config->path);
+        validate += ValidateValue(config->events, TRACE_EVENTS_MIN, TRACE_EVENTS_MAX);
+        validate += (-1 == Trace_Event_Fd) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    Trace_Settings = *config;
+    Trace_Event_Fd = eventfd(0, EFD_CLOEXEC);
+    if (-1 == Trace_Event_Fd)
+        return E_NOT_OK;
+
+    __atomic_store_n(&Trace_Stopping, 0, __ATOMIC_RELEASE);
+    if (0 != pthread_create(&Trace_Dumper, NULL, Trace_Worker, NULL))
+    {
+        close(Trace_Event_Fd);
+        Trace_Event_Fd = -1;
+        return E_NOT_OK;
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = Trace_Signal;
+    sa.sa_flags = SA_RESTART;
+    sigaction(SIGUSR2, &sa, &Trace_OldAction);
+
+    __atomic_store_n(&Trace_Active, 1, __ATOMIC_RELAXED);
+    return E_OK;
+
+}/* End of function Trace_Start */
+
+/** Recording stops first, so the final dump holds the last events of every thread.
+ */
+void Trace_Stop(void)
+{
+    uint64_t one = 1;
+
+    if (-1 == Trace_Event_Fd)
+        return;
+
+    __atomic_store_n(&Trace_Active, 0, __ATOMIC_RELAXED);
+    sigaction(SIGUSR2, &Trace_OldAction, NULL);
+    __atomic_store_n(&Trace_Stopping, 1, __ATOMIC_RELEASE);
+    (void)!write(Trace_Event_Fd, &one, sizeof(one));
+    pthread_join(Trace_Dumper, NULL);
+
+    close(Trace_Event_Fd);
+    Trace_Event_Fd = -1;
+
+    if (E_OK != Trace_Dump(Trace_Settings.path))
+        fprintf(stderr, "Could not dump trace to %s\n", Trace_Settings.path);
+
+}/* End of function Trace_Stop */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
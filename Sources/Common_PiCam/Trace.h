@@ -0,0 +1,181 @@
+/**
+ * @file Trace.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for frame level tracing of processing stages in Chrome trace format </b>
+ * @version
+ * @date 2026-10-19 Initial template for frame level tracing
+ * @date 2026-10-19 Keep private helpers out of the header, the dumper blocks signals
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef TRACE_H
+#define  TRACE_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include "Common_PiCam.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Default number of events kept per thread, older events are overwritten */
+#define TRACE_EVENTS            (32768)
+
+/** Minimum number of events kept per thread */
+#define TRACE_EVENTS_MIN        (64)
+
+/** Maximum number of events kept per thread */
+#define TRACE_EVENTS_MAX        (1 << 22)
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Event recorded by a thread */
+typedef struct
+{
+    /** Name of the stage, a string constant */
+    const char* name;
+    /** Begin of the stage in nanoseconds of CLOCK_MONOTONIC */
+    int64_t begin_ns;
+    /** Duration of the stage in nanoseconds, -1 for an instant event */
+    int64_t duration_ns;
+    /** Sequence number of the processed frame */
+    uint32_t frame;
+} Trace_Event;
+
+/** Ring of the latest events of one thread. Only the owning thread writes it, dumps read it
+ *  without locks.
+ */
+typedef struct Trace_Thread
+{
+    /** Events, size is a power of two */
+    Trace_Event* event;
+    /** Number of events ever recorded, the next one is written at head & mask */
+    uint64_t head;
+    /** Size of event minus one */
+    uint64_t mask;
+    /** Kernel thread ID */
+    int tid;
+    /** Next registered thread */
+    struct Trace_Thread* next;
+} Trace_Thread;
+
+/** Configuration of tracing */
+typedef struct
+{
+    /** Path of the trace file, replaced on every dump */
+    const char* path;
+    /** Number of events kept per thread, rounded up to a power of two
+     *  (TRACE_EVENTS_MIN to TRACE_EVENTS_MAX) */
+    int events;
+} Trace_Config;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Starts an event of the calling thread.
+ *
+ * @return int64_t  Begin in nanoseconds, 0 if tracing is disabled
+ *
+ */
+int64_t Trace_Begin(void);
+
+/**
+ * @brief   Ends an event of the calling thread started by Trace_Begin or Metrics_Begin.
+ *
+ * @param[in] name      Name of the stage, a string constant
+ * @param[in] begin_ns  Begin returned by Trace_Begin, 0 records nothing
+ *
+ */
+void Trace_End(const char* name, int64_t begin_ns);
+
+/**
+ * @brief   Records an instant event of the calling thread, e.g. a dropped frame.
+ *
+ * @param[in] name  Name of the event, a string constant
+ *
+ */
+void Trace_Instant(const char* name);
+
+/**
+ * @brief   Returns whether events are recorded.
+ *
+ * @return int  1 while tracing, 0 otherwise
+ *
+ */
+int Trace_Enabled(void);
+
+/**
+ * @brief   Sets the frame the calling thread processes, following events are tagged with it.
+ *
+ * @param[in] frame Sequence number of the frame
+ *
+ */
+void Trace_SetFrame(uint32_t frame);
+
+/**
+ * @brief   Returns the frame the calling thread processes, to hand it to another thread.
+ *
+ * @return uint32_t Sequence number of the frame
+ *
+ */
+uint32_t Trace_GetFrame(void);
+
+/**
+ * @brief   Writes the events of all threads as Chrome trace JSON to a temporary file renamed
+ *          over the path.
+ *
+ * @param[in] path  Path of the file
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType Trace_Dump(const char* path);
+
+/**
+ * @brief   Enables tracing, installs the SIGUSR2 handler and starts the dump thread.
+ *
+ * @param[in] config    Configuration of tracing
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType Trace_Start(const Trace_Config* config);
+
+/**
+ * @brief   Disables tracing, stops the dump thread and dumps the final trace.
+ *
+ */
+void Trace_Stop(void);
+
+/** @} */
+
+#endif /** TRACE_H **/
+
+/*==============================[  End of File  ]======================================*/
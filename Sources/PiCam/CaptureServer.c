@@ -0,0 +1,437 @@
+/**
+ * @file CaptureServer.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of serving captures of a streaming camera over a Unix domain socket </b>
+ * @version
+ * @date 2026-10-18 Initial template for the capture server
+ * @date 2026-10-19 Return errors of the camera to the caller instead of exiting
+ * @date 2026-10-19 Answer with frames captured after the request and send without blocking
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "CaptureServer.h"
+#include "JpegEncoder.h"
+#include "write.h"
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function returning the time in microseconds of CLOCK_MONOTONIC, the clock
+ *          of V4L2 buffer timestamps.
+ *
+ * @return int64_t  Current time in microseconds
+ *
+ */
+static inline int64_t CaptureServer_Now(void);
+
+/**
+ * @brief   Helper function to send as much of the answer as the socket takes without blocking.
+ *          A client which received the whole answer is counted and disconnected.
+ *
+ * @param[inout] server Capture server
+ * @param[inout] client Client with an answer
+ *
+ */
+static inline void CaptureServer_Send(CaptureServer* server, CaptureServer_Client* client);
+
+/**
+ * @brief   Helper function to close the connection of a client. The answer buffer is kept.
+ *
+ * @param[inout] client Client to disconnect
+ *
+ */
+static inline void CaptureServer_Drop(CaptureServer_Client* client);
+
+/**
+ * @brief   Helper function to read the request of a client. Complete requests for images
+ *          wait for the next frame, information requests are answered at once.
+ *
+ * @param[inout] server Capture server
+ * @param[inout] client Client with pending data
+ *
+ */
+static inline void CaptureServer_Receive(CaptureServer* server, CaptureServer_Client* client);
+
+/**
+ * @brief   Helper function to answer the clients whose request is older than the latest frame.
+ *          The frame is encoded at most once and copied for every client, so the next frame
+ *          can be dequeued while answers are sent.
+ *
+ * @param[inout] server Capture server
+ *
+ */
+static inline void CaptureServer_Answer(CaptureServer* server);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** V4L2 buffers are stamped with CLOCK_MONOTONIC, so requests and frames compare directly.
+ */
+static inline int64_t CaptureServer_Now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+
+}/* End of function CaptureServer_Now */
+
+/** MSG_NOSIGNAL reports a disconnected client as error instead of raising SIGPIPE, the rest
+ * of the answer is sent once select reports the socket writable.
+ */
+static inline void CaptureServer_Send(CaptureServer* server, CaptureServer_Client* client)
+{
+    while (client->sent < client->length)
+    {
+        ssize_t r = send(client->fd, client->answer + client->sent, client->length - client->sent,
+                         MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (r < 0 && EINTR == errno)
+            continue;
+        if (r < 0 && (EAGAIN == errno || EWOULDBLOCK == errno))
+            return;
+        if (r <= 0)
+        {
+            CaptureServer_Drop(client);
+            return;
+        }
+        client->sent += (size_t)r;
+    }
+
+    server->served++;
+    CaptureServer_Drop(client);
+
+}/* End of function CaptureServer_Send */
+
+/** The slot can be reused afterwards.
+ */
+static inline void CaptureServer_Drop(CaptureServer_Client* client)
+{
+    close(client->fd);
+    client->fd = -1;
+    client->request = SERVER_REQUEST_NONE;
+    client->used = 0;
+    client->length = 0;
+    client->sent = 0;
+
+}/* End of function CaptureServer_Drop */
+
+/** A request is complete with a newline, when the client stops sending or when the buffer is
+ * full. Its time is taken here, frames captured before it do not answer it.
+ */
+static inline void CaptureServer_Receive(CaptureServer* server, CaptureServer_Client* client)
+{
+    const PiCam_Context* cam = server->cam;
+    char* end;
+    ssize_t r;
+
+    r = read(client->fd, client->buffer + client->used, CAPTURE_SERVER_REQUEST_SIZE - 1 - client->used);
+    if (r < 0)
+    {
+        if (EAGAIN != errno && EINTR != errno)
+            CaptureServer_Drop(client);
+        return;
+    }
+
+    client->used += (size_t)r;
+    client->buffer[client->used] = '\0';
+
+    end = strpbrk(client->buffer, "\r\n");
+    if (NULL == end && r > 0 && client->used < CAPTURE_SERVER_REQUEST_SIZE - 1)
+        return;
+    if (NULL != end)
+        *end = '\0';
+
+    client->requested = CaptureServer_Now();
+    if (0 == strcmp(client->buffer, "jpg"))
+        client->request = SERVER_REQUEST_JPEG;
+    else if (0 == strcmp(client->buffer, "raw"))
+        client->request = SERVER_REQUEST_RAW;
+    else if (0 == strcmp(client->buffer, "info"))
+    {
+        char info[64];
+        int n = snprintf(info, sizeof(info), "%u %u I420\n", cam->width, cam->height);
+        (void)!send(client->fd, info, (size_t)n, MSG_NOSIGNAL | MSG_DONTWAIT);
+    }
+
+    if (SERVER_REQUEST_NONE == client->request)
+        CaptureServer_Drop(client);
+
+}/* End of function CaptureServer_Receive */
+
+/** Uses the encoder of the save context, which the write functions share.
+ */
+static inline void CaptureServer_Answer(CaptureServer* server)
+{
+    PiCam_Context* cam = server->cam;
+    Save_Context* save = cam->save;
+    int64_t captured = (int64_t)cam->image.timestamp.tv_sec * 1000000 + cam->image.timestamp.tv_usec;
+    size_t raw_length = (size_t)cam->width * cam->height * 3 / 2;
+    Std_ReturnType encoded = E_OK;
+    int i, encode = 1;
+
+    for (i = 0; i < CAPTURE_SERVER_MAX_CLIENTS; i++)
+    {
+        CaptureServer_Client* client = &server->client[i];
+        const unsigned char* data = cam->image.start;
+        size_t length = raw_length;
+
+        /* Frames which waited in the driver queue while the request arrived are too old */
+        if (SERVER_REQUEST_NONE == client->request || client->length > 0 || captured <= client->requested)
+            continue;
+
+        if (SERVER_REQUEST_JPEG == client->request)
+        {
+            if (encode)
+            {
+                Image_Planar image;
+
+                encode = 0;
+                if (!save->encoder_ready)
+                {
+                    encoded = JpegEncoder_Init(&save->encoder, save->quality);
+                    save->encoder_ready = (E_OK == encoded);
+                }
+                if (E_OK == encoded)
+                {
+                    JpegEncoder_SetQuality(&save->encoder, save->quality);
+                    Image_SetPlanar(&image, PIXFMT_YUV420, (int)cam->width, (int)cam->height, cam->image.start);
+                    encoded = JpegEncoder_Encode(&save->encoder, &image);
+                }
+            }
+            if (E_OK != encoded)
+            {
+                CaptureServer_Drop(client);
+                continue;
+            }
+            data = save->encoder.buffer;
+            length = save->encoder.length;
+        }
+
+        if (client->capacity < length)
+        {
+            unsigned char* answer = realloc(client->answer, length);
+            if (NULL == answer)
+            {
+                CaptureServer_Drop(client);
+                continue;
+            }
+            client->answer = answer;
+            client->capacity = length;
+        }
+
+        memcpy(client->answer, data, length);
+        client->length = length;
+        client->sent = 0;
+        client->deadline = CaptureServer_Now() + (int64_t)CAPTURE_SERVER_SEND_TIMEOUT_MS * 1000;
+        CaptureServer_Send(server, client);
+    }
+
+}/* End of function CaptureServer_Answer */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** The socket is non-blocking so a client leaving before accept does not block the server.
+ */
+Std_ReturnType CaptureServer_Open(CaptureServer* server, PiCam_Context* cam, const char* path)
+{
+    Std_ReturnType validate = E_OK;
+    struct sockaddr_un addr;
+    int i;
+
+    validate += ValidateParam(server);
+    validate += ValidateParam(cam);
+    validate += ValidateParam((void*)path);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateParam(cam->save);
+        validate += (strlen(path) < sizeof(addr.sun_path)) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    memset(server, 0, sizeof(CaptureServer));
+    server->cam = cam;
+    server->path = path;
+    for (i = 0; i < CAPTURE_SERVER_MAX_CLIENTS; i++)
+        server->client[i].fd = -1;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    server->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (-1 == server->fd)
+        return E_NOT_OK;
+
+    unlink(path);
+    if (-1 == bind(server->fd, (struct sockaddr*)&addr, sizeof(addr)) ||
+        -1 == listen(server->fd, CAPTURE_SERVER_MAX_CLIENTS))
+    {
+        close(server->fd);
+        server->fd = -1;
+        return E_NOT_OK;
+    }
+
+    return E_OK;
+
+}/* End of function CaptureServer_Open */
+
+/** Frames are dequeued as they arrive and answer only requests older than their V4L2
+ * timestamp, a frame which waited in the driver queue is requeued without answering.
+ */
+Std_ReturnType CaptureServer_Run(CaptureServer* server)
+{
+    PiCam_Context* cam = server->cam;
+    int i;
+
+    server->running = 1;
+
+    while (server->running)
+    {
+        fd_set fds, wfds;
+        struct timeval tv = { 1, 0 };
+        int max_fd = (cam->fd > server->fd) ? cam->fd : server->fd;
+        int r;
+
+        int64_t now = CaptureServer_Now();
+
+        FD_ZERO(&fds);
+        FD_ZERO(&wfds);
+        FD_SET(cam->fd, &fds);
+        FD_SET(server->fd, &fds);
+        for (i = 0; i < CAPTURE_SERVER_MAX_CLIENTS; i++)
+        {
+            CaptureServer_Client* client = &server->client[i];
+
+            if (client->length > 0 && now > client->deadline)
+                CaptureServer_Drop(client);
+            if (client->fd < 0 || (SERVER_REQUEST_NONE != client->request && 0 == client->length))
+                continue;
+
+            FD_SET(client->fd, (client->length > 0) ? &wfds : &fds);
+            if (client->fd > max_fd)
+                max_fd = client->fd;
+        }
+
+        r = select(max_fd + 1, &fds, &wfds, NULL, &tv);
+        if (-1 == r)
+        {
+            if (EINTR == errno)
+                continue;
+            server->running = 0;
+            return errno_print("select");
+        }
+
+        for (i = 0; i < CAPTURE_SERVER_MAX_CLIENTS; i++)
+        {
+            CaptureServer_Client* client = &server->client[i];
+            if (client->fd >= 0 && client->length > 0 && FD_ISSET(client->fd, &wfds))
+                CaptureServer_Send(server, client);
+            else if (client->fd >= 0 && SERVER_REQUEST_NONE == client->request && FD_ISSET(client->fd, &fds))
+                CaptureServer_Receive(server, client);
+        }
+
+        if (FD_ISSET(server->fd, &fds))
+        {
+            int fd = accept4(server->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+            for (i = 0; fd >= 0 && i < CAPTURE_SERVER_MAX_CLIENTS; i++)
+            {
+                if (server->client[i].fd < 0)
+                {
+                    server->client[i].fd = fd;
+                    fd = -1;
+                }
+            }
+            if (fd >= 0)
+                close(fd);
+        }
+
+        if (FD_ISSET(cam->fd, &fds))
+        {
+            r = ReadBuffer(cam);
+            if (r < 0)
+            {
+                server->running = 0;
+                return E_NOT_OK;
+            }
+            if (EXIT_SUCCESS == r)
+                CaptureServer_Answer(server);
+        }
+    }
+
+    return E_OK;
+
+}/* End of function CaptureServer_Run */
+
+/** Only clears a flag, the loop notices it after select returns.
+ */
+void CaptureServer_Stop(CaptureServer* server)
+{
+    server->running = 0;
+
+}/* End of function CaptureServer_Stop */
+
+/** Clients still waiting for a frame or the rest of an answer receive nothing more.
+ */
+void CaptureServer_Close(CaptureServer* server)
+{
+    int i;
+
+    for (i = 0; i < CAPTURE_SERVER_MAX_CLIENTS; i++)
+    {
+        if (server->client[i].fd >= 0)
+            CaptureServer_Drop(&server->client[i]);
+        free(server->client[i].answer);
+        server->client[i].answer = NULL;
+        server->client[i].capacity = 0;
+    }
+
+    if (server->fd >= 0)
+    {
+        close(server->fd);
+        unlink(server->path);
+    }
+    server->fd = -1;
+
+}/* End of function CaptureServer_Close */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
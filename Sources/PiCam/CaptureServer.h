@@ -0,0 +1,171 @@
+/**
+ * @file CaptureServer.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for serving captures of a streaming camera over a Unix domain socket </b>
+ * @version
+ * @date 2026-10-18 Initial template for the capture server
+ * @date 2026-10-19 Return errors of the camera to the caller instead of exiting
+ * @date 2026-10-19 Answer with frames captured after the request and send without blocking
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef CAPTURESERVER_H
+#define  CAPTURESERVER_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <signal.h>
+#include "Common_PiCam.h"
+#include "PiCam.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Maximum number of connected clients, further connections are closed */
+#define CAPTURE_SERVER_MAX_CLIENTS  (16)
+
+/** Maximum length of a request including the newline */
+#define CAPTURE_SERVER_REQUEST_SIZE (16)
+
+/** Time a client may take to receive an image before it is dropped, checked at least every
+ *  second */
+#define CAPTURE_SERVER_SEND_TIMEOUT_MS  (2000)
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Enumeration of requests a client can send */
+typedef enum
+{
+    /** Request not complete yet */
+    SERVER_REQUEST_NONE,
+    /** Next frame as JPEG image */
+    SERVER_REQUEST_JPEG,
+    /** Next frame as uncompressed I420 */
+    SERVER_REQUEST_RAW
+} CaptureServer_Request;
+
+/** Connection of one client */
+typedef struct
+{
+    /** Socket of the connection, -1 for an unused slot */
+    int fd;
+    /** Request waiting for the next frame */
+    CaptureServer_Request request;
+    /** Received part of the request */
+    char buffer[CAPTURE_SERVER_REQUEST_SIZE];
+    /** Number of received bytes */
+    size_t used;
+    /** Time the request was complete in microseconds of CLOCK_MONOTONIC, only frames captured
+     *  later answer it */
+    int64_t requested;
+    /** Answer being sent, NULL while waiting for a frame */
+    unsigned char* answer;
+    /** Allocated size of answer, kept for the next client of the slot */
+    size_t capacity;
+    /** Size of the answer in bytes */
+    size_t length;
+    /** Number of bytes of the answer sent */
+    size_t sent;
+    /** Time the client is dropped unless the answer was sent, microseconds of CLOCK_MONOTONIC */
+    int64_t deadline;
+} CaptureServer_Client;
+
+/** Server answering capture requests with frames of a camera which keeps streaming. Every
+ *  request is answered with the first frame whose V4L2 timestamp is later than the request,
+ *  answers are sent without blocking so slow clients do not hold up dequeuing.
+ */
+typedef struct
+{
+    /** Capture context of the streaming camera */
+    PiCam_Context* cam;
+    /** Listening socket */
+    int fd;
+    /** Path of the socket in the file system */
+    const char* path;
+    /** Connected clients */
+    CaptureServer_Client client[CAPTURE_SERVER_MAX_CLIENTS];
+    /** Cleared to stop the server */
+    volatile sig_atomic_t running;
+    /** Number of images sent */
+    uint32_t served;
+} CaptureServer;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Creates the listening socket. An existing socket file at the path is replaced.
+ *
+ * @param[out] server   Capture server
+ * @param[in] cam       Capture context, images are encoded with its save context
+ * @param[in] path      Path of the socket
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType CaptureServer_Open(CaptureServer* server, PiCam_Context* cam, const char* path);
+
+/**
+ * @brief   Serves requests until the server is stopped. Requests are lines of text, the
+ *          connection is closed after the answer:
+ *          - jpg   Next frame as JPEG image with the quality of the save context
+ *          - raw   Next frame as I420 image without header
+ *          - info  Line with width, height and pixel format of the frames
+ *          Unknown requests are closed without answer.
+ *
+ * @param[inout] server Capture server, the camera must be streaming
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Server was stopped
+ * @retval E_NOT_OK         Error of the camera or the socket, the error is printed
+ *
+ */
+Std_ReturnType CaptureServer_Run(CaptureServer* server);
+
+/**
+ * @brief   Stops a running server within a second. Can be called from signal handlers and
+ *          other threads.
+ *
+ * @param[inout] server Capture server
+ *
+ */
+void CaptureServer_Stop(CaptureServer* server);
+
+/**
+ * @brief   Disconnects all clients, frees their answers and removes the socket.
+ *
+ * @param[inout] server Capture server
+ *
+ */
+void CaptureServer_Close(CaptureServer* server);
+
+/** @} */
+
+#endif /** CAPTURESERVER_H **/
+
+/*==============================[  End of File  ]======================================*/
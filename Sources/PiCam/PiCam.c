@@ -8,6 +8,23 @@
  * @date 2022-03-21 Updates for saving BMP image
  * @date 2022-03-23 Updates for Gaussian filter and Edge detection
  * @date 2022-03-24 Update for convolution methods
+ * @date 2026-10-18 Save every frame in continuous capture
+ * @date 2026-10-18 Hand frames to the raw output in continuous capture
+ * @date 2026-10-18 Save frames in the selected file format
+ * @date 2026-10-18 Hand frames to the encoder pool in continuous capture
+ * @date 2026-10-18 Move camera configuration and state into a capture context
+ * @date 2026-10-18 Grab single frames with a timeout for the library interface
+ * @date 2026-10-18 Run captured frames through a processing pipeline if selected
+ * @date 2026-10-18 Hand captured frames to pipeline stage threads if started
+ * @date 2026-10-18 Pass capture timestamps to the pipeline for its deadlines
+ * @date 2026-10-19 Add low latency capture of the newest frame and buffer count setting
+ * @date 2026-10-19 Time dequeue and copy of frames for the stage histograms
+ * @date 2026-10-19 Tag events of the capture thread with the frame sequence for tracing
+ * @date 2026-10-19 Hand the capture time of frames to the outputs
+ * @date 2026-10-19 Access the continuous capture flag atomically
+ * @date 2026-10-19 Return errors of the device to the caller instead of exiting
+ * @date 2026-10-19 Copy frames of continuous capture into memory lent by the raw output
+ * @date 2026-10-19 Remove the process wide SIGINT handler, contexts are stopped by the library
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -27,6 +44,8 @@
 #include <stdlib.h>
 #include "PiCam.h"
 #include "write.h"
+#include "Metrics.h"
+#include "Trace.h"
 
 /*============================[  Defines  ]=============================================*/
 
@@ -48,29 +67,6 @@
  *  @{
  */
 
-/** Stops continuous capture
- */ 
-void StopContCapture(int sig_id) 
-{
-	printf("Stoping continuous capture\n");
-	continuous = 0;
-}
-
-/** Assigns signal interrupt handler function pointer
- */
-void InstallSIGINTHandler() 
-{
-	struct sigaction sa;
-	CLEAR(sa);
-	
-	sa.sa_handler = StopContCapture;
-	if(sigaction(SIGINT, &sa, 0) != 0)
-	{
-		fprintf(stderr,"Could not install SIGINT handler, continuous capture disabled \n");
-		continuous = 0;
-	}
-}
-
 /** Input output control device driver
  */ 
 int xioctl(int fd, int req, void* argp)
@@ -83,156 +79,279 @@ int xioctl(int fd, int req, void* argp)
 	return r;
 }
 
-/** Updates the global buffer from captured buffer from v4l2 
+/** Copies captured buffer from v4l2 into the latest image of the context
  */ 
-void Update_LatestBuffer(const void* p, struct timeval timestamp)
+Std_ReturnType Copy_LatestBuffer(PiCam_Context* cam, const void* p)
 {
-	int image_size = width*height*3*sizeof(char)/2;
+	int image_size = cam->width*cam->height*3*sizeof(char)/2;
 	unsigned char* src = (unsigned char*)p;
-	Image_Buffer.start = malloc(image_size);
-	memcpy(Image_Buffer.start, src, image_size);
+
+	/* A buffer handed to the raw output or encoder pool is released there */
+	if (!cam->handed && !cam->claimed)
+		free(cam->image.start);
+	cam->handed = 0;
+
+	/* Frames of continuous capture go straight into the raw output if it lends memory */
+	cam->image.start = NULL;
+	if (__atomic_load_n(&cam->continuous, __ATOMIC_RELAXED) == 1)
+		cam->image.start = Save_ClaimRawFrame(cam->save, (size_t)image_size);
+	cam->claimed = (NULL != cam->image.start);
+	if (!cam->claimed)
+		cam->image.start = malloc(image_size);
+	if (NULL == cam->image.start)
+		return errno_print("malloc");
+	memcpy(cam->image.start, src, image_size);
+
+	return E_OK;
+}
+
+/** Updates the latest image of the context from captured buffer from v4l2 
+ */ 
+Std_ReturnType Update_LatestBuffer(PiCam_Context* cam, const void* p, struct timeval timestamp)
+{
+	if (E_OK != Copy_LatestBuffer(cam, p))
+		return E_NOT_OK;
+	return Save_LatestBuffer(cam, timestamp);
+}
+
+/** Saves the latest image of the context in continuous capture
+ */ 
+Std_ReturnType Save_LatestBuffer(PiCam_Context* cam, struct timeval timestamp)
+{
+	int64_t captured = (int64_t)timestamp.tv_sec * 1000000 + timestamp.tv_usec;
+
+	cam->image.timestamp = timestamp;
+
+	/* Save every frame, a configured output sink collects them into a single recording */
+	if (__atomic_load_n(&cam->continuous, __ATOMIC_RELAXED) == 1)
+	{
+		sprintf(cam->frame_name, continuousFilenameFmt, cam->filename, cam->frame_count++, 
+			captured, Save_GetExtension(cam->save));
+		/* Stage threads set the capture time of the frames they save, unless a raw output takes all */
+		if (NULL == cam->pipeline || NULL != cam->save->raw_submit)
+			Save_SetCaptureTime(cam->save, captured);
+		cam->handed = writerawimageYUV420(cam->save, cam->width, cam->height, cam->image.start, cam->frame_name);
+		if (!cam->handed && NULL != cam->pipeline)
+		{
+			cam->handed = Pipeline_Submit(cam->pipeline, cam->save, cam->image.start, cam->frame_name, captured);
+			return E_OK;
+		}
+		if (!cam->handed)
+			cam->handed = writepooledimageYUV420(cam->save, cam->width, cam->height, cam->image.start, cam->frame_name);
+		if (!cam->handed)
+			return writeimageYUV420(cam->save, cam->width, cam->height, cam->image.start, cam->frame_name);
+	}
+
+	return E_OK;
+}
+
+/** A frame which waited for the application is older than the one behind it, so only the 
+ * last dequeued buffer is kept. 
+ */
+Std_ReturnType DrainBuffers(PiCam_Context* cam, struct v4l2_buffer* buf)
+{
+	struct v4l2_buffer next;
+
+	for (;;)
+	{
+		CLEAR(next);
+		next.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+		next.memory = V4L2_MEMORY_MMAP;
+
+		if (-1 == xioctl(cam->fd, VIDIOC_DQBUF, &next))
+		{
+			if (EAGAIN == errno)
+				return E_OK;
+			return errno_print("VIDIOC_DQBUF");
+		}
+
+		if (-1 == xioctl(cam->fd, VIDIOC_QBUF, buf))
+			return errno_print("VIDIOC_QBUF");
+
+		*buf = next;
+		cam->stale++;
+	}
 }
 
 /**	Read single frame from v4l2 buffer
 */
-int ReadBuffer(void)
+int ReadBuffer(PiCam_Context* cam)
 {
 	struct v4l2_buffer buf;
+	Std_ReturnType copied;
+	int64_t start = Metrics_Begin();
     CLEAR(buf);
 
     buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     buf.memory = V4L2_MEMORY_MMAP;
 
-    if (-1 == xioctl(fd, VIDIOC_DQBUF, &buf)) 
+    if (-1 == xioctl(cam->fd, VIDIOC_DQBUF, &buf)) 
 	{
         switch (errno) 
 		{
             case EAGAIN:
-                return 0;
+                return EXIT_FAILURE;
 
             case EIO:
                 // Could ignore EIO, see spec
                 // fall through
 
             default:
-                errno_exit("VIDIOC_DQBUF");
+                errno_print("VIDIOC_DQBUF");
+                return -1;
         }
     }
+	Trace_SetFrame(buf.sequence);
+
+	/* The buffer goes back to the driver before processing, so it fills it with a newer frame */
+	if (cam->latest)
+	{
+		if (E_OK != DrainBuffers(cam, &buf))
+			return -1;
+		Trace_SetFrame(buf.sequence);
+		assert(buf.index < cam->n_buffers);
+		copied = Copy_LatestBuffer(cam, cam->buffers[buf.index].start);
+		if (-1 == xioctl(cam->fd, VIDIOC_QBUF, &buf))
+		{
+			errno_print("VIDIOC_QBUF");
+			return -1;
+		}
+		Metrics_End(METRIC_CAPTURE, start);
+		if (E_OK != copied || E_OK != Save_LatestBuffer(cam, buf.timestamp))
+			return -1;
+		return 0;
+	}
 
-    assert(buf.index < n_buffers);
-	Update_LatestBuffer(img_buffer[buf.index].start,buf.timestamp);
+    assert(buf.index < cam->n_buffers);
+	copied = Copy_LatestBuffer(cam, cam->buffers[buf.index].start);
+	Metrics_End(METRIC_CAPTURE, start);
+	if (E_OK == copied)
+		copied = Save_LatestBuffer(cam, buf.timestamp);
 
-    if (-1 == xioctl(fd, VIDIOC_QBUF, &buf))
-        errno_exit("VIDIOC_QBUF");
+    if (-1 == xioctl(cam->fd, VIDIOC_QBUF, &buf))
+    {
+        errno_print("VIDIOC_QBUF");
+        return -1;
+    }
 
-	return 0;
+	return (E_OK == copied) ? 0 : -1;
 }
 
 /** Initializes MMAP to capture image buffers form v4l2 library
  */ 
-void InitMMAP(void)
+Std_ReturnType InitMMAP(PiCam_Context* cam)
 {
 	struct v4l2_requestbuffers req;
+	struct v4l2_control ctrl;
+	unsigned int min = cam->buffer_count ? VIDIOC_REQBUFS_MIN : VIDIOC_REQBUFS_COUNT;
 
 	CLEAR(req);
+	CLEAR(ctrl);
 
-	req.count = VIDIOC_REQBUFS_COUNT;
+	req.count = cam->buffer_count ? cam->buffer_count : VIDIOC_REQBUFS_COUNT;
 	req.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 	req.memory = V4L2_MEMORY_MMAP;
 
-	if (-1 == xioctl(fd, VIDIOC_REQBUFS, &req)) {
+	/* Fewer buffers than the driver needs to keep streaming would stall capture */
+	ctrl.id = V4L2_CID_MIN_BUFFERS_FOR_CAPTURE;
+	if (0 == xioctl(cam->fd, VIDIOC_G_CTRL, &ctrl) && ctrl.value > 0 && (unsigned int)ctrl.value > req.count)
+		req.count = ctrl.value;
+
+	if (-1 == xioctl(cam->fd, VIDIOC_REQBUFS, &req)) {
 		if (EINVAL == errno) {
-			fprintf(stderr, "%s does not support memory mapping\n", deviceName);
-			exit(EXIT_FAILURE);
+			fprintf(stderr, "%s does not support memory mapping\n", cam->device);
+			return E_NOT_OK;
 		} else {
-			errno_exit("VIDIOC_REQBUFS");
+			return errno_print("VIDIOC_REQBUFS");
 		}
 	}
 
-	if (req.count < 3) {
-		fprintf(stderr, "Insufficient buffer memory on %s\n", deviceName);
-		exit(EXIT_FAILURE);
+	if (req.count < min) {
+		fprintf(stderr, "Insufficient buffer memory on %s\n", cam->device);
+		return E_NOT_OK;
 	}
 
-	img_buffer = calloc(req.count, sizeof(*img_buffer));
+	cam->buffers = calloc(req.count, sizeof(*cam->buffers));
 
-	if (!img_buffer) {
+	if (!cam->buffers) {
 		fprintf(stderr, "Out of memory\n");
-		exit(EXIT_FAILURE);
+		return E_NOT_OK;
 	}
 
-	for (n_buffers = 0; n_buffers < req.count; ++n_buffers) {
+	for (cam->n_buffers = 0; cam->n_buffers < req.count; ++cam->n_buffers) {
 		struct v4l2_buffer buf;
 
 		CLEAR(buf);
 
 		buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 		buf.memory = V4L2_MEMORY_MMAP;
-		buf.index = n_buffers;
+		buf.index = cam->n_buffers;
 
-		if (-1 == xioctl(fd, VIDIOC_QUERYBUF, &buf))
-			errno_exit("VIDIOC_QUERYBUF");
+		if (-1 == xioctl(cam->fd, VIDIOC_QUERYBUF, &buf))
+			return errno_print("VIDIOC_QUERYBUF");
 
-		img_buffer[n_buffers].length = buf.length;
-		img_buffer[n_buffers].start = v4l2_mmap(NULL,  /* Start anywhere */ 
+		cam->buffers[cam->n_buffers].length = buf.length;
+		cam->buffers[cam->n_buffers].start = v4l2_mmap(NULL,  /* Start anywhere */ 
                                             buf.length, PROT_READ | PROT_WRITE, /* Required */
                                             MAP_SHARED, /* Recommended */ 
-                                            fd, 
+                                            cam->fd, 
                                             buf.m.offset);
 
-		if (MAP_FAILED == img_buffer[n_buffers].start)
-			errno_exit("mmap");
+		if (MAP_FAILED == cam->buffers[cam->n_buffers].start)
+			return errno_print("mmap");
 	}
+
+	return E_OK;
 }
 
 /** Initialize v4l2 formats and check if the camera device supports the 
  * provided settings.
 */
-void InitializeCameraFormats(struct v4l2_format format)
+Std_ReturnType InitializeCameraFormats(PiCam_Context* cam, struct v4l2_format format)
 {
 	struct v4l2_streamparm frameint;
 	unsigned int min;
 
 	// v4l2_format
 	format.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
-	format.fmt.pix.width = width;
-	format.fmt.pix.height = height;
+	format.fmt.pix.width = cam->width;
+	format.fmt.pix.height = cam->height;
 	format.fmt.pix.field = V4L2_FIELD_INTERLACED;
-	format.fmt.pix.pixelformat = pixel_format;
+	format.fmt.pix.pixelformat = cam->pixel_format;
 
-	if (-1 == xioctl(fd, VIDIOC_S_FMT, &format))
-		errno_exit("VIDIOC_S_FMT");
+	if (-1 == xioctl(cam->fd, VIDIOC_S_FMT, &format))
+		return errno_print("VIDIOC_S_FMT");
 
-	if (format.fmt.pix.pixelformat != pixel_format) {
-		fprintf(stderr,"Libv4l didn't accept %d format. Can't proceed.\n",pixel_format);
-		exit(EXIT_FAILURE);
+	if (format.fmt.pix.pixelformat != cam->pixel_format) {
+		fprintf(stderr,"Libv4l didn't accept %d format. Can't proceed.\n",cam->pixel_format);
+		return E_NOT_OK;
 	}
 	else
 	{
-		fprintf(stdout,"Capture successful in %d format \n", pixel_format);
+		fprintf(stdout,"Capture successful in %d format \n", cam->pixel_format);
 	}
 
 	/* Note VIDIOC_S_FMT may change width and height. */
-	if (width != format.fmt.pix.width) {
-		width = format.fmt.pix.width;
-		fprintf(stderr,"Image width set to %i by device %s.\n", width, deviceName);
+	if (cam->width != format.fmt.pix.width) {
+		cam->width = format.fmt.pix.width;
+		fprintf(stderr,"Image width set to %i by device %s.\n", cam->width, cam->device);
 	}
 
-	if (height != format.fmt.pix.height) {
-		height = format.fmt.pix.height;
-		fprintf(stderr,"Image height set to %i by device %s.\n", height, deviceName);
+	if (cam->height != format.fmt.pix.height) {
+		cam->height = format.fmt.pix.height;
+		fprintf(stderr,"Image height set to %i by device %s.\n", cam->height, cam->device);
 	}
 	
   /* If the user has set the fps to -1, don't try to set the frame interval */
-  if (fps != -1)
+  if (cam->fps != -1)
   {
     CLEAR(frameint);
     
     /* Attempt to set the frame interval. */
     frameint.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
     frameint.parm.capture.timeperframe.numerator = 1;
-    frameint.parm.capture.timeperframe.denominator = fps;
-    if (-1 == xioctl(fd, VIDIOC_S_PARM, &frameint))
+    frameint.parm.capture.timeperframe.denominator = cam->fps;
+    if (-1 == xioctl(cam->fd, VIDIOC_S_PARM, &frameint))
       fprintf(stderr,"Unable to set frame interval.\n");
   }
 
@@ -244,18 +363,25 @@ void InitializeCameraFormats(struct v4l2_format format)
 	if (format.fmt.pix.sizeimage < min)
 		format.fmt.pix.sizeimage = min;
 
+	return E_OK;
 }
 
-void CheckContinuousFlag( int flag)
+/** The filename of frames is allocated once for the longest frame number and timestamp. 
+ */ 
+Std_ReturnType CheckContinuousFlag(PiCam_Context* cam)
 {
 	/** Continuous capture flag set to TRUE */
-	if(continuous == 1) 
+	if(cam->continuous == 1) 
 	{
-		int max_name_len = snprintf(NULL,0,continuousFilenameFmt,filename,UINT32_MAX,INT64_MAX);
-		filenamePart = filename;
-		filename = calloc(max_name_len+1,sizeof(char));
-		strcpy(filename,filenamePart);
+		int max_name_len = snprintf(NULL,0,continuousFilenameFmt,cam->filename,UINT32_MAX,INT64_MAX,Save_GetExtension(cam->save));
+		free(cam->frame_name);
+		cam->frame_name = calloc(max_name_len+1,sizeof(char));
+		if (NULL == cam->frame_name)
+			return errno_print("calloc");
+		strcpy(cam->frame_name,cam->filename);
 	}
+
+	return E_OK;
 }
 
 /** @} */
@@ -264,9 +390,42 @@ void CheckContinuousFlag( int flag)
  *  @{
  */
 
-/**	Captures image buffer and stores them in global variable.
+/** Sets the default camera settings, options of the application override them. 
+ */ 
+void PiCam_InitContext(PiCam_Context* cam, Save_Context* save)
+{
+	CLEAR(*cam);
+	cam->device = "/dev/video0";
+	cam->io = IO_METHOD_MMAP;
+	cam->fd = -1;
+	cam->width = 640;
+	cam->height = 480;
+	cam->fps = 30;
+	cam->pixel_format = V4L2_PIX_FMT_YUV420;
+	cam->save = save;
+}
+
+/** The latest image is kept by an output it was handed to or lent by. 
+ */ 
+void PiCam_DeInitContext(PiCam_Context* cam)
+{
+	if (!cam->handed && !cam->claimed)
+		free(cam->image.start);
+	cam->image.start = NULL;
+	free(cam->frame_name);
+	cam->frame_name = NULL;
+}
+
+/** Continuous capture ends after the frame in progress. 
+ */ 
+void PiCam_Stop(PiCam_Context* cam)
+{
+	__atomic_store_n(&cam->continuous, 0, __ATOMIC_RELAXED);
+}
+
+/**	Captures image buffer and stores it in the capture context.
 */
-void CaptureFrame(void)
+Std_ReturnType CaptureFrame(PiCam_Context* cam)
 {	
 	int count;
 	unsigned int numberOfTimeouts;
@@ -282,61 +441,106 @@ void CaptureFrame(void)
 			int r;
 
 			FD_ZERO(&fds);
-			FD_SET(fd, &fds);
+			FD_SET(cam->fd, &fds);
 
 			/* Timeout. */
 			tv.tv_sec = 1;
 			tv.tv_usec = 0;
 
-			r = select(fd + 1, &fds, NULL, NULL, &tv);
+			r = select(cam->fd + 1, &fds, NULL, NULL, &tv);
 
 			if (-1 == r) {
 				if (EINTR == errno)
 					continue;
 
-				errno_exit("select");
+				return errno_print("select");
 			}
 
 			if (0 == r) {
 				if (numberOfTimeouts <= 0) {
-					count++;
+					continue;
 				} else {
 					fprintf(stderr, "select timeout\n");
-					exit(EXIT_FAILURE);
+					return E_NOT_OK;
 				}
 			}
-			if(continuous == 1) {
+			if(__atomic_load_n(&cam->continuous, __ATOMIC_RELAXED) == 1) {
 				count = 3;
 			}
 
-			if (0 == ReadBuffer())
+			r = ReadBuffer(cam);
+			if (0 == r)
 				break;
+			if (r < 0)
+				return E_NOT_OK;
 
 			/* EAGAIN - continue select loop. */
 		}
 	}
+
+	return E_OK;
+}
+
+/**	Waits for the next frame like CaptureFrame, but for a single frame and without retries. 
+ * The timeout restarts if a signal interrupts the wait.
+*/
+Std_ReturnType GrabFrame(PiCam_Context* cam, int timeout_ms)
+{
+	for (;;) {
+		fd_set fds;
+		struct timeval tv;
+		int r;
+
+		FD_ZERO(&fds);
+		FD_SET(cam->fd, &fds);
+
+		tv.tv_sec = timeout_ms / 1000;
+		tv.tv_usec = (timeout_ms % 1000) * 1000;
+
+		r = select(cam->fd + 1, &fds, NULL, NULL, (timeout_ms < 0) ? NULL : &tv);
+
+		if (-1 == r) {
+			if (EINTR == errno)
+				continue;
+
+			return E_NOT_OK;
+		}
+
+		if (0 == r)
+			return E_NOT_OK;
+
+		r = ReadBuffer(cam);
+		if (EXIT_SUCCESS == r)
+			return E_OK;
+		if (r < 0)
+			return E_NOT_OK;
+
+		/* EAGAIN - continue select loop. */
+	}
 }
 
 /**	Stop capturing v4l2 buffers
 */
-void StopCapture(void)
+Std_ReturnType StopCapture(PiCam_Context* cam)
 {
 	enum v4l2_buf_type type;
 
     type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 
-    if (-1 == xioctl(fd, VIDIOC_STREAMOFF, &type))
-    errno_exit("VIDIOC_STREAMOFF");
+    if (-1 == xioctl(cam->fd, VIDIOC_STREAMOFF, &type))
+        return errno_print("VIDIOC_STREAMOFF");
+
+    return E_OK;
 }
 
 /** Start capturing v4l2 buffers
 */
-void StartCapture(void)
+Std_ReturnType StartCapture(PiCam_Context* cam)
 {
 	unsigned int i;
 	enum v4l2_buf_type type;
 
-    for (i = 0; i < n_buffers; ++i) 
+    for (i = 0; i < cam->n_buffers; ++i) 
     {
         struct v4l2_buffer buf;
         CLEAR(buf);
@@ -345,63 +549,71 @@ void StartCapture(void)
         buf.memory = V4L2_MEMORY_MMAP;
         buf.index = i;
 
-        if (-1 == xioctl(fd, VIDIOC_QBUF, &buf))
-            errno_exit("VIDIOC_QBUF");
+        if (-1 == xioctl(cam->fd, VIDIOC_QBUF, &buf))
+            return errno_print("VIDIOC_QBUF");
         }
 
     type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 
-    if (-1 == xioctl(fd, VIDIOC_STREAMON, &type))
-        errno_exit("VIDIOC_STREAMON");
+    if (-1 == xioctl(cam->fd, VIDIOC_STREAMON, &type))
+        return errno_print("VIDIOC_STREAMON");
 
+    return E_OK;
 }
 
 /** De-initializes camera using v4l2_munmap 
 */
-void DeInitCamera(void)
+Std_ReturnType DeInitCamera(PiCam_Context* cam)
 {
+	Std_ReturnType unmapped = E_OK;
 	unsigned int i;
 
-    for (i = 0; i < n_buffers; ++i)
-        if (-1 == v4l2_munmap(img_buffer[i].start, img_buffer[i].length))
-            errno_exit("munmap");
+	for (i = 0; i < cam->n_buffers; ++i)
+	{
+		if (-1 == v4l2_munmap(cam->buffers[i].start, cam->buffers[i].length))
+			unmapped = errno_print("munmap");
+	}
+
+	free(cam->buffers);
+	cam->buffers = NULL;
+	cam->n_buffers = 0;
 
-	free(img_buffer);
+	return unmapped;
 }
 
 /** Initializes camera and camera formats to capture v4l2 buffers 
 */
-void InitCamera(void)
+Std_ReturnType InitCamera(PiCam_Context* cam)
 {
 	struct v4l2_capability cap;
 	struct v4l2_cropcap cropcap;
 	struct v4l2_crop crop;
 	struct v4l2_format fmt;
 
-	if (-1 == xioctl(fd, VIDIOC_QUERYCAP, &cap)) 
+	if (-1 == xioctl(cam->fd, VIDIOC_QUERYCAP, &cap)) 
     {
 		if (EINVAL == errno) 
         {
-			fprintf(stderr, "%s is no V4L2 device\n",deviceName);
-			exit(EXIT_FAILURE);
+			fprintf(stderr, "%s is no V4L2 device\n",cam->device);
+			return E_NOT_OK;
 		} 
         else 
         {
-			errno_exit("VIDIOC_QUERYCAP");
+			return errno_print("VIDIOC_QUERYCAP");
 		}
 	}
 
 	if (!(cap.capabilities & V4L2_CAP_VIDEO_CAPTURE)) 
     {
-		fprintf(stderr, "%s is no video capture device\n",deviceName);
-		exit(EXIT_FAILURE);
+		fprintf(stderr, "%s is no video capture device\n",cam->device);
+		return E_NOT_OK;
 	}
 
 
     if (!(cap.capabilities & V4L2_CAP_STREAMING)) 
     {
-        fprintf(stderr, "%s does not support streaming i/o\n",deviceName);
-        exit(EXIT_FAILURE);
+        fprintf(stderr, "%s does not support streaming i/o\n",cam->device);
+        return E_NOT_OK;
     }
 
 	/* Select video input, video standard and tune here. */
@@ -409,12 +621,12 @@ void InitCamera(void)
 
 	cropcap.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 
-	if (0 == xioctl(fd, VIDIOC_CROPCAP, &cropcap)) 
+	if (0 == xioctl(cam->fd, VIDIOC_CROPCAP, &cropcap)) 
     {
 		crop.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
 		crop.c = cropcap.defrect; /* reset to default */
 
-		if (-1 == xioctl(fd, VIDIOC_S_CROP, &crop)) 
+		if (-1 == xioctl(cam->fd, VIDIOC_S_CROP, &crop)) 
         {
 			switch (errno) 
             {
@@ -434,47 +646,53 @@ void InitCamera(void)
 
 	CLEAR(fmt);
 
-	InitializeCameraFormats(fmt);
-	InitMMAP();
+	if (E_OK != InitializeCameraFormats(cam, fmt))
+		return E_NOT_OK;
 
+	return InitMMAP(cam);
 }
 
 /**	Closes camera
 */
-void CloseCamera(void)
+Std_ReturnType CloseCamera(PiCam_Context* cam)
 {
-	if (-1 == v4l2_close(fd))
-		errno_exit("close");
+	int closed = v4l2_close(cam->fd);
 
-	fd = -1;
+	cam->fd = -1;
+	if (-1 == closed)
+		return errno_print("close");
+
+	return E_OK;
 }
 
 /**	Open camera device
 */
-void OpenCamera(void)
+Std_ReturnType OpenCamera(PiCam_Context* cam)
 {
 	struct stat st;
 
 	// stat file
-	if (-1 == stat(deviceName, &st)) {
-		fprintf(stderr, "Cannot identify '%s': %d, %s\n", deviceName, errno, strerror(errno));
-		exit(EXIT_FAILURE);
+	if (-1 == stat(cam->device, &st)) {
+		fprintf(stderr, "Cannot identify '%s': %d, %s\n", cam->device, errno, strerror(errno));
+		return E_NOT_OK;
 	}
 
 	// check if its device
 	if (!S_ISCHR(st.st_mode)) {
-		fprintf(stderr, "%s is no device\n", deviceName);
-		exit(EXIT_FAILURE);
+		fprintf(stderr, "%s is no device\n", cam->device);
+		return E_NOT_OK;
 	}
 
 	// open device
-	fd = v4l2_open(deviceName, O_RDWR /* required */ | O_NONBLOCK, 0);
+	cam->fd = v4l2_open(cam->device, O_RDWR /* required */ | O_NONBLOCK, 0);
 
 	// check if opening was successfull
-	if (-1 == fd) {
-		fprintf(stderr, "Cannot open '%s': %d, %s\n", deviceName, errno, strerror(errno));
-		exit(EXIT_FAILURE);
+	if (-1 == cam->fd) {
+		fprintf(stderr, "Cannot open '%s': %d, %s\n", cam->device, errno, strerror(errno));
+		return E_NOT_OK;
 	}
+
+	return E_OK;
 }
 
 /** @} */
@@ -6,6 +6,14 @@
  * @date 2022-03-03 Initial template
  * @date 2022-03-21 Updates for saving BMP image
  * @date 2022-03-23 Updates for Gaussian filter and Edge detection
+ * @date 2026-10-18 Move camera configuration and state into a capture context
+ * @date 2026-10-18 Grab single frames with a timeout for the library interface
+ * @date 2026-10-18 Run captured frames through a processing pipeline if selected
+ * @date 2026-10-19 Add low latency capture of the newest frame and buffer count setting
+ * @date 2026-10-19 Access the continuous capture flag atomically
+ * @date 2026-10-19 Return errors of the device to the caller instead of exiting
+ * @date 2026-10-19 Copy frames of continuous capture into memory lent by the raw output
+ * @date 2026-10-19 Remove the process wide SIGINT handler, contexts are stopped by the library
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -24,8 +32,11 @@
 #include <string.h>
 #include <libv4l2.h>
 #include <inttypes.h>
+#include <signal.h>
 #include <linux/videodev2.h>
 #include "Common_PiCam.h"
+#include "write.h"
+#include "Pipeline.h"
 
 /*============================[  Defines  ]=============================================*/
 
@@ -36,6 +47,12 @@
 /** Minimum number of buffers to request in VIDIOC_REQBUFS call */
 #define VIDIOC_REQBUFS_COUNT 3
 
+/** Fewest buffers streaming works with, one filled by the driver while one is read */
+#define VIDIOC_REQBUFS_MIN 2
+
+/** Most buffers which can be requested */
+#define VIDIOC_REQBUFS_MAX 32
+
 /** @} */
 
 /*============================[  Data Types  ]==========================================*/
@@ -64,50 +81,66 @@ typedef struct
     u_int16_t*  start;
 } Image_HSV;
 
-/** @} */
-
-/*============================[  Global Variables  ]=====================================*/
-
-/** \addtogroup global_variables	  
- *  @{
+/** Configuration and state of one capture pipeline. Independent pipelines use one context 
+ *  each and may run on different threads. 
  */
-
-/** I/O method to use for the library */
-static io_method io = IO_METHOD_MMAP;
-
-/** File descriptor */
-static int fd = -1;
-
-/** Variable to store the captured buffer */
-struct buffer* img_buffer;
-
-/** Number of buffers */
-static unsigned int n_buffers = 0;
-
-/** Global camera settings */
-/** Default camera setting for image width  */
-static unsigned int width = 640;
-
-/** Default camera setting for image height  */
-static unsigned int height = 480;
-
-/** Default camera setting for frames per seconds */
-static unsigned int fps = 30;
-
-/** Default camera name in linux */
-static char* deviceName = "/dev/video0";
-
-/** Default pixel format to capture */
-uint32_t pixel_format;
+typedef struct
+{
+    /** Camera name in linux */
+    const char* device;
+    /** I/O method to use for the library */
+    io_method io;
+    /** File descriptor of the device, -1 while closed */
+    int fd;
+    /** Memory mapped capture buffers */
+    struct buffer* buffers;
+    /** Number of buffers */
+    unsigned int n_buffers;
+    /** Number of buffers to request, 0 for VIDIOC_REQBUFS_COUNT, the driver may raise it */
+    unsigned int buffer_count;
+    /** Flag to read only the newest of the frames ready in the driver queue */
+    int latest;
+    /** Number of frames returned unread to the driver queue */
+    unsigned long stale;
+    /** Image width, the device may change it */
+    unsigned int width;
+    /** Image height, the device may change it */
+    unsigned int height;
+    /** Frames per second, -1 to keep the setting of the device */
+    int fps;
+    /** Pixel format to capture */
+    uint32_t pixel_format;
+    /** Flag to capture continuously until stopped, accessed atomically as PiCam_Stop may be
+     *  called from another thread */
+    int continuous;
+    /** Filename of the saved image, filename prefix in continuous capture */
+    char* filename;
+    /** Filename of the current frame in continuous capture */
+    char* frame_name;
+    /** Number of frames saved in continuous capture */
+    uint32_t frame_count;
+    /** Set if the latest image was handed to an output which releases it */
+    int handed;
+    /** Set if the latest image is memory lent by the raw output, which is never freed */
+    int claimed;
+    /** Latest captured image */
+    struct buffer image;
+    /** Write functions saving captured images */
+    Save_Context* save;
+    /** Compiled processing pipeline saving captured images, NULL to save frames as captured */
+    Pipeline* pipeline;
+} PiCam_Context;
 
 /** @} */
 
+/*============================[  Global Variables  ]=====================================*/
+
 /** \addtogroup global_constants	  
  *  @{
  */
 
 /** Filename to save images incase of continuous capture  */
-static const char* const continuousFilenameFmt = "%s_%010"PRIu32"_%"PRId64".jpg";
+static const char* const continuousFilenameFmt = "%s_%010"PRIu32"_%"PRId64"%s";
 
 /** @} */
 
@@ -117,20 +150,6 @@ static const char* const continuousFilenameFmt = "%s_%010"PRIu32"_%"PRId64".jpg"
  *  @{
  */
 
-/**
- * @brief Stop SIGINT interput handler.
- * 
- * @param[in] sig_id Signal ID 
- * 
- */
-void StopContCapture(int sig_id);
-
-/**
- * @brief SIGINT interput handler.
- * 
- */
-void InstallSIGINTHandler(void); 
-
 /**
  * @brief Implementation of wrapper around v4l2_ioctl. Capture ioctl buffer 
  * and retry if error EINTR was returned. A signal was caught during the 
@@ -150,42 +169,107 @@ int xioctl(int fd, int req, void* argp);
 /**
  * @brief Read single frame from buffer.
  * 
+ * @param[inout] cam    Capture context
+ * 
  * @return int  Operation Status
  * @retval EXIT_SUCCESS Operation successful
- * @retval EXIT_FAILURE Operation unsuccessful 
+ * @retval EXIT_FAILURE No frame was ready
+ * @retval -1           Error of the device or of saving the frame, the error is printed
+ * 
+ */
+int ReadBuffer(PiCam_Context* cam);
+
+/**
+ * @brief Dequeue all further frames ready in the driver queue and keep the newest. Older 
+ * frames are returned to the driver at once and counted as stale.
+ * 
+ * @param[inout] cam    Capture context
+ * @param[inout] buf    Dequeued buffer, replaced by the newest one
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful, the error is printed
  * 
  */
-int ReadBuffer(void);
+Std_ReturnType DrainBuffers(PiCam_Context* cam, struct v4l2_buffer* buf);
 
 /**
- * @brief   Function to update local and global image pixel buffer from captured v4l2 buffer.   
+ * @brief Copy a captured v4l2 buffer into the latest image of a context, the buffer can be 
+ * returned to the driver afterwards.
  * 
+ * @param[inout] cam    Capture context
+ * @param[in] p         Pointer to captured buffer
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful, the error is printed
+ * 
+ */
+Std_ReturnType Copy_LatestBuffer(PiCam_Context* cam, const void* p);
+
+/**
+ * @brief In continuous capture save the latest image of a context like Update_LatestBuffer.
+ * 
+ * @param[inout] cam    Capture context
+ * @param[in] timestamp Timestamp of the captured buffer
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful, the error is printed
+ * 
+ */
+Std_ReturnType Save_LatestBuffer(PiCam_Context* cam, struct timeval timestamp);
+
+/**
+ * @brief   Function to update the latest image of a context from captured v4l2 buffer.   
+ *          In continuous capture every frame is saved as JPEG image.
+ * 
+ * @param[inout] cam    Capture context
  * @param[in] p         Pointer to captured buffer
  * @param[in] timestamp Timestamp of captured buffer 
  * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful, the error is printed
+ * 
  */
-void Update_LatestBuffer(const void* p, struct timeval timestamp);
+Std_ReturnType Update_LatestBuffer(PiCam_Context* cam, const void* p, struct timeval timestamp);
 
 /**
  * @brief Initialization of MMAP driver.
  * 
+ * @param[inout] cam    Capture context
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful, the error is printed
+ * 
  */
-void InitMMAP(void);
+Std_ReturnType InitMMAP(PiCam_Context* cam);
 
 /**
  * @brief Initialize v4l2 formats and checks if the camera settings are supported.
  * 
+ * @param[inout] cam    Capture context, width and height are updated to the device settings
  * @param[in] format    Camera format to initialize
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful, the error is printed
+ * 
  */
-void InitializeCameraFormats(struct v4l2_format format);
+Std_ReturnType InitializeCameraFormats(PiCam_Context* cam, struct v4l2_format format);
 
 /**
- * @brief Checks if the continuous flag is set and updates the filename formatting 
- * to save the captured image using timestamp.
+ * @brief Checks if the continuous flag is set and allocates the filename of frames, which 
+ * are saved with the filename as prefix followed by frame number and timestamp.
+ * 
+ * @param[inout] cam    Capture context
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful, the error is printed
  * 
- * @param[in] flag  Flag to set continuous capture
  */
-void CheckContinuousFlag( int flag);
+Std_ReturnType CheckContinuousFlag(PiCam_Context* cam);
 
 /** @} */
 
@@ -193,47 +277,129 @@ void CheckContinuousFlag( int flag);
  *  @{
  */
 
+/**
+ * @brief Initialize a capture context with the default camera settings. The device is 
+ * /dev/video0 capturing 640x480 YUV420 images at 30 frames per second.
+ * 
+ * @param[out] cam      Capture context
+ * @param[in] save      Write functions saving captured images
+ * 
+ */
+void PiCam_InitContext(PiCam_Context* cam, Save_Context* save);
+
+/**
+ * @brief Release filenames and the latest image of a capture context.
+ * 
+ * @param[inout] cam    Capture context
+ * 
+ */
+void PiCam_DeInitContext(PiCam_Context* cam);
+
+/**
+ * @brief Stop continuous capture of a context, can be called from any thread.
+ * 
+ * @param[inout] cam    Capture context
+ * 
+ */
+void PiCam_Stop(PiCam_Context* cam);
+
 /**
  * @brief Function to read and process frames.
  * 
+ * @param[inout] cam    Capture context
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful, the error is printed
+ * 
  */
-void CaptureFrame(void);
+Std_ReturnType CaptureFrame(PiCam_Context* cam);
+
+/**
+ * @brief Wait for a single frame and store it as latest image of the context. In 
+ * continuous capture the frame is saved as in CaptureFrame.
+ * 
+ * @param[inout] cam        Capture context, capture must be started
+ * @param[in] timeout_ms    Maximum time to wait in milliseconds, negative to wait forever
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             A new frame is the latest image
+ * @retval E_NOT_OK         Timeout or error while waiting
+ * 
+ */
+Std_ReturnType GrabFrame(PiCam_Context* cam, int timeout_ms);
 
 /**
  * @brief Stop capturing frames from buffer.
  * 
+ * @param[inout] cam    Capture context
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful, the error is printed
+ * 
  */
-void StopCapture(void);
+Std_ReturnType StopCapture(PiCam_Context* cam);
 
 /**
  * @brief Start capturing frames from buffer.
  * 
+ * @param[inout] cam    Capture context
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful, the error is printed
+ * 
  */
-void StartCapture(void);
+Std_ReturnType StartCapture(PiCam_Context* cam);
 
 /**
  * @brief De-initialization of device. 
  * 
+ * @param[inout] cam    Capture context
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful, the error is printed
+ * 
  */
-void DeInitCamera(void);
+Std_ReturnType DeInitCamera(PiCam_Context* cam);
 
 /**
  * @brief Initialization for v4l2 buffer for camera device.
  * 
+ * @param[inout] cam    Capture context
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful, the error is printed
+ * 
  */
-void InitCamera(void);
+Std_ReturnType InitCamera(PiCam_Context* cam);
 
 /**
  * @brief Function to open camera device.
  * 
+ * @param[inout] cam    Capture context
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful, the error is printed
+ * 
  */
-void OpenCamera(void);
+Std_ReturnType OpenCamera(PiCam_Context* cam);
 
 /**
  * @brief Function to close camera device.
  * 
+ * @param[inout] cam    Capture context
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful, the error is printed
+ * 
  */
-void CloseCamera(void);
+Std_ReturnType CloseCamera(PiCam_Context* cam);
 
 /** @} */
 
@@ -0,0 +1,825 @@
+/**
+ * @file PiCamLib.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of the libpicam interface to capture, encode and save images from
+ *          other programs </b>
+ * @version
+ * @date 2026-10-18 Initial template for the library interface
+ * @date 2026-10-19 Hand the capture time of the saved frame to the outputs
+ * @date 2026-10-19 Add outputs, pipelines, recording and serving, errors are returned
+ * @date 2026-10-19 Lend slots of the frame ring for frames copied in place
+ * @date 2026-10-19 Set deadlines only with a deadline and a frame interval
+ * @date 2026-10-19 Record AVI files and frame logs on a writer thread with a chosen policy
+ * @date 2026-10-19 Reject downscaled images together with a frame log
+ * @date 2026-10-19 Return the status type of the interface
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "PiCamLib.h"
+#include "PiCam.h"
+#include "OutputSink.h"
+#include "UringSink.h"
+#include "FrameLog.h"
+#include "AviWriter.h"
+#include "RawSink.h"
+#include "FrameRing.h"
+#include "CaptureServer.h"
+#include "Metrics.h"
+#include "Trace.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Public types are cast to the internal ones, so their layouts must not drift apart */
+_Static_assert(sizeof(PiCamLib_Image) == sizeof(Image_Planar) &&
+               offsetof(PiCamLib_Image, plane) == offsetof(Image_Planar, plane) &&
+               offsetof(PiCamLib_Image, stride) == offsetof(Image_Planar, stride) &&
+               (int)PICAMLIB_YUV444 == (int)PIXFMT_YUV444, "PiCamLib_Image differs from Image_Planar");
+_Static_assert((int)PICAMLIB_PPM == (int)SAVE_PPM, "PiCamLib_FileFormat differs from Save_Format");
+_Static_assert((int)PICAMLIB_RAW_NV12 == (int)RAW_NV12, "PiCamLib_RawFormat differs from Raw_Format");
+_Static_assert((int)PICAMLIB_QUEUE_DROP_OLDEST == (int)QUEUE_DROP_OLDEST, "PiCamLib_QueuePolicy differs from Queue_Policy");
+_Static_assert((int)PICAMLIB_DEADLINE_DEGRADE == (int)DEADLINE_DEGRADE, "PiCamLib_DeadlinePolicy differs from Deadline_Policy");
+_Static_assert(PICAMLIB_BUFFERS_MIN == VIDIOC_REQBUFS_MIN && PICAMLIB_BUFFERS_MAX == VIDIOC_REQBUFS_MAX,
+               "PiCamLib buffer limits differ from the capture context");
+_Static_assert(PICAMLIB_OK == E_OK && PICAMLIB_ERROR == E_NOT_OK, "PiCamLib_Status differs from Std_ReturnType");
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Opened camera, see PiCamLib.h */
+struct PiCamLib
+{
+    /** Capture context of the camera */
+    PiCam_Context cam;
+    /** Save context of the captured images */
+    Save_Context save;
+    /** Set once a frame was captured */
+    int captured;
+    /** Set while the device streams */
+    int streaming;
+    /** Output sink taking encoded images, NULL to write them on the capturing thread */
+    void* sink;
+    /** Output sink writing images on writer threads */
+    OutputSink writers;
+    /** Output sink writing images with io_uring */
+    UringSink uring;
+    /** Frame log recording all saved images */
+    FrameLog log;
+    /** AVI writer recording all saved images */
+    AviWriter avi;
+    /** Frame log or AVI writer the writer thread hands images to, NULL if not recording */
+    void* recording;
+    /** Raw output of uncompressed frames, NULL if not opened */
+    RawSink* raw;
+    /** Raw output storage */
+    RawSink raw_sink;
+    /** Shared memory ring publishing frames, NULL if not opened */
+    FrameRing* ring;
+    /** Shared memory ring storage */
+    FrameRing ring_sink;
+    /** Encoder pool, NULL if not started */
+    EncoderPool* pool;
+    /** Encoder pool storage */
+    EncoderPool pool_threads;
+    /** Rate controller, NULL if not used */
+    RateControl* rate;
+    /** Rate controller storage */
+    RateControl rate_control;
+    /** Downscaled images and thumbnails */
+    Preview_Config preview;
+    /** Processing pipeline storage, cam.pipeline points to it once compiled */
+    Pipeline pipeline;
+    /** Frames in flight between stage threads, 0 runs stages on the capturing thread */
+    int depth;
+    /** Action when all pipeline frames are in flight */
+    Queue_Policy policy;
+    /** Server answering capture requests */
+    CaptureServer server;
+    /** Set once the server was opened */
+    int serving;
+};
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** Streaming starts once and keeps going between captures and recordings.
+ */
+static Std_ReturnType PiCamLib_Stream(PiCamLib* lib)
+{
+    if (lib->streaming)
+        return E_OK;
+
+    if (E_OK != StartCapture(&lib->cam))
+        return E_NOT_OK;
+    lib->streaming = 1;
+
+    return E_OK;
+
+}/* End of function PiCamLib_Stream */
+
+/** Reverse order of PiCamLib_SetOutputs, the encoder pool delivers pending images to the
+ * output sink before the sink writes them.
+ */
+static Std_ReturnType PiCamLib_CloseOutputs(PiCamLib* lib)
+{
+    Std_ReturnType closed = E_OK;
+
+    if (NULL != lib->pool)
+    {
+        EncoderPool_Close(lib->pool);
+        Save_SetEncoderPool(&lib->save, NULL);
+        lib->pool = NULL;
+    }
+
+    Save_SetPreview(&lib->save, NULL);
+
+    if (NULL != lib->rate)
+    {
+        Save_SetRateControl(&lib->save, NULL);
+        RateControl_DeInit(lib->rate);
+        lib->rate = NULL;
+    }
+
+    if (NULL != lib->raw)
+        RawSink_Close(lib->raw);
+    if (NULL != lib->ring)
+        FrameRing_Close(lib->ring);
+    lib->raw = NULL;
+    lib->ring = NULL;
+    Save_SetRawOutput(&lib->save, NULL, NULL, NULL);
+
+    if (&lib->uring == lib->sink)
+        UringSink_Close(&lib->uring);
+    else if (&lib->writers == lib->sink)
+        OutputSink_Close(&lib->writers);
+    lib->sink = NULL;
+    Save_SetOutput(&lib->save, NULL, NULL);
+
+    if (&lib->avi == lib->recording && E_OK != AviWriter_Close(&lib->avi))
+        closed = errno_print("AviWriter_Close");
+    else if (&lib->log == lib->recording)
+        FrameLog_Close(&lib->log);
+    lib->recording = NULL;
+
+    return closed;
+
+}/* End of function PiCamLib_CloseOutputs */
+
+/** Outputs opened before the failing one are closed again.
+ */
+static Std_ReturnType PiCamLib_FailOutputs(PiCamLib* lib, const char* output)
+{
+    errno_print(output);
+    PiCamLib_CloseOutputs(lib);
+
+    return E_NOT_OK;
+
+}/* End of function PiCamLib_FailOutputs */
+
+/** Combinations of outputs which cannot work together are rejected before any is opened.
+ */
+static Std_ReturnType PiCamLib_CheckOutputs(const PiCamLib* lib, const PiCamLib_Outputs* outputs)
+{
+    /* AVI recordings hold MJPEG frames only */
+    if (NULL != outputs->avi && SAVE_JPEG != lib->save.format)
+    {
+        fprintf(stderr, "AVI recording requires JPEG images\n");
+        return E_NOT_OK;
+    }
+
+    /* Downscaled images are JPEG files of their own and do not fit into a recording */
+    if ((outputs->scales || outputs->thumbnail) && SAVE_JPEG != lib->save.format)
+    {
+        fprintf(stderr, "Downscaled images and thumbnails require JPEG images\n");
+        return E_NOT_OK;
+    }
+    if (outputs->scales && NULL != outputs->avi)
+    {
+        fprintf(stderr, "Downscaled images cannot be recorded into an AVI file\n");
+        return E_NOT_OK;
+    }
+    if (outputs->scales && NULL != outputs->log)
+    {
+        fprintf(stderr, "Downscaled images cannot be recorded into a frame log\n");
+        return E_NOT_OK;
+    }
+
+    /* Both take the uncompressed frames */
+    if (NULL != outputs->shm && NULL != outputs->raw)
+    {
+        fprintf(stderr, "Shared memory and raw output cannot be combined\n");
+        return E_NOT_OK;
+    }
+
+    return E_OK;
+
+}/* End of function PiCamLib_CheckOutputs */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** Programs compare it with PICAMLIB_VERSION of the headers they were built with.
+ */
+const char* PiCamLib_Version(void)
+{
+    return PICAMLIB_VERSION;
+
+}/* End of function PiCamLib_Version */
+
+/** Same defaults as PiCam_InitContext and Save_Init.
+ */
+void PiCamLib_DefaultConfig(PiCamLib_Config* config)
+{
+    memset(config, 0, sizeof(PiCamLib_Config));
+    config->device = "/dev/video0";
+    config->width = 640;
+    config->height = 480;
+    config->fps = 30;
+    config->quality = SAVE_DEFAULT_QUALITY;
+    config->format = PICAMLIB_JPEG;
+
+}/* End of function PiCamLib_DefaultConfig */
+
+/** Writes files on the capturing thread like a save context without outputs.
+ */
+void PiCamLib_DefaultOutputs(PiCamLib_Outputs* outputs)
+{
+    memset(outputs, 0, sizeof(PiCamLib_Outputs));
+    outputs->policy = PICAMLIB_QUEUE_DROP_OLDEST;
+    outputs->raw_format = PICAMLIB_RAW_Y4M;
+
+}/* End of function PiCamLib_DefaultOutputs */
+
+/** Stages run on the capturing thread unless a depth is set.
+ */
+void PiCamLib_DefaultPipeline(PiCamLib_Pipeline* pipeline)
+{
+    memset(pipeline, 0, sizeof(PiCamLib_Pipeline));
+    pipeline->policy = PICAMLIB_QUEUE_BLOCK;
+    pipeline->deadline_policy = PICAMLIB_DEADLINE_DEGRADE;
+
+}/* End of function PiCamLib_DefaultPipeline */
+
+/** Periods and sizes are the defaults of the metrics and trace modules.
+ */
+void PiCamLib_DefaultDiagnostics(PiCamLib_Diagnostics* diagnostics)
+{
+    diagnostics->metrics = NULL;
+    diagnostics->metrics_period_s = METRICS_PERIOD_S;
+    diagnostics->trace = NULL;
+    diagnostics->trace_events = TRACE_EVENTS;
+
+}/* End of function PiCamLib_DefaultDiagnostics */
+
+/** Timing starts before cameras are opened, so every frame is measured.
+ */
+PiCamLib_Status PiCamLib_StartDiagnostics(const PiCamLib_Diagnostics* diagnostics)
+{
+    Metrics_Config metrics = { diagnostics->metrics, diagnostics->metrics_period_s };
+    Trace_Config trace = { diagnostics->trace, diagnostics->trace_events };
+
+    if (NULL != metrics.path && E_OK != Metrics_Start(&metrics))
+        return errno_print("Metrics_Start");
+
+    if (NULL != trace.path && E_OK != Trace_Start(&trace))
+    {
+        Metrics_Stop();
+        return errno_print("Trace_Start");
+    }
+
+    return E_OK;
+
+}/* End of function PiCamLib_StartDiagnostics */
+
+/** Called after all cameras are closed, so the final files hold the last frames.
+ */
+void PiCamLib_StopDiagnostics(void)
+{
+    Trace_Stop();
+    Metrics_Stop();
+
+}/* End of function PiCamLib_StopDiagnostics */
+
+/** Errors of the device are printed and returned as NULL instead of terminating the program.
+ */
+PiCamLib* PiCamLib_Open(const PiCamLib_Config* config)
+{
+    Std_ReturnType validate = E_OK;
+    PiCamLib* lib;
+
+    validate += ValidateParam((void*)config);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateParam((void*)config->device);
+        validate += ValidateValue(config->quality, 1, 100);
+        validate += ValidateValue(config->format, PICAMLIB_JPEG, PICAMLIB_PPM);
+        validate += ((config->width > 0) && (config->height > 0)) ? E_OK : E_NOT_OK;
+        validate += (0 == config->buffers || (config->buffers >= PICAMLIB_BUFFERS_MIN &&
+                     config->buffers <= PICAMLIB_BUFFERS_MAX)) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return NULL;
+    }
+
+    lib = calloc(1, sizeof(PiCamLib));
+    if (NULL == lib)
+        return NULL;
+
+    Save_Init(&lib->save);
+    lib->save.quality = config->quality;
+    Save_SetFormat(&lib->save, (Save_Format)config->format);
+
+    PiCam_InitContext(&lib->cam, &lib->save);
+    lib->cam.device = config->device;
+    lib->cam.width = config->width;
+    lib->cam.height = config->height;
+    lib->cam.fps = config->fps;
+    lib->cam.buffer_count = config->buffers;
+    lib->cam.latest = config->latest;
+
+    if (E_OK != OpenCamera(&lib->cam))
+    {
+        Save_DeInit(&lib->save);
+        free(lib);
+        return NULL;
+    }
+
+    if (E_OK != InitCamera(&lib->cam))
+    {
+        DeInitCamera(&lib->cam);
+        CloseCamera(&lib->cam);
+        Save_DeInit(&lib->save);
+        free(lib);
+        return NULL;
+    }
+
+    return lib;
+
+}/* End of function PiCamLib_Open */
+
+/** Frames in flight are processed before the encoders and outputs are closed, streaming is
+ * stopped before the buffers are unmapped.
+ */
+PiCamLib_Status PiCamLib_Close(PiCamLib* lib)
+{
+    Std_ReturnType closed = E_OK;
+
+    if (NULL == lib)
+        return E_OK;
+
+    if (NULL != lib->cam.pipeline)
+        Pipeline_Stop(lib->cam.pipeline);
+
+    closed |= PiCamLib_CloseOutputs(lib);
+
+    if (NULL != lib->cam.pipeline)
+    {
+        Pipeline_Free(lib->cam.pipeline);
+        lib->cam.pipeline = NULL;
+    }
+
+    if (lib->streaming)
+        closed |= StopCapture(&lib->cam);
+    closed |= DeInitCamera(&lib->cam);
+    closed |= CloseCamera(&lib->cam);
+    PiCam_DeInitContext(&lib->cam);
+    Save_DeInit(&lib->save);
+    free(lib);
+
+    return closed;
+
+}/* End of function PiCamLib_Close */
+
+/** The size is known once the camera is initialized.
+ */
+void PiCamLib_GetSize(const PiCamLib* lib, int* width, int* height)
+{
+    *width = (int)lib->cam.width;
+    *height = (int)lib->cam.height;
+
+}/* End of function PiCamLib_GetSize */
+
+/** Outputs are sized for the frames the device delivers. The encoder pool passes images on to
+ * the output sink in capture order.
+ */
+PiCamLib_Status PiCamLib_SetOutputs(PiCamLib* lib, const PiCamLib_Outputs* outputs)
+{
+    Std_ReturnType validate = E_OK;
+    Sink_SubmitFunc submit = NULL;
+    Sink_SubmitFunc forward = NULL;
+    Save_Context* save;
+    PiCam_Context* cam;
+
+    validate += ValidateParam(lib);
+    validate += ValidateParam((void*)outputs);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateValue((int)outputs->policy, PICAMLIB_QUEUE_BLOCK, PICAMLIB_QUEUE_DROP_OLDEST);
+        validate += ValidateValue(outputs->sync_batch, 0, SINK_MAX_SYNC_BATCH);
+        validate += (NULL == lib->cam.pipeline) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    save = &lib->save;
+    cam = &lib->cam;
+
+    if (E_OK != PiCamLib_CloseOutputs(lib) || E_OK != PiCamLib_CheckOutputs(lib, outputs))
+        return E_NOT_OK;
+
+    /* Uncompressed frames bypass the JPEG encoder */
+    if (NULL != outputs->raw)
+    {
+        RawSink_Config raw_config = { outputs->raw, (Raw_Format)outputs->raw_format, cam->width, cam->height, (cam->fps > 0) ? cam->fps : 0 };
+        if (E_OK != RawSink_Open(&lib->raw_sink, &raw_config))
+            return PiCamLib_FailOutputs(lib, "RawSink_Open");
+        lib->raw = &lib->raw_sink;
+        Save_SetRawOutput(save, RawSink_Submit, NULL, lib->raw);
+    }
+
+    /* Other processes map the frames instead of opening the camera themselves */
+    if (NULL != outputs->shm)
+    {
+        FrameRing_Config ring_config = { outputs->shm, 8, cam->width, cam->height, FRAMERING_LEASE_MS };
+        if (E_OK != FrameRing_Open(&lib->ring_sink, &ring_config))
+            return PiCamLib_FailOutputs(lib, "FrameRing_Open");
+        lib->ring = &lib->ring_sink;
+        Save_SetRawOutput(save, FrameRing_Submit, FrameRing_Claim, lib->ring);
+    }
+
+    /* Recordings are appended by a single writer thread, which keeps the frames in order */
+    if (NULL != outputs->avi)
+    {
+        /* Frame rate is measured, the driver may not honor the requested interval */
+        AviWriter_Config avi_config = { outputs->avi, cam->width, cam->height, 0, 0, 0 };
+        if (E_OK != AviWriter_Open(&lib->avi, &avi_config))
+            return PiCamLib_FailOutputs(lib, "AviWriter_Open");
+        forward = AviWriter_Submit;
+        lib->recording = &lib->avi;
+    }
+    else if (NULL != outputs->log)
+    {
+        FrameLog_Config log_config = { outputs->log, 256u << 20, 600, 65536 };
+        if (E_OK != FrameLog_Open(&lib->log, &log_config))
+            return PiCamLib_FailOutputs(lib, "FrameLog_Open");
+        forward = FrameLog_Submit;
+        lib->recording = &lib->log;
+    }
+
+    /* Start writer threads so storage latency does not stall capture */
+    if (NULL != lib->recording || (outputs->writers > 0 && !outputs->uring))
+    {
+        OutputSink_Config sink_config = { (NULL != lib->recording) ? 1 : outputs->writers, 16, (Queue_Policy)outputs->policy,
+            outputs->sync_batch, forward, lib->recording };
+        if (E_OK != OutputSink_Init(&lib->writers, &sink_config))
+            return PiCamLib_FailOutputs(lib, "OutputSink_Init");
+        submit = OutputSink_Submit;
+        lib->sink = &lib->writers;
+    }
+    else if (outputs->uring)
+    {
+        UringSink_Config uring_config = { 16, 64, (Queue_Policy)outputs->policy, 0, NULL, 0 };
+        if (E_OK != UringSink_Init(&lib->uring, &uring_config))
+            return PiCamLib_FailOutputs(lib, "UringSink_Init");
+        submit = UringSink_Submit;
+        lib->sink = &lib->uring;
+    }
+
+    Save_SetOutput(save, submit, lib->sink);
+
+    lib->preview.scales = outputs->scales;
+    lib->preview.thumbnail = outputs->thumbnail;
+    lib->preview.quality = PREVIEW_QUALITY;
+    Save_SetPreview(save, &lib->preview);
+
+    /* Quality follows the output rate and encode time, the configured quality is the highest */
+    if (outputs->bitrate > 0 || outputs->budget > 0)
+    {
+        RateControl_Config rate_config = { (uint32_t)outputs->bitrate * 1000, (cam->fps > 0) ? cam->fps : 0,
+            (uint32_t)(outputs->budget * 1000), (save->quality < RATE_MIN_QUALITY) ? save->quality : RATE_MIN_QUALITY, save->quality };
+        if (E_OK != RateControl_Init(&lib->rate_control, &rate_config))
+            return PiCamLib_FailOutputs(lib, "RateControl_Init");
+        lib->rate = &lib->rate_control;
+        Save_SetRateControl(save, lib->rate);
+    }
+
+    /* Encode frames in parallel, the pool passes them on to the output in capture order */
+    if (outputs->jobs > 0)
+    {
+        EncoderPool_Config pool_config = { outputs->jobs, 2 * outputs->jobs, save->quality, outputs->jobs, submit, lib->sink,
+            lib->rate, lib->preview };
+        if (E_OK != EncoderPool_Init(&lib->pool_threads, &pool_config))
+            return PiCamLib_FailOutputs(lib, "EncoderPool_Init");
+        lib->pool = &lib->pool_threads;
+        Save_SetEncoderPool(save, lib->pool);
+    }
+
+    return E_OK;
+
+}/* End of function PiCamLib_SetOutputs */
+
+/** Stage threads are started by PiCamLib_Record, so frames in flight are processed when a
+ * recording ends.
+ */
+PiCamLib_Status PiCamLib_SetPipeline(PiCamLib* lib, const PiCamLib_Pipeline* pipeline)
+{
+    Std_ReturnType validate = E_OK;
+    PiCam_Context* cam;
+
+    validate += ValidateParam(lib);
+    validate += ValidateParam((void*)pipeline);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateParam((void*)pipeline->spec);
+        if (0 != pipeline->depth)
+            validate += ValidateValue(pipeline->depth, 2, PIPELINE_MAX_DEPTH);
+        validate += (NULL == lib->cam.pipeline) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    cam = &lib->cam;
+
+    /* The pipeline ends in the encoded images, uncompressed outputs take the frames before it */
+    if (NULL != lib->raw || NULL != lib->ring)
+    {
+        fprintf(stderr, "Processing pipelines cannot be combined with uncompressed outputs\n");
+        return E_NOT_OK;
+    }
+
+    /* Deadlines are counted in frame intervals of the requested rate */
+    if (pipeline->deadline > 0 && cam->fps <= 0)
+    {
+        fprintf(stderr, "Deadlines require a frame interval\n");
+        return E_NOT_OK;
+    }
+
+    /* Stages are sized for the frames the device delivers */
+    if (E_OK != Pipeline_Parse(&lib->pipeline, pipeline->spec) ||
+        E_OK != Pipeline_Compile(&lib->pipeline, (int)cam->width, (int)cam->height, &lib->save))
+    {
+        Pipeline_Free(&lib->pipeline);
+        return E_NOT_OK;
+    }
+
+    /* Without a frame interval the budget is undefined, frames are processed completely */
+    if (pipeline->deadline > 0 && cam->fps > 0)
+        Pipeline_SetDeadline(&lib->pipeline, (int64_t)(pipeline->deadline * 1000000 / cam->fps), (Deadline_Policy)pipeline->deadline_policy);
+    lib->depth = pipeline->depth;
+    lib->policy = (Queue_Policy)pipeline->policy;
+    cam->pipeline = &lib->pipeline;
+
+    return E_OK;
+
+}/* End of function PiCamLib_SetPipeline */
+
+/** Nothing is printed without a pipeline.
+ */
+void PiCamLib_PrintPipeline(const PiCamLib* lib, FILE* fp)
+{
+    if (NULL != lib->cam.pipeline)
+        Pipeline_Print(lib->cam.pipeline, fp);
+
+}/* End of function PiCamLib_PrintPipeline */
+
+/** A single image is saved after streaming stopped, continuous recordings saved every frame
+ * already.
+ */
+PiCamLib_Status PiCamLib_Record(PiCamLib* lib, const char* filename, int continuous)
+{
+    Std_ReturnType validate = E_OK;
+    Std_ReturnType recorded;
+    PiCam_Context* cam;
+    Save_Context* save;
+
+    validate += ValidateParam(lib);
+    validate += ValidateParam((void*)filename);
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    cam = &lib->cam;
+    save = &lib->save;
+    cam->filename = (char*)filename;
+    __atomic_store_n(&cam->continuous, continuous ? 1 : 0, __ATOMIC_RELAXED);
+
+    if (E_OK != CheckContinuousFlag(cam))
+        return E_NOT_OK;
+
+    if (NULL != cam->pipeline && lib->depth > 0 && E_OK != Pipeline_Start(cam->pipeline, save, lib->depth, lib->policy))
+        return E_NOT_OK;
+
+    recorded = PiCamLib_Stream(lib);
+    if (E_OK == recorded)
+        recorded = CaptureFrame(cam);
+    if (E_OK == recorded)
+    {
+        lib->streaming = 0;
+        recorded = StopCapture(cam);
+    }
+    PiCam_Stop(cam);
+
+    if (E_OK == recorded && !continuous)
+    {
+        lib->captured = 1;
+        Save_SetCaptureTime(save, (int64_t)cam->image.timestamp.tv_sec * 1000000 + cam->image.timestamp.tv_usec);
+        cam->handed = writerawimageYUV420(save, cam->width, cam->height, cam->image.start, cam->filename);
+        if (!cam->handed && NULL != cam->pipeline)
+            cam->handed = Pipeline_Submit(cam->pipeline, save, cam->image.start, cam->filename, 0);
+        else if (!cam->handed)
+            recorded = writeimageYUV420(save, cam->width, cam->height, cam->image.start, cam->filename);
+    }
+
+    /* Process frames in flight, so the statistics cover every frame */
+    if (NULL != cam->pipeline)
+        Pipeline_Stop(cam->pipeline);
+
+    return recorded;
+
+}/* End of function PiCamLib_Record */
+
+/** The camera keeps streaming, images are sent to clients instead of files.
+ */
+PiCamLib_Status PiCamLib_Serve(PiCamLib* lib, const char* path)
+{
+    Std_ReturnType validate = E_OK;
+    Std_ReturnType served;
+
+    validate += ValidateParam(lib);
+    validate += ValidateParam((void*)path);
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    if (E_OK != CaptureServer_Open(&lib->server, &lib->cam, path))
+        return errno_print("CaptureServer_Open");
+    lib->serving = 1;
+
+    served = PiCamLib_Stream(lib);
+    if (E_OK == served)
+        served = CaptureServer_Run(&lib->server);
+    CaptureServer_Close(&lib->server);
+
+    return served;
+
+}/* End of function PiCamLib_Serve */
+
+/** Only clears flags, which is safe in signal handlers.
+ */
+void PiCamLib_Stop(PiCamLib* lib)
+{
+    if (NULL == lib)
+        return;
+
+    PiCam_Stop(&lib->cam);
+    CaptureServer_Stop(&lib->server);
+
+}/* End of function PiCamLib_Stop */
+
+/** Stage statistics can be printed while stage threads run.
+ */
+void PiCamLib_PrintStats(const PiCamLib* lib, FILE* fp)
+{
+    if (lib->serving)
+        fprintf(fp, "Served %" PRIu32 " images\n", lib->server.served);
+    if (lib->cam.latest)
+        fprintf(fp, "Skipped %lu stale frames\n", lib->cam.stale);
+    if (NULL != lib->cam.pipeline)
+        Pipeline_PrintStats(lib->cam.pipeline, fp);
+
+}/* End of function PiCamLib_PrintStats */
+
+/** The image describes the latest image of the capture context without copying it.
+ */
+PiCamLib_Status PiCamLib_Capture(PiCamLib* lib, PiCamLib_Image* image, int timeout_ms)
+{
+    Std_ReturnType validate = E_OK;
+
+    validate += ValidateParam(lib);
+    validate += ValidateParam(image);
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    if (E_OK != PiCamLib_Stream(lib) || E_OK != GrabFrame(&lib->cam, timeout_ms))
+        return E_NOT_OK;
+
+    lib->captured = 1;
+    Image_SetPlanar((Image_Planar*)image, PIXFMT_YUV420, (int)lib->cam.width, (int)lib->cam.height, lib->cam.image.start);
+
+    return E_OK;
+
+}/* End of function PiCamLib_Capture */
+
+/** Uses the encoder of the save context, which the write functions share.
+ */
+PiCamLib_Status PiCamLib_EncodeJpeg(PiCamLib* lib, const PiCamLib_Image* image, unsigned char** data, size_t* length)
+{
+    Std_ReturnType validate = E_OK;
+    Save_Context* save;
+
+    validate += ValidateParam(lib);
+    validate += ValidateParam((void*)image);
+    validate += ValidateParam(data);
+    validate += ValidateParam(length);
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    save = &lib->save;
+    if (!save->encoder_ready)
+    {
+        if (E_OK != JpegEncoder_Init(&save->encoder, save->quality))
+            return E_NOT_OK;
+        save->encoder_ready = 1;
+    }
+
+    JpegEncoder_SetQuality(&save->encoder, save->quality);
+
+    if (E_OK != JpegEncoder_Encode(&save->encoder, (const Image_Planar*)image))
+        return E_NOT_OK;
+
+    *data = JpegEncoder_Detach(&save->encoder, length);
+
+    return (NULL != *data) ? E_OK : E_NOT_OK;
+
+}/* End of function PiCamLib_EncodeJpeg */
+
+/** The write functions do not modify the filename.
+ */
+PiCamLib_Status PiCamLib_Save(PiCamLib* lib, const char* filename)
+{
+    Std_ReturnType validate = E_OK;
+
+    validate += ValidateParam(lib);
+    validate += ValidateParam((void*)filename);
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    if (!lib->captured)
+        return E_NOT_OK;
+
+    Save_SetCaptureTime(&lib->save, (int64_t)lib->cam.image.timestamp.tv_sec * 1000000 + lib->cam.image.timestamp.tv_usec);
+    return writeimageYUV420(&lib->save, (int)lib->cam.width, (int)lib->cam.height, lib->cam.image.start, (char*)filename);
+
+}/* End of function PiCamLib_Save */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
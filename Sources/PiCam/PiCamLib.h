@@ -0,0 +1,496 @@
+/**
+ * @file PiCamLib.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for the libpicam interface to capture, encode and save images from
+ *          other programs </b>
+ * @version
+ * @date 2026-10-18 Initial template for the library interface
+ * @date 2026-10-19 Add outputs, pipelines, recording and serving, self-contained header
+ * @date 2026-10-19 Add the overflow policy and fdatasync batch of the writer threads
+ * @date 2026-10-19 Export only the interface and name its status type after the library
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef PICAMLIB_H
+#define  PICAMLIB_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stddef.h>
+#include <stdio.h>
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Major version of the library interface, changes break existing programs */
+#define PICAMLIB_VERSION_MAJOR  (2)
+
+/** Minor version of the library interface, changes only add functions */
+#define PICAMLIB_VERSION_MINOR  (0)
+
+/** Version of the library interface as string */
+#define PICAMLIB_VERSION        "2.0"
+
+/** Fewest capture buffers, one filled by the driver while one is read */
+#define PICAMLIB_BUFFERS_MIN    (2)
+
+/** Most capture buffers */
+#define PICAMLIB_BUFFERS_MAX    (32)
+
+/** Status of a library function which completed as expected */
+#define PICAMLIB_OK             (0)
+
+/** Status of a library function which failed */
+#define PICAMLIB_ERROR          (1)
+
+/** Marks the functions of the library interface, the shared library exports nothing else */
+#if defined(__GNUC__)
+#define PICAMLIB_API            __attribute__((visibility("default")))
+#else
+#define PICAMLIB_API
+#endif
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Status returned by library functions, PICAMLIB_OK or PICAMLIB_ERROR */
+typedef int PiCamLib_Status;
+
+/** Pixel formats of images */
+typedef enum
+{
+    /** Planar Y, U and V with 2x2 subsampled chroma (I420) */
+    PICAMLIB_YUV420,
+    /** Planar Y and interleaved UV with 2x2 subsampled chroma */
+    PICAMLIB_NV12,
+    /** Packed Y0 U Y1 V with horizontally subsampled chroma */
+    PICAMLIB_YUYV,
+    /** Single luminance plane */
+    PICAMLIB_GRAY,
+    /** Packed R G B, 3 bytes per pixel */
+    PICAMLIB_RGB24,
+    /** Packed B G R, 3 bytes per pixel */
+    PICAMLIB_BGR24,
+    /** Packed R G B A, 4 bytes per pixel */
+    PICAMLIB_RGBA,
+    /** Packed Y U V without subsampling, 3 bytes per pixel */
+    PICAMLIB_YUV444
+} PiCamLib_PixelFormat;
+
+/** Image with up to three planes */
+typedef struct
+{
+    /** Pixel format of the image */
+    PiCamLib_PixelFormat format;
+    /** Width of the image */
+    int width;
+    /** Height of the image */
+    int height;
+    /** Pointers to the starting pixel position of each plane, unused planes are NULL */
+    unsigned char* plane[3];
+    /** Number of bytes between starting positions of two consecutive rows of each plane */
+    int stride[3];
+} PiCamLib_Image;
+
+/** File formats of saved images */
+typedef enum
+{
+    /** JPEG image */
+    PICAMLIB_JPEG,
+    /** Lossless QOI image of RGB pixels */
+    PICAMLIB_QOI,
+    /** Binary PGM image of the luminance plane */
+    PICAMLIB_PGM,
+    /** Binary PPM image of RGB pixels */
+    PICAMLIB_PPM
+} PiCamLib_FileFormat;
+
+/** Layouts of uncompressed frames */
+typedef enum
+{
+    /** YUV4MPEG2 stream with a header and a line before every frame */
+    PICAMLIB_RAW_Y4M,
+    /** Planar I420 frames without headers */
+    PICAMLIB_RAW_I420,
+    /** NV12 frames without headers */
+    PICAMLIB_RAW_NV12
+} PiCamLib_RawFormat;
+
+/** Actions when a frame is captured while all pipeline frames are in flight, or an image is
+ *  saved while the queue of the writer threads is full */
+typedef enum
+{
+    /** Wait until the first stage takes a frame */
+    PICAMLIB_QUEUE_BLOCK,
+    /** Drop the captured frame */
+    PICAMLIB_QUEUE_DROP_NEWEST,
+    /** Drop the oldest frame no stage started */
+    PICAMLIB_QUEUE_DROP_OLDEST
+} PiCamLib_QueuePolicy;
+
+/** Actions when pipeline frames fall behind their deadline */
+typedef enum
+{
+    /** Drop late frames */
+    PICAMLIB_DEADLINE_DROP,
+    /** Run cheaper stages and skip optional stages for late frames */
+    PICAMLIB_DEADLINE_DEGRADE
+} PiCamLib_DeadlinePolicy;
+
+/** Settings of a camera opened with the library */
+typedef struct
+{
+    /** Camera name in linux */
+    const char* device;
+    /** Requested image width, the device may change it */
+    unsigned int width;
+    /** Requested image height, the device may change it */
+    unsigned int height;
+    /** Frames per second, -1 to keep the setting of the device */
+    int fps;
+    /** Image quality for JPEG compression (1 to 100) */
+    int quality;
+    /** File format of saved images */
+    PiCamLib_FileFormat format;
+    /** Number of capture buffers (PICAMLIB_BUFFERS_MIN to PICAMLIB_BUFFERS_MAX), 0 for the
+     *  default of the library */
+    unsigned int buffers;
+    /** 1 to read only the newest frame, frames which waited in the driver queue are skipped */
+    int latest;
+} PiCamLib_Config;
+
+/** Outputs of saved images. Without a file output images are written as individual files on
+ *  the capturing thread.
+ */
+typedef struct
+{
+    /** Number of writer threads (0 to 4), 0 writes images on the capturing thread */
+    int writers;
+    /** 1 to write images with io_uring */
+    int uring;
+    /** Path prefix of frame log segments written by a writer thread, NULL to not record a
+     *  frame log */
+    const char* log;
+    /** Filename of an MJPEG AVI recording written by a writer thread, NULL to not record an
+     *  AVI file */
+    const char* avi;
+    /** Action when an image is saved while the queue of the writer threads is full */
+    PiCamLib_QueuePolicy policy;
+    /** Number of images written by a writer thread before they are synchronized with
+     *  fdatasync (0 to 64), 0 leaves writeback to the kernel */
+    int sync_batch;
+    /** Path of a file or FIFO receiving uncompressed frames, "-" for standard output, NULL to
+     *  encode frames */
+    const char* raw;
+    /** Layout of uncompressed frames */
+    PiCamLib_RawFormat raw_format;
+    /** Path of the socket handing out a shared memory ring of frames, NULL to not publish
+     *  frames */
+    const char* shm;
+    /** Number of JPEG encoder threads (0 to 8), 0 encodes on the capturing thread */
+    int jobs;
+    /** Data rate of saved images in kilobytes per second the JPEG quality is adapted to, 0 for
+     *  fixed quality */
+    int bitrate;
+    /** Encode time per image in milliseconds the JPEG quality is adapted to, 0 for no limit */
+    float budget;
+    /** Bit mask of downscaled JPEG images saved next to each image, bit n for 1/2^(n+1) size */
+    int scales;
+    /** 1 to embed a thumbnail into the EXIF segment of JPEG images */
+    int thumbnail;
+} PiCamLib_Outputs;
+
+/** Processing pipeline of saved images */
+typedef struct
+{
+    /** Declaration of the stages, @ followed by a filename reads it from a file */
+    const char* spec;
+    /** Number of frames in flight between stage threads (2 to 16), 0 runs stages on the
+     *  capturing thread */
+    int depth;
+    /** Action when a frame is captured while all frames are in flight */
+    PiCamLib_QueuePolicy policy;
+    /** Latency bound of frames in frame intervals after capture, 0 to process every frame
+     *  completely */
+    float deadline;
+    /** Action when frames fall behind their deadline */
+    PiCamLib_DeadlinePolicy deadline_policy;
+} PiCamLib_Pipeline;
+
+/** Diagnostics of all cameras of the process */
+typedef struct
+{
+    /** File of stage timing histograms in Prometheus text format, NULL to not time stages */
+    const char* metrics;
+    /** Seconds between exports of the histograms, 0 to export on SIGUSR1 and at stop only */
+    int metrics_period_s;
+    /** File of stage traces in Chrome trace format, NULL to not trace */
+    const char* trace;
+    /** Number of events kept per thread, written on SIGUSR2 and at stop */
+    int trace_events;
+} PiCamLib_Diagnostics;
+
+/** Opened camera with its capture and save contexts. The layout is private to the library,
+ *  so programs only hold a pointer and keep working with later library versions.
+ */
+typedef struct PiCamLib PiCamLib;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Returns the version of the library the program runs with.
+ *
+ * @return const char*  Version of the library as "major.minor"
+ *
+ */
+PICAMLIB_API const char* PiCamLib_Version(void);
+
+/**
+ * @brief   Fills a configuration with the default settings of the application, /dev/video0
+ *          capturing 640x480 images at 30 frames per second saved as JPEG.
+ *
+ * @param[out] config   Configuration
+ *
+ */
+PICAMLIB_API void PiCamLib_DefaultConfig(PiCamLib_Config* config);
+
+/**
+ * @brief   Fills outputs with the defaults, images written as individual files on the
+ *          capturing thread. Writer threads drop the oldest image when their queue is full.
+ *
+ * @param[out] outputs  Outputs
+ *
+ */
+PICAMLIB_API void PiCamLib_DefaultOutputs(PiCamLib_Outputs* outputs);
+
+/**
+ * @brief   Fills a pipeline with the defaults, no stages run on the capturing thread and late
+ *          frames are degraded.
+ *
+ * @param[out] pipeline Pipeline
+ *
+ */
+PICAMLIB_API void PiCamLib_DefaultPipeline(PiCamLib_Pipeline* pipeline);
+
+/**
+ * @brief   Fills diagnostics with the defaults, neither timing nor tracing.
+ *
+ * @param[out] diagnostics  Diagnostics
+ *
+ */
+PICAMLIB_API void PiCamLib_DefaultDiagnostics(PiCamLib_Diagnostics* diagnostics);
+
+/**
+ * @brief   Starts timing and tracing of all cameras of the process. Timing installs a SIGUSR1
+ *          handler and tracing a SIGUSR2 handler.
+ *
+ * @param[in] diagnostics   Diagnostics to start, files which are NULL are left out
+ *
+ * @return PiCamLib_Status  Operation Status
+ * @retval PICAMLIB_OK      Operation successful
+ * @retval PICAMLIB_ERROR   Operation unsuccessful, nothing was started
+ *
+ */
+PICAMLIB_API PiCamLib_Status PiCamLib_StartDiagnostics(const PiCamLib_Diagnostics* diagnostics);
+
+/**
+ * @brief   Stops timing and tracing and writes the final files.
+ *
+ */
+PICAMLIB_API void PiCamLib_StopDiagnostics(void);
+
+/**
+ * @brief   Opens and initializes a camera. Streaming starts with the first capture, recording
+ *          or serving.
+ *
+ * @param[in] config    Settings of the camera
+ *
+ * @return PiCamLib*    Opened camera, NULL if the settings are invalid or the device could
+ *                      not be opened
+ *
+ */
+PICAMLIB_API PiCamLib* PiCamLib_Open(const PiCamLib_Config* config);
+
+/**
+ * @brief   Processes frames in flight, writes pending images, closes the outputs and the
+ *          camera and releases all resources of the handle.
+ *
+ * @param[in] lib       Opened camera, NULL is ignored
+ *
+ * @return PiCamLib_Status  Operation Status
+ * @retval PICAMLIB_OK      Operation successful
+ * @retval PICAMLIB_ERROR   An output or the device reported an error, the error is printed
+ *
+ */
+PICAMLIB_API PiCamLib_Status PiCamLib_Close(PiCamLib* lib);
+
+/**
+ * @brief   Returns the capture size chosen by the device.
+ *
+ * @param[in] lib       Opened camera
+ * @param[out] width    Image width
+ * @param[out] height   Image height
+ *
+ */
+PICAMLIB_API void PiCamLib_GetSize(const PiCamLib* lib, int* width, int* height);
+
+/**
+ * @brief   Opens the outputs of saved images, replacing outputs opened before. Must be called
+ *          before a pipeline is set.
+ *
+ * @param[inout] lib    Opened camera
+ * @param[in] outputs   Outputs to open
+ *
+ * @return PiCamLib_Status  Operation Status
+ * @retval PICAMLIB_OK      Operation successful
+ * @retval PICAMLIB_ERROR   Invalid combination or an output could not be opened, the error is
+ *                          printed and images are written as individual files
+ *
+ */
+PICAMLIB_API PiCamLib_Status PiCamLib_SetOutputs(PiCamLib* lib, const PiCamLib_Outputs* outputs);
+
+/**
+ * @brief   Parses and compiles a processing pipeline for the capture size, recorded frames
+ *          run through it before they are saved.
+ *
+ * @param[inout] lib        Opened camera
+ * @param[in] pipeline      Pipeline to build
+ *
+ * @return PiCamLib_Status  Operation Status
+ * @retval PICAMLIB_OK      Operation successful
+ * @retval PICAMLIB_ERROR   Invalid pipeline or it cannot be combined with the outputs, the
+ *                          error is printed
+ *
+ */
+PICAMLIB_API PiCamLib_Status PiCamLib_SetPipeline(PiCamLib* lib, const PiCamLib_Pipeline* pipeline);
+
+/**
+ * @brief   Prints the compiled stages of the pipeline with their output formats and sizes.
+ *
+ * @param[in] lib       Opened camera
+ * @param[in] fp        File pointer
+ *
+ */
+PICAMLIB_API void PiCamLib_PrintPipeline(const PiCamLib* lib, FILE* fp);
+
+/**
+ * @brief   Streams and saves frames through the pipeline and outputs. A single recording saves
+ *          the last of a few frames under the filename, a continuous recording saves every
+ *          frame with frame number and capture time appended until PiCamLib_Stop is called.
+ *          Frames in flight between stage threads are processed before it returns.
+ *
+ * @param[inout] lib        Opened camera
+ * @param[in] filename      Filename, or prefix of the frames of a continuous recording
+ * @param[in] continuous    1 to record until stopped, 0 for a single image
+ *
+ * @return PiCamLib_Status  Operation Status
+ * @retval PICAMLIB_OK      Operation successful
+ * @retval PICAMLIB_ERROR   Error of the device or of saving a frame, the error is printed
+ *
+ */
+PICAMLIB_API PiCamLib_Status PiCamLib_Record(PiCamLib* lib, const char* filename, int continuous);
+
+/**
+ * @brief   Serves capture requests on a Unix domain socket until PiCamLib_Stop is called. The
+ *          requests are answered with frames of the camera, outputs and pipeline are unused.
+ *
+ * @param[inout] lib    Opened camera
+ * @param[in] path      Path of the socket
+ *
+ * @return PiCamLib_Status  Operation Status
+ * @retval PICAMLIB_OK      Operation successful
+ * @retval PICAMLIB_ERROR   Socket could not be opened or error of the device, the error is
+ *                          printed
+ *
+ */
+PICAMLIB_API PiCamLib_Status PiCamLib_Serve(PiCamLib* lib, const char* path);
+
+/**
+ * @brief   Ends a continuous recording after the frame in progress and serving within a
+ *          second. Can be called from signal handlers and other threads.
+ *
+ * @param[inout] lib    Opened camera
+ *
+ */
+PICAMLIB_API void PiCamLib_Stop(PiCamLib* lib);
+
+/**
+ * @brief   Prints the served images, skipped stale frames and the stage statistics of the
+ *          pipeline.
+ *
+ * @param[in] lib       Opened camera
+ * @param[in] fp        File pointer
+ *
+ */
+PICAMLIB_API void PiCamLib_PrintStats(const PiCamLib* lib, FILE* fp);
+
+/**
+ * @brief   Captures the next YUV420 frame. The image refers to memory of the handle which
+ *          stays valid until the next capture or until the camera is closed.
+ *
+ * @param[inout] lib        Opened camera
+ * @param[out] image        Captured image
+ * @param[in] timeout_ms    Maximum time to wait in milliseconds, negative to wait forever
+ *
+ * @return PiCamLib_Status  Operation Status
+ * @retval PICAMLIB_OK      Operation successful
+ * @retval PICAMLIB_ERROR   Timeout, error of the device or invalid parameters
+ *
+ */
+PICAMLIB_API PiCamLib_Status PiCamLib_Capture(PiCamLib* lib, PiCamLib_Image* image, int timeout_ms);
+
+/**
+ * @brief   Encodes an image as JPEG with the configured quality. The encoder of the handle is
+ *          kept across calls. Formats are YUV420, NV12, YUYV, GRAY, RGB24, BGR24, RGBA and
+ *          YUV444.
+ *
+ * @param[inout] lib    Opened camera
+ * @param[in] image     Image to encode
+ * @param[out] data     Encoded image, to be released with free
+ * @param[out] length   Size of the encoded image in bytes
+ *
+ * @return PiCamLib_Status  Operation Status
+ * @retval PICAMLIB_OK      Operation successful
+ * @retval PICAMLIB_ERROR   Operation unsuccessful
+ *
+ */
+PICAMLIB_API PiCamLib_Status PiCamLib_EncodeJpeg(PiCamLib* lib, const PiCamLib_Image* image, unsigned char** data, size_t* length);
+
+/**
+ * @brief   Saves the last captured frame in the configured file format through the outputs.
+ *
+ * @param[inout] lib    Opened camera
+ * @param[in] filename  Filename for image to save
+ *
+ * @return PiCamLib_Status  Operation Status
+ * @retval PICAMLIB_OK      Operation successful
+ * @retval PICAMLIB_ERROR   No frame was captured, invalid parameters or writing failed
+ *
+ */
+PICAMLIB_API PiCamLib_Status PiCamLib_Save(PiCamLib* lib, const char* filename);
+
+/** @} */
+
+#endif /** PICAMLIB_H **/
+
+/*==============================[  End of File  ]======================================*/
@@ -7,6 +7,8 @@
  * @date 2033-03-23 Updates for Gaussian filter and Edge detection
  * @date 2022-03-24 Updates for convolution methods
  * @date 2022-03-27 Updates for mean and median filtering
+ * @date 2026-10-18 Sort median windows without reading past their end
+ * @date 2026-10-19 Time filters for the stage histograms
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -24,6 +26,7 @@
 #include <math.h>
 #include <string.h>
 #include "Convolutions.h"
+#include "Metrics.h"
 
 /*===========================[ Global Variables  ]========================================*/
 
@@ -233,7 +236,7 @@ static inline Std_ReturnType Get_MedianM3(Mat3 pixel)
 	/** Sort pixel values in ascending order */
 	for (i = 0; i < 9; i ++)
 	{
-		for (j = 0; j <= i; j++)
+		for (j = 0; j < 8 - i; j++)
 		{
 			if (ip_array[j] < ip_array[j+1])
 			{
@@ -270,7 +273,7 @@ static inline Std_ReturnType Get_MedianM5(Mat5 pixel)
 	/** Sort pixel values in ascending order */
 	for (i = 0; i < 25; i ++)
 	{
-		for (j = 0; j <= i; j++)
+		for (j = 0; j < 24 - i; j++)
 		{
 			if (ip_array[j] < ip_array[j+1])
 			{
@@ -307,6 +310,7 @@ void GaussianFilter(int width, int height, unsigned char* src, unsigned char* ds
 		int x, y;
 		unsigned char pixel;
 		Mat3 mat_pixel;
+		int64_t start = Metrics_Begin();
 		
 		/* TODO: Replace with function call to copy border pixels of width 1 */
 		memcpy(dst, src, width*height);
@@ -321,6 +325,7 @@ void GaussianFilter(int width, int height, unsigned char* src, unsigned char* ds
 				*(dst + x*width + y) = pixel;
 			}
 		}
+		Metrics_End(METRIC_GAUSSIAN, start);
 	}
 	else
 	{
@@ -343,6 +348,7 @@ void Edge_Detector(int width, int height, unsigned char* src, unsigned char* dst
 	if (E_OK == validate)
 	{
 		int x, y;
+		int64_t start = Metrics_Begin();
 		/* TODO: Replace with function call to copy border pixels of width 1 */
 		memcpy(dst, src, width*height);
 
@@ -356,6 +362,7 @@ void Edge_Detector(int width, int height, unsigned char* src, unsigned char* dst
 				Populate_Edges(retval, method, width, y, x, dst);
 			}
 		}
+		Metrics_End(METRIC_EDGE, start);
 	}
 	else
 	{
@@ -379,6 +386,7 @@ void MeanFilter(int width, int height, unsigned char* src, unsigned char* dst)
 	{
 		int x, y, ret_m3;
 		Mat3 mat3_pixel; 				
+		int64_t start = Metrics_Begin();
 		/* TODO: Replace with function call to copy border pixels of width 1 */
 		memcpy(dst, src, width*height);
 		
@@ -391,6 +399,7 @@ void MeanFilter(int width, int height, unsigned char* src, unsigned char* dst)
 				*(dst + x*width + y) = LIMITCHAR(ret_m3/9);
 			}
 		}	
+		Metrics_End(METRIC_MEAN, start);
 	}
 	else
 	{
@@ -415,6 +424,7 @@ void MedianFilter(int width, int height, unsigned char* src, unsigned char* dst,
 		int x, y, ret_m3, ret_m5;
 		Mat3 mat3_pixel; 
 		Mat5 mat5_pixel; 				
+		int64_t start = Metrics_Begin();
 		/* TODO: Replace with function call to copy border pixels of width 1 */
 		memcpy(dst, src, width*height);
 
@@ -448,6 +458,7 @@ void MedianFilter(int width, int height, unsigned char* src, unsigned char* dst,
 			printf("Please mention matrix size.\n");
 			break;
 		}
+		Metrics_End(METRIC_MEDIAN, start);
 	}
 	else
 	{
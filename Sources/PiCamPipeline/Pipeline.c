@@ -0,0 +1,1254 @@
+/**
+ * @file Pipeline.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of processing pipelines declared as a list of stages </b>
+ * @version
+ * @date 2026-10-18 Initial template for declarative processing pipelines
+ * @date 2026-10-18 Run stages on threads of their own connected by bounded queues
+ * @date 2026-10-18 Degrade, skip or drop work of frames which miss their deadline
+ * @date 2026-10-19 Trace stages per frame with their sequence number
+ * @date 2026-10-19 Hand the capture time of frames to the outputs
+ * @date 2026-10-19 Keep private helpers out of the header
+ * @date 2026-10-19 Keep the stage thread entry and frame helpers private
+ * @date 2026-10-19 Keep deadline helpers out of the header
+ * @date 2026-10-19 Worker threads block the signals of the application
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "Pipeline.h"
+#include "ColorConversion.h"
+#include "YUVtoRGB.h"
+#include "RateControl.h"
+#include "Trace.h"
+
+/*============================[  Global Variables  ]====================================*/
+
+/** \addtogroup global_variables
+ *  @{
+ */
+
+/** Names of the stage types as declared */
+static const char* const Pipeline_StageNames[] =
+{
+    "convert", "blur", "mean", "median", "edge", "rotate", "resize", "encode", "sink"
+};
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to name a pixel format as in convert stages.
+ *
+ * @param[in] format    Pixel format
+ *
+ * @return const char*  Name of the format
+ *
+ */
+static inline const char* Pipeline_FormatName(Image_Format format);
+
+/**
+ * @brief   Helper function to parse a single stage such as blur, median=5 or resize=320x240.
+ *
+ * @param[out] stage    Parsed stage
+ * @param[in] token     Stage declaration, modified while parsing
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Unknown stage or invalid argument
+ *
+ */
+static inline Std_ReturnType Pipeline_ParseStage(Pipeline_Stage* stage, char* token);
+
+/**
+ * @brief   Helper function to remove conversions which do not change the result. A conversion
+ *          followed by another one, to the current format, or in front of JPEG encoding, which
+ *          reads YUV420 directly, is removed.
+ *
+ * @param[inout] pipeline   Parsed pipeline
+ * @param[in] jpeg          Set if the sink writes JPEG images
+ *
+ */
+static inline void Pipeline_Elide(Pipeline* pipeline, int jpeg);
+
+/**
+ * @brief   Helper function to resize a plane with bilinear interpolation or nearest neighbour.
+ *
+ * @param[in] src       Source plane
+ * @param[in] sw        Width of the source plane
+ * @param[in] sh        Height of the source plane
+ * @param[out] dst      Destination plane
+ * @param[in] dw        Width of the destination plane
+ * @param[in] dh        Height of the destination plane
+ * @param[in] channels  Number of interleaved channels
+ * @param[in] nearest   1 for nearest neighbour, 0 for bilinear interpolation
+ *
+ */
+static inline void Pipeline_ResizePlane(const unsigned char* src, int sw, int sh, unsigned char* dst, int dw, int dh, int channels, int nearest);
+
+/**
+ * @brief   Helper function to run a single stage on the output of the previous one.
+ *
+ * @param[inout] pipeline   Compiled pipeline
+ * @param[in] index         Index of the stage to run
+ * @param[inout] frame      Frame holding the stage outputs
+ * @param[inout] save       Save context of the sink
+ * @param[in] cheap         1 to run the cheaper variant of the stage
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType Pipeline_Apply(Pipeline* pipeline, int index, Pipeline_Frame* frame, Save_Context* save, int cheap);
+
+/**
+ * @brief   Helper function to allocate the stage outputs of a frame.
+ *
+ * @param[in] pipeline  Compiled pipeline
+ * @param[out] frame    Frame to allocate
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Out of memory
+ *
+ */
+static inline Std_ReturnType Pipeline_AllocFrame(const Pipeline* pipeline, Pipeline_Frame* frame);
+
+/**
+ * @brief   Helper function to release the captured frame and encoded file of a frame and
+ *          return it to the free frames.
+ *
+ * @param[inout] pipeline   Running pipeline
+ * @param[inout] frame      Frame to recycle
+ *
+ */
+static inline void Pipeline_Recycle(Pipeline* pipeline, Pipeline_Frame* frame);
+
+/**
+ * @brief   Thread function running one stage on frames of its queue and passing them to the
+ *          queue of the next stage. The sink recycles frames.
+ *
+ * @param[in] arg   Pointer to Pipeline
+ *
+ * @return void*    NULL
+ *
+ */
+static void* Pipeline_Worker(void* arg);
+
+/**
+ * @brief   Helper function to check if a stage has a cheaper variant.
+ *
+ * @param[in] stage Stage
+ *
+ * @return int  1 if the stage has a cheaper variant, 0 otherwise
+ *
+ */
+static inline int Pipeline_HasCheap(const Pipeline_Stage* stage);
+
+/**
+ * @brief   Helper function to decide how a stage processes a frame. The remaining processing
+ *          time is predicted from the moving averages of the remaining stages.
+ *
+ * @param[in] pipeline  Compiled pipeline
+ * @param[in] index     Index of the stage
+ * @param[in] frame     Frame to process
+ * @param[in] now       Current time in microseconds
+ *
+ * @return Stage_Action Decision of the scheduler
+ *
+ */
+static inline Stage_Action Pipeline_Schedule(const Pipeline* pipeline, int index, const Pipeline_Frame* frame, int64_t now);
+
+/**
+ * @brief   Helper function to lower time estimates of stages which were not run.
+ *
+ * @param[inout] pipeline   Compiled pipeline
+ * @param[in] first         Index of the first stage
+ * @param[in] last          Index of the last stage
+ * @param[in] variant       0 for the full, 1 for the cheaper variant
+ *
+ */
+static inline void Pipeline_Age(Pipeline* pipeline, int first, int last, int variant);
+
+/**
+ * @brief   Helper function to schedule and run a single stage and account its time.
+ *
+ * @param[inout] pipeline   Compiled pipeline
+ * @param[in] index         Index of the stage to run
+ * @param[inout] frame      Frame holding the stage outputs
+ * @param[inout] save       Save context of the sink
+ *
+ * @return int  1 if the frame continues, 0 if it was dropped or the stage failed
+ *
+ */
+static inline int Pipeline_Step(Pipeline* pipeline, int index, Pipeline_Frame* frame, Save_Context* save);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** Names are the arguments of convert stages.
+ */
+static inline const char* Pipeline_FormatName(Image_Format format)
+{
+    switch (format)
+    {
+        case PIXFMT_GRAY:   return "gray";
+        case PIXFMT_YUV420: return "yuv420";
+        case PIXFMT_YUV444: return "yuv444";
+        case PIXFMT_RGB24:  return "rgb";
+        default:            return "?";
+    }
+
+}/* End of function Pipeline_FormatName */
+
+/** Arguments follow the name after =, a resize takes an optional :nearest behind its size. A
+ * trailing ? follows the arguments.
+ */
+static inline Std_ReturnType Pipeline_ParseStage(Pipeline_Stage* stage, char* token)
+{
+    size_t length = strlen(token);
+    char* arg;
+    char* end = NULL;
+
+    memset(stage, 0, sizeof(Pipeline_Stage));
+
+    if (length > 1 && '?' == token[length - 1])
+    {
+        token[length - 1] = '\0';
+        stage->optional = 1;
+    }
+
+    arg = strchr(token, '=');
+    if (NULL != arg)
+        *arg++ = '\0';
+
+    if (0 == strcasecmp(token, "convert"))
+    {
+        stage->type = STAGE_CONVERT;
+        if (NULL == arg)
+            return E_NOT_OK;
+        if (0 == strcasecmp(arg, "gray"))
+            stage->arg = PIXFMT_GRAY;
+        else if (0 == strcasecmp(arg, "yuv420"))
+            stage->arg = PIXFMT_YUV420;
+        else if (0 == strcasecmp(arg, "yuv444"))
+            stage->arg = PIXFMT_YUV444;
+        else if (0 == strcasecmp(arg, "rgb"))
+            stage->arg = PIXFMT_RGB24;
+        else
+            return E_NOT_OK;
+    }
+    else if (0 == strcasecmp(token, "blur"))
+        stage->type = STAGE_BLUR;
+    else if (0 == strcasecmp(token, "mean"))
+        stage->type = STAGE_MEAN;
+    else if (0 == strcasecmp(token, "median"))
+    {
+        stage->type = STAGE_MEDIAN;
+        stage->arg = (NULL == arg) ? 3 : (int)strtol(arg, &end, 10);
+        if ((NULL != end && '\0' != *end) || (3 != stage->arg && 5 != stage->arg))
+            return E_NOT_OK;
+    }
+    else if (0 == strcasecmp(token, "edge"))
+    {
+        stage->type = STAGE_EDGE;
+        if (NULL == arg || 0 == strcasecmp(arg, "sobel"))
+            stage->arg = METHOD_SOBEL;
+        else if (0 == strcasecmp(arg, "canny"))
+            stage->arg = METHOD_CANNY;
+        else
+            return E_NOT_OK;
+    }
+    else if (0 == strcasecmp(token, "rotate"))
+    {
+        stage->type = STAGE_ROTATE;
+        if (NULL == arg)
+            return E_NOT_OK;
+        stage->arg = (int)strtol(arg, &end, 10);
+        if ('\0' != *end)
+            return E_NOT_OK;
+    }
+    else if (0 == strcasecmp(token, "resize"))
+    {
+        stage->type = STAGE_RESIZE;
+        if (NULL == arg)
+            return E_NOT_OK;
+        stage->width = (int)strtol(arg, &end, 10);
+        if ('x' != *end && 'X' != *end)
+            return E_NOT_OK;
+        stage->height = (int)strtol(end + 1, &end, 10);
+        if (0 == strcasecmp(end, ":nearest"))
+            stage->arg = 1;
+        else if ('\0' != *end)
+            return E_NOT_OK;
+        if (stage->width < 2 || stage->height < 2)
+            return E_NOT_OK;
+    }
+    else if (0 == strcasecmp(token, "encode"))
+    {
+        stage->type = STAGE_ENCODE;
+        stage->arg = (NULL == arg) ? 0 : (int)strtol(arg, &end, 10);
+        if ((NULL != end && '\0' != *end) || (NULL != arg && E_OK != ValidateValue(stage->arg, 1, 100)))
+            return E_NOT_OK;
+    }
+    else if (0 == strcasecmp(token, "sink"))
+        stage->type = STAGE_SINK;
+    else
+        return E_NOT_OK;
+
+    if (NULL != arg && (STAGE_BLUR == stage->type || STAGE_MEAN == stage->type || STAGE_SINK == stage->type))
+        return E_NOT_OK;
+
+    return E_OK;
+
+}/* End of function Pipeline_ParseStage */
+
+/** A conversion to gray drops the chrominance, so it is kept even if another conversion
+ * follows. The JPEG encoder reads YUV420 with its chrominance as captured, converting to
+ * YUV444 or RGB first only upsamples what the encoder subsamples again.
+ */
+static inline void Pipeline_Elide(Pipeline* pipeline, int jpeg)
+{
+    Image_Format format = PIXFMT_YUV420;
+    int i = 0;
+
+    while (i < pipeline->count)
+    {
+        Pipeline_Stage* stage = &pipeline->stage[i];
+        const Pipeline_Stage* next = (i + 1 < pipeline->count) ? &pipeline->stage[i + 1] : NULL;
+
+        if (STAGE_CONVERT == stage->type)
+        {
+            int redundant = ((Image_Format)stage->arg == format);
+
+            if (NULL != next && STAGE_CONVERT == next->type && PIXFMT_GRAY != stage->arg)
+                redundant = 1;
+            if (NULL != next && PIXFMT_YUV420 == format && PIXFMT_GRAY != stage->arg &&
+                (STAGE_ENCODE == next->type || (jpeg && STAGE_SINK == next->type)))
+                redundant = 1;
+
+            if (redundant)
+            {
+                memmove(stage, stage + 1, (size_t)(pipeline->count - i - 1) * sizeof(Pipeline_Stage));
+                pipeline->count--;
+                pipeline->elided++;
+                continue;
+            }
+            format = (Image_Format)stage->arg;
+        }
+        else if (STAGE_EDGE == stage->type)
+            format = PIXFMT_GRAY;
+
+        i++;
+    }
+
+}/* End of function Pipeline_Elide */
+
+/** Source positions are sampled at pixel centers in 16.16 fixed point, weights are rounded to
+ * 8 bits.
+ */
+static inline void Pipeline_ResizePlane(const unsigned char* src, int sw, int sh, unsigned char* dst, int dw, int dh, int channels, int nearest)
+{
+    int64_t step_x = ((int64_t)sw << 16) / dw;
+    int64_t step_y = ((int64_t)sh << 16) / dh;
+    int x, y, c;
+
+    for (y = 0; y < dh; y++)
+    {
+        int64_t fy = y * step_y + step_y / 2 - 32768;
+        int y0, y1, wy;
+        const unsigned char* r0;
+        const unsigned char* r1;
+        unsigned char* out = dst + (size_t)y * dw * channels;
+
+        if (fy < 0)
+            fy = 0;
+        y0 = (int)(fy >> 16);
+        y1 = (y0 + 1 < sh) ? y0 + 1 : sh - 1;
+        wy = (int)((fy >> 8) & 0xFF);
+        if (nearest && wy >= 128)
+            y0 = y1;
+        r0 = src + (size_t)y0 * sw * channels;
+        r1 = src + (size_t)y1 * sw * channels;
+
+        for (x = 0; x < dw; x++)
+        {
+            int64_t fx = x * step_x + step_x / 2 - 32768;
+            int x0, x1, wx;
+
+            if (fx < 0)
+                fx = 0;
+            x0 = (int)(fx >> 16);
+            x1 = (x0 + 1 < sw) ? x0 + 1 : sw - 1;
+            wx = (int)((fx >> 8) & 0xFF);
+
+            if (nearest)
+            {
+                const unsigned char* p = r0 + (size_t)((wx >= 128) ? x1 : x0) * channels;
+                for (c = 0; c < channels; c++)
+                    *out++ = p[c];
+                continue;
+            }
+
+            for (c = 0; c < channels; c++)
+            {
+                int top = r0[x0 * channels + c] * (256 - wx) + r0[x1 * channels + c] * wx;
+                int bottom = r1[x0 * channels + c] * (256 - wx) + r1[x1 * channels + c] * wx;
+                *out++ = (unsigned char)((top * (256 - wy) + bottom * wy + 32768) >> 16);
+            }
+        }
+    }
+
+}/* End of function Pipeline_ResizePlane */
+
+/** Rotations and conversions have no cheaper variant.
+ */
+static inline int Pipeline_HasCheap(const Pipeline_Stage* stage)
+{
+    return (STAGE_BLUR == stage->type) || (STAGE_MEDIAN == stage->type) || (STAGE_ENCODE == stage->type) ||
+           (STAGE_EDGE == stage->type && METHOD_CANNY == stage->arg) || (STAGE_RESIZE == stage->type && !stage->arg);
+
+}/* End of function Pipeline_HasCheap */
+
+/** The scheduler degrades the earliest stages first. A frame is dropped as soon as even the
+ * cheapest processing of the remaining stages ends after its deadline. Cheaper variants not
+ * measured yet are assumed to take half the time.
+ */
+static inline Stage_Action Pipeline_Schedule(const Pipeline* pipeline, int index, const Pipeline_Frame* frame, int64_t now)
+{
+    const Pipeline_Stage* stage = &pipeline->stage[index];
+    int64_t deadline = frame->captured + pipeline->budget_us;
+    int64_t full = 0, least = 0;
+    int i;
+
+    if (0 == pipeline->budget_us)
+        return ACTION_RUN;
+
+    for (i = index; i < pipeline->count; i++)
+    {
+        const Pipeline_Stage* next = &pipeline->stage[i];
+        int64_t normal = __atomic_load_n(&next->estimate_us[0], __ATOMIC_RELAXED);
+        int64_t cheap = __atomic_load_n(&next->estimate_us[1], __ATOMIC_RELAXED);
+
+        if (0 == cheap)
+            cheap = normal / 2;
+        full += normal;
+        least += next->optional ? 0 : (Pipeline_HasCheap(next) && cheap < normal) ? cheap : normal;
+    }
+
+    if (now + full <= deadline)
+        return ACTION_RUN;
+    if (DEADLINE_DROP == pipeline->deadline || now + least > deadline)
+        return ACTION_DROP;
+    if (stage->optional)
+        return ACTION_SKIP;
+
+    return Pipeline_HasCheap(stage) ? ACTION_CHEAP : ACTION_RUN;
+
+}/* End of function Pipeline_Schedule */
+
+/** Filters work on the luminance, the chrominance of YUV420 images is copied unchanged. The
+ * encoded file is detached from the encoder, so the next frame can be encoded before the sink
+ * wrote it. Cheaper variants are the mean filter for blur and 3x3 median, 3x3 for 5x5 median,
+ * Sobel for Canny, nearest neighbour resize and the fast DCT.
+ */
+static inline Std_ReturnType Pipeline_Apply(Pipeline* pipeline, int index, Pipeline_Frame* frame, Save_Context* save, int cheap)
+{
+    const Pipeline_Stage* stage = &pipeline->stage[index];
+    const Image_Planar* in = (index > 0) ? frame->result[index - 1] : &frame->input;
+    Image_Planar* out = &frame->image[index];
+    int w = in->width, h = in->height;
+    int p;
+
+    switch (stage->type)
+    {
+        case STAGE_CONVERT:
+            if (PIXFMT_GRAY == stage->arg)
+            {
+                Image_SetPlanar(out, PIXFMT_GRAY, w, h, in->plane[0]);
+                break;
+            }
+            if (PIXFMT_YUV444 == stage->arg)
+            {
+                Convert_YUV420toYUV444(w, h, in->plane[0], out->plane[0]);
+                break;
+            }
+            if (PIXFMT_RGB24 == stage->arg)
+                return Convert_YUVtoRGB(in, out, YUV_BT601_FULL);
+            memcpy(out->plane[0], in->plane[0], (size_t)w * h);
+            memset(out->plane[1], 128, (size_t)w * h / 2);
+            break;
+
+        case STAGE_BLUR:
+        case STAGE_MEAN:
+        case STAGE_MEDIAN:
+            if (STAGE_BLUR == stage->type && !cheap)
+                GaussianFilter(w, h, in->plane[0], out->plane[0], 3);
+            else if (STAGE_MEDIAN == stage->type && (!cheap || 5 == stage->arg))
+                MedianFilter(w, h, in->plane[0], out->plane[0], cheap ? 3 : stage->arg);
+            else
+                MeanFilter(w, h, in->plane[0], out->plane[0]);
+            if (PIXFMT_YUV420 == in->format)
+            {
+                memcpy(out->plane[1], in->plane[1], (size_t)w * h / 4);
+                memcpy(out->plane[2], in->plane[2], (size_t)w * h / 4);
+            }
+            break;
+
+        case STAGE_EDGE:
+            Edge_Detector(w, h, in->plane[0], out->plane[0], cheap ? METHOD_SOBEL : (EdgeDetector)stage->arg);
+            break;
+
+        case STAGE_ROTATE:
+            if (PIXFMT_YUV420 == in->format)
+                return Remap_ApplyYUV420(&stage->remap, in->plane[0], out->plane[0]);
+            return Remap_ApplyInterleaved(&stage->remap, (PIXFMT_GRAY == in->format) ? 1 : 3, in->plane[0], out->plane[0]);
+
+        case STAGE_RESIZE:
+            if (PIXFMT_YUV420 != in->format)
+            {
+                Pipeline_ResizePlane(in->plane[0], w, h, out->plane[0], out->width, out->height,
+                                     (PIXFMT_GRAY == in->format) ? 1 : 3, stage->arg || cheap);
+                break;
+            }
+            for (p = 0; p < 3; p++)
+                Pipeline_ResizePlane(in->plane[p], in->stride[p], p ? h / 2 : h, out->plane[p], out->stride[p],
+                                     p ? out->height / 2 : out->height, 1, stage->arg || cheap);
+            break;
+
+        case STAGE_ENCODE:
+            *out = *in;
+            JpegEncoder_SetFastDCT(&pipeline->encoder, cheap);
+            if (E_OK != JpegEncoder_Encode(&pipeline->encoder, in))
+                return E_NOT_OK;
+            frame->data = JpegEncoder_Detach(&pipeline->encoder, &frame->length);
+            return (NULL != frame->data) ? E_OK : E_NOT_OK;
+
+        case STAGE_SINK:
+            *out = *in;
+            Save_SetCaptureTime(save, frame->captured);
+            if (NULL != frame->data)
+            {
+                writeencodedimage(save, frame->data, frame->length, frame->filename);
+                frame->data = NULL;
+            }
+            else
+                writeimage(save, in, frame->filename);
+            break;
+
+        default:
+            return E_NOT_OK;
+    }
+
+    return E_OK;
+
+}/* End of function Pipeline_Apply */
+
+/** Estimates of work which is not done are never measured again, so they are lowered a
+ * little instead. Stale estimates after a stall then cannot make the scheduler drop or degrade
+ * every following frame.
+ */
+static inline void Pipeline_Age(Pipeline* pipeline, int first, int last, int variant)
+{
+    int i;
+
+    for (i = first; i <= last; i++)
+    {
+        int64_t* estimate = &pipeline->stage[i].estimate_us[variant];
+        int64_t value = __atomic_load_n(estimate, __ATOMIC_RELAXED);
+        __atomic_store_n(estimate, value - value / PIPELINE_ESTIMATE_AGING, __ATOMIC_RELAXED);
+    }
+
+}/* End of function Pipeline_Age */
+
+/** Statistics are only written by the thread running the stage. The latency of a frame ends
+ * with its sink. Traces show dropped and skipped work as instants.
+ */
+static inline int Pipeline_Step(Pipeline* pipeline, int index, Pipeline_Frame* frame, Save_Context* save)
+{
+    Pipeline_Stage* stage = &pipeline->stage[index];
+    int64_t traced = Trace_Begin();
+    int64_t start = RateControl_Now();
+    Stage_Action action = Pipeline_Schedule(pipeline, index, frame, start);
+    int cheap = (ACTION_CHEAP == action);
+    int64_t* estimate = &stage->estimate_us[cheap];
+    int64_t end, latency;
+
+    Trace_SetFrame(frame->sequence);
+
+    if (ACTION_DROP == action)
+    {
+        Trace_Instant("drop");
+        Pipeline_Age(pipeline, index, pipeline->count - 1, 0);
+        Pipeline_Age(pipeline, index, pipeline->count - 1, 1);
+        __atomic_fetch_add(&pipeline->late, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    if (ACTION_RUN != action)
+        Pipeline_Age(pipeline, index, index, 0);
+
+    if (ACTION_SKIP == action)
+    {
+        Trace_Instant("skip");
+        frame->result[index] = (index > 0) ? frame->result[index - 1] : &frame->input;
+        __atomic_fetch_add(&stage->skipped, 1, __ATOMIC_RELAXED);
+        return 1;
+    }
+
+    frame->result[index] = &frame->image[index];
+    if (E_OK != Pipeline_Apply(pipeline, index, frame, save, cheap))
+    {
+        fprintf(stderr, "Pipeline stage %d failed on %s\n", index + 1, frame->filename);
+        return 0;
+    }
+
+    end = RateControl_Now();
+    Trace_End(Pipeline_StageNames[stage->type], traced);
+    __atomic_fetch_add(&stage->busy_us, end - start, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stage->frames, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&stage->degraded, (unsigned long)cheap, __ATOMIC_RELAXED);
+    __atomic_store_n(estimate, *estimate ? *estimate + (end - start - *estimate) / 8 : end - start, __ATOMIC_RELAXED);
+
+    if (index == pipeline->count - 1)
+    {
+        latency = end - frame->captured;
+        __atomic_fetch_add(&pipeline->completed, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&pipeline->latency_us, latency, __ATOMIC_RELAXED);
+        if (latency > __atomic_load_n(&pipeline->latency_max_us, __ATOMIC_RELAXED))
+            __atomic_store_n(&pipeline->latency_max_us, latency, __ATOMIC_RELAXED);
+        if (pipeline->budget_us && latency > pipeline->budget_us)
+            __atomic_fetch_add(&pipeline->missed, 1, __ATOMIC_RELAXED);
+    }
+
+    return 1;
+
+}/* End of function Pipeline_Step */
+
+/** One buffer holds the outputs of all stages, views get their planes while running.
+ */
+static inline Std_ReturnType Pipeline_AllocFrame(const Pipeline* pipeline, Pipeline_Frame* frame)
+{
+    size_t size = 0;
+    int i;
+
+    memset(frame, 0, sizeof(Pipeline_Frame));
+
+    for (i = 0; i < pipeline->count; i++)
+        size += pipeline->stage[i].size;
+
+    frame->buffer = malloc(size ? size : 1);
+    if (NULL == frame->buffer)
+        return E_NOT_OK;
+
+    for (i = 0, size = 0; i < pipeline->count; i++)
+    {
+        const Image_Planar* out = &pipeline->stage[i].out;
+
+        Image_SetPlanar(&frame->image[i], out->format, out->width, out->height,
+                        pipeline->stage[i].size ? frame->buffer + size : NULL);
+        size += pipeline->stage[i].size;
+    }
+
+    return E_OK;
+
+}/* End of function Pipeline_AllocFrame */
+
+/** A frame without stage output, e.g. dropped before the first stage, is recycled the same way.
+ */
+static inline void Pipeline_Recycle(Pipeline* pipeline, Pipeline_Frame* frame)
+{
+    free(frame->source);
+    frame->source = NULL;
+    free(frame->data);
+    frame->data = NULL;
+    (void)BoundedQueue_Push(&pipeline->free, frame, QUEUE_BLOCK, NULL);
+
+}/* End of function Pipeline_Recycle */
+
+/** Each thread takes the next stage index, the wait for a frame is accounted as idle time and
+ * the time the frame spent in the queue as queued time.
+ */
+static void* Pipeline_Worker(void* arg)
+{
+    Pipeline* pipeline = (Pipeline*)arg;
+    int index = __atomic_fetch_add(&pipeline->next_stage, 1, __ATOMIC_RELAXED);
+    Pipeline_Stage* stage = &pipeline->stage[index];
+    Pipeline_Frame* frame;
+
+    Thread_BlockSignals();
+
+    for (;;)
+    {
+        int64_t start = RateControl_Now();
+        int64_t now;
+        int last;
+
+        frame = BoundedQueue_Pop(&stage->queue, 1);
+        if (NULL == frame)
+            break;
+
+        now = RateControl_Now();
+        __atomic_fetch_add(&stage->idle_us, now - start, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&stage->queued_us, now - frame->queued, __ATOMIC_RELAXED);
+
+        last = !Pipeline_Step(pipeline, index, frame, pipeline->save);
+        frame->queued = RateControl_Now();
+
+        if (last || index == pipeline->count - 1)
+            Pipeline_Recycle(pipeline, frame);
+        else
+            (void)BoundedQueue_Push(&pipeline->stage[index + 1].queue, frame, QUEUE_BLOCK, NULL);
+    }
+
+    /** The next stage drains its queue before it ends */
+    if (index < pipeline->count - 1)
+        BoundedQueue_Close(&pipeline->stage[index + 1].queue);
+
+    return NULL;
+
+}/* End of function Pipeline_Worker */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** The declaration is copied, so the caller keeps its string.
+ */
+Std_ReturnType Pipeline_Parse(Pipeline* pipeline, const char* spec)
+{
+    Std_ReturnType validate = E_OK;
+    char text[PIPELINE_MAX_FILE];
+    char* line;
+    char* next;
+
+    validate += ValidateParam(pipeline);
+    validate += ValidateParam((void*)spec);
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    memset(pipeline, 0, sizeof(Pipeline));
+
+    if ('@' == spec[0])
+    {
+        FILE* file = fopen(spec + 1, "r");
+        size_t length;
+
+        if (NULL == file)
+        {
+            fprintf(stderr, "Cannot open pipeline file %s\n", spec + 1);
+            return E_NOT_OK;
+        }
+        length = fread(text, 1, sizeof(text) - 1, file);
+        fclose(file);
+        text[length] = '\0';
+    }
+    else
+    {
+        strncpy(text, spec, sizeof(text) - 1);
+        text[sizeof(text) - 1] = '\0';
+    }
+
+    for (line = text; NULL != line; line = next)
+    {
+        char* comment;
+        char* token;
+        char* save_ptr;
+
+        next = strchr(line, '\n');
+        if (NULL != next)
+            *next++ = '\0';
+        comment = strchr(line, '#');
+        if (NULL != comment)
+            *comment = '\0';
+
+        for (token = strtok_r(line, ", \t\r", &save_ptr); NULL != token; token = strtok_r(NULL, ", \t\r", &save_ptr))
+        {
+            if (PIPELINE_MAX_STAGES == pipeline->count)
+            {
+                fprintf(stderr, "Pipeline has more than %d stages\n", PIPELINE_MAX_STAGES);
+                return E_NOT_OK;
+            }
+            if (E_OK != Pipeline_ParseStage(&pipeline->stage[pipeline->count], token))
+            {
+                fprintf(stderr, "Invalid pipeline stage %s\n", token);
+                return E_NOT_OK;
+            }
+            pipeline->count++;
+        }
+    }
+
+    if (0 == pipeline->count)
+    {
+        fprintf(stderr, "Pipeline has no stages\n");
+        return E_NOT_OK;
+    }
+
+    return E_OK;
+
+}/* End of function Pipeline_Parse */
+
+/** Every stage learns its input format and size here, so a frame only fills in the planes of
+ * the first input.
+ */
+Std_ReturnType Pipeline_Compile(Pipeline* pipeline, int width, int height, const Save_Context* save)
+{
+    Std_ReturnType validate = E_OK;
+    Image_Planar current;
+    int i;
+
+    validate += ValidateParam(pipeline);
+    validate += ValidateParam((void*)save);
+    validate += ValidateImageSize(width, height);
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    if (STAGE_SINK != pipeline->stage[pipeline->count - 1].type)
+    {
+        if (PIPELINE_MAX_STAGES == pipeline->count)
+        {
+            fprintf(stderr, "Pipeline has no room for its sink\n");
+            return E_NOT_OK;
+        }
+        memset(&pipeline->stage[pipeline->count], 0, sizeof(Pipeline_Stage));
+        pipeline->stage[pipeline->count++].type = STAGE_SINK;
+    }
+
+    for (i = 0; i < pipeline->count - 1; i++)
+    {
+        if (STAGE_SINK == pipeline->stage[i].type)
+        {
+            fprintf(stderr, "Pipeline sink must be the last stage\n");
+            return E_NOT_OK;
+        }
+        if (STAGE_ENCODE == pipeline->stage[i].type && i != pipeline->count - 2)
+        {
+            fprintf(stderr, "Pipeline encode must be followed by the sink\n");
+            return E_NOT_OK;
+        }
+        if (STAGE_ENCODE == pipeline->stage[i].type && SAVE_JPEG != save->format)
+        {
+            fprintf(stderr, "Pipeline encode writes JPEG images only\n");
+            return E_NOT_OK;
+        }
+    }
+
+    Pipeline_Elide(pipeline, SAVE_JPEG == save->format);
+
+    Image_SetPlanar(&current, PIXFMT_YUV420, width, height, NULL);
+
+    for (i = 0; i < pipeline->count; i++)
+    {
+        Pipeline_Stage* stage = &pipeline->stage[i];
+        Image_Format in = current.format;
+        Image_Format format = in;
+        int w = current.width, h = current.height;
+        int valid = 1, allocate = 1;
+
+        stage->in = current;
+
+        switch (stage->type)
+        {
+            case STAGE_CONVERT:
+                format = (Image_Format)stage->arg;
+                valid = (PIXFMT_YUV420 == in) || (PIXFMT_GRAY == in && PIXFMT_YUV420 == format);
+                allocate = (PIXFMT_GRAY != format);
+                break;
+
+            case STAGE_BLUR:
+            case STAGE_MEAN:
+            case STAGE_MEDIAN:
+                valid = (PIXFMT_GRAY == in) || (PIXFMT_YUV420 == in);
+                break;
+
+            case STAGE_EDGE:
+                valid = (PIXFMT_GRAY == in) || (PIXFMT_YUV420 == in);
+                format = PIXFMT_GRAY;
+                break;
+
+            case STAGE_ROTATE:
+                {
+                    Remap_Transform tf;
+                    Remap_SetRotation(&tf, w, h, stage->arg);
+                    validate = Remap_Create(&stage->remap, w, h, &tf, PIPELINE_REMAP_SHIFT, 1);
+                    stage->remap_ready = (E_OK == validate);
+                }
+                break;
+
+            case STAGE_RESIZE:
+                w = stage->width;
+                h = stage->height;
+                valid = (PIXFMT_YUV420 != in) || (0 == w % 2 && 0 == h % 2);
+                break;
+
+            case STAGE_ENCODE:
+                allocate = 0;
+                if (!pipeline->encoder_ready)
+                {
+                    validate = JpegEncoder_Init(&pipeline->encoder, stage->arg ? stage->arg : save->quality);
+                    pipeline->encoder_ready = (E_OK == validate);
+                }
+                break;
+
+            case STAGE_SINK:
+                allocate = 0;
+                if (i > 0 && STAGE_ENCODE == pipeline->stage[i - 1].type)
+                    break;
+                valid = (SAVE_JPEG == save->format) ||
+                        (SAVE_QOI == save->format && PIXFMT_YUV444 != in) ||
+                        (SAVE_PGM == save->format && (PIXFMT_GRAY == in || PIXFMT_YUV420 == in)) ||
+                        (SAVE_PPM == save->format && (PIXFMT_RGB24 == in || PIXFMT_YUV420 == in));
+                break;
+
+            default:
+                valid = 0;
+                break;
+        }
+
+        if (stage->optional && STAGE_BLUR != stage->type && STAGE_MEAN != stage->type &&
+            STAGE_MEDIAN != stage->type && STAGE_ROTATE != stage->type)
+        {
+            fprintf(stderr, "Pipeline stage %d cannot be optional\n", i + 1);
+            return E_NOT_OK;
+        }
+
+        if (!valid)
+        {
+            fprintf(stderr, "Pipeline stage %d cannot take %s images of %dx%d\n", i + 1, Pipeline_FormatName(in), w, h);
+            return E_NOT_OK;
+        }
+        if (E_OK != validate)
+            return E_NOT_OK;
+
+        stage->size = Image_SetPlanar(&stage->out, format, w, h, NULL);
+        if (!allocate)
+            stage->size = 0;
+
+        current = stage->out;
+    }
+
+    /** Without stage threads a single frame is reused */
+    pipeline->frames = malloc(sizeof(Pipeline_Frame));
+    if (NULL == pipeline->frames || E_OK != Pipeline_AllocFrame(pipeline, pipeline->frames))
+        return E_NOT_OK;
+    pipeline->depth = 1;
+
+    return E_OK;
+
+}/* End of function Pipeline_Compile */
+
+/** Conversions removed while compiling are reported as a count.
+ */
+void Pipeline_Print(const Pipeline* pipeline, FILE* fp)
+{
+    int i;
+
+    fprintf(fp, "Pipeline: %s %dx%d", Pipeline_FormatName(pipeline->stage[0].in.format),
+            pipeline->stage[0].in.width, pipeline->stage[0].in.height);
+
+    for (i = 0; i < pipeline->count; i++)
+    {
+        const Pipeline_Stage* stage = &pipeline->stage[i];
+        fprintf(fp, " -> %s%s", Pipeline_StageNames[stage->type], stage->optional ? "?" : "");
+        if (STAGE_SINK != stage->type && STAGE_ENCODE != stage->type)
+            fprintf(fp, " %s %dx%d", Pipeline_FormatName(stage->out.format), stage->out.width, stage->out.height);
+    }
+
+    fprintf(fp, " (%d conversions elided)\n", pipeline->elided);
+
+}/* End of function Pipeline_Print */
+
+/** Every stage reads the output of the previous one, views such as a conversion to gray point
+ * into the frame itself.
+ */
+Std_ReturnType Pipeline_Run(Pipeline* pipeline, Save_Context* save, unsigned char* img, char* filename, int64_t captured)
+{
+    Pipeline_Frame* frame = &pipeline->frames[0];
+    int i;
+
+    Image_SetPlanar(&frame->input, PIXFMT_YUV420, pipeline->stage[0].in.width, pipeline->stage[0].in.height, img);
+    snprintf(frame->filename, sizeof(frame->filename), "%s", filename);
+    frame->captured = captured ? captured : RateControl_Now();
+    frame->sequence = Trace_GetFrame();
+
+    for (i = 0; i < pipeline->count; i++)
+    {
+        if (!Pipeline_Step(pipeline, i, frame, save))
+        {
+            free(frame->data);
+            frame->data = NULL;
+            return E_NOT_OK;
+        }
+    }
+
+    return E_OK;
+
+}/* End of function Pipeline_Run */
+
+/** Averages of processing times are kept, so a new bound applies at once.
+ */
+void Pipeline_SetDeadline(Pipeline* pipeline, int64_t budget_us, Deadline_Policy policy)
+{
+    pipeline->budget_us = (budget_us > 0) ? budget_us : 0;
+    pipeline->deadline = policy;
+
+}/* End of function Pipeline_SetDeadline */
+
+/** The queue of every stage can hold all frames, so passing a frame on never blocks and the
+ * free frames are the only point of backpressure.
+ */
+Std_ReturnType Pipeline_Start(Pipeline* pipeline, Save_Context* save, int depth, Queue_Policy policy)
+{
+    Std_ReturnType validate = E_OK;
+    Pipeline_Frame* frames;
+    int i;
+
+    validate += ValidateParam(pipeline);
+    validate += ValidateParam(save);
+    validate += ValidateValue(depth, 2, PIPELINE_MAX_DEPTH);
+
+    if (E_OK == validate)
+        validate += (pipeline->depth > 0 && 0 == pipeline->started) ? E_OK : E_NOT_OK;
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    frames = realloc(pipeline->frames, (size_t)depth * sizeof(Pipeline_Frame));
+    if (NULL == frames)
+        return E_NOT_OK;
+    pipeline->frames = frames;
+
+    for (; pipeline->depth < depth; pipeline->depth++)
+        if (E_OK != Pipeline_AllocFrame(pipeline, &frames[pipeline->depth]))
+            return E_NOT_OK;
+
+    if (E_OK != BoundedQueue_Init(&pipeline->free, depth))
+        return E_NOT_OK;
+    for (i = 0; i < depth; i++)
+        (void)BoundedQueue_Push(&pipeline->free, &frames[i], QUEUE_BLOCK, NULL);
+
+    for (i = 0; i < pipeline->count; i++)
+    {
+        if (E_OK != BoundedQueue_Init(&pipeline->stage[i].queue, depth))
+        {
+            while (--i >= 0)
+                BoundedQueue_DeInit(&pipeline->stage[i].queue);
+            BoundedQueue_DeInit(&pipeline->free);
+            return E_NOT_OK;
+        }
+    }
+
+    pipeline->save = save;
+    pipeline->policy = policy;
+    pipeline->next_stage = 0;
+
+    for (i = 0; i < pipeline->count; i++)
+    {
+        if (0 != pthread_create(&pipeline->stage[i].thread, NULL, Pipeline_Worker, pipeline))
+            break;
+        pipeline->started++;
+    }
+
+    if (pipeline->started < pipeline->count)
+    {
+        Pipeline_Stop(pipeline);
+        return E_NOT_OK;
+    }
+
+    return E_OK;
+
+}/* End of function Pipeline_Start */
+
+/** A dropped frame is released at once, its filename is not written. Failed stages are
+ * reported by the stage and drop the frame as well.
+ */
+int Pipeline_Submit(Pipeline* pipeline, Save_Context* save, unsigned char* img, char* filename, int64_t captured)
+{
+    Pipeline_Frame* frame;
+    int64_t now = RateControl_Now();
+
+    /** Drivers stamping frames with the wall clock are timed from submission */
+    if (captured <= 0 || captured > now + 1000000 || captured < now - 1000000)
+        captured = now;
+
+    if (0 == pipeline->started)
+    {
+        pipeline->submitted++;
+        (void)Pipeline_Run(pipeline, save, img, filename, captured);
+        return 0;
+    }
+
+    frame = BoundedQueue_Pop(&pipeline->free, 0);
+
+    if (NULL == frame && QUEUE_BLOCK == pipeline->policy)
+    {
+        int64_t start = RateControl_Now();
+        frame = BoundedQueue_Pop(&pipeline->free, 1);
+        __atomic_fetch_add(&pipeline->blocked_us, RateControl_Now() - start, __ATOMIC_RELAXED);
+    }
+    else if (NULL == frame && QUEUE_DROP_OLDEST == pipeline->policy)
+    {
+        frame = BoundedQueue_Pop(&pipeline->stage[0].queue, 0);
+        if (NULL != frame)
+        {
+            free(frame->source);
+            frame->source = NULL;
+            __atomic_fetch_add(&pipeline->dropped, 1, __ATOMIC_RELAXED);
+        }
+    }
+
+    if (NULL == frame)
+    {
+        free(img);
+        __atomic_fetch_add(&pipeline->dropped, 1, __ATOMIC_RELAXED);
+        return 1;
+    }
+
+    Image_SetPlanar(&frame->input, PIXFMT_YUV420, pipeline->stage[0].in.width, pipeline->stage[0].in.height, img);
+    frame->source = img;
+    frame->captured = captured;
+    frame->sequence = Trace_GetFrame();
+    frame->queued = RateControl_Now();
+    snprintf(frame->filename, sizeof(frame->filename), "%s", filename);
+
+    __atomic_fetch_add(&pipeline->submitted, 1, __ATOMIC_RELAXED);
+    if (E_OK != BoundedQueue_Push(&pipeline->stage[0].queue, frame, QUEUE_BLOCK, NULL))
+        Pipeline_Recycle(pipeline, frame);
+
+    return 1;
+
+}/* End of function Pipeline_Submit */
+
+/** Closing the first queue ends the stage threads one after the other once they processed
+ * the frames in flight.
+ */
+void Pipeline_Stop(Pipeline* pipeline)
+{
+    int i;
+
+    if (0 == pipeline->started)
+        return;
+
+    BoundedQueue_Close(&pipeline->stage[0].queue);
+    for (i = 0; i < pipeline->started; i++)
+        pthread_join(pipeline->stage[i].thread, NULL);
+
+    /** Stages which did not start leave their queues open */
+    for (i = pipeline->started; i < pipeline->count; i++)
+        BoundedQueue_Close(&pipeline->stage[i].queue);
+    for (i = 0; i < pipeline->count; i++)
+        BoundedQueue_DeInit(&pipeline->stage[i].queue);
+    BoundedQueue_DeInit(&pipeline->free);
+
+    pipeline->started = 0;
+
+}/* End of function Pipeline_Stop */
+
+/** Averages are per processed frame, the queue depth is a snapshot next to its peak, which
+ * is kept after the threads stopped.
+ */
+void Pipeline_PrintStats(const Pipeline* pipeline, FILE* fp)
+{
+    unsigned long completed;
+    int i;
+
+    fprintf(fp, "Pipeline: %lu frames submitted, %lu dropped, %.1f ms blocked\n",
+            __atomic_load_n(&pipeline->submitted, __ATOMIC_RELAXED), __atomic_load_n(&pipeline->dropped, __ATOMIC_RELAXED),
+            __atomic_load_n(&pipeline->blocked_us, __ATOMIC_RELAXED) / 1000.0);
+
+    completed = __atomic_load_n(&pipeline->completed, __ATOMIC_RELAXED);
+    fprintf(fp, "  %lu saved, latency avg %.2f ms max %.2f ms", completed,
+            __atomic_load_n(&pipeline->latency_us, __ATOMIC_RELAXED) / (completed ? (double)completed : 1.0) / 1000.0,
+            __atomic_load_n(&pipeline->latency_max_us, __ATOMIC_RELAXED) / 1000.0);
+    if (pipeline->budget_us)
+        fprintf(fp, ", deadline %.2f ms missed %lu dropped %lu", pipeline->budget_us / 1000.0,
+                __atomic_load_n(&pipeline->missed, __ATOMIC_RELAXED), __atomic_load_n(&pipeline->late, __ATOMIC_RELAXED));
+    fprintf(fp, "\n");
+
+    for (i = 0; i < pipeline->count; i++)
+    {
+        const Pipeline_Stage* stage = &pipeline->stage[i];
+        unsigned long frames = __atomic_load_n(&stage->frames, __ATOMIC_RELAXED);
+        double n = frames ? (double)frames : 1.0;
+
+        fprintf(fp, "  %-8s %6lu frames  busy %8.2f ms  queued %8.2f ms  idle %8.2f ms  depth %d/%d  cheap %lu  skipped %lu\n",
+                Pipeline_StageNames[stage->type], frames,
+                __atomic_load_n(&stage->busy_us, __ATOMIC_RELAXED) / n / 1000.0,
+                __atomic_load_n(&stage->queued_us, __ATOMIC_RELAXED) / n / 1000.0,
+                __atomic_load_n(&stage->idle_us, __ATOMIC_RELAXED) / n / 1000.0,
+                __atomic_load_n(&stage->queue.count, __ATOMIC_RELAXED),
+                __atomic_load_n(&stage->queue.high_water, __ATOMIC_RELAXED),
+                __atomic_load_n(&stage->degraded, __ATOMIC_RELAXED), __atomic_load_n(&stage->skipped, __ATOMIC_RELAXED));
+    }
+
+}/* End of function Pipeline_PrintStats */
+
+/** Frames are released after every stage thread ended, the pipeline can be parsed again
+ * afterwards.
+ */
+void Pipeline_Free(Pipeline* pipeline)
+{
+    int i;
+
+    Pipeline_Stop(pipeline);
+
+    for (i = 0; i < pipeline->depth; i++)
+    {
+        free(pipeline->frames[i].buffer);
+        free(pipeline->frames[i].source);
+        free(pipeline->frames[i].data);
+    }
+    free(pipeline->frames);
+    pipeline->frames = NULL;
+    pipeline->depth = 0;
+
+    for (i = 0; i < pipeline->count; i++)
+    {
+        if (pipeline->stage[i].remap_ready)
+            Remap_Destroy(&pipeline->stage[i].remap);
+        pipeline->stage[i].remap_ready = 0;
+    }
+
+    if (pipeline->encoder_ready)
+        JpegEncoder_DeInit(&pipeline->encoder);
+    pipeline->encoder_ready = 0;
+    pipeline->count = 0;
+
+}/* End of function Pipeline_Free */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
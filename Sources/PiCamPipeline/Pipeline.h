@@ -0,0 +1,383 @@
+/**
+ * @file Pipeline.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for processing pipelines declared as a list of stages </b>
+ * @version
+ * @date 2026-10-18 Initial template for declarative processing pipelines
+ * @date 2026-10-18 Run stages on threads of their own connected by bounded queues
+ * @date 2026-10-18 Degrade, skip or drop work of frames which miss their deadline
+ * @date 2026-10-19 Carry the frame sequence number for traces
+ * @date 2026-10-19 Keep private helpers out of the header
+ * @date 2026-10-19 Keep the stage thread entry and frame helpers private
+ * @date 2026-10-19 Keep deadline helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef PIPELINE_H
+#define  PIPELINE_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <pthread.h>
+#include "Common_PiCam.h"
+#include "BoundedQueue.h"
+#include "Convolutions.h"
+#include "JpegEncoder.h"
+#include "Remap.h"
+#include "OutputSink.h"
+#include "write.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Maximum number of stages of a pipeline */
+#define PIPELINE_MAX_STAGES     (16)
+
+/** Maximum size of a pipeline file in bytes */
+#define PIPELINE_MAX_FILE       (4096)
+
+/** Grid spacing of the remap tables of rotations as power of two */
+#define PIPELINE_REMAP_SHIFT    (3)
+
+/** Maximum number of frames in flight between stage threads */
+#define PIPELINE_MAX_DEPTH      (16)
+
+/** Time estimates of work which is not done shrink by 1/n per frame */
+#define PIPELINE_ESTIMATE_AGING (32)
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Enumeration of pipeline stages */
+typedef enum
+{
+    /** Convert to another pixel format: gray, yuv420, yuv444 or rgb */
+    STAGE_CONVERT,
+    /** 3x3 Gaussian filter of the luminance */
+    STAGE_BLUR,
+    /** 3x3 mean filter of the luminance */
+    STAGE_MEAN,
+    /** 3x3 or 5x5 median filter of the luminance */
+    STAGE_MEDIAN,
+    /** Sobel or Canny edge detection, the result is a gray image */
+    STAGE_EDGE,
+    /** Rotation around the image center by degrees */
+    STAGE_ROTATE,
+    /** Bilinear or nearest neighbour resize */
+    STAGE_RESIZE,
+    /** JPEG encoding with a fixed quality */
+    STAGE_ENCODE,
+    /** Output through the save context, always the last stage */
+    STAGE_SINK
+} Stage_Type;
+
+/** Enumeration of actions of the deadline scheduler when frames fall behind */
+typedef enum
+{
+    /** Drop frames predicted to miss their deadline */
+    DEADLINE_DROP,
+    /** Run cheaper variants of stages and skip optional stages first, drop frames which miss
+     *  their deadline even so */
+    DEADLINE_DEGRADE
+} Deadline_Policy;
+
+/** Enumeration of decisions of the deadline scheduler for one stage of one frame */
+typedef enum
+{
+    /** Run the stage as declared */
+    ACTION_RUN,
+    /** Run the cheaper variant of the stage */
+    ACTION_CHEAP,
+    /** Pass the input on unchanged */
+    ACTION_SKIP,
+    /** Drop the frame */
+    ACTION_DROP
+} Stage_Action;
+
+/** One stage of a pipeline with its preallocated output */
+typedef struct
+{
+    /** Kind of stage */
+    Stage_Type type;
+    /** Argument of the stage: pixel format, filter size, edge method, angle or quality */
+    int arg;
+    /** Target width of a resize */
+    int width;
+    /** Target height of a resize */
+    int height;
+    /** Set if the scheduler may skip the stage, declared with a trailing ? */
+    int optional;
+    /** Format and size of the input after compilation, planes are unset */
+    Image_Planar in;
+    /** Format and size of the output after compilation, planes are unset */
+    Image_Planar out;
+    /** Size of the output buffer in bytes, 0 if the output refers to the input */
+    size_t size;
+    /** Coordinate map of a rotation */
+    Remap_Table remap;
+    /** Set once remap is created */
+    int remap_ready;
+    /** Frames waiting for the stage thread */
+    BoundedQueue queue;
+    /** Thread running the stage */
+    pthread_t thread;
+    /** Number of processed frames */
+    unsigned long frames;
+    /** Time spent processing frames in microseconds */
+    int64_t busy_us;
+    /** Time the stage thread waited for frames in microseconds */
+    int64_t idle_us;
+    /** Time frames waited in the queue of the stage in microseconds */
+    int64_t queued_us;
+    /** Moving average of the processing time of the declared and the cheaper variant */
+    int64_t estimate_us[2];
+    /** Number of frames processed with the cheaper variant */
+    unsigned long degraded;
+    /** Number of frames passed on unchanged */
+    unsigned long skipped;
+} Pipeline_Stage;
+
+/** One frame travelling through the stages with the outputs of all of them */
+typedef struct
+{
+    /** Captured YUV420 frame */
+    Image_Planar input;
+    /** Outputs of the stages, views of a previous image for stages without buffer */
+    Image_Planar image[PIPELINE_MAX_STAGES];
+    /** Result of every stage, the input of a skipped stage */
+    const Image_Planar* result[PIPELINE_MAX_STAGES];
+    /** Buffer holding the outputs of all stages */
+    unsigned char* buffer;
+    /** Captured frame released with the frame, NULL if the caller keeps it */
+    unsigned char* source;
+    /** File encoded by STAGE_ENCODE until the sink writes it */
+    unsigned char* data;
+    /** Size of data in bytes */
+    size_t length;
+    /** Time the frame entered its current queue in microseconds */
+    int64_t queued;
+    /** Capture time in microseconds of CLOCK_MONOTONIC */
+    int64_t captured;
+    /** Sequence number of the captured frame for traces */
+    uint32_t sequence;
+    /** Filename of the image */
+    char filename[SINK_MAX_FILENAME];
+} Pipeline_Frame;
+
+/** Linear processing graph from the captured YUV420 frame to the sink. It is validated and
+ *  its buffers are allocated once by Pipeline_Compile, frames run without allocations.
+ */
+typedef struct
+{
+    /** Stages in processing order */
+    Pipeline_Stage stage[PIPELINE_MAX_STAGES];
+    /** Number of stages */
+    int count;
+    /** Number of redundant conversions removed by Pipeline_Compile */
+    int elided;
+    /** Encoder of STAGE_ENCODE */
+    JpegEncoder encoder;
+    /** Set once encoder is initialized */
+    int encoder_ready;
+    /** Frames with their stage outputs, one without stage threads */
+    Pipeline_Frame* frames;
+    /** Number of frames */
+    int depth;
+    /** Frames not in flight */
+    BoundedQueue free;
+    /** Action when a frame is submitted while all frames are in flight */
+    Queue_Policy policy;
+    /** Save context of the sink thread */
+    Save_Context* save;
+    /** Number of started stage threads */
+    int started;
+    /** Index of the next stage thread taking its stage */
+    int next_stage;
+    /** Number of frames submitted to the stage threads */
+    unsigned long submitted;
+    /** Number of frames dropped because all frames were in flight */
+    unsigned long dropped;
+    /** Time submitting threads waited for a frame in microseconds */
+    int64_t blocked_us;
+    /** Maximum time from capture to the end of the sink in microseconds, 0 for no deadline */
+    int64_t budget_us;
+    /** Action of the scheduler when frames fall behind */
+    Deadline_Policy deadline;
+    /** Number of frames dropped to meet deadlines */
+    unsigned long late;
+    /** Number of frames saved */
+    unsigned long completed;
+    /** Number of frames saved after their deadline */
+    unsigned long missed;
+    /** Sum of capture to save latencies in microseconds */
+    int64_t latency_us;
+    /** Highest capture to save latency in microseconds */
+    int64_t latency_max_us;
+} Pipeline;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Parses a pipeline declaration. Stages are separated by commas, blanks or newlines
+ *          and # starts a comment. A declaration starting with @ names a file holding it.
+ *
+ *          convert=gray|yuv420|yuv444|rgb, blur, mean, median[=3|5], edge[=sobel|canny],
+ *          rotate=degrees, resize=WxH[:nearest], encode[=quality], sink
+ *
+ *          A trailing ? marks blur, mean, median and rotate optional for the deadline
+ *          scheduler, e.g. median=5?.
+ *
+ * @param[out] pipeline Pipeline
+ * @param[in] spec      Declaration of the stages
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType Pipeline_Parse(Pipeline* pipeline, const char* spec);
+
+/**
+ * @brief   Validates the pixel formats along the pipeline, removes redundant conversions and
+ *          allocates the output of every stage. A sink is appended if the declaration has
+ *          none.
+ *
+ * @param[inout] pipeline   Parsed pipeline
+ * @param[in] width         Width of captured frames
+ * @param[in] height        Height of captured frames
+ * @param[in] save          Save context of the sink, selects the file format and quality
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Invalid pipeline or out of memory
+ *
+ */
+Std_ReturnType Pipeline_Compile(Pipeline* pipeline, int width, int height, const Save_Context* save);
+
+/**
+ * @brief   Prints the compiled stages with their output formats and sizes.
+ *
+ * @param[in] pipeline  Compiled pipeline
+ * @param[in] fp        File pointer
+ *
+ */
+void Pipeline_Print(const Pipeline* pipeline, FILE* fp);
+
+/**
+ * @brief   Runs a captured frame through the pipeline on the calling thread and saves the
+ *          result.
+ *
+ * @param[inout] pipeline   Compiled pipeline without stage threads
+ * @param[inout] save       Save context of the sink
+ * @param[in] img           YUV420 frame of the compiled size
+ * @param[in] filename      Filename of the image
+ * @param[in] captured      Capture time in microseconds of CLOCK_MONOTONIC, 0 for now
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Frame saved
+ * @retval E_NOT_OK         Frame dropped or a stage failed
+ *
+ */
+Std_ReturnType Pipeline_Run(Pipeline* pipeline, Save_Context* save, unsigned char* img, char* filename, int64_t captured);
+
+/**
+ * @brief   Sets the latency bound of frames. Frames which fall behind it are degraded or
+ *          dropped, so latency stays bounded when processing is slower than capture.
+ *
+ * @param[inout] pipeline   Compiled pipeline, stage threads not started
+ * @param[in] budget_us     Maximum time from capture to the end of the sink in microseconds,
+ *                          0 to process every frame completely
+ * @param[in] policy        Action when frames fall behind
+ *
+ */
+void Pipeline_SetDeadline(Pipeline* pipeline, int64_t budget_us, Deadline_Policy policy);
+
+/**
+ * @brief   Starts one thread per stage. Stages are connected by queues and a fixed number of
+ *          frames circulates between them, so throughput is limited by the slowest stage.
+ *
+ * @param[inout] pipeline   Compiled pipeline
+ * @param[inout] save       Save context of the sink, used by the sink thread only
+ * @param[in] depth         Number of frames in flight (2 to PIPELINE_MAX_DEPTH)
+ * @param[in] policy        Action when a frame is submitted while all frames are in flight:
+ *                          QUEUE_BLOCK waits, QUEUE_DROP_NEWEST drops the submitted frame and
+ *                          QUEUE_DROP_OLDEST drops the oldest frame no stage started
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType Pipeline_Start(Pipeline* pipeline, Save_Context* save, int depth, Queue_Policy policy);
+
+/**
+ * @brief   Passes a captured frame to the stage threads, or runs it on the calling thread if
+ *          none were started.
+ *
+ * @param[inout] pipeline   Compiled pipeline
+ * @param[inout] save       Save context of the sink without stage threads
+ * @param[in] img           YUV420 frame of the compiled size allocated with malloc
+ * @param[in] filename      Filename of the image
+ * @param[in] captured      Capture time in microseconds of CLOCK_MONOTONIC, 0 for now. Times
+ *                          more than a second away from now are taken as now.
+ *
+ * @return int  1 if the pipeline took the frame and releases it, 0 if the caller keeps it
+ *
+ */
+int Pipeline_Submit(Pipeline* pipeline, Save_Context* save, unsigned char* img, char* filename, int64_t captured);
+
+/**
+ * @brief   Processes the frames in flight and stops the stage threads.
+ *
+ * @param[inout] pipeline   Pipeline
+ *
+ */
+void Pipeline_Stop(Pipeline* pipeline);
+
+/**
+ * @brief   Prints queue depths, processing and waiting times of every stage. Can be called
+ *          while the stage threads run.
+ *
+ * @param[in] pipeline  Compiled pipeline
+ * @param[in] fp        File pointer
+ *
+ */
+void Pipeline_PrintStats(const Pipeline* pipeline, FILE* fp);
+
+/**
+ * @brief   Stops the stage threads and releases the buffers, remap tables and encoder of a
+ *          pipeline.
+ *
+ * @param[inout] pipeline   Pipeline to release
+ *
+ */
+void Pipeline_Free(Pipeline* pipeline);
+
+/** @} */
+
+#endif /** PIPELINE_H **/
+
+/*==============================[  End of File  ]======================================*/
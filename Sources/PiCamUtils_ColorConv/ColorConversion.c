@@ -7,6 +7,9 @@
  * @date 2022-03-21 Updates for saving BMP image
  * @date 2022-03-28 Rename and move to appropriate folder
  * @date 2022-04-03 Update color conversion functions for HSV
+ * @date 2026-10-18 Compute chroma row positions once per row
+ * @date 2026-10-19 Time conversions for the stage histograms
+ * @date 2026-10-19 Return errors of unsupported formats to the caller
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -22,6 +25,7 @@
 #include <math.h>
 #include "write.h"
 #include "ColorConversion.h"
+#include "Metrics.h"
 
 /*===========================[  Function definitions  ]===================================*/
 
@@ -35,7 +39,7 @@
  * Each Y goes to one of the pixels, and the Cb and Cr belong to both pixels. 
  * 
  */
-void Convert_YUV420toYUV444(int width, int height, unsigned char* src, unsigned char* dst) 
+Std_ReturnType Convert_YUV420toYUV444(int width, int height, unsigned char* src, unsigned char* dst) 
 {
     Std_ReturnType validate = E_OK;
 
@@ -49,30 +53,36 @@ void Convert_YUV420toYUV444(int width, int height, unsigned char* src, unsigned
         int row, column;
         int frame = width * height;
         int chroma_length = frame / 4;
+        int64_t start = Metrics_Begin();
         
 		for (row = 0; row < height ; row++ ) 
         {
+            unsigned char* src_y = src + row * width;
+            unsigned char* src_u = src + frame + (row >> 1) * (width >> 1);
+            unsigned char* src_v = src_u + chroma_length;
+
 			for (column = 0; column < width ; column++ ) 
             {
-				int pos = row * width + column;
-                int chroma_pos = ((int)(row/2) * (int)(width/2)) + (column/2);
-
                 /** Luminance value update */
-                *(dst++) = *(src + pos);
+                *(dst++) = *(src_y + column);
                 /** Chrominance values update */
-                *(dst++) = *(src + frame + chroma_pos);
-                *(dst++) = *(src + frame + chroma_length + chroma_pos);
+                *(dst++) = *(src_u + (column >> 1));
+                *(dst++) = *(src_v + (column >> 1));
 			}
 		}
+        Metrics_End(METRIC_CONVERT, start);
     }
     else
     {
-        errno_exit("YUV420 to YUV444 Conversion cannot be performed because of invalid input parameters\n");
+        fprintf(stderr, "YUV420 to YUV444 Conversion cannot be performed because of invalid input parameters\n");
+        return E_NOT_OK;
     }
+
+    return E_OK;
 }/* End of function Convert_YUV420toYUV444 */
 
 
-void Convert_YUV420toBMPRGB(int width, int height, unsigned char* src, unsigned char* dst) 
+Std_ReturnType Convert_YUV420toBMPRGB(int width, int height, unsigned char* src, unsigned char* dst) 
 {
     Std_ReturnType validate = E_OK;
 
@@ -91,16 +101,17 @@ void Convert_YUV420toBMPRGB(int width, int height, unsigned char* src, unsigned
         
 		for (row = height -1; row >= 0 ; row-- ) 
         {
+            unsigned char* src_y = src + row * width;
+            unsigned char* src_v = src + frame + (row >> 1) * (width >> 1);
+            unsigned char* src_u = src_v + chroma_length;
+
 			for (column = width -1; column >= 0 ; column-- ) 
             {
-				int pos = row * width + column;
-                int chroma_pos = ((int)(row/2) * (int)(width/2)) + (column/2);
-
                 /** Luminance value update */
-                pixel_Y = *(src + pos);
+                pixel_Y = *(src_y + column);
                 /** Chrominance values update */
-                pixel_V = *(src + frame + chroma_pos);
-                pixel_U = *(src + frame + chroma_length + chroma_pos);
+                pixel_V = *(src_v + (column >> 1));
+                pixel_U = *(src_u + (column >> 1));
 
                 /** Luminance value update */
                 *(dst++) = GETREDPIXEL_FROM_YUV(pixel_Y, pixel_V);  
@@ -112,11 +123,14 @@ void Convert_YUV420toBMPRGB(int width, int height, unsigned char* src, unsigned
     }
     else
     {
-        errno_exit("YUV420 to RGB Conversion cannot be performed because of invalid input parameters\n");
+        fprintf(stderr, "YUV420 to RGB Conversion cannot be performed because of invalid input parameters\n");
+        return E_NOT_OK;
     }
+
+    return E_OK;
 }/* End of function Convert_YUV420toBMPRGB */
 
-void Convert_YUV444toRGB444(int width, int height, unsigned char* src, unsigned char* dst) 
+Std_ReturnType Convert_YUV444toRGB444(int width, int height, unsigned char* src, unsigned char* dst) 
 {
     Std_ReturnType validate = E_OK;
 
@@ -155,12 +169,15 @@ void Convert_YUV444toRGB444(int width, int height, unsigned char* src, unsigned
     }
     else
     {
-        errno_exit("YUV420 to RGB Conversion cannot be performed because of invalid input parameters\n");
+        fprintf(stderr, "YUV420 to RGB Conversion cannot be performed because of invalid input parameters\n");
+        return E_NOT_OK;
     }
+
+    return E_OK;
 }/* End of function Convert_YUV444toRGB444 */
 
 /** TODO: Implementation is not correct. Redo whole function */
-void Convert_RGB444toHSV444(int width, int height, unsigned char* src, u_int16_t* dst)
+Std_ReturnType Convert_RGB444toHSV444(int width, int height, unsigned char* src, u_int16_t* dst)
 {
     Std_ReturnType validate = E_OK;
 
@@ -212,12 +229,15 @@ void Convert_RGB444toHSV444(int width, int height, unsigned char* src, u_int16_t
     }
     else
     {
-        errno_exit("YUV420 to RGB Conversion cannot be performed because of invalid input parameters\n");
+        fprintf(stderr, "YUV420 to RGB Conversion cannot be performed because of invalid input parameters\n");
+        return E_NOT_OK;
     }
+
+    return E_OK;
 }/* End of function Convert_RGB444toHSV444 */
 
 /** TODO: Implementation is not correct. Redo whole function */
-void Convert_HSV444toRGB444(int width, int height, u_int16_t* src, unsigned char* dst)
+Std_ReturnType Convert_HSV444toRGB444(int width, int height, u_int16_t* src, unsigned char* dst)
 {
     Std_ReturnType validate = E_OK;
 
@@ -291,8 +311,11 @@ void Convert_HSV444toRGB444(int width, int height, u_int16_t* src, unsigned char
     }
     else
     {
-        errno_exit("YUV420 to RGB Conversion cannot be performed because of invalid input parameters\n");
+        fprintf(stderr, "YUV420 to RGB Conversion cannot be performed because of invalid input parameters\n");
+        return E_NOT_OK;
     }
+
+    return E_OK;
 }/* End of function Convert_HSV444toRGB444 */
 
 /** @} */
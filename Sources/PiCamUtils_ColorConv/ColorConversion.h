@@ -7,6 +7,8 @@
  * @date 2022-03-21 Updates for saving BMP image
  * @date 2022-03-28 Rename and move to appropriate folder
  * @date 2022-04-03 Update color conversion functions for HSV
+ * @date 2026-10-18 Use fixed-point arithmetic for YUV to RGB macros
+ * @date 2026-10-19 Return errors of unsupported formats to the caller
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -30,20 +32,21 @@
  *  @{
  */
 
-/** Conversion from YUV color space to RGB \n
- *   r = y0 + ((357 * cr) >> 8) - 179;  \n
- *   g = y0 - (( 87 * cb) >> 8) +  44 - ((181 * cr) >> 8) + 91; \n
- *   b = y0 + ((450 * cb) >> 8) - 226;  \n
+/** Conversion from YUV color space to RGB for BT.601 limited range in Q8 fixed-point \n
+ *   r = (298 * (y - 16) + 409 * (cr - 128) + 128) >> 8;  \n
+ *   g = (298 * (y - 16) - 100 * (cb - 128) - 208 * (cr - 128) + 128) >> 8; \n
+ *   b = (298 * (y - 16) + 516 * (cb - 128) + 128) >> 8;  \n
+ *   Whole images are converted faster with Convert_YUVtoRGB in YUVtoRGB.h.
 */
 
 /** Return red pixel value from YUV */
-#define GETREDPIXEL_FROM_YUV(y,v)       (LIMITPIXEL( (int)(1.164*(y-16) + 1.596*(v-128))))
+#define GETREDPIXEL_FROM_YUV(y,v)       (LIMITPIXEL( ((298*((y)-16) + 409*((v)-128) + 128) >> 8) ))
 
-/** Return red pixel value from YUV */
-#define GETGREENPIXEL_FROM_YUV(y,u,v)   (LIMITPIXEL( (int)(1.164*(y-16) - 0.392*(u-128) -0.813*(v-128))))
+/** Return green pixel value from YUV */
+#define GETGREENPIXEL_FROM_YUV(y,u,v)   (LIMITPIXEL( ((298*((y)-16) - 100*((u)-128) - 208*((v)-128) + 128) >> 8) ))
 
-/** Return red pixel value from YUV */
-#define GETBLUEPIXEL_FROM_YUV(y, u)     (LIMITPIXEL( (int)(1.164*(y-16) + 2.017*(u-128))))
+/** Return blue pixel value from YUV */
+#define GETBLUEPIXEL_FROM_YUV(y, u)     (LIMITPIXEL( ((298*((y)-16) + 516*((u)-128) + 128) >> 8) ))
 
 /** @} */
 
@@ -61,8 +64,12 @@
  * @param[in] src       Pointer of source image to change format 
  * @param[inout] dst    Pointer of destination image to save the changed format
  * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Invalid input parameters
+ * 
  */
-void Convert_YUV420toYUV444(int width, int height, unsigned char* src, unsigned char* dst);
+Std_ReturnType Convert_YUV420toYUV444(int width, int height, unsigned char* src, unsigned char* dst);
 
 /**
  * @brief Converts YUV420 pixels to bitmap formatting for RGB colorspace.
@@ -72,8 +79,12 @@ void Convert_YUV420toYUV444(int width, int height, unsigned char* src, unsigned
  * @param[in] src       Pointer of source image to change format 
  * @param[inout] dst    Pointer of destination image to save the changed format
  * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Invalid input parameters
+ * 
  */
-void Convert_YUV420toBMPRGB(int width, int height, unsigned char* src, unsigned char* dst);
+Std_ReturnType Convert_YUV420toBMPRGB(int width, int height, unsigned char* src, unsigned char* dst);
 
 /**
  * @brief Convert image colorspace format from YUV420 to RGB444.
@@ -94,8 +105,12 @@ void Convert_YUV420toRGB444(int width, int height, unsigned char* src, unsigned
  * @param[in] src       Pointer of source image to change format 
  * @param[inout] dst    Pointer of destination image to save the changed format
  * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Invalid input parameters
+ * 
  */
-void Convert_YUV444toRGB444(int width, int height, unsigned char* src, unsigned char* dst);
+Std_ReturnType Convert_YUV444toRGB444(int width, int height, unsigned char* src, unsigned char* dst);
 
 /**
  * @brief Convert image colorspace format from YUV420 to RGB444.
@@ -105,8 +120,12 @@ void Convert_YUV444toRGB444(int width, int height, unsigned char* src, unsigned
  * @param[in] src       Pointer of source image to change format 
  * @param[inout] dst    Pointer of destination image to save the changed format
  * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Invalid input parameters
+ * 
  */
-void Convert_RGB444toHSV444(int width, int height, unsigned char* src, u_int16_t* dst);
+Std_ReturnType Convert_RGB444toHSV444(int width, int height, unsigned char* src, u_int16_t* dst);
 
 /**
  * @brief Convert image colorspace format from YUV420 to RGB444.
@@ -116,8 +135,12 @@ void Convert_RGB444toHSV444(int width, int height, unsigned char* src, u_int16_t
  * @param[in] src       Pointer of source image to change format 
  * @param[inout] dst    Pointer of destination image to save the changed format
  * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Invalid input parameters
+ * 
  */
-void Convert_HSV444toRGB444(int width, int height, u_int16_t* src, unsigned char* dst);
+Std_ReturnType Convert_HSV444toRGB444(int width, int height, u_int16_t* src, unsigned char* dst);
 
 /** @} */
 
@@ -0,0 +1,610 @@
+/**
+ * @file YUVtoRGB.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of fixed-point YUV to RGB conversion </b>
+ * @version
+ * @date 2026-10-18 Initial template for fixed-point SIMD YUV to RGB conversion
+ * @date 2026-10-19 Time conversions for the stage histograms
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "YUVtoRGB.h"
+#include "Metrics.h"
+
+#if PICAM_SIMD_NEON
+#include <arm_neon.h>
+#elif PICAM_SIMD_AVX2
+#include <immintrin.h>
+#elif PICAM_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup function_macros
+ *  @{
+ */
+
+/** Rounding constant added before removing fractional bits of coefficients */
+#define YUV_ROUND           (1 << (YUV_COEF_BITS - 1))
+
+/** Fixed-point sum of products to pixel value */
+#define YUV_TOPIXEL(x)      ((unsigned char)LIMITPIXEL(((x) + YUV_ROUND) >> YUV_COEF_BITS))
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to convert a single row of pixels with scalar arithmetic.
+ *
+ * @param[in] k         Conversion coefficients
+ * @param[in] src       Source image descriptor
+ * @param[in] row       Row index of source image
+ * @param[in] start     First column to convert
+ * @param[inout] dst    Pointer to destination row
+ * @param[in] format    Packed RGB format of destination
+ *
+ */
+static inline void Convert_RowScalar(const YUV_Coefficients* k, const Image_Planar* src, int row, int start, unsigned char* dst, Image_Format format);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @note Scalar arithmetic is identical to the SIMD paths so that the row tail matches the
+ *       vectorized part bit by bit.
+ *
+ */
+static inline void Convert_RowScalar(const YUV_Coefficients* k, const Image_Planar* src, int row, int start, unsigned char* dst, Image_Format format)
+{
+    const unsigned char* ys = src->plane[0] + (size_t)row * src->stride[0];
+    const unsigned char* us = NULL;
+    const unsigned char* vs = NULL;
+    int x;
+
+    if (PIXFMT_YUV420 == src->format)
+    {
+        us = src->plane[1] + (size_t)(row >> 1) * src->stride[1];
+        vs = src->plane[2] + (size_t)(row >> 1) * src->stride[2];
+    }
+    else if (PIXFMT_NV12 == src->format)
+    {
+        us = src->plane[1] + (size_t)(row >> 1) * src->stride[1];
+        vs = us + 1;
+    }
+
+    for (x = start; x < src->width; x++)
+    {
+        int y, u, v, luma, r, g, b;
+
+        if (PIXFMT_YUV420 == src->format)
+        {
+            y = ys[x];
+            u = us[x >> 1];
+            v = vs[x >> 1];
+        }
+        else if (PIXFMT_NV12 == src->format)
+        {
+            y = ys[x];
+            u = us[2 * (x >> 1)];
+            v = vs[2 * (x >> 1)];
+        }
+        else
+        {
+            y = ys[2 * x];
+            u = ys[4 * (x >> 1) + 1];
+            v = ys[4 * (x >> 1) + 3];
+        }
+
+        luma = k->y * (y - k->y_offset);
+        u -= 128;
+        v -= 128;
+        r = YUV_TOPIXEL(luma + k->rv * v);
+        g = YUV_TOPIXEL(luma + k->gu * u + k->gv * v);
+        b = YUV_TOPIXEL(luma + k->bu * u);
+
+        if (PIXFMT_BGR24 == format)
+        {
+            *(dst++) = b;
+            *(dst++) = g;
+            *(dst++) = r;
+        }
+        else
+        {
+            *(dst++) = r;
+            *(dst++) = g;
+            *(dst++) = b;
+            if (PIXFMT_RGBA == format)
+                *(dst++) = 255;
+        }
+    }
+}/* End of function Convert_RowScalar */
+
+#if PICAM_SIMD_NEON
+
+/**
+ * @brief   Loads 16 pixels of luminance and chrominance duplicated for each pixel.
+ *
+ */
+static inline void Load16_NEON(const Image_Planar* src, int row, int x, uint8x16_t* y, uint8x16_t* u, uint8x16_t* v)
+{
+    const unsigned char* ys = src->plane[0] + (size_t)row * src->stride[0];
+
+    if (PIXFMT_YUYV == src->format)
+    {
+        uint8x8x4_t px = vld4_u8(ys + 2 * x);
+        uint8x8x2_t yy = vzip_u8(px.val[0], px.val[2]);
+        uint8x8x2_t uu = vzip_u8(px.val[1], px.val[1]);
+        uint8x8x2_t vv = vzip_u8(px.val[3], px.val[3]);
+
+        *y = vcombine_u8(yy.val[0], yy.val[1]);
+        *u = vcombine_u8(uu.val[0], uu.val[1]);
+        *v = vcombine_u8(vv.val[0], vv.val[1]);
+    }
+    else
+    {
+        const unsigned char* cs = src->plane[1] + (size_t)(row >> 1) * src->stride[1];
+        uint8x8_t u8, v8;
+        uint8x8x2_t uu, vv;
+
+        if (PIXFMT_NV12 == src->format)
+        {
+            uint8x8x2_t uv = vld2_u8(cs + x);
+            u8 = uv.val[0];
+            v8 = uv.val[1];
+        }
+        else
+        {
+            u8 = vld1_u8(cs + (x >> 1));
+            v8 = vld1_u8(src->plane[2] + (size_t)(row >> 1) * src->stride[2] + (x >> 1));
+        }
+
+        uu = vzip_u8(u8, u8);
+        vv = vzip_u8(v8, v8);
+        *y = vld1q_u8(ys + x);
+        *u = vcombine_u8(uu.val[0], uu.val[1]);
+        *v = vcombine_u8(vv.val[0], vv.val[1]);
+    }
+}/* End of function Load16_NEON */
+
+/**
+ * @brief   Sum of products of two 8 lane vectors, rounded and narrowed to 16 bit.
+ *
+ */
+static inline int16x8_t Dot2_NEON(int16x8_t a, int16_t ca, int16x8_t b, int16_t cb)
+{
+    int32x4_t lo = vmull_n_s16(vget_low_s16(a), ca);
+    int32x4_t hi = vmull_n_s16(vget_high_s16(a), ca);
+
+    lo = vmlal_n_s16(lo, vget_low_s16(b), cb);
+    hi = vmlal_n_s16(hi, vget_high_s16(b), cb);
+
+    return vcombine_s16(vqrshrn_n_s32(lo, YUV_COEF_BITS), vqrshrn_n_s32(hi, YUV_COEF_BITS));
+}/* End of function Dot2_NEON */
+
+/**
+ * @brief   Sum of products of three 8 lane vectors, rounded and narrowed to 16 bit.
+ *
+ */
+static inline int16x8_t Dot3_NEON(int16x8_t a, int16_t ca, int16x8_t b, int16_t cb, int16x8_t c, int16_t cc)
+{
+    int32x4_t lo = vmull_n_s16(vget_low_s16(a), ca);
+    int32x4_t hi = vmull_n_s16(vget_high_s16(a), ca);
+
+    lo = vmlal_n_s16(lo, vget_low_s16(b), cb);
+    hi = vmlal_n_s16(hi, vget_high_s16(b), cb);
+    lo = vmlal_n_s16(lo, vget_low_s16(c), cc);
+    hi = vmlal_n_s16(hi, vget_high_s16(c), cc);
+
+    return vcombine_s16(vqrshrn_n_s32(lo, YUV_COEF_BITS), vqrshrn_n_s32(hi, YUV_COEF_BITS));
+}/* End of function Dot3_NEON */
+
+/**
+ * @brief   Converts and stores 16 pixels.
+ *
+ */
+static inline void Convert16_NEON(const YUV_Coefficients* k, uint8x16_t y8, uint8x16_t u8, uint8x16_t v8, unsigned char* dst, Image_Format format)
+{
+    const uint8x8_t yoff = vdup_n_u8((uint8_t)k->y_offset);
+    const uint8x8_t coff = vdup_n_u8(128);
+    int16x8_t y[2], u[2], v[2];
+    uint8x8_t r[2], g[2], b[2];
+    int half;
+
+    y[0] = vreinterpretq_s16_u16(vsubl_u8(vget_low_u8(y8), yoff));
+    y[1] = vreinterpretq_s16_u16(vsubl_u8(vget_high_u8(y8), yoff));
+    u[0] = vreinterpretq_s16_u16(vsubl_u8(vget_low_u8(u8), coff));
+    u[1] = vreinterpretq_s16_u16(vsubl_u8(vget_high_u8(u8), coff));
+    v[0] = vreinterpretq_s16_u16(vsubl_u8(vget_low_u8(v8), coff));
+    v[1] = vreinterpretq_s16_u16(vsubl_u8(vget_high_u8(v8), coff));
+
+    for (half = 0; half < 2; half++)
+    {
+        r[half] = vqmovun_s16(Dot2_NEON(y[half], k->y, v[half], k->rv));
+        g[half] = vqmovun_s16(Dot3_NEON(y[half], k->y, u[half], k->gu, v[half], k->gv));
+        b[half] = vqmovun_s16(Dot2_NEON(y[half], k->y, u[half], k->bu));
+    }
+
+    if (PIXFMT_RGBA == format)
+    {
+        uint8x16x4_t px;
+        px.val[0] = vcombine_u8(r[0], r[1]);
+        px.val[1] = vcombine_u8(g[0], g[1]);
+        px.val[2] = vcombine_u8(b[0], b[1]);
+        px.val[3] = vdupq_n_u8(255);
+        vst4q_u8(dst, px);
+    }
+    else
+    {
+        uint8x16x3_t px;
+        px.val[0] = (PIXFMT_BGR24 == format) ? vcombine_u8(b[0], b[1]) : vcombine_u8(r[0], r[1]);
+        px.val[1] = vcombine_u8(g[0], g[1]);
+        px.val[2] = (PIXFMT_BGR24 == format) ? vcombine_u8(r[0], r[1]) : vcombine_u8(b[0], b[1]);
+        vst3q_u8(dst, px);
+    }
+}/* End of function Convert16_NEON */
+
+#elif PICAM_SIMD_SSE2
+
+/**
+ * @brief   Loads 16 pixels of luminance and chrominance duplicated for each pixel.
+ *
+ */
+static inline void Load16_SSE2(const Image_Planar* src, int row, int x, __m128i* y, __m128i* u, __m128i* v)
+{
+    const __m128i mask = _mm_set1_epi16(0x00FF);
+    const unsigned char* ys = src->plane[0] + (size_t)row * src->stride[0];
+    __m128i u8, v8;
+
+    if (PIXFMT_YUYV == src->format)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(ys + 2 * x));
+        __m128i b = _mm_loadu_si128((const __m128i*)(ys + 2 * x + 16));
+        __m128i c = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+
+        *y = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+        u8 = _mm_packus_epi16(_mm_and_si128(c, mask), _mm_and_si128(c, mask));
+        v8 = _mm_packus_epi16(_mm_srli_epi16(c, 8), _mm_srli_epi16(c, 8));
+    }
+    else
+    {
+        const unsigned char* cs = src->plane[1] + (size_t)(row >> 1) * src->stride[1];
+
+        if (PIXFMT_NV12 == src->format)
+        {
+            __m128i uv = _mm_loadu_si128((const __m128i*)(cs + x));
+            u8 = _mm_packus_epi16(_mm_and_si128(uv, mask), _mm_and_si128(uv, mask));
+            v8 = _mm_packus_epi16(_mm_srli_epi16(uv, 8), _mm_srli_epi16(uv, 8));
+        }
+        else
+        {
+            u8 = _mm_loadl_epi64((const __m128i*)(cs + (x >> 1)));
+            v8 = _mm_loadl_epi64((const __m128i*)(src->plane[2] + (size_t)(row >> 1) * src->stride[2] + (x >> 1)));
+        }
+
+        *y = _mm_loadu_si128((const __m128i*)(ys + x));
+    }
+
+    *u = _mm_unpacklo_epi8(u8, u8);
+    *v = _mm_unpacklo_epi8(v8, v8);
+}/* End of function Load16_SSE2 */
+
+/**
+ * @brief   Interleaves and stores 16 pixels of red, green and blue channels.
+ *
+ */
+static inline void Store16_SSE2(__m128i r, __m128i g, __m128i b, unsigned char* dst, Image_Format format)
+{
+    const __m128i alpha = _mm_set1_epi8((char)0xFF);
+    __m128i rg_lo, rg_hi, ba_lo, ba_hi, px[4];
+
+    if (PIXFMT_BGR24 == format)
+    {
+        __m128i t = r;
+        r = b;
+        b = t;
+    }
+
+    rg_lo = _mm_unpacklo_epi8(r, g);
+    rg_hi = _mm_unpackhi_epi8(r, g);
+    ba_lo = _mm_unpacklo_epi8(b, alpha);
+    ba_hi = _mm_unpackhi_epi8(b, alpha);
+    px[0] = _mm_unpacklo_epi16(rg_lo, ba_lo);
+    px[1] = _mm_unpackhi_epi16(rg_lo, ba_lo);
+    px[2] = _mm_unpacklo_epi16(rg_hi, ba_hi);
+    px[3] = _mm_unpackhi_epi16(rg_hi, ba_hi);
+
+    if (PIXFMT_RGBA == format)
+    {
+        _mm_storeu_si128((__m128i*)dst, px[0]);
+        _mm_storeu_si128((__m128i*)(dst + 16), px[1]);
+        _mm_storeu_si128((__m128i*)(dst + 32), px[2]);
+        _mm_storeu_si128((__m128i*)(dst + 48), px[3]);
+    }
+    else
+    {
+        /** SSE2 has no byte shuffle, drop the alpha byte while copying out */
+        unsigned char tmp[64] __attribute__((aligned(16)));
+        int i;
+
+        _mm_store_si128((__m128i*)tmp, px[0]);
+        _mm_store_si128((__m128i*)(tmp + 16), px[1]);
+        _mm_store_si128((__m128i*)(tmp + 32), px[2]);
+        _mm_store_si128((__m128i*)(tmp + 48), px[3]);
+
+        for (i = 0; i < 16; i++)
+        {
+            dst[3*i] = tmp[4*i];
+            dst[3*i + 1] = tmp[4*i + 1];
+            dst[3*i + 2] = tmp[4*i + 2];
+        }
+    }
+}/* End of function Store16_SSE2 */
+
+#if PICAM_SIMD_AVX2
+
+/**
+ * @brief   Sum of products of 16 lane vectors. Unpack and pack operate within 128 bit lanes,
+ *          so the result keeps the pixel order of the inputs.
+ *
+ */
+static inline __m256i Dot_AVX2(__m256i a, __m256i b, __m256i cab, __m256i c, __m256i cc)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i rnd = _mm256_set1_epi32(YUV_ROUND);
+    __m256i lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), cab);
+    __m256i hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), cab);
+
+    lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(c, zero), cc));
+    hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(c, zero), cc));
+    lo = _mm256_srai_epi32(_mm256_add_epi32(lo, rnd), YUV_COEF_BITS);
+    hi = _mm256_srai_epi32(_mm256_add_epi32(hi, rnd), YUV_COEF_BITS);
+
+    return _mm256_packs_epi32(lo, hi);
+}/* End of function Dot_AVX2 */
+
+/**
+ * @brief   Saturates 16 lanes of 16 bit values to 16 bytes in pixel order.
+ *
+ */
+static inline __m128i Pack_AVX2(__m256i x)
+{
+    x = _mm256_packus_epi16(x, x);
+    x = _mm256_permute4x64_epi64(x, _MM_SHUFFLE(3, 1, 2, 0));
+
+    return _mm256_castsi256_si128(x);
+}/* End of function Pack_AVX2 */
+
+/**
+ * @brief   Converts 16 pixels to red, green and blue channels.
+ *
+ */
+static inline void Convert16_AVX2(const YUV_Coefficients* k, __m128i y8, __m128i u8, __m128i v8, __m128i* r, __m128i* g, __m128i* b)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i c_yv = _mm256_set1_epi32((int)(((unsigned)(unsigned short)k->rv << 16) | (unsigned short)k->y));
+    const __m256i c_yug = _mm256_set1_epi32((int)(((unsigned)(unsigned short)k->gu << 16) | (unsigned short)k->y));
+    const __m256i c_vg = _mm256_set1_epi32((unsigned short)k->gv);
+    const __m256i c_yub = _mm256_set1_epi32((int)(((unsigned)(unsigned short)k->bu << 16) | (unsigned short)k->y));
+    __m256i y = _mm256_sub_epi16(_mm256_cvtepu8_epi16(y8), _mm256_set1_epi16(k->y_offset));
+    __m256i u = _mm256_sub_epi16(_mm256_cvtepu8_epi16(u8), _mm256_set1_epi16(128));
+    __m256i v = _mm256_sub_epi16(_mm256_cvtepu8_epi16(v8), _mm256_set1_epi16(128));
+
+    *r = Pack_AVX2(Dot_AVX2(y, v, c_yv, zero, zero));
+    *g = Pack_AVX2(Dot_AVX2(y, u, c_yug, v, c_vg));
+    *b = Pack_AVX2(Dot_AVX2(y, u, c_yub, zero, zero));
+}/* End of function Convert16_AVX2 */
+
+#else
+
+/**
+ * @brief   Sum of products of 8 lane vectors, rounded and narrowed to 16 bit.
+ *
+ */
+static inline __m128i Dot_SSE2(__m128i a, __m128i b, __m128i cab, __m128i c, __m128i cc)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i rnd = _mm_set1_epi32(YUV_ROUND);
+    __m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(a, b), cab);
+    __m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(a, b), cab);
+
+    lo = _mm_add_epi32(lo, _mm_madd_epi16(_mm_unpacklo_epi16(c, zero), cc));
+    hi = _mm_add_epi32(hi, _mm_madd_epi16(_mm_unpackhi_epi16(c, zero), cc));
+    lo = _mm_srai_epi32(_mm_add_epi32(lo, rnd), YUV_COEF_BITS);
+    hi = _mm_srai_epi32(_mm_add_epi32(hi, rnd), YUV_COEF_BITS);
+
+    return _mm_packs_epi32(lo, hi);
+}/* End of function Dot_SSE2 */
+
+/**
+ * @brief   Converts 16 pixels to red, green and blue channels.
+ *
+ */
+static inline void Convert16_SSE2(const YUV_Coefficients* k, __m128i y8, __m128i u8, __m128i v8, __m128i* r, __m128i* g, __m128i* b)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i yoff = _mm_set1_epi16(k->y_offset);
+    const __m128i coff = _mm_set1_epi16(128);
+    const __m128i c_yv = _mm_set1_epi32((int)(((unsigned)(unsigned short)k->rv << 16) | (unsigned short)k->y));
+    const __m128i c_yug = _mm_set1_epi32((int)(((unsigned)(unsigned short)k->gu << 16) | (unsigned short)k->y));
+    const __m128i c_vg = _mm_set1_epi32((unsigned short)k->gv);
+    const __m128i c_yub = _mm_set1_epi32((int)(((unsigned)(unsigned short)k->bu << 16) | (unsigned short)k->y));
+    __m128i rr[2], gg[2], bb[2];
+    int half;
+
+    for (half = 0; half < 2; half++)
+    {
+        __m128i y = _mm_sub_epi16((0 == half) ? _mm_unpacklo_epi8(y8, zero) : _mm_unpackhi_epi8(y8, zero), yoff);
+        __m128i u = _mm_sub_epi16((0 == half) ? _mm_unpacklo_epi8(u8, zero) : _mm_unpackhi_epi8(u8, zero), coff);
+        __m128i v = _mm_sub_epi16((0 == half) ? _mm_unpacklo_epi8(v8, zero) : _mm_unpackhi_epi8(v8, zero), coff);
+
+        rr[half] = Dot_SSE2(y, v, c_yv, zero, zero);
+        gg[half] = Dot_SSE2(y, u, c_yug, v, c_vg);
+        bb[half] = Dot_SSE2(y, u, c_yub, zero, zero);
+    }
+
+    *r = _mm_packus_epi16(rr[0], rr[1]);
+    *g = _mm_packus_epi16(gg[0], gg[1]);
+    *b = _mm_packus_epi16(bb[0], bb[1]);
+}/* End of function Convert16_SSE2 */
+
+#endif /* PICAM_SIMD_AVX2 */
+
+#endif /* PICAM_SIMD_NEON */
+
+/**
+ * @brief   Helper function to convert a single row, vectorized part first and scalar tail.
+ *
+ * @param[in] k         Conversion coefficients
+ * @param[in] src       Source image descriptor
+ * @param[in] row       Row index of source image
+ * @param[inout] dst    Pointer to destination row
+ * @param[in] format    Packed RGB format of destination
+ *
+ */
+static inline void Convert_Row(const YUV_Coefficients* k, const Image_Planar* src, int row, unsigned char* dst, Image_Format format)
+{
+    const int bpp = (PIXFMT_RGBA == format) ? 4 : 3;
+    int x = 0;
+
+#if PICAM_SIMD_NEON
+    for (; x + 16 <= src->width; x += 16)
+    {
+        uint8x16_t y, u, v;
+        Load16_NEON(src, row, x, &y, &u, &v);
+        Convert16_NEON(k, y, u, v, dst + x * bpp, format);
+    }
+#elif PICAM_SIMD_AVX2
+    for (; x + 32 <= src->width; x += 32)
+    {
+        __m128i y0, u0, v0, y1, u1, v1, r, g, b;
+        Load16_SSE2(src, row, x, &y0, &u0, &v0);
+        Load16_SSE2(src, row, x + 16, &y1, &u1, &v1);
+        Convert16_AVX2(k, y0, u0, v0, &r, &g, &b);
+        Store16_SSE2(r, g, b, dst + x * bpp, format);
+        Convert16_AVX2(k, y1, u1, v1, &r, &g, &b);
+        Store16_SSE2(r, g, b, dst + (x + 16) * bpp, format);
+    }
+    for (; x + 16 <= src->width; x += 16)
+    {
+        __m128i y, u, v, r, g, b;
+        Load16_SSE2(src, row, x, &y, &u, &v);
+        Convert16_AVX2(k, y, u, v, &r, &g, &b);
+        Store16_SSE2(r, g, b, dst + x * bpp, format);
+    }
+#elif PICAM_SIMD_SSE2
+    for (; x + 16 <= src->width; x += 16)
+    {
+        __m128i y, u, v, r, g, b;
+        Load16_SSE2(src, row, x, &y, &u, &v);
+        Convert16_SSE2(k, y, u, v, &r, &g, &b);
+        Store16_SSE2(r, g, b, dst + x * bpp, format);
+    }
+#endif
+
+    Convert_RowScalar(k, src, row, x, dst + x * bpp, format);
+}/* End of function Convert_Row */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * Coefficients are derived from the luma weights Kr and Kb of the color matrix. Limited
+ * range expands luminance by 255/219 and chrominance by 255/224.
+ *
+ */
+void YUV_GetCoefficients(YUV_Matrix matrix, YUV_Coefficients* k)
+{
+    const double one = (double)(1 << YUV_COEF_BITS);
+    int bt709 = (YUV_BT709_LIMITED == matrix) || (YUV_BT709_FULL == matrix);
+    int limited = (YUV_BT601_LIMITED == matrix) || (YUV_BT709_LIMITED == matrix);
+    double kr = bt709 ? 0.2126 : 0.299;
+    double kb = bt709 ? 0.0722 : 0.114;
+    double kg = 1 - kr - kb;
+    double ys = limited ? 255.0 / 219.0 : 1.0;
+    double cs = limited ? 255.0 / 224.0 : 1.0;
+
+    k->y_offset = limited ? 16 : 0;
+    k->y = (short)lround(ys * one);
+    k->rv = (short)lround(2 * (1 - kr) * cs * one);
+    k->gu = (short)-lround(2 * kb * (1 - kb) / kg * cs * one);
+    k->gv = (short)-lround(2 * kr * (1 - kr) / kg * cs * one);
+    k->bu = (short)lround(2 * (1 - kb) * cs * one);
+}/* End of function YUV_GetCoefficients */
+
+
+/**
+ *
+ */
+Std_ReturnType Convert_YUVtoRGB(const Image_Planar* src, Image_Planar* dst, YUV_Matrix matrix)
+{
+    Std_ReturnType validate = E_OK;
+
+    validate += ValidateParam((void*)src);
+    validate += ValidateParam(dst);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateParam(src->plane[0]);
+        validate += ValidateParam(dst->plane[0]);
+        validate += ValidateImageSize(src->width, src->height);
+        validate += ((src->width == dst->width) && (src->height == dst->height)) ? E_OK : E_NOT_OK;
+        validate += ((PIXFMT_YUV420 == src->format) || (PIXFMT_NV12 == src->format) ||
+                     (PIXFMT_YUYV == src->format)) ? E_OK : E_NOT_OK;
+        validate += ((PIXFMT_RGB24 == dst->format) || (PIXFMT_BGR24 == dst->format) ||
+                     (PIXFMT_RGBA == dst->format)) ? E_OK : E_NOT_OK;
+        if ((PIXFMT_YUV420 == src->format) || (PIXFMT_NV12 == src->format))
+            validate += ValidateParam(src->plane[1]);
+        if (PIXFMT_YUV420 == src->format)
+            validate += ValidateParam(src->plane[2]);
+    }
+
+    if (E_OK == validate)
+    {
+        YUV_Coefficients k;
+        int row;
+        int64_t start = Metrics_Begin();
+
+        YUV_GetCoefficients(matrix, &k);
+
+        for (row = 0; row < src->height; row++)
+        {
+            Convert_Row(&k, src, row, dst->plane[0] + (size_t)row * dst->stride[0], dst->format);
+        }
+        Metrics_End(METRIC_CONVERT, start);
+    }
+    else
+    {
+        printf("Invalid input parameters provided.\n");
+    }
+
+    return validate;
+
+}/* End of function Convert_YUVtoRGB */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
@@ -0,0 +1,110 @@
+/**
+ * @file YUVtoRGB.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for fixed-point YUV to RGB conversion </b>
+ * @version
+ * @date 2026-10-18 Initial template for fixed-point SIMD YUV to RGB conversion
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef YUVTORGB_H
+#define  YUVTORGB_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include "Common_PiCam.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Number of fractional bits of fixed-point conversion coefficients. Q13 keeps the largest
+ *  coefficient (blue from U in BT.709 limited range) within a signed 16 bit value.
+ */
+#define YUV_COEF_BITS       (13)
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Enumeration of YUV color matrices and value ranges */
+typedef enum
+{
+    /** ITU-R BT.601, luminance 16 to 235 and chrominance 16 to 240 */
+    YUV_BT601_LIMITED,
+    /** ITU-R BT.601 (JFIF), full range 0 to 255 */
+    YUV_BT601_FULL,
+    /** ITU-R BT.709, luminance 16 to 235 and chrominance 16 to 240 */
+    YUV_BT709_LIMITED,
+    /** ITU-R BT.709, full range 0 to 255 */
+    YUV_BT709_FULL
+} YUV_Matrix;
+
+/** Fixed-point conversion coefficients with YUV_COEF_BITS fractional bits */
+typedef struct
+{
+    /** Luminance offset, 16 for limited range and 0 for full range */
+    short y_offset;
+    /** Luminance scale for all channels */
+    short y;
+    /** Red from V */
+    short rv;
+    /** Green from U */
+    short gu;
+    /** Green from V */
+    short gv;
+    /** Blue from U */
+    short bu;
+} YUV_Coefficients;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Computes fixed-point conversion coefficients for a color matrix and value range.
+ *
+ * @param[in] matrix    Color matrix and value range
+ * @param[out] k        Conversion coefficients
+ *
+ */
+void YUV_GetCoefficients(YUV_Matrix matrix, YUV_Coefficients* k);
+
+/**
+ * @brief   Converts a YUV420, NV12 or YUYV image to packed RGB24, BGR24 or RGBA using fixed-point
+ *          arithmetic. Rows are processed with SSE2, AVX2 or NEON where available, 16 to 32
+ *          pixels per iteration.
+ *
+ * @param[in] src       Source image descriptor
+ * @param[inout] dst    Destination image descriptor with same size as source
+ * @param[in] matrix    Color matrix and value range of source image
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType Convert_YUVtoRGB(const Image_Planar* src, Image_Planar* dst, YUV_Matrix matrix);
+
+/** @} */
+
+#endif /** YUVTORGB_H **/
+
+/*==============================[  End of File  ]======================================*/
@@ -7,6 +7,8 @@
  * @date 2022-04-02 Update scaling, resizing and flip operations
  * @date 2022-04-03 Update editing functions
  * @date 2022-04-05 Update editing functions for RGB colorspace
+ * @date 2026-10-18 Use point operation lookup tables for contrast transformations
+ * @date 2026-10-19 Initialize point operations by field name
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -23,6 +25,7 @@
 #include <stdlib.h>
 #include <math.h>
 #include "Edit.h"
+#include "PointOperations.h"
 
 /*===========================[ Global Variables  ]========================================*/
 
@@ -195,19 +198,12 @@ static inline void Interpolate_Scale(Interpolate_Positions inPos, unsigned char*
  */
 static inline void BLT(int width, int height, unsigned char* src, unsigned char* dst, float gain, float bias)
 {
-    int x, y, offset;
+    PointOp op = { .type = POINTOP_GAIN_BIAS, .channels = POINTOP_ALL_CHANNELS, .gain = gain, .bias = bias };
+    PointOp_LUT lut;
 
-    for (x = 0; x < height ; ++x)
-    {
-        for (y = 0; y < width ; ++y)
-        {
-            offset = 3*(x * width + y);         
-
-            *(dst + offset) = LIMITPIXEL(*(src + offset) * gain + bias);
-            *(dst + offset + 1) = LIMITPIXEL(*(src + offset +1) * gain + bias);
-            *(dst + offset + 2) = LIMITPIXEL(*(src + offset +2) * gain + bias);
-        }
-    }
+    /** Evaluate the transformation once per intensity level instead of once per pixel */
+    if (E_OK == PointOp_Compile(&lut, 3, &op, 1))
+        PointOp_Apply(&lut, width, height, src, dst);
 }
 
 /**
@@ -218,19 +214,12 @@ static inline void BLT(int width, int height, unsigned char* src, unsigned char*
  */
 static inline void TransformConstrast(int width, int height, unsigned char* src, unsigned char* dst, float ratio)
 {
-    int x, y, offset;
+    PointOp op = { .type = POINTOP_GAIN_BIAS, .channels = POINTOP_ALL_CHANNELS, .gain = ratio, .bias = 0 };
+    PointOp_LUT lut;
 
-    for (x = 0; x < height ; ++x)
-    {
-        for (y = 0; y < width ; ++y)
-        {
-            offset = 3*(x * width + y);         
-
-            *(dst + offset) = LIMITPIXEL((float)ratio * (*(src + offset)));
-            *(dst + offset + 1) = LIMITPIXEL((float)ratio * (*(src + offset + 1)));
-            *(dst + offset + 2) = LIMITPIXEL((float)ratio * (*(src + offset + 2)));
-        }
-    }    
+    /** Evaluate the transformation once per intensity level instead of once per pixel */
+    if (E_OK == PointOp_Compile(&lut, 3, &op, 1))
+        PointOp_Apply(&lut, width, height, src, dst);
 }
 
 /** @} */
@@ -0,0 +1,323 @@
+/**
+ * @file PointOperations.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of composable point operations using lookup tables </b>
+ * @version
+ * @date 2026-10-18 Initial template for point operation lookup tables
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "PointOperations.h"
+
+#if PICAM_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to evaluate a point operation on a single sample value.
+ *
+ * @param[in] op        Point operation to evaluate
+ * @param[in] value     Input sample value in range 0 to 255
+ *
+ * @return float    Output sample value limited to range 0 to 255
+ *
+ */
+static inline float Evaluate_PointOp(const PointOp* op, float value);
+
+/**
+ * @brief   Helper function to apply a single lookup table on a contiguous sample buffer.
+ *
+ * @param[in] table     Lookup table with 256 entries
+ * @param[in] length    Number of samples to transform
+ * @param[in] src       Pointer to source samples
+ * @param[inout] dst    Pointer to destination samples, may be same as src
+ *
+ */
+static inline void Lookup_Contiguous(const unsigned char* table, size_t length, const unsigned char* src, unsigned char* dst);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @note Output of every operation is limited to the pixel range so that the composed table
+ *       behaves the same as applying the operations one after another.
+ *
+ */
+static inline float Evaluate_PointOp(const PointOp* op, float value)
+{
+    float range;
+
+    switch (op->type)
+    {
+        case POINTOP_GAIN_BIAS:
+            value = value * op->gain + op->bias;
+            break;
+
+        case POINTOP_CONTRAST_PERCENT:
+            value = value * (float)(100 + op->percent) / 100;
+            break;
+
+        case POINTOP_GAMMA:
+            value = 255.0f * powf(value / 255.0f, 1.0f / op->gamma);
+            break;
+
+        case POINTOP_LEVELS:
+            range = (float)(op->in_white - op->in_black);
+            value = (value - op->in_black) / range;
+            value = (value < 0.0f) ? 0.0f : ((value > 1.0f) ? 1.0f : value);
+            value = powf(value, 1.0f / op->gamma);
+            value = op->out_black + value * (op->out_white - op->out_black);
+            break;
+
+        case POINTOP_CURVE:
+            value = op->curve[(int)(value + 0.5f)];
+            break;
+
+        default:
+            break;
+    }
+
+    return LIMITPIXEL(value);
+}/* End of function Evaluate_PointOp */
+
+#if PICAM_SIMD_NEON
+/**
+ * @brief   Looks up 16 samples in a 256 entry table using four 64 byte table lookups.
+ *          Indices out of range of a lookup leave the previous result untouched.
+ *
+ * @param[in] table     Lookup table with 256 entries
+ * @param[in] idx       Vector with 16 sample values
+ *
+ * @return uint8x16_t   Vector with 16 transformed samples
+ *
+ */
+static inline uint8x16_t Lookup_Neon(const unsigned char* table, uint8x16_t idx)
+{
+    uint8x16x4_t t0, t1, t2, t3;
+    uint8x16_t offset = vdupq_n_u8(64);
+    uint8x16_t result;
+    int i;
+
+    for (i = 0; i < 4; i++)
+    {
+        t0.val[i] = vld1q_u8(table + 16*i);
+        t1.val[i] = vld1q_u8(table + 64 + 16*i);
+        t2.val[i] = vld1q_u8(table + 128 + 16*i);
+        t3.val[i] = vld1q_u8(table + 192 + 16*i);
+    }
+
+    result = vqtbl4q_u8(t0, idx);
+    idx = vsubq_u8(idx, offset);
+    result = vqtbx4q_u8(result, t1, idx);
+    idx = vsubq_u8(idx, offset);
+    result = vqtbx4q_u8(result, t2, idx);
+    idx = vsubq_u8(idx, offset);
+    result = vqtbx4q_u8(result, t3, idx);
+
+    return result;
+}/* End of function Lookup_Neon */
+#endif
+
+/**
+ * @note This function assumes the provided pointers for table, src and dst are not a NULL_PTR.
+ * @warning NULL_PTR should not be passed to this function in place of table, src and dst, if
+ *          NULL_PTR is passed, the function doesnot have a sanity check and results in
+ *          segmentation faults.
+ *
+ */
+static inline void Lookup_Contiguous(const unsigned char* table, size_t length, const unsigned char* src, unsigned char* dst)
+{
+    size_t i = 0;
+
+#if PICAM_SIMD_NEON
+    for (; i + 16 <= length; i += 16)
+    {
+        vst1q_u8(dst + i, Lookup_Neon(table, vld1q_u8(src + i)));
+    }
+#endif
+
+    /** Table lookups are independent, unroll to keep loads in flight */
+    for (; i + 4 <= length; i += 4)
+    {
+        unsigned char p0 = table[src[i]];
+        unsigned char p1 = table[src[i + 1]];
+        unsigned char p2 = table[src[i + 2]];
+        unsigned char p3 = table[src[i + 3]];
+
+        dst[i] = p0;
+        dst[i + 1] = p1;
+        dst[i + 2] = p2;
+        dst[i + 3] = p3;
+    }
+
+    for (; i < length; i++)
+    {
+        dst[i] = table[src[i]];
+    }
+}/* End of function Lookup_Contiguous */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ *
+ */
+Std_ReturnType PointOp_Compile(PointOp_LUT* lut, int channels, const PointOp* ops, int count)
+{
+    Std_ReturnType validate = E_OK;
+    int op, channel, value;
+
+    validate += ValidateParam(lut);
+    validate += ValidateValue(channels, 1, POINTOP_MAX_CHANNELS);
+    validate += ValidateValue(count, 0, 64);
+    if (0 < count)
+        validate += ValidateParam((void*)ops);
+
+    for (op = 0; (E_OK == validate) && (op < count); op++)
+    {
+        if ((POINTOP_GAMMA == ops[op].type) || (POINTOP_LEVELS == ops[op].type))
+            validate += (0.0f < ops[op].gamma) ? E_OK : E_NOT_OK;
+        if (POINTOP_LEVELS == ops[op].type)
+            validate += (ops[op].in_white > ops[op].in_black) ? E_OK : E_NOT_OK;
+        if (POINTOP_CURVE == ops[op].type)
+            validate += ValidateParam((void*)ops[op].curve);
+    }
+
+    if (E_OK == validate)
+    {
+        float values[256];
+
+        lut->channels = channels;
+        lut->uniform = 1;
+
+        for (channel = 0; channel < channels; channel++)
+        {
+            for (value = 0; value < 256; value++)
+                values[value] = (float)value;
+
+            /** Compose operations in order, each one maps the output of the previous */
+            for (op = 0; op < count; op++)
+            {
+                if (0 == (ops[op].channels & (1u << channel)))
+                    continue;
+
+                for (value = 0; value < 256; value++)
+                    values[value] = Evaluate_PointOp(&ops[op], values[value]);
+            }
+
+            for (value = 0; value < 256; value++)
+                lut->table[channel][value] = (unsigned char)(values[value] + 0.5f);
+
+            if ((0 < channel) && (0 != memcmp(lut->table[channel], lut->table[0], 256)))
+                lut->uniform = 0;
+        }
+    }
+    else
+    {
+        printf("Invalid input parameters provided.\n");
+    }
+
+    return validate;
+
+}/* End of function PointOp_Compile */
+
+
+/**
+ *
+ */
+Std_ReturnType PointOp_Apply(const PointOp_LUT* lut, int width, int height, const unsigned char* src, unsigned char* dst)
+{
+    Std_ReturnType validate = E_OK;
+
+    validate += ValidateParam((void*)lut);
+    validate += ValidateParam((void*)src);
+    validate += ValidateParam(dst);
+    validate += ValidateImageSize(width, height);
+
+    if (E_OK == validate)
+    {
+        size_t pixels = (size_t)width * height;
+        size_t i = 0;
+        int c;
+
+        if ((1 == lut->channels) || (0 != lut->uniform))
+        {
+            /** Same table for all samples, treat the image as a flat sample buffer */
+            Lookup_Contiguous(lut->table[0], pixels * lut->channels, src, dst);
+        }
+        else
+        {
+#if PICAM_SIMD_NEON
+            if (3 == lut->channels)
+            {
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    uint8x16x3_t px = vld3q_u8(src + 3*i);
+                    px.val[0] = Lookup_Neon(lut->table[0], px.val[0]);
+                    px.val[1] = Lookup_Neon(lut->table[1], px.val[1]);
+                    px.val[2] = Lookup_Neon(lut->table[2], px.val[2]);
+                    vst3q_u8(dst + 3*i, px);
+                }
+            }
+            else if (4 == lut->channels)
+            {
+                for (; i + 16 <= pixels; i += 16)
+                {
+                    uint8x16x4_t px = vld4q_u8(src + 4*i);
+                    px.val[0] = Lookup_Neon(lut->table[0], px.val[0]);
+                    px.val[1] = Lookup_Neon(lut->table[1], px.val[1]);
+                    px.val[2] = Lookup_Neon(lut->table[2], px.val[2]);
+                    px.val[3] = Lookup_Neon(lut->table[3], px.val[3]);
+                    vst4q_u8(dst + 4*i, px);
+                }
+            }
+#endif
+            for (; i < pixels; i++)
+            {
+                for (c = 0; c < lut->channels; c++)
+                {
+                    dst[i*lut->channels + c] = lut->table[c][src[i*lut->channels + c]];
+                }
+            }
+        }
+    }
+    else
+    {
+        printf("Invalid input parameters provided.\n");
+    }
+
+    return validate;
+
+}/* End of function PointOp_Apply */
+
+/** @} */
+
+/*==============================[  End of File  ]========================================*/
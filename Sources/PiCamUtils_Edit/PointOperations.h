@@ -0,0 +1,145 @@
+/**
+ * @file PointOperations.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for composable point operations using lookup tables </b>
+ * @version
+ * @date 2026-10-18 Initial template for point operation lookup tables
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]========================================*/
+
+#ifndef POINTOPERATIONS_H
+#define  POINTOPERATIONS_H
+
+/*===========================[  Inclusions  ]===========================================*/
+
+#include "Common_PiCam.h"
+
+/*============================[  Defines  ]=============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Maximum number of interleaved channels supported by a point operation table */
+#define POINTOP_MAX_CHANNELS    (4)
+
+/** Channel mask to apply a point operation to every channel */
+#define POINTOP_ALL_CHANNELS    (0x0Fu)
+
+/** @} */
+
+/*============================[  Data Types  ]==========================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Enumeration of supported point operations */
+typedef enum
+{
+    /** Basic linear transformation, out = gain * in + bias */
+    POINTOP_GAIN_BIAS,
+    /** Percentage contrast increment, out = in * (100 + percent) / 100 */
+    POINTOP_CONTRAST_PERCENT,
+    /** Gamma correction, out = 255 * (in / 255) ^ (1 / gamma) */
+    POINTOP_GAMMA,
+    /** Input/output levels with mid-tone gamma */
+    POINTOP_LEVELS,
+    /** Custom tone curve with 256 entries */
+    POINTOP_CURVE
+} PointOp_Type;
+
+/** Structure describing a single point operation of an adjustment sequence. Only the
+ *  fields relevant for the selected type are evaluated.
+ */
+typedef struct
+{
+    /** Type of point operation */
+    PointOp_Type type;
+    /** Bit mask of interleaved channels the operation is applied to */
+    unsigned int channels;
+    /** Gain for POINTOP_GAIN_BIAS */
+    float gain;
+    /** Bias for POINTOP_GAIN_BIAS */
+    float bias;
+    /** Percent for POINTOP_CONTRAST_PERCENT */
+    int percent;
+    /** Gamma for POINTOP_GAMMA and mid-tone gamma for POINTOP_LEVELS */
+    float gamma;
+    /** Input black point for POINTOP_LEVELS */
+    int in_black;
+    /** Input white point for POINTOP_LEVELS */
+    int in_white;
+    /** Output black point for POINTOP_LEVELS */
+    int out_black;
+    /** Output white point for POINTOP_LEVELS */
+    int out_white;
+    /** Pointer to 256 entry tone curve for POINTOP_CURVE */
+    const unsigned char* curve;
+} PointOp;
+
+/** Compiled lookup table of a sequence of point operations, one table per channel */
+typedef struct
+{
+    /** Number of interleaved channels in the image */
+    int channels;
+    /** Set if all channels share the same table */
+    int uniform;
+    /** Lookup tables for each channel */
+    unsigned char table[POINTOP_MAX_CHANNELS][256];
+} PointOp_LUT;
+
+/** @} */
+
+/*===========================[  Function declarations  ]================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Compiles a sequence of point operations into a single lookup table per channel.
+ *          Operations are composed in the order provided, intermediate values are kept in
+ *          floating point and limited to the pixel range after each operation.
+ *
+ * @param[inout] lut    Lookup table to compile
+ * @param[in] channels  Number of interleaved channels of the images to transform (1 to 4)
+ * @param[in] ops       Array of point operations
+ * @param[in] count     Number of point operations in ops, 0 compiles an identity table
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType PointOp_Compile(PointOp_LUT* lut, int channels, const PointOp* ops, int count);
+
+/**
+ * @brief   Applies a compiled lookup table on an interleaved image in a single pass. Source and
+ *          destination may point to the same buffer for in-place operation.
+ *
+ * @param[in] lut       Compiled lookup table
+ * @param[in] width     Width of source image
+ * @param[in] height    Height of source image
+ * @param[in] src       Pointer to starting pixel position of source image
+ * @param[inout] dst    Pointer to starting pixel position of destination image
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType PointOp_Apply(const PointOp_LUT* lut, int width, int height, const unsigned char* src, unsigned char* dst);
+
+/** @} */
+
+#endif /* POINTOPERATIONS_H */
+
+/*==============================[  End of File  ]======================================*/
@@ -0,0 +1,159 @@
+/**
+ * @file Pyramid.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of image pyramids of successively halved images </b>
+ * @version
+ * @date 2026-10-18 Initial template for image pyramids
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Pyramid.h"
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to halve a plane with a 2x2 box filter.
+ *
+ * @param[in] src           Source plane
+ * @param[in] src_stride    Bytes between rows of the source plane
+ * @param[out] dst          Destination plane
+ * @param[in] dst_stride    Bytes between rows of the destination plane
+ * @param[in] width         Width of the destination plane
+ * @param[in] height        Height of the destination plane
+ *
+ */
+static inline void Pyramid_Halve(const unsigned char* src, int src_stride, unsigned char* dst, int dst_stride, int width, int height);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** Rounded average of each 2x2 block. The inner loop has no dependencies between pixels, so
+ * the compiler vectorizes it.
+ */
+static inline void Pyramid_Halve(const unsigned char* src, int src_stride, unsigned char* dst, int dst_stride, int width, int height)
+{
+    int x, y;
+
+    for (y = 0; y < height; y++)
+    {
+        const unsigned char* a = src + (size_t)(2 * y) * src_stride;
+        const unsigned char* b = a + src_stride;
+        unsigned char* d = dst + (size_t)y * dst_stride;
+
+        for (x = 0; x < width; x++)
+            d[x] = (unsigned char)((a[2 * x] + a[2 * x + 1] + b[2 * x] + b[2 * x + 1] + 2) >> 2);
+    }
+
+}/* End of function Pyramid_Halve */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** Levels are laid out one after another without row padding. The buffer only grows, so
+ * frames of constant size reuse it without allocations.
+ */
+Std_ReturnType Pyramid_Build(Pyramid* pyramid, const Image_Planar* src, int levels)
+{
+    Std_ReturnType validate = E_OK;
+    const Image_Planar* parent = src;
+    size_t size = 0;
+    unsigned char* pos;
+    int planes, w, h, count, l, p;
+
+    validate += ValidateParam(pyramid);
+    validate += ValidateParam((void*)src);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateParam(src->plane[0]);
+        validate += ValidateValue(levels, 1, PYRAMID_MAX_LEVELS);
+        validate += ((PIXFMT_YUV420 == src->format) || (PIXFMT_GRAY == src->format)) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    planes = (PIXFMT_YUV420 == src->format) ? 3 : 1;
+    w = src->width;
+    h = src->height;
+
+    for (count = 0; count < levels; count++)
+    {
+        w = (w / 2) & ~1;
+        h = (h / 2) & ~1;
+        if (w < 2 || h < 2)
+            break;
+        size += Image_SetPlanar(&pyramid->level[count], src->format, w, h, NULL);
+    }
+
+    if (pyramid->capacity < size)
+    {
+        unsigned char* buffer = realloc(pyramid->buffer, size);
+        if (NULL == buffer)
+            return E_NOT_OK;
+        pyramid->buffer = buffer;
+        pyramid->capacity = size;
+    }
+
+    pos = pyramid->buffer;
+    for (l = 0; l < count; l++)
+    {
+        Image_Planar* level = &pyramid->level[l];
+
+        pos += Image_SetPlanar(level, src->format, level->width, level->height, pos);
+
+        for (p = 0; p < planes; p++)
+        {
+            int shift = (p > 0) ? 1 : 0;
+            Pyramid_Halve(parent->plane[p], parent->stride[p], level->plane[p], level->stride[p],
+                level->width >> shift, level->height >> shift);
+        }
+
+        parent = level;
+    }
+
+    pyramid->levels = count;
+
+    return E_OK;
+
+}/* End of function Pyramid_Build */
+
+/** Frees the buffer, the pyramid can be built again afterwards.
+ */
+void Pyramid_Free(Pyramid* pyramid)
+{
+    free(pyramid->buffer);
+    pyramid->buffer = NULL;
+    pyramid->capacity = 0;
+    pyramid->levels = 0;
+
+}/* End of function Pyramid_Free */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
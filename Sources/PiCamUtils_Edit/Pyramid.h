@@ -0,0 +1,93 @@
+/**
+ * @file Pyramid.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for image pyramids of successively halved images </b>
+ * @version
+ * @date 2026-10-18 Initial template for image pyramids
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]========================================*/
+
+#ifndef PYRAMID_H
+#define  PYRAMID_H
+
+/*===========================[  Inclusions  ]===========================================*/
+
+#include <stddef.h>
+#include "Common_PiCam.h"
+
+/*============================[  Defines  ]=============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Maximum number of levels below the source image, down to 1/16 */
+#define PYRAMID_MAX_LEVELS      (4)
+
+/** @} */
+
+/*============================[  Data Types  ]==========================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Successively halved copies of an image. Level n is 1/2^(n+1) of the source in both
+ *  directions. All levels share one buffer which is kept across frames.
+ */
+typedef struct
+{
+    /** Number of valid levels */
+    int levels;
+    /** Image descriptors of the levels */
+    Image_Planar level[PYRAMID_MAX_LEVELS];
+    /** Buffer holding all levels */
+    unsigned char* buffer;
+    /** Allocated size of the buffer in bytes */
+    size_t capacity;
+} Pyramid;
+
+/** @} */
+
+/*===========================[  Function declarations  ]================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Computes levels of a YUV420 or GRAY image. Every level is computed from the one
+ *          above it, widths and heights are rounded down to even numbers. Computation stops
+ *          early if a level would be smaller than 2x2 pixels.
+ *
+ * @param[inout] pyramid    Pyramid, zero initialized before the first call
+ * @param[in] src           Source image
+ * @param[in] levels        Number of levels to compute (1 to PYRAMID_MAX_LEVELS)
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType Pyramid_Build(Pyramid* pyramid, const Image_Planar* src, int levels);
+
+/**
+ * @brief   Releases the buffer of a pyramid.
+ *
+ * @param[inout] pyramid    Pyramid to release
+ *
+ */
+void Pyramid_Free(Pyramid* pyramid);
+
+/** @} */
+
+#endif /** PYRAMID_H **/
+
+/*==============================[  End of File  ]======================================*/
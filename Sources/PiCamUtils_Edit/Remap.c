@@ -0,0 +1,461 @@
+/**
+ * @file Remap.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of geometric correction using precomputed remap tables </b>
+ * @version
+ * @date 2026-10-18 Initial template for lens distortion correction and warps
+ * @date 2026-10-19 Keep the thread entry of bands private
+ * @date 2026-10-19 Keep private helpers out of the header
+ * @date 2026-10-19 Worker threads block the signals of the application
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "Remap.h"
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Thread entry to apply a remap table on a band of rows.
+ *
+ * @param[in] arg   Pointer to Remap_Job
+ *
+ * @return void*    Always NULL
+ *
+ */
+static void* Remap_Worker(void* arg);
+
+/**
+ * @brief   Helper function to evaluate source position of a destination position.
+ *
+ * @param[in] tf        Geometric transformation
+ * @param[in] x         Destination position along x axis
+ * @param[in] y         Destination position along y axis
+ * @param[out] sx       Source position along x axis
+ * @param[out] sy       Source position along y axis
+ *
+ */
+static inline void Evaluate_Transform(const Remap_Transform* tf, double x, double y, double* sx, double* sy);
+
+/**
+ * @brief   Helper function to compile coordinate map of a single plane. The plane is scaled by
+ *          the subsampling factor with respect to the image the transformation is defined on.
+ *
+ * @param[inout] map        Coordinate map to compile
+ * @param[in] width         Width of the plane
+ * @param[in] height        Height of the plane
+ * @param[in] shift         Grid spacing as power of two
+ * @param[in] subsample     Subsampling factor of the plane, 1 for luminance and 2 for YUV420 chroma
+ * @param[in] tf            Geometric transformation
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType Build_Map(Remap_Map* map, int width, int height, int shift, int subsample, const Remap_Transform* tf);
+
+/**
+ * @brief   Helper function to resample a band of rows of a plane with bilinear interpolation.
+ *
+ * @param[in] map       Coordinate map of the plane
+ * @param[in] channels  Number of interleaved channels
+ * @param[in] src       Pointer to source plane
+ * @param[inout] dst    Pointer to destination plane
+ * @param[in] row_start First row of the band
+ * @param[in] row_end   Row after the last row of the band
+ * @param[in] fill      Sample value for positions outside the source plane
+ *
+ */
+static inline void Remap_Rows(const Remap_Map* map, int channels, const unsigned char* src, unsigned char* dst, int row_start, int row_end, unsigned char fill);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @note Lens model maps undistorted destination positions to distorted source positions, the
+ *       same direction as used for building undistortion maps in common calibration tools.
+ *
+ */
+static inline void Evaluate_Transform(const Remap_Transform* tf, double x, double y, double* sx, double* sy)
+{
+    if (REMAP_LENS == tf->type)
+    {
+        double zoom = (0 < tf->zoom) ? tf->zoom : 1.0;
+        double xn = (x - tf->cx) / (tf->fx * zoom);
+        double yn = (y - tf->cy) / (tf->fy * zoom);
+        double r2 = xn*xn + yn*yn;
+        double radial = 1 + r2*(tf->k1 + r2*(tf->k2 + r2*tf->k3));
+        double xd = xn*radial + 2*tf->p1*xn*yn + tf->p2*(r2 + 2*xn*xn);
+        double yd = yn*radial + tf->p1*(r2 + 2*yn*yn) + 2*tf->p2*xn*yn;
+
+        *sx = tf->fx * xd + tf->cx;
+        *sy = tf->fy * yd + tf->cy;
+    }
+    else
+    {
+        double w = tf->matrix[2][0]*x + tf->matrix[2][1]*y + tf->matrix[2][2];
+
+        /** Points on the horizon line are mapped far outside of the source image */
+        if (fabs(w) < 1e-12)
+            w = 1e-12;
+
+        *sx = (tf->matrix[0][0]*x + tf->matrix[0][1]*y + tf->matrix[0][2]) / w;
+        *sy = (tf->matrix[1][0]*x + tf->matrix[1][1]*y + tf->matrix[1][2]) / w;
+    }
+}/* End of function Evaluate_Transform */
+
+/**
+ * @note Grid spans one node beyond the last pixel so that interpolation never needs a
+ *       bounds check. Coordinates are limited to the range of the fixed-point format.
+ *
+ */
+static inline Std_ReturnType Build_Map(Remap_Map* map, int width, int height, int shift, int subsample, const Remap_Transform* tf)
+{
+    Std_ReturnType lreturn = E_NOT_OK;
+    const double limit = 32767.0;
+    int gx, gy;
+
+    map->width = width;
+    map->height = height;
+    map->shift = shift;
+    map->grid_width = ((width - 1) >> shift) + 2;
+    map->grid_height = ((height - 1) >> shift) + 2;
+    map->grid = malloc(2 * sizeof(int32_t) * map->grid_width * map->grid_height);
+
+    if (NULL != map->grid)
+    {
+        int32_t* node = map->grid;
+
+        for (gy = 0; gy < map->grid_height; gy++)
+        {
+            for (gx = 0; gx < map->grid_width; gx++)
+            {
+                double x = (double)(gx << shift);
+                double y = (double)(gy << shift);
+                double sx, sy;
+
+                /** Subsampled planes are evaluated at the sample center in full resolution */
+                x = subsample * x + 0.5 * (subsample - 1);
+                y = subsample * y + 0.5 * (subsample - 1);
+                Evaluate_Transform(tf, x, y, &sx, &sy);
+                sx = (sx - 0.5 * (subsample - 1)) / subsample;
+                sy = (sy - 0.5 * (subsample - 1)) / subsample;
+
+                sx = (sx > limit) ? limit : ((sx < -limit) ? -limit : sx);
+                sy = (sy > limit) ? limit : ((sy < -limit) ? -limit : sy);
+                *(node++) = (int32_t)lround(sx * (1 << REMAP_FRAC_BITS));
+                *(node++) = (int32_t)lround(sy * (1 << REMAP_FRAC_BITS));
+            }
+        }
+
+        lreturn = E_OK;
+    }
+
+    return lreturn;
+}/* End of function Build_Map */
+
+/**
+ * @note This function assumes the provided pointers for map, src and dst are not a NULL_PTR.
+ * @warning NULL_PTR should not be passed to this function in place of map, src and dst, if
+ *          NULL_PTR is passed, the function doesnot have a sanity check and results in
+ *          segmentation faults.
+ *
+ */
+static inline void Remap_Rows(const Remap_Map* map, int channels, const unsigned char* src, unsigned char* dst, int row_start, int row_end, unsigned char fill)
+{
+    const int64_t max_x = (int64_t)(map->width - 1) << REMAP_FRAC_BITS;
+    const int64_t max_y = (int64_t)(map->height - 1) << REMAP_FRAC_BITS;
+    const int step_mask = (1 << map->shift) - 1;
+    const int stride = map->width * channels;
+    int x, y, c;
+
+    for (y = row_start; y < row_end; y++)
+    {
+        const int32_t* top = map->grid + 2 * (y >> map->shift) * map->grid_width;
+        const int32_t* bottom = top + 2 * map->grid_width;
+        const int64_t wy_grid = y & step_mask;
+        unsigned char* out = dst + (size_t)y * stride;
+
+        for (x = 0; x < map->width; x++)
+        {
+            const int gx = 2 * (x >> map->shift);
+            const int64_t wx_grid = x & step_mask;
+            int64_t sx0, sy0, sx1, sy1, sx, sy;
+
+            /** Interpolate source position between the four surrounding grid nodes */
+            sx0 = top[gx] + (((bottom[gx] - (int64_t)top[gx]) * wy_grid) >> map->shift);
+            sy0 = top[gx + 1] + (((bottom[gx + 1] - (int64_t)top[gx + 1]) * wy_grid) >> map->shift);
+            sx1 = top[gx + 2] + (((bottom[gx + 2] - (int64_t)top[gx + 2]) * wy_grid) >> map->shift);
+            sy1 = top[gx + 3] + (((bottom[gx + 3] - (int64_t)top[gx + 3]) * wy_grid) >> map->shift);
+            sx = sx0 + (((sx1 - sx0) * wx_grid) >> map->shift);
+            sy = sy0 + (((sy1 - sy0) * wx_grid) >> map->shift);
+
+            if (sx < 0 || sy < 0 || sx > max_x || sy > max_y)
+            {
+                for (c = 0; c < channels; c++)
+                    *(out++) = fill;
+            }
+            else
+            {
+                const int xi = (int)(sx >> REMAP_FRAC_BITS);
+                const int yi = (int)(sy >> REMAP_FRAC_BITS);
+                const int wx = (int)(sx >> (REMAP_FRAC_BITS - 8)) & 0xFF;
+                const int wy = (int)(sy >> (REMAP_FRAC_BITS - 8)) & 0xFF;
+                const int dx = (xi + 1 < map->width) ? channels : 0;
+                const int dy = (yi + 1 < map->height) ? stride : 0;
+                const unsigned char* p = src + (size_t)yi * stride + xi * channels;
+
+                /** Bilinear interpolation with 8 bit weights */
+                for (c = 0; c < channels; c++, p++)
+                {
+                    int upper = p[0] * (256 - wx) + p[dx] * wx;
+                    int lower = p[dy] * (256 - wx) + p[dy + dx] * wx;
+                    *(out++) = (unsigned char)((upper * (256 - wy) + lower * wy + 32768) >> 16);
+                }
+            }
+        }
+    }
+}/* End of function Remap_Rows */
+
+/**
+ * @note Each band covers the same fraction of rows in luminance and chrominance planes.
+ *
+ */
+static void* Remap_Worker(void* arg)
+{
+    const Remap_Job* job = (const Remap_Job*)arg;
+    const Remap_Table* table = job->table;
+    const int threads = table->threads;
+    const Remap_Map* luma = &table->luma;
+    int start = (luma->height * job->band) / threads;
+    int end = (luma->height * (job->band + 1)) / threads;
+
+    Thread_BlockSignals();
+
+    if (0 == job->channels)
+    {
+        const Remap_Map* chroma = &table->chroma;
+        size_t luma_size = (size_t)luma->width * luma->height;
+        size_t chroma_size = (size_t)chroma->width * chroma->height;
+        int chroma_start = (chroma->height * job->band) / threads;
+        int chroma_end = (chroma->height * (job->band + 1)) / threads;
+
+        Remap_Rows(luma, 1, job->src, job->dst, start, end, 0);
+        Remap_Rows(chroma, 1, job->src + luma_size, job->dst + luma_size, chroma_start, chroma_end, 128);
+        Remap_Rows(chroma, 1, job->src + luma_size + chroma_size, job->dst + luma_size + chroma_size,
+                   chroma_start, chroma_end, 128);
+    }
+    else
+    {
+        Remap_Rows(luma, job->channels, job->src, job->dst, start, end, 0);
+    }
+
+    return NULL;
+}/* End of function Remap_Worker */
+
+/**
+ * @brief   Helper function to split the remap into bands and process them on worker threads.
+ *          The calling thread processes the first band.
+ *
+ * @param[in] table     Compiled remap table
+ * @param[in] channels  Number of interleaved channels, 0 for YUV420 planar images
+ * @param[in] src       Pointer to source image
+ * @param[inout] dst    Pointer to destination image
+ *
+ */
+static inline void Run_Bands(const Remap_Table* table, int channels, const unsigned char* src, unsigned char* dst)
+{
+    pthread_t workers[REMAP_MAX_THREADS];
+    int started[REMAP_MAX_THREADS];
+    Remap_Job jobs[REMAP_MAX_THREADS];
+    int band;
+
+    for (band = 0; band < table->threads; band++)
+    {
+        jobs[band].table = table;
+        jobs[band].channels = channels;
+        jobs[band].src = src;
+        jobs[band].dst = dst;
+        jobs[band].band = band;
+        started[band] = 0;
+    }
+
+    for (band = 1; band < table->threads; band++)
+        started[band] = (0 == pthread_create(&workers[band], NULL, Remap_Worker, &jobs[band]));
+
+    Remap_Worker(&jobs[0]);
+
+    for (band = 1; band < table->threads; band++)
+    {
+        /** Process the band on calling thread if the worker could not be started */
+        if (started[band])
+            pthread_join(workers[band], NULL);
+        else
+            Remap_Worker(&jobs[band]);
+    }
+}/* End of function Run_Bands */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ *
+ */
+void Remap_SetRotation(Remap_Transform* tf, int width, int height, double angle)
+{
+    double rad = angle * (double) M_PI / 180;
+    double c = cos(rad);
+    double s = sin(rad);
+    double hc = width / 2;
+    double vc = height / 2;
+
+    if (NULL != tf)
+    {
+        memset(tf, 0, sizeof(*tf));
+        tf->type = REMAP_PERSPECTIVE;
+        tf->matrix[0][0] = c;
+        tf->matrix[0][1] = s;
+        tf->matrix[0][2] = hc - c*hc - s*vc;
+        tf->matrix[1][0] = -s;
+        tf->matrix[1][1] = c;
+        tf->matrix[1][2] = vc + s*hc - c*vc;
+        tf->matrix[2][2] = 1;
+    }
+}/* End of function Remap_SetRotation */
+
+
+/**
+ *
+ */
+Std_ReturnType Remap_Create(Remap_Table* table, int width, int height, const Remap_Transform* tf, int shift, int threads)
+{
+    Std_ReturnType validate = E_OK;
+
+    validate += ValidateParam(table);
+    validate += ValidateParam((void*)tf);
+    validate += ValidateImageSize(width, height);
+    validate += ValidateValue(shift, 0, REMAP_MAX_SHIFT);
+    validate += ValidateValue(threads, 1, REMAP_MAX_THREADS);
+
+    if (E_OK == validate)
+    {
+        memset(table, 0, sizeof(*table));
+        table->threads = threads;
+
+        validate += Build_Map(&table->luma, width, height, shift, 1, tf);
+        validate += Build_Map(&table->chroma, width / 2, height / 2, (0 < shift) ? shift - 1 : 0, 2, tf);
+
+        if (E_OK != validate)
+        {
+            printf("Out of memory for remap table.\n");
+            Remap_Destroy(table);
+        }
+    }
+    else
+    {
+        printf("Invalid input parameters provided.\n");
+    }
+
+    return validate;
+
+}/* End of function Remap_Create */
+
+
+/**
+ *
+ */
+void Remap_Destroy(Remap_Table* table)
+{
+    if (NULL != table)
+    {
+        free(table->luma.grid);
+        free(table->chroma.grid);
+        table->luma.grid = NULL;
+        table->chroma.grid = NULL;
+    }
+}/* End of function Remap_Destroy */
+
+
+/**
+ *
+ */
+Std_ReturnType Remap_ApplyYUV420(const Remap_Table* table, const unsigned char* src, unsigned char* dst)
+{
+    Std_ReturnType validate = E_OK;
+
+    validate += ValidateParam((void*)table);
+    validate += ValidateParam((void*)src);
+    validate += ValidateParam(dst);
+    if (E_OK == validate)
+        validate += ValidateParam(table->luma.grid);
+
+    if (E_OK == validate)
+    {
+        Run_Bands(table, 0, src, dst);
+    }
+    else
+    {
+        printf("Invalid input parameters provided.\n");
+    }
+
+    return validate;
+
+}/* End of function Remap_ApplyYUV420 */
+
+
+/**
+ *
+ */
+Std_ReturnType Remap_ApplyInterleaved(const Remap_Table* table, int channels, const unsigned char* src, unsigned char* dst)
+{
+    Std_ReturnType validate = E_OK;
+
+    validate += ValidateParam((void*)table);
+    validate += ValidateParam((void*)src);
+    validate += ValidateParam(dst);
+    validate += ValidateValue(channels, 1, 4);
+    if (E_OK == validate)
+        validate += ValidateParam(table->luma.grid);
+
+    if (E_OK == validate)
+    {
+        Run_Bands(table, channels, src, dst);
+    }
+    else
+    {
+        printf("Invalid input parameters provided.\n");
+    }
+
+    return validate;
+
+}/* End of function Remap_ApplyInterleaved */
+
+/** @} */
+
+/*==============================[  End of File  ]========================================*/
@@ -0,0 +1,207 @@
+/**
+ * @file Remap.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for geometric correction using precomputed remap tables </b>
+ * @version
+ * @date 2026-10-18 Initial template for lens distortion correction and warps
+ * @date 2026-10-19 Keep the thread entry of bands private
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]========================================*/
+
+#ifndef REMAP_H
+#define  REMAP_H
+
+/*===========================[  Inclusions  ]===========================================*/
+
+#include <stdint.h>
+#include "Common_PiCam.h"
+
+/*============================[  Defines  ]=============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Number of fractional bits of source coordinates stored in a remap table */
+#define REMAP_FRAC_BITS         (16)
+
+/** Maximum grid spacing of a remap table as power of two, 1 << 5 = 32 pixels */
+#define REMAP_MAX_SHIFT         (5)
+
+/** Maximum number of threads used to apply a remap table */
+#define REMAP_MAX_THREADS       (8)
+
+/** @} */
+
+/*============================[  Data Types  ]==========================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Enumeration of geometric transformation models */
+typedef enum
+{
+    /** Projective transformation using a 3X3 matrix, affine if last row is {0, 0, 1} */
+    REMAP_PERSPECTIVE,
+    /** Brown-Conrady lens distortion model with radial and tangential coefficients */
+    REMAP_LENS
+} Remap_Type;
+
+/** Structure describing a geometric transformation. The transformation maps destination
+ *  pixel coordinates to source pixel coordinates (inverse mapping).
+ */
+typedef struct
+{
+    /** Transformation model */
+    Remap_Type type;
+    /** Matrix for REMAP_PERSPECTIVE, source = matrix * (x, y, 1) */
+    double matrix[3][3];
+    /** Focal length in pixels along x axis for REMAP_LENS */
+    double fx;
+    /** Focal length in pixels along y axis for REMAP_LENS */
+    double fy;
+    /** Principal point along x axis for REMAP_LENS */
+    double cx;
+    /** Principal point along y axis for REMAP_LENS */
+    double cy;
+    /** Radial distortion coefficients for REMAP_LENS */
+    double k1, k2, k3;
+    /** Tangential distortion coefficients for REMAP_LENS */
+    double p1, p2;
+    /** Focal length scale of corrected image for REMAP_LENS, 1 keeps the focal length */
+    double zoom;
+} Remap_Transform;
+
+/** Coordinate map of a single image plane. Source coordinates in fixed-point format are
+ *  stored for grid nodes every (1 << shift) pixels and interpolated in between.
+ */
+typedef struct
+{
+    /** Width of the image plane */
+    int width;
+    /** Height of the image plane */
+    int height;
+    /** Grid spacing as power of two */
+    int shift;
+    /** Number of grid nodes in horizontal direction */
+    int grid_width;
+    /** Number of grid nodes in vertical direction */
+    int grid_height;
+    /** Interleaved source x and y coordinates of grid nodes with REMAP_FRAC_BITS fraction */
+    int32_t* grid;
+} Remap_Map;
+
+/** Compiled remap table for luminance and subsampled chrominance planes */
+typedef struct
+{
+    /** Map for luminance plane or interleaved images */
+    Remap_Map luma;
+    /** Map for chrominance planes of YUV420 images */
+    Remap_Map chroma;
+    /** Number of threads used to apply the table */
+    int threads;
+} Remap_Table;
+
+/** Arguments for a thread applying a remap table on a band of rows */
+typedef struct
+{
+    /** Remap table to apply */
+    const Remap_Table* table;
+    /** Number of interleaved channels, 0 for YUV420 planar images */
+    int channels;
+    /** Pointer to source image */
+    const unsigned char* src;
+    /** Pointer to destination image */
+    unsigned char* dst;
+    /** Index of the band to process */
+    int band;
+} Remap_Job;
+
+/** @} */
+
+/*===========================[  Function declarations  ]================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Sets an affine or perspective transformation to rotate an image around its center,
+ *          using the same orientation as Rotate_Image.
+ *
+ * @param[inout] tf     Geometric transformation to set
+ * @param[in] width     Width of image
+ * @param[in] height    Height of image
+ * @param[in] angle     Rotation angle in degrees
+ *
+ */
+void Remap_SetRotation(Remap_Transform* tf, int width, int height, double angle);
+
+/**
+ * @brief   Compiles a geometric transformation into remap tables for luminance and YUV420 chroma
+ *          planes. Compile once and apply to every frame.
+ *
+ * @param[inout] table  Remap table to compile
+ * @param[in] width     Width of image
+ * @param[in] height    Height of image
+ * @param[in] tf        Geometric transformation
+ * @param[in] shift     Grid spacing as power of two (0 to REMAP_MAX_SHIFT), 0 stores every pixel
+ * @param[in] threads   Number of threads to apply the table (1 to REMAP_MAX_THREADS)
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType Remap_Create(Remap_Table* table, int width, int height, const Remap_Transform* tf, int shift, int threads);
+
+/**
+ * @brief   Releases memory of a compiled remap table.
+ *
+ * @param[inout] table  Remap table to release
+ *
+ */
+void Remap_Destroy(Remap_Table* table);
+
+/**
+ * @brief   Applies a remap table on a planar YUV420 image.
+ *
+ * @param[in] table     Compiled remap table
+ * @param[in] src       Pointer to source YUV420 image
+ * @param[inout] dst    Pointer to destination YUV420 image, must not overlap src
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType Remap_ApplyYUV420(const Remap_Table* table, const unsigned char* src, unsigned char* dst);
+
+/**
+ * @brief   Applies a remap table on an interleaved image such as RGB or YUV444.
+ *
+ * @param[in] table     Compiled remap table
+ * @param[in] channels  Number of interleaved channels (1 to 4)
+ * @param[in] src       Pointer to source image
+ * @param[inout] dst    Pointer to destination image, must not overlap src
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType Remap_ApplyInterleaved(const Remap_Table* table, int channels, const unsigned char* src, unsigned char* dst);
+
+/** @} */
+
+#endif /* REMAP_H */
+
+/*==============================[  End of File  ]======================================*/
@@ -0,0 +1,683 @@
+/**
+ * @file AviWriter.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of MJPEG AVI container writer with OpenDML extensions </b>
+ * @version
+ * @date 2026-10-18 Initial template for AVI container writer
+ * @date 2026-10-19 Take the capture time of submitted frames
+ * @date 2026-10-19 Leave no descriptor or buffers to close after a failed open
+ * @date 2026-10-19 Keep private helpers out of the header, time frames by their capture
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include "AviWriter.h"
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to store a 32 bit value in little endian byte order.
+ *
+ * @param[out] p        Destination
+ * @param[in] value     Value to store
+ *
+ * @return unsigned char*   Position behind the value
+ *
+ */
+static inline unsigned char* AviWriter_Put32(unsigned char* p, uint32_t value);
+
+/**
+ * @brief   Helper function to store a 16 bit value in little endian byte order.
+ *
+ * @param[out] p        Destination
+ * @param[in] value     Value to store
+ *
+ * @return unsigned char*   Position behind the value
+ *
+ */
+static inline unsigned char* AviWriter_Put16(unsigned char* p, uint16_t value);
+
+/**
+ * @brief   Helper function to store a four character code.
+ *
+ * @param[out] p        Destination
+ * @param[in] tag       Four character code
+ *
+ * @return unsigned char*   Position behind the code
+ *
+ */
+static inline unsigned char* AviWriter_PutTag(unsigned char* p, const char* tag);
+
+/**
+ * @brief   Helper function to create the file header with hdrl list, super index, odml list
+ *          and the start of the first movi list from the current state of the writer.
+ *
+ * @param[in] avi       AVI writer
+ * @param[out] header   Header buffer of header_size bytes, NULL to compute the size only
+ *
+ * @return size_t       Size of the header in bytes
+ *
+ */
+static inline size_t AviWriter_BuildHeader(const AviWriter* avi, unsigned char* header);
+
+/**
+ * @brief   Helper function to write the buffered bytes to the file.
+ *
+ * @param[inout] avi    AVI writer
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType AviWriter_Flush(AviWriter* avi);
+
+/**
+ * @brief   Helper function to append bytes to the file through the write buffer. Blocks larger
+ *          than the buffer are written directly.
+ *
+ * @param[inout] avi    AVI writer
+ * @param[in] data      Bytes to append
+ * @param[in] length    Number of bytes
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType AviWriter_Append(AviWriter* avi, const void* data, size_t length);
+
+/**
+ * @brief   Helper function to overwrite a size field, in the write buffer if the position was
+ *          not written yet, otherwise in the file.
+ *
+ * @param[inout] avi    AVI writer
+ * @param[in] offset    Position of the field in the file
+ * @param[in] value     New value of the field
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType AviWriter_Patch(AviWriter* avi, uint64_t offset, uint32_t value);
+
+/**
+ * @brief   Helper function to start an AVIX RIFF list with its movi list.
+ *
+ * @param[inout] avi    AVI writer
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType AviWriter_BeginRiff(AviWriter* avi);
+
+/**
+ * @brief   Helper function to complete the open RIFF list. Writes the standard index, the
+ *          legacy idx1 index for the first list, and the list sizes.
+ *
+ * @param[inout] avi    AVI writer
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType AviWriter_EndRiff(AviWriter* avi);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** Stores a value in little endian byte order and returns the position behind it.
+ */
+static inline unsigned char* AviWriter_Put32(unsigned char* p, uint32_t value)
+{
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)(value >> 16);
+    p[3] = (unsigned char)(value >> 24);
+    return p + 4;
+
+}/* End of function AviWriter_Put32 */
+
+/** Stores a value in little endian byte order and returns the position behind it.
+ */
+static inline unsigned char* AviWriter_Put16(unsigned char* p, uint16_t value)
+{
+    p[0] = (unsigned char)value;
+    p[1] = (unsigned char)(value >> 8);
+    return p + 2;
+
+}/* End of function AviWriter_Put16 */
+
+/** Stores a four character code and returns the position behind it.
+ */
+static inline unsigned char* AviWriter_PutTag(unsigned char* p, const char* tag)
+{
+    memcpy(p, tag, 4);
+    return p + 4;
+
+}/* End of function AviWriter_PutTag */
+
+/** Lays out RIFF AVI, hdrl (avih, strl with strh, strf and indx, odml with dmlh), JUNK and
+ * the movi list header. The JUNK chunk pads the header to AVI_HEADER_ALIGN, so frames start
+ * at a block boundary and the header can be rewritten in place.
+ */
+static inline size_t AviWriter_BuildHeader(const AviWriter* avi, unsigned char* header)
+{
+    const size_t strl_size = 4 + (8 + 56) + (8 + 40) + (8 + 24 + 16 * AVI_SUPERINDEX_ENTRIES);
+    const size_t hdrl_size = 4 + (8 + 56) + (8 + strl_size) + (8 + 4 + 8 + 248);
+    const size_t used = 12 + (8 + hdrl_size) + 8 + 12;
+    const size_t size = (used + AVI_HEADER_ALIGN - 1) / AVI_HEADER_ALIGN * AVI_HEADER_ALIGN;
+    uint32_t rate, scale, usec;
+    unsigned char* p = header;
+    uint32_t i;
+
+    if (NULL == header)
+        return size;
+
+    /** Configured rate, or the mean interval of the recorded frames */
+    if (avi->config.fps > 0)
+    {
+        rate = (uint32_t)avi->config.fps;
+        scale = 1;
+        usec = 1000000 / rate;
+    }
+    else if (avi->frames > 1 && avi->last_time > avi->first_time)
+    {
+        usec = (uint32_t)((avi->last_time - avi->first_time) / (avi->frames - 1));
+        rate = 1000000;
+        scale = (usec > 0) ? usec : 1;
+    }
+    else
+    {
+        rate = AVI_DEFAULT_FPS;
+        scale = 1;
+        usec = 1000000 / AVI_DEFAULT_FPS;
+    }
+
+    memset(header, 0, size);
+
+    p = AviWriter_PutTag(p, "RIFF");
+    p = AviWriter_Put32(p, avi->first_riff_size);
+    p = AviWriter_PutTag(p, "AVI ");
+
+    p = AviWriter_PutTag(p, "LIST");
+    p = AviWriter_Put32(p, (uint32_t)hdrl_size);
+    p = AviWriter_PutTag(p, "hdrl");
+
+    /** Main AVI header, frame count of the first RIFF list only */
+    p = AviWriter_PutTag(p, "avih");
+    p = AviWriter_Put32(p, 56);
+    p = AviWriter_Put32(p, usec);
+    p = AviWriter_Put32(p, (uint32_t)((uint64_t)(avi->max_frame + 8) * rate / scale));
+    p = AviWriter_Put32(p, 0);
+    p = AviWriter_Put32(p, 0x10);
+    p = AviWriter_Put32(p, avi->first_frames);
+    p = AviWriter_Put32(p, 0);
+    p = AviWriter_Put32(p, 1);
+    p = AviWriter_Put32(p, avi->max_frame + 8);
+    p = AviWriter_Put32(p, (uint32_t)avi->config.width);
+    p = AviWriter_Put32(p, (uint32_t)avi->config.height);
+    p += 16;
+
+    p = AviWriter_PutTag(p, "LIST");
+    p = AviWriter_Put32(p, (uint32_t)strl_size);
+    p = AviWriter_PutTag(p, "strl");
+
+    /** Stream header, frame count of the whole file */
+    p = AviWriter_PutTag(p, "strh");
+    p = AviWriter_Put32(p, 56);
+    p = AviWriter_PutTag(p, "vids");
+    p = AviWriter_PutTag(p, "MJPG");
+    p = AviWriter_Put32(p, 0);
+    p = AviWriter_Put16(p, 0);
+    p = AviWriter_Put16(p, 0);
+    p = AviWriter_Put32(p, 0);
+    p = AviWriter_Put32(p, scale);
+    p = AviWriter_Put32(p, rate);
+    p = AviWriter_Put32(p, 0);
+    p = AviWriter_Put32(p, avi->frames);
+    p = AviWriter_Put32(p, avi->max_frame + 8);
+    p = AviWriter_Put32(p, 0xFFFFFFFFu);
+    p = AviWriter_Put32(p, 0);
+    p = AviWriter_Put16(p, 0);
+    p = AviWriter_Put16(p, 0);
+    p = AviWriter_Put16(p, (uint16_t)avi->config.width);
+    p = AviWriter_Put16(p, (uint16_t)avi->config.height);
+
+    /** Stream format, BITMAPINFOHEADER */
+    p = AviWriter_PutTag(p, "strf");
+    p = AviWriter_Put32(p, 40);
+    p = AviWriter_Put32(p, 40);
+    p = AviWriter_Put32(p, (uint32_t)avi->config.width);
+    p = AviWriter_Put32(p, (uint32_t)avi->config.height);
+    p = AviWriter_Put16(p, 1);
+    p = AviWriter_Put16(p, 24);
+    p = AviWriter_PutTag(p, "MJPG");
+    p = AviWriter_Put32(p, (uint32_t)(avi->config.width * avi->config.height * 3));
+    p += 16;
+
+    /** OpenDML super index, one entry per RIFF list */
+    p = AviWriter_PutTag(p, "indx");
+    p = AviWriter_Put32(p, 24 + 16 * AVI_SUPERINDEX_ENTRIES);
+    p = AviWriter_Put16(p, 4);
+    *p++ = 0;
+    *p++ = 0;
+    p = AviWriter_Put32(p, avi->riff_count);
+    p = AviWriter_PutTag(p, "00dc");
+    p += 12;
+    for (i = 0; i < AVI_SUPERINDEX_ENTRIES; i++)
+    {
+        p = AviWriter_Put32(p, (uint32_t)avi->super[i].offset);
+        p = AviWriter_Put32(p, (uint32_t)(avi->super[i].offset >> 32));
+        p = AviWriter_Put32(p, avi->super[i].size);
+        p = AviWriter_Put32(p, avi->super[i].duration);
+    }
+
+    /** OpenDML header, frame count of the whole file */
+    p = AviWriter_PutTag(p, "LIST");
+    p = AviWriter_Put32(p, 4 + 8 + 248);
+    p = AviWriter_PutTag(p, "odml");
+    p = AviWriter_PutTag(p, "dmlh");
+    p = AviWriter_Put32(p, 248);
+    p = AviWriter_Put32(p, avi->frames);
+    p += 244;
+
+    p = AviWriter_PutTag(p, "JUNK");
+    p = AviWriter_Put32(p, (uint32_t)(size - (size_t)(p - header) - 4 - 12));
+    p = header + size - 12;
+
+    p = AviWriter_PutTag(p, "LIST");
+    p = AviWriter_Put32(p, avi->first_movi_size);
+    AviWriter_PutTag(p, "movi");
+
+    return size;
+
+}/* End of function AviWriter_BuildHeader */
+
+/** Writes the whole buffer, retrying after partial writes.
+ */
+static inline Std_ReturnType AviWriter_Flush(AviWriter* avi)
+{
+    size_t done = 0;
+
+    while (done < avi->buffered)
+    {
+        ssize_t r = write(avi->fd, avi->buffer + done, avi->buffered - done);
+        if (r < 0 && EINTR == errno)
+            continue;
+        if (r <= 0)
+            return E_NOT_OK;
+        done += (size_t)r;
+    }
+
+    avi->buffered = 0;
+
+    return E_OK;
+
+}/* End of function AviWriter_Flush */
+
+/** Copies into the write buffer. Blocks which do not fit into an empty buffer go to the file
+ * directly, the copy would not save a system call.
+ */
+static inline Std_ReturnType AviWriter_Append(AviWriter* avi, const void* data, size_t length)
+{
+    const unsigned char* bytes = data;
+
+    if (avi->buffered + length > avi->config.buffer_size)
+    {
+        if (E_OK != AviWriter_Flush(avi))
+            return E_NOT_OK;
+    }
+
+    if (length >= avi->config.buffer_size)
+    {
+        size_t done = 0;
+
+        while (done < length)
+        {
+            ssize_t r = write(avi->fd, bytes + done, length - done);
+            if (r < 0 && EINTR == errno)
+                continue;
+            if (r <= 0)
+                return E_NOT_OK;
+            done += (size_t)r;
+        }
+    }
+    else
+    {
+        memcpy(avi->buffer + avi->buffered, bytes, length);
+        avi->buffered += length;
+    }
+
+    avi->position += length;
+
+    return E_OK;
+
+}/* End of function AviWriter_Append */
+
+/** Size fields of lists are only known when the list is complete.
+ */
+static inline Std_ReturnType AviWriter_Patch(AviWriter* avi, uint64_t offset, uint32_t value)
+{
+    uint64_t flushed = avi->position - avi->buffered;
+    unsigned char field[4];
+
+    AviWriter_Put32(field, value);
+
+    if (offset >= flushed)
+    {
+        memcpy(avi->buffer + (offset - flushed), field, 4);
+        return E_OK;
+    }
+
+    return (4 == pwrite(avi->fd, field, 4, (off_t)offset)) ? E_OK : E_NOT_OK;
+
+}/* End of function AviWriter_Patch */
+
+/** Sizes of the new lists are patched when the list is complete.
+ */
+static inline Std_ReturnType AviWriter_BeginRiff(AviWriter* avi)
+{
+    unsigned char header[24];
+    unsigned char* p = header;
+
+    p = AviWriter_PutTag(p, "RIFF");
+    p = AviWriter_Put32(p, 0);
+    p = AviWriter_PutTag(p, "AVIX");
+    p = AviWriter_PutTag(p, "LIST");
+    p = AviWriter_Put32(p, 0);
+    AviWriter_PutTag(p, "movi");
+
+    avi->riff_offset = avi->position;
+    avi->movi_offset = avi->position + 12;
+    avi->index_count = 0;
+
+    return AviWriter_Append(avi, header, sizeof(header));
+
+}/* End of function AviWriter_BeginRiff */
+
+/** The standard index ends the movi list, offsets are relative to the RIFF list. The idx1
+ * index of the first list is relative to the movi tag, for players without OpenDML support.
+ */
+static inline Std_ReturnType AviWriter_EndRiff(AviWriter* avi)
+{
+    unsigned char chunk[32];
+    unsigned char* p = chunk;
+    uint64_t index_offset = avi->position;
+    uint32_t i;
+    Std_ReturnType status = E_OK;
+
+    p = AviWriter_PutTag(p, "ix00");
+    p = AviWriter_Put32(p, 24 + 8 * avi->index_count);
+    p = AviWriter_Put16(p, 2);
+    *p++ = 0;
+    *p++ = 1;
+    p = AviWriter_Put32(p, avi->index_count);
+    p = AviWriter_PutTag(p, "00dc");
+    p = AviWriter_Put32(p, (uint32_t)avi->riff_offset);
+    p = AviWriter_Put32(p, (uint32_t)(avi->riff_offset >> 32));
+    AviWriter_Put32(p, 0);
+    status += AviWriter_Append(avi, chunk, 32);
+
+    for (i = 0; i < avi->index_count && E_OK == status; i++)
+    {
+        AviWriter_Put32(chunk, (uint32_t)(avi->index[i].offset + 8 - avi->riff_offset));
+        AviWriter_Put32(chunk + 4, avi->index[i].size);
+        status += AviWriter_Append(avi, chunk, 8);
+    }
+
+    avi->super[avi->riff_count].offset = index_offset;
+    avi->super[avi->riff_count].size = 32 + 8 * avi->index_count;
+    avi->super[avi->riff_count].duration = avi->index_count;
+
+    status += AviWriter_Patch(avi, avi->movi_offset + 4, (uint32_t)(avi->position - avi->movi_offset - 8));
+
+    if (0 == avi->riff_count)
+    {
+        avi->first_movi_size = (uint32_t)(avi->position - avi->movi_offset - 8);
+        avi->first_frames = avi->index_count;
+
+        p = AviWriter_PutTag(chunk, "idx1");
+        AviWriter_Put32(p, 16 * avi->index_count);
+        status += AviWriter_Append(avi, chunk, 8);
+
+        for (i = 0; i < avi->index_count && E_OK == status; i++)
+        {
+            p = AviWriter_PutTag(chunk, "00dc");
+            p = AviWriter_Put32(p, 0x10);
+            p = AviWriter_Put32(p, (uint32_t)(avi->index[i].offset - avi->movi_offset - 8));
+            AviWriter_Put32(p, avi->index[i].size);
+            status += AviWriter_Append(avi, chunk, 16);
+        }
+
+        avi->first_riff_size = (uint32_t)(avi->position - 8);
+    }
+
+    status += AviWriter_Patch(avi, avi->riff_offset + 4, (uint32_t)(avi->position - avi->riff_offset - 8));
+
+    avi->riff_count++;
+    avi->index_count = 0;
+
+    return (E_OK == status) ? E_OK : E_NOT_OK;
+
+}/* End of function AviWriter_EndRiff */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** The placeholder header reserves the space of the final header, which has a fixed size.
+ */
+Std_ReturnType AviWriter_Open(AviWriter* avi, const AviWriter_Config* config)
+{
+    Std_ReturnType validate = E_OK;
+    unsigned char* header;
+
+    validate += ValidateParam(avi);
+    validate += ValidateParam((void*)config);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateParam((void*)config->filename);
+        validate += (config->width > 0 && config->width <= UINT16_MAX) ? E_OK : E_NOT_OK;
+        validate += (config->height > 0 && config->height <= UINT16_MAX) ? E_OK : E_NOT_OK;
+        validate += (config->fps >= 0) ? E_OK : E_NOT_OK;
+        validate += (config->riff_size <= (1u << 31)) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        if (NULL != avi)
+            avi->fd = -1;
+        return E_NOT_OK;
+    }
+
+    memset(avi, 0, sizeof(AviWriter));
+    avi->fd = -1;
+    avi->config = *config;
+    if (0 == avi->config.buffer_size)
+        avi->config.buffer_size = AVI_BUFFER_SIZE;
+    if (0 == avi->config.riff_size)
+        avi->config.riff_size = AVI_MAX_RIFF_SIZE;
+
+    avi->header_size = AviWriter_BuildHeader(avi, NULL);
+    if (avi->config.buffer_size < avi->header_size)
+        avi->config.buffer_size = avi->header_size;
+
+    avi->buffer = malloc(avi->config.buffer_size);
+    avi->index_capacity = 1024;
+    avi->index = malloc(avi->index_capacity * sizeof(AviWriter_IndexEntry));
+    if (NULL == avi->buffer || NULL == avi->index)
+    {
+        free(avi->buffer);
+        free(avi->index);
+        avi->buffer = NULL;
+        avi->index = NULL;
+        return E_NOT_OK;
+    }
+
+    avi->fd = open(config->filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (-1 == avi->fd)
+    {
+        free(avi->buffer);
+        free(avi->index);
+        avi->buffer = NULL;
+        avi->index = NULL;
+        return E_NOT_OK;
+    }
+
+    /** Sequential writes, let the kernel read ahead and write back in large blocks */
+    posix_fadvise(avi->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+
+    header = avi->buffer;
+    AviWriter_BuildHeader(avi, header);
+    avi->buffered = avi->header_size;
+    avi->position = avi->header_size;
+    avi->riff_offset = 0;
+    avi->movi_offset = avi->header_size - 12;
+
+    return E_OK;
+
+}/* End of function AviWriter_Open */
+
+/** A frame is a 00dc chunk padded to an even size. The RIFF list is completed before a frame
+ * which would let the list and its indices exceed riff_size.
+ */
+Std_ReturnType AviWriter_AddFrame(AviWriter* avi, const unsigned char* data, size_t length, int64_t captured)
+{
+    static const unsigned char pad = 0;
+    unsigned char chunk[8];
+    struct timespec now;
+    uint64_t needed;
+
+    if (-1 == avi->fd || NULL == data || length > avi->config.riff_size / 2)
+        return E_NOT_OK;
+
+    needed = (avi->position - avi->riff_offset) + 8 + length + 1 + 32 + 8 * (uint64_t)(avi->index_count + 1);
+    if (0 == avi->riff_count)
+        needed += 8 + 16 * (uint64_t)(avi->index_count + 1);
+
+    if (avi->index_count > 0 && needed > avi->config.riff_size)
+    {
+        if (avi->riff_count + 1 >= AVI_SUPERINDEX_ENTRIES)
+            return E_NOT_OK;
+        if (E_OK != AviWriter_EndRiff(avi) || E_OK != AviWriter_BeginRiff(avi))
+            return E_NOT_OK;
+    }
+
+    if (avi->index_count == avi->index_capacity)
+    {
+        AviWriter_IndexEntry* index = realloc(avi->index, 2 * avi->index_capacity * sizeof(AviWriter_IndexEntry));
+        if (NULL == index)
+            return E_NOT_OK;
+        avi->index = index;
+        avi->index_capacity *= 2;
+    }
+
+    avi->index[avi->index_count].offset = avi->position;
+    avi->index[avi->index_count].size = (uint32_t)length;
+
+    AviWriter_PutTag(chunk, "00dc");
+    AviWriter_Put32(chunk + 4, (uint32_t)length);
+    if (E_OK != AviWriter_Append(avi, chunk, 8) || E_OK != AviWriter_Append(avi, data, length))
+        return E_NOT_OK;
+    if ((length & 1) && E_OK != AviWriter_Append(avi, &pad, 1))
+        return E_NOT_OK;
+
+    /** Queued frames are appended late, the capture time keeps the measured rate exact */
+    if (captured <= 0)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        captured = (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+    }
+    avi->last_time = captured;
+    if (0 == avi->frames)
+        avi->first_time = avi->last_time;
+
+    avi->index_count++;
+    avi->frames++;
+    if (length > avi->max_frame)
+        avi->max_frame = (uint32_t)length;
+
+    return E_OK;
+
+}/* End of function AviWriter_AddFrame */
+
+/** Appends the frame and releases the buffer.
+ */
+Std_ReturnType AviWriter_Submit(void* avi, const char* filename, unsigned char* data, size_t length, int64_t captured)
+{
+    Std_ReturnType status;
+
+    (void)filename;
+    status = AviWriter_AddFrame((AviWriter*)avi, data, length, captured);
+    free(data);
+
+    return status;
+
+}/* End of function AviWriter_Submit */
+
+/** The final header carries frame counts, frame rate and the super index.
+ */
+Std_ReturnType AviWriter_Close(AviWriter* avi)
+{
+    Std_ReturnType status = E_OK;
+
+    if (-1 == avi->fd)
+        return E_NOT_OK;
+
+    status += AviWriter_EndRiff(avi);
+    status += AviWriter_Flush(avi);
+
+    if (E_OK == status)
+    {
+        AviWriter_BuildHeader(avi, avi->buffer);
+        if ((ssize_t)avi->header_size != pwrite(avi->fd, avi->buffer, avi->header_size, 0))
+            status = E_NOT_OK;
+    }
+
+    if (0 != close(avi->fd))
+        status = E_NOT_OK;
+
+    free(avi->buffer);
+    free(avi->index);
+    avi->buffer = NULL;
+    avi->index = NULL;
+    avi->fd = -1;
+
+    return (E_OK == status) ? E_OK : E_NOT_OK;
+
+}/* End of function AviWriter_Close */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
@@ -0,0 +1,214 @@
+/**
+ * @file AviWriter.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for MJPEG AVI container writer with OpenDML extensions </b>
+ * @version
+ * @date 2026-10-18 Initial template for AVI container writer
+ * @date 2026-10-19 Take the capture time of submitted frames
+ * @date 2026-10-19 Leave no descriptor or buffers to close after a failed open
+ * @date 2026-10-19 Keep private helpers out of the header, time frames by their capture
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef AVIWRITER_H
+#define  AVIWRITER_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include "Common_PiCam.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Number of entries of the OpenDML super index, every entry covers one RIFF list */
+#define AVI_SUPERINDEX_ENTRIES  (256)
+
+/** Maximum size of a RIFF list, larger recordings continue in AVIX lists */
+#define AVI_MAX_RIFF_SIZE       (1u << 30)
+
+/** Default size of the write buffer */
+#define AVI_BUFFER_SIZE         (4u << 20)
+
+/** Alignment of the first frame in the file */
+#define AVI_HEADER_ALIGN        (4096)
+
+/** Frame rate written to the header when neither configured nor measurable */
+#define AVI_DEFAULT_FPS         (30)
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Configuration of an AVI writer */
+typedef struct
+{
+    /** Filename of the AVI file */
+    const char* filename;
+    /** Width of the frames in pixels */
+    int width;
+    /** Height of the frames in pixels */
+    int height;
+    /** Frame rate, 0 to derive it from the time between frames */
+    int fps;
+    /** Size of the write buffer in bytes, 0 for AVI_BUFFER_SIZE */
+    size_t buffer_size;
+    /** Maximum size of a RIFF list in bytes, 0 for AVI_MAX_RIFF_SIZE */
+    uint32_t riff_size;
+} AviWriter_Config;
+
+/** Frame of the open RIFF list */
+typedef struct
+{
+    /** Position of the chunk header in the file */
+    uint64_t offset;
+    /** Size of the frame in bytes */
+    uint32_t size;
+} AviWriter_IndexEntry;
+
+/** Entry of the super index, locating the standard index of a RIFF list */
+typedef struct
+{
+    /** Position of the standard index chunk in the file */
+    uint64_t offset;
+    /** Size of the standard index chunk in bytes, including chunk header */
+    uint32_t size;
+    /** Number of frames of the RIFF list */
+    uint32_t duration;
+} AviWriter_SuperEntry;
+
+/** Writer of MJPEG frames into a single AVI file. Frames are collected in a large buffer and
+ *  written sequentially, the index of every RIFF list is kept in memory until the list is
+ *  complete and the headers are written again when the file is closed.
+ */
+typedef struct
+{
+    /** Configuration of the writer */
+    AviWriter_Config config;
+    /** Descriptor of the AVI file, -1 if closed */
+    int fd;
+    /** Write buffer */
+    unsigned char* buffer;
+    /** Number of bytes in the write buffer */
+    size_t buffered;
+    /** Size of the file including buffered bytes */
+    uint64_t position;
+    /** Size of the file header up to the first frame */
+    size_t header_size;
+    /** Position of the open RIFF list */
+    uint64_t riff_offset;
+    /** Position of the movi list of the open RIFF list */
+    uint64_t movi_offset;
+    /** Frames of the open RIFF list */
+    AviWriter_IndexEntry* index;
+    /** Number of frames of the open RIFF list */
+    uint32_t index_count;
+    /** Number of entries index has room for */
+    uint32_t index_capacity;
+    /** Super index entries of completed RIFF lists */
+    AviWriter_SuperEntry super[AVI_SUPERINDEX_ENTRIES];
+    /** Number of completed RIFF lists */
+    uint32_t riff_count;
+    /** Size of the first RIFF list, written with the file header */
+    uint32_t first_riff_size;
+    /** Size of the first movi list, written with the file header */
+    uint32_t first_movi_size;
+    /** Number of frames of the first RIFF list */
+    uint32_t first_frames;
+    /** Number of frames of all RIFF lists */
+    uint32_t frames;
+    /** Size of the largest frame in bytes */
+    uint32_t max_frame;
+    /** Monotonic capture time of the first frame in microseconds */
+    int64_t first_time;
+    /** Monotonic capture time of the last frame in microseconds */
+    int64_t last_time;
+} AviWriter;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Creates an AVI file and writes a placeholder header. On failure the writer is left
+ *          closed, AviWriter_Close then returns E_NOT_OK without closing a descriptor.
+ *
+ * @param[inout] avi    AVI writer to open
+ * @param[in] config    Configuration of the writer
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType AviWriter_Open(AviWriter* avi, const AviWriter_Config* config);
+
+/**
+ * @brief   Appends a JPEG frame, starting a new RIFF list when the open one is full.
+ *
+ * @param[inout] avi    AVI writer
+ * @param[in] data      JPEG frame
+ * @param[in] length    Size of the frame in bytes
+ * @param[in] captured  Capture time in microseconds of CLOCK_MONOTONIC, 0 to take the time
+ *                      of appending
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType AviWriter_AddFrame(AviWriter* avi, const unsigned char* data, size_t length, int64_t captured);
+
+/**
+ * @brief   Appends a JPEG file handed over by the write functions, signature matches
+ *          Sink_SubmitFunc. The filename is ignored and the data is released. Must be called
+ *          from a single thread.
+ *
+ * @param[inout] avi    Pointer to AviWriter
+ * @param[in] filename  Ignored
+ * @param[in] data      JPEG frame allocated with malloc
+ * @param[in] length    Size of the frame in bytes
+ * @param[in] captured  Capture time in microseconds of CLOCK_MONOTONIC, 0 if unknown
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType AviWriter_Submit(void* avi, const char* filename, unsigned char* data, size_t length, int64_t captured);
+
+/**
+ * @brief   Completes the open RIFF list, writes the final header and closes the file.
+ *
+ * @param[inout] avi    AVI writer to close
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType AviWriter_Close(AviWriter* avi);
+
+/** @} */
+
+#endif /** AVIWRITER_H **/
+
+/*==============================[  End of File  ]======================================*/
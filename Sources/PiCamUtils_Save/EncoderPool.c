@@ -0,0 +1,680 @@
+/**
+ * @file EncoderPool.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of parallel JPEG encoding across frames and restart interval slices </b>
+ * @version
+ * @date 2026-10-18 Initial template for parallel JPEG encoder pool
+ * @date 2026-10-18 Select quality of frames with a rate controller
+ * @date 2026-10-18 Add downscaled outputs and EXIF thumbnails of frames
+ * @date 2026-10-19 Pass the capture time of frames to the sink
+ * @date 2026-10-19 Encode slices with standard Huffman tables only
+ * @date 2026-10-19 Keep private helpers out of the header
+ * @date 2026-10-19 Worker threads block the signals of the application
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "EncoderPool.h"
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to hand an encoded file to the configured sink, or to write it if
+ *          no sink is configured. The encoded data is released either way.
+ *
+ * @param[in] pool      Encoder pool
+ * @param[in] filename  Name of the file
+ * @param[in] data      Encoded data allocated with malloc, NULL if encoding failed
+ * @param[in] length    Size of the encoded data in bytes
+ * @param[in] captured  Capture time of the frame passed to the sink
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType Pool_Write(EncoderPool* pool, const char* filename, unsigned char* data, size_t length, int64_t captured);
+
+/**
+ * @brief   Helper function to deliver the downscaled outputs and the encoded frame.
+ *
+ * @param[in] pool      Encoder pool
+ * @param[inout] job    Encoded frame
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType Pool_Deliver(EncoderPool* pool, Pool_Job* job);
+
+/**
+ * @brief   Helper function to store an encoded frame and deliver all frames which are next in
+ *          submission order. Only one thread delivers at a time, so the sink sees frames
+ *          sequentially and in order.
+ *
+ * @param[inout] pool   Encoder pool
+ * @param[in] job       Encoded frame
+ *
+ */
+static inline void Pool_Complete(EncoderPool* pool, Pool_Job* job);
+
+/**
+ * @brief   Helper function to find the entropy coded data of a JPEG image and the height field
+ *          of its frame header.
+ *
+ * @param[in] data      JPEG image
+ * @param[in] length    Size of the image in bytes
+ * @param[out] height   Position of the height field, 0 if there is no frame header
+ *
+ * @return size_t       Position of the entropy coded data, 0 if the image is malformed
+ *
+ */
+static inline size_t Pool_ScanStart(const unsigned char* data, size_t length, size_t* height);
+
+/**
+ * @brief   Helper function to copy entropy coded data and number its restart markers
+ *          consecutively.
+ *
+ * @param[out] dst          Destination
+ * @param[in] src           Entropy coded data
+ * @param[in] length        Size of the entropy coded data in bytes
+ * @param[inout] restarts   Number of restart markers before the data
+ *
+ */
+static inline void Pool_CopyScan(unsigned char* dst, const unsigned char* src, size_t length, uint32_t* restarts);
+
+/**
+ * @brief   Helper function to join slices encoded with a restart interval of one MCU row into
+ *          a single JPEG image. Header and tables are taken from the first slice.
+ *
+ * @param[in] jobs      Encoded slices from top to bottom
+ * @param[in] count     Number of slices
+ * @param[in] height    Height of the complete image
+ * @param[out] data     Joined image allocated with malloc
+ * @param[out] length   Size of the joined image in bytes
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType Pool_Join(const Pool_Job* jobs, int count, int height, unsigned char** data, size_t* length);
+
+/**
+ * @brief   Thread entry of an encoder thread.
+ *
+ * @param[in] arg   Pointer to EncoderPool
+ *
+ * @return void*    Always NULL
+ *
+ */
+static void* Pool_Worker(void* arg);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** Writes the file with retries of partial and interrupted writes when no sink is set.
+ */
+static inline Std_ReturnType Pool_Write(EncoderPool* pool, const char* filename, unsigned char* data, size_t length, int64_t captured)
+{
+    size_t done = 0;
+    int fd;
+
+    if (NULL == data)
+        return E_NOT_OK;
+
+    if (NULL != pool->config.submit)
+        return pool->config.submit(pool->config.sink, filename, data, length, captured);
+
+    fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    while (-1 != fd && done < length)
+    {
+        ssize_t r = write(fd, data + done, length - done);
+        if (r < 0 && EINTR == errno)
+            continue;
+        if (r <= 0)
+            break;
+        done += (size_t)r;
+    }
+
+    if (-1 != fd)
+        close(fd);
+    free(data);
+
+    if (done != length)
+    {
+        fprintf(stderr, "Could not write file %s, error %d, %s\n", filename, errno, strerror(errno));
+        return E_NOT_OK;
+    }
+
+    return E_OK;
+
+}/* End of function Pool_Write */
+
+/** Downscaled outputs go first, so consumers of the full size image find them complete.
+ */
+static inline Std_ReturnType Pool_Deliver(EncoderPool* pool, Pool_Job* job)
+{
+    char filename[SINK_MAX_FILENAME];
+    int i;
+
+    for (i = 0; i < job->outputs; i++)
+    {
+        if (E_OK == Preview_Filename(filename, sizeof(filename), job->filename, &job->output[i]))
+            Pool_Write(pool, filename, job->output[i].data, job->output[i].length, job->captured);
+        else
+            free(job->output[i].data);
+    }
+
+    return Pool_Write(pool, job->filename, job->data, job->length, job->captured);
+
+}/* End of function Pool_Deliver */
+
+/** The lock is released while a frame is delivered, frames completed meanwhile are picked up
+ * by the delivering thread before it gives up the role.
+ */
+static inline void Pool_Complete(EncoderPool* pool, Pool_Job* job)
+{
+    const int window = pool->config.window;
+    Pool_Job* next;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->ready[job->sequence % window] = job;
+
+    if (pool->delivering)
+    {
+        pthread_mutex_unlock(&pool->lock);
+        return;
+    }
+
+    pool->delivering = 1;
+    while (NULL != (next = pool->ready[pool->next_out % window]))
+    {
+        Std_ReturnType status;
+
+        pool->ready[pool->next_out % window] = NULL;
+        pthread_mutex_unlock(&pool->lock);
+
+        status = Pool_Deliver(pool, next);
+        free(next);
+
+        pthread_mutex_lock(&pool->lock);
+        pool->next_out++;
+        if (E_OK == status)
+            pool->frames++;
+        else
+            pool->failed++;
+        pthread_cond_broadcast(&pool->delivered_cond);
+    }
+    pool->delivering = 0;
+
+    pthread_mutex_unlock(&pool->lock);
+
+}/* End of function Pool_Complete */
+
+/** Walks the marker segments following SOI up to the start of scan. Fill bytes between
+ * segments are skipped.
+ */
+static inline size_t Pool_ScanStart(const unsigned char* data, size_t length, size_t* height)
+{
+    size_t pos = 2;
+
+    *height = 0;
+
+    if (length < 4 || 0xFF != data[0] || 0xD8 != data[1])
+        return 0;
+
+    while (pos + 4 <= length)
+    {
+        unsigned char marker = data[pos + 1];
+        size_t segment = ((size_t)data[pos + 2] << 8) | data[pos + 3];
+
+        if (0xFF != data[pos])
+            return 0;
+        if (0xFF == marker)
+        {
+            pos++;
+            continue;
+        }
+
+        if (marker >= 0xC0 && marker <= 0xC2)
+            *height = pos + 5;
+        if (0xDA == marker)
+            return (pos + 2 + segment <= length) ? pos + 2 + segment : 0;
+
+        pos += 2 + segment;
+    }
+
+    return 0;
+
+}/* End of function Pool_ScanStart */
+
+/** Entropy coded data stuffs a zero byte behind every 0xFF, so 0xFF followed by 0xD0 to 0xD7
+ * is always a restart marker.
+ */
+static inline void Pool_CopyScan(unsigned char* dst, const unsigned char* src, size_t length, uint32_t* restarts)
+{
+    unsigned char* end = dst + length;
+    unsigned char* p = dst;
+
+    memcpy(dst, src, length);
+
+    while (NULL != (p = memchr(p, 0xFF, (size_t)(end - p))) && p + 1 < end)
+    {
+        if (p[1] >= 0xD0 && p[1] <= 0xD7)
+            p[1] = (unsigned char)(0xD0 + ((*restarts)++ & 7));
+        p += 2;
+    }
+
+}/* End of function Pool_CopyScan */
+
+/** Every slice ends on a complete MCU row with its entropy coder flushed, exactly as before a
+ * restart marker, so the scans are concatenated with one restart marker in between and the
+ * markers are renumbered modulo 8.
+ */
+static inline Std_ReturnType Pool_Join(const Pool_Job* jobs, int count, int height, unsigned char** data, size_t* length)
+{
+    size_t height_pos, start, total = 2;
+    uint32_t restarts = 0;
+    unsigned char* out;
+    unsigned char* p;
+    int i;
+
+    if (count < 1)
+        return E_NOT_OK;
+
+    start = Pool_ScanStart(jobs[0].data, jobs[0].length, &height_pos);
+    if (0 == start || 0 == height_pos || start > jobs[0].length)
+        return E_NOT_OK;
+
+    for (i = 0; i < count; i++)
+        total += jobs[i].length + 2;
+
+    out = malloc(total);
+    if (NULL == out)
+        return E_NOT_OK;
+
+    memcpy(out, jobs[0].data, start);
+    out[height_pos] = (unsigned char)(height >> 8);
+    out[height_pos + 1] = (unsigned char)height;
+    p = out + start;
+
+    for (i = 0; i < count; i++)
+    {
+        size_t dummy;
+        size_t scan = (0 == i) ? start : Pool_ScanStart(jobs[i].data, jobs[i].length, &dummy);
+        size_t end = jobs[i].length - 2;
+
+        if (0 == scan || scan > end || 0xFF != jobs[i].data[end] || 0xD9 != jobs[i].data[end + 1])
+        {
+            free(out);
+            return E_NOT_OK;
+        }
+
+        if (i > 0)
+        {
+            *p++ = 0xFF;
+            *p++ = (unsigned char)(0xD0 + (restarts++ & 7));
+        }
+
+        Pool_CopyScan(p, jobs[i].data + scan, end - scan, &restarts);
+        p += end - scan;
+    }
+
+    *p++ = 0xFF;
+    *p++ = 0xD9;
+
+    *data = out;
+    *length = (size_t)(p - out);
+
+    return E_OK;
+
+}/* End of function Pool_Join */
+
+/** Encodes jobs until the queue is closed and empty. Frames are released after encoding and
+ * passed on in order, slices are reported to the waiting thread. Downscaled outputs of frames
+ * are encoded with the same encoder before the full size image.
+ */
+static void* Pool_Worker(void* arg)
+{
+    EncoderPool* pool = (EncoderPool*)arg;
+    const Preview_Config* config = &pool->config.preview;
+    JpegEncoder encoder;
+    Preview preview;
+    int ready = (E_OK == JpegEncoder_Init(&encoder, pool->config.quality));
+    int previews = ready && (config->scales || config->thumbnail) && (E_OK == Preview_Init(&preview, config));
+    Pool_Job* job;
+
+    Thread_BlockSignals();
+
+    while (NULL != (job = BoundedQueue_Pop(&pool->queue, 1)))
+    {
+        job->data = NULL;
+        job->length = 0;
+        job->outputs = 0;
+
+        if (ready)
+        {
+            int64_t start = RateControl_Now();
+
+            JpegEncoder_SetQuality(&encoder, job->quality);
+            JpegEncoder_SetFastDCT(&encoder, job->fast_dct);
+            JpegEncoder_SetRestartRows(&encoder, (NULL != job->batch) ? 1 : 0);
+            /** Joined slices share the Huffman tables in the header of the first slice */
+            if (NULL != job->batch)
+                JpegEncoder_SetOptimizeCoding(&encoder, 0);
+
+            if (previews && NULL == job->batch && E_OK == Preview_Encode(&preview, &encoder, &job->image))
+            {
+                memcpy(job->output, preview.output, sizeof(job->output));
+                job->outputs = preview.outputs;
+            }
+
+            if (E_OK == JpegEncoder_Encode(&encoder, &job->image))
+                job->data = JpegEncoder_Detach(&encoder, &job->length);
+
+            /** Slices are fed back by the thread joining them */
+            if (NULL != pool->config.rate && NULL == job->batch && NULL != job->data)
+                RateControl_Update(pool->config.rate, job->length, RateControl_Now() - start);
+        }
+
+        if (NULL == job->batch)
+        {
+            free(job->frame);
+            job->frame = NULL;
+            Pool_Complete(pool, job);
+            continue;
+        }
+
+        pthread_mutex_lock(&job->batch->lock);
+        if (NULL == job->data)
+            job->batch->failed = 1;
+        if (0 == --job->batch->pending)
+            pthread_cond_signal(&job->batch->done);
+        pthread_mutex_unlock(&job->batch->lock);
+    }
+
+    if (previews)
+        Preview_DeInit(&preview);
+    if (ready)
+        JpegEncoder_DeInit(&encoder);
+
+    return NULL;
+
+}/* End of function Pool_Worker */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** Creates the queue with room for all frames in flight and the slices of one frame, then
+ * starts the encoder threads.
+ */
+Std_ReturnType EncoderPool_Init(EncoderPool* pool, const EncoderPool_Config* config)
+{
+    Std_ReturnType validate = E_OK;
+    int i;
+
+    validate += ValidateParam(pool);
+    validate += ValidateParam((void*)config);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateValue(config->threads, 1, POOL_MAX_THREADS);
+        validate += ValidateValue(config->window, 1, POOL_MAX_WINDOW);
+        validate += ValidateValue(config->quality, 1, 100);
+        validate += ValidateValue(config->slices, 0, POOL_MAX_SLICES);
+        validate += ValidateValue(config->preview.scales, 0, (1 << PYRAMID_MAX_LEVELS) - 1);
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    memset(pool, 0, sizeof(EncoderPool));
+    pool->config = *config;
+
+    if (E_OK != BoundedQueue_Init(&pool->queue, config->window + POOL_MAX_SLICES))
+        return E_NOT_OK;
+    if (E_OK != JpegEncoder_Init(&pool->encoder, config->quality))
+    {
+        BoundedQueue_DeInit(&pool->queue);
+        return E_NOT_OK;
+    }
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->delivered_cond, NULL);
+
+    for (i = 0; i < config->threads; i++)
+    {
+        if (0 != pthread_create(&pool->thread[i], NULL, Pool_Worker, pool))
+        {
+            EncoderPool_Close(pool);
+            return E_NOT_OK;
+        }
+        pool->started++;
+    }
+
+    return E_OK;
+
+}/* End of function EncoderPool_Init */
+
+/** Waits for a free place in the window, so at most window frames are buffered and the
+ * delivery ring cannot overflow.
+ */
+Std_ReturnType EncoderPool_Submit(EncoderPool* pool, const Image_Planar* image, unsigned char* frame, const char* filename, int64_t captured)
+{
+    Pool_Job* job;
+
+    if (NULL == image || NULL == filename || strlen(filename) >= SINK_MAX_FILENAME)
+    {
+        printf("Invalid input parameters provided.\n");
+        free(frame);
+        return E_NOT_OK;
+    }
+
+    job = malloc(sizeof(Pool_Job));
+    if (NULL == job)
+    {
+        free(frame);
+        return E_NOT_OK;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->next_in - pool->next_out >= (uint32_t)pool->config.window)
+        pthread_cond_wait(&pool->delivered_cond, &pool->lock);
+    job->sequence = pool->next_in++;
+    job->quality = pool->config.quality;
+    job->fast_dct = 0;
+    pthread_mutex_unlock(&pool->lock);
+
+    if (NULL != pool->config.rate)
+        RateControl_Get(pool->config.rate, &job->quality, &job->fast_dct);
+
+    job->image = *image;
+    job->frame = frame;
+    job->batch = NULL;
+    job->outputs = 0;
+    job->captured = captured;
+    strcpy(job->filename, filename);
+
+    if (E_OK != BoundedQueue_Push(&pool->queue, job, QUEUE_BLOCK, NULL))
+    {
+        /** The sequence number is taken, deliver the frame as failed to keep the order */
+        free(job->frame);
+        job->frame = NULL;
+        job->data = NULL;
+        Pool_Complete(pool, job);
+        return E_NOT_OK;
+    }
+
+    return E_OK;
+
+}/* End of function EncoderPool_Submit */
+
+/** Slices are whole MCU rows of equal height except the last one. The calling thread encodes
+ * the first slice itself while the encoder threads take the others. Downscaled outputs are
+ * encoded first, so the thumbnail ends up in the header of the first slice.
+ */
+Std_ReturnType EncoderPool_EncodeSlices(EncoderPool* pool, const Image_Planar* image, int quality, int fast_dct, Preview* preview, unsigned char** data, size_t* length)
+{
+    Std_ReturnType validate = E_OK;
+    Pool_Job jobs[POOL_MAX_SLICES];
+    Pool_Batch batch;
+    Std_ReturnType status = E_OK;
+    int mcu_rows, rows, count, i;
+
+    validate += ValidateParam(pool);
+    validate += ValidateParam((void*)image);
+    validate += ValidateParam(data);
+    validate += ValidateParam(length);
+
+    if (E_OK == validate)
+        validate += (image->height > 0) ? E_OK : E_NOT_OK;
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    mcu_rows = (image->height + POOL_MCU_ROWS - 1) / POOL_MCU_ROWS;
+    count = pool->config.slices;
+    if (count > mcu_rows / POOL_MIN_SLICE_ROWS)
+        count = mcu_rows / POOL_MIN_SLICE_ROWS;
+
+    JpegEncoder_SetQuality(&pool->encoder, quality);
+    JpegEncoder_SetFastDCT(&pool->encoder, fast_dct);
+    JpegEncoder_SetRestartRows(&pool->encoder, 0);
+
+    if (NULL != preview && E_OK != Preview_Encode(preview, &pool->encoder, image))
+        preview->outputs = 0;
+
+    if (count < 2)
+    {
+        if (E_OK != JpegEncoder_Encode(&pool->encoder, image))
+            return E_NOT_OK;
+        *data = JpegEncoder_Detach(&pool->encoder, length);
+        return (NULL != *data) ? E_OK : E_NOT_OK;
+    }
+
+    rows = ((mcu_rows + count - 1) / count) * POOL_MCU_ROWS;
+    count = (image->height + rows - 1) / rows;
+
+    batch.pending = count - 1;
+    batch.failed = 0;
+    pthread_mutex_init(&batch.lock, NULL);
+    pthread_cond_init(&batch.done, NULL);
+
+    for (i = 0; i < count; i++)
+    {
+        int top = i * rows;
+
+        jobs[i].image = *image;
+        jobs[i].image.height = (image->height - top < rows) ? image->height - top : rows;
+        jobs[i].image.plane[0] += (size_t)top * image->stride[0];
+        if (PIXFMT_YUV420 == image->format)
+        {
+            jobs[i].image.plane[1] += (size_t)(top / 2) * image->stride[1];
+            jobs[i].image.plane[2] += (size_t)(top / 2) * image->stride[2];
+        }
+        jobs[i].frame = NULL;
+        jobs[i].batch = &batch;
+        jobs[i].quality = quality;
+        jobs[i].fast_dct = fast_dct;
+        jobs[i].data = NULL;
+        jobs[i].length = 0;
+
+        if (i > 0 && E_OK != BoundedQueue_Push(&pool->queue, &jobs[i], QUEUE_BLOCK, NULL))
+        {
+            pthread_mutex_lock(&batch.lock);
+            batch.pending--;
+            batch.failed = 1;
+            pthread_mutex_unlock(&batch.lock);
+        }
+    }
+
+    JpegEncoder_SetRestartRows(&pool->encoder, 1);
+    JpegEncoder_SetOptimizeCoding(&pool->encoder, 0);
+    if (E_OK == JpegEncoder_Encode(&pool->encoder, &jobs[0].image))
+        jobs[0].data = JpegEncoder_Detach(&pool->encoder, &jobs[0].length);
+
+    pthread_mutex_lock(&batch.lock);
+    while (batch.pending > 0)
+        pthread_cond_wait(&batch.done, &batch.lock);
+    pthread_mutex_unlock(&batch.lock);
+
+    pthread_mutex_destroy(&batch.lock);
+    pthread_cond_destroy(&batch.done);
+
+    if (batch.failed || NULL == jobs[0].data)
+        status = E_NOT_OK;
+    else
+        status = Pool_Join(jobs, count, image->height, data, length);
+
+    for (i = 0; i < count; i++)
+        free(jobs[i].data);
+
+    return status;
+
+}/* End of function EncoderPool_EncodeSlices */
+
+/** Stores the quality, frames submitted afterwards are encoded with it.
+ */
+void EncoderPool_SetQuality(EncoderPool* pool, int quality)
+{
+    quality = (quality < 1) ? 1 : ((quality > 100) ? 100 : quality);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->config.quality = quality;
+    pthread_mutex_unlock(&pool->lock);
+
+}/* End of function EncoderPool_SetQuality */
+
+/** Closes the queue so the encoder threads exit after encoding the remaining frames, then
+ * joins them. Every frame is delivered before its encoder thread picks the next job.
+ */
+void EncoderPool_Close(EncoderPool* pool)
+{
+    int i;
+
+    BoundedQueue_Close(&pool->queue);
+
+    for (i = 0; i < pool->started; i++)
+        pthread_join(pool->thread[i], NULL);
+    pool->started = 0;
+
+    BoundedQueue_DeInit(&pool->queue);
+    JpegEncoder_DeInit(&pool->encoder);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->delivered_cond);
+
+}/* End of function EncoderPool_Close */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
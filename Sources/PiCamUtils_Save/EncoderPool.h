@@ -0,0 +1,244 @@
+/**
+ * @file EncoderPool.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for parallel JPEG encoding across frames and restart interval slices </b>
+ * @version
+ * @date 2026-10-18 Initial template for parallel JPEG encoder pool
+ * @date 2026-10-18 Select quality of frames with a rate controller
+ * @date 2026-10-18 Add downscaled outputs and EXIF thumbnails of frames
+ * @date 2026-10-19 Pass the capture time of frames to the sink
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef ENCODERPOOL_H
+#define  ENCODERPOOL_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdint.h>
+#include <pthread.h>
+#include "Common_PiCam.h"
+#include "BoundedQueue.h"
+#include "JpegEncoder.h"
+#include "OutputSink.h"
+#include "Preview.h"
+#include "RateControl.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Maximum number of encoder threads of a pool */
+#define POOL_MAX_THREADS        (8)
+
+/** Maximum number of frames submitted to a pool and not yet delivered */
+#define POOL_MAX_WINDOW         (32)
+
+/** Maximum number of slices of a single frame */
+#define POOL_MAX_SLICES         (16)
+
+/** Height of an MCU row in luminance rows, libjpeg subsamples chroma 2x2 by default */
+#define POOL_MCU_ROWS           (16)
+
+/** Minimum number of MCU rows of a slice, smaller slices do not pay off the extra markers */
+#define POOL_MIN_SLICE_ROWS     (4)
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Configuration of an encoder pool */
+typedef struct
+{
+    /** Number of encoder threads (1 to POOL_MAX_THREADS) */
+    int threads;
+    /** Maximum number of frames in flight, submitting blocks while it is reached
+     *  (1 to POOL_MAX_WINDOW) */
+    int window;
+    /** Compression quality (1 to 100) */
+    int quality;
+    /** Number of slices a single frame is split into, 0 or 1 encodes frames in one piece
+     *  (0 to POOL_MAX_SLICES) */
+    int slices;
+    /** Function receiving encoded files in submission order, NULL to write files directly */
+    Sink_SubmitFunc submit;
+    /** Output sink passed to submit */
+    void* sink;
+    /** Rate controller selecting quality and DCT method of frames, NULL for fixed quality */
+    RateControl* rate;
+    /** Downscaled outputs and thumbnail of submitted frames, all zero for none */
+    Preview_Config preview;
+} EncoderPool_Config;
+
+/** Slices of a frame encoded together, the submitting thread waits for all of them */
+typedef struct
+{
+    /** Number of slices not encoded yet */
+    int pending;
+    /** Set if any slice could not be encoded */
+    int failed;
+    /** Lock protecting the batch */
+    pthread_mutex_t lock;
+    /** Signalled when the last slice is encoded */
+    pthread_cond_t done;
+} Pool_Batch;
+
+/** Work item of an encoder pool, either a complete frame or a slice of a batch */
+typedef struct
+{
+    /** Image to encode */
+    Image_Planar image;
+    /** Frame buffer allocated with malloc and released after encoding, NULL for slices */
+    unsigned char* frame;
+    /** Batch of a slice, NULL for frames */
+    Pool_Batch* batch;
+    /** Compression quality (1 to 100) */
+    int quality;
+    /** 1 for fast integer DCT, 0 for accurate integer DCT */
+    int fast_dct;
+    /** Position of a frame in submission order */
+    uint32_t sequence;
+    /** Name of the file of a frame */
+    char filename[SINK_MAX_FILENAME];
+    /** Capture time of a frame passed to the sink */
+    int64_t captured;
+    /** Encoded image allocated with malloc, NULL if encoding failed */
+    unsigned char* data;
+    /** Size of the encoded image in bytes */
+    size_t length;
+    /** Downscaled outputs of a frame, delivered before the frame */
+    Preview_Output output[PYRAMID_MAX_LEVELS];
+    /** Number of downscaled outputs */
+    int outputs;
+} Pool_Job;
+
+/** Pool of threads encoding JPEG images with one persistent encoder each. Consecutive frames
+ *  are encoded concurrently and delivered in submission order. A single frame can be split
+ *  into bands of MCU rows which are encoded concurrently with restart markers and joined into
+ *  one baseline JPEG image.
+ */
+typedef struct
+{
+    /** Configuration of the pool */
+    EncoderPool_Config config;
+    /** Jobs waiting for an encoder thread */
+    BoundedQueue queue;
+    /** Encoder threads */
+    pthread_t thread[POOL_MAX_THREADS];
+    /** Number of started encoder threads */
+    int started;
+    /** Encoder of the thread splitting frames into slices */
+    JpegEncoder encoder;
+    /** Lock protecting ordering and statistics */
+    pthread_mutex_t lock;
+    /** Signalled when frames were delivered */
+    pthread_cond_t delivered_cond;
+    /** Encoded frames waiting for their predecessors, indexed by sequence modulo window */
+    Pool_Job* ready[POOL_MAX_WINDOW];
+    /** Sequence number of the next submitted frame */
+    uint32_t next_in;
+    /** Sequence number of the next frame to deliver */
+    uint32_t next_out;
+    /** Set while a thread delivers frames */
+    int delivering;
+    /** Number of frames delivered */
+    unsigned long frames;
+    /** Number of frames which could not be encoded or delivered */
+    unsigned long failed;
+} EncoderPool;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Initializes an encoder pool and starts its encoder threads.
+ *
+ * @param[inout] pool   Encoder pool to initialize
+ * @param[in] config    Configuration of the pool
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType EncoderPool_Init(EncoderPool* pool, const EncoderPool_Config* config);
+
+/**
+ * @brief   Queues a frame to be encoded. Blocks while the configured number of frames is in
+ *          flight. Must be called from a single thread.
+ *
+ * @param[inout] pool   Encoder pool
+ * @param[in] image     Image to encode, planes pointing into frame
+ * @param[in] frame     Frame buffer allocated with malloc, ownership passes to the pool
+ * @param[in] filename  Name of the encoded file
+ * @param[in] captured  Capture time in microseconds of CLOCK_MONOTONIC, 0 if unknown
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Frame queued
+ * @retval E_NOT_OK         Frame rejected and released
+ *
+ */
+Std_ReturnType EncoderPool_Submit(EncoderPool* pool, const Image_Planar* image, unsigned char* frame, const char* filename, int64_t captured);
+
+/**
+ * @brief   Encodes a single image, split into slices which are encoded concurrently by the
+ *          encoder threads and the calling thread. Images too small to split are encoded in
+ *          one piece. Must be called from a single thread.
+ *
+ * @param[inout] pool   Encoder pool
+ * @param[in] image     Image to encode
+ * @param[in] quality   Compression quality (1 to 100)
+ * @param[in] fast_dct  1 for fast integer DCT, 0 for accurate integer DCT
+ * @param[inout] preview    Downscaled outputs and thumbnail of the image, NULL for none
+ * @param[out] data     Encoded image allocated with malloc
+ * @param[out] length   Size of the encoded image in bytes
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType EncoderPool_EncodeSlices(EncoderPool* pool, const Image_Planar* image, int quality, int fast_dct, Preview* preview, unsigned char** data, size_t* length);
+
+/**
+ * @brief   Sets compression quality of subsequently submitted frames, unless a rate controller
+ *          selects it.
+ *
+ * @param[inout] pool   Encoder pool
+ * @param[in] quality   Compression quality (1 to 100)
+ *
+ */
+void EncoderPool_SetQuality(EncoderPool* pool, int quality);
+
+/**
+ * @brief   Encodes and delivers all queued frames, stops the encoder threads and releases the
+ *          pool.
+ *
+ * @param[inout] pool   Encoder pool to close
+ *
+ */
+void EncoderPool_Close(EncoderPool* pool);
+
+/** @} */
+
+#endif /** ENCODERPOOL_H **/
+
+/*==============================[  End of File  ]======================================*/
@@ -0,0 +1,327 @@
+/**
+ * @file FrameLog.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of append-only frame log with preallocated segments and index </b>
+ * @version
+ * @date 2026-10-18 Initial template for segmented frame log
+ * @date 2026-10-19 Take the capture time of submitted frames
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <time.h>
+#include "FrameLog.h"
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to create and preallocate the data and index files of a segment.
+ *
+ * @param[inout] log    Frame log
+ * @param[in] segment   Segment number
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType FrameLog_OpenSegment(FrameLog* log, uint32_t segment);
+
+/**
+ * @brief   Helper function to mark the open segment closed, release unused preallocated space
+ *          and unmap its index.
+ *
+ * @param[inout] log    Frame log
+ *
+ */
+static inline void FrameLog_CloseSegment(FrameLog* log);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** Reserves blocks of the data file with fallocate, so appending frames does not allocate
+ * metadata. The index file is sized for segment_frames records and mapped shared, readers can
+ * map it while the segment is recorded.
+ */
+static inline Std_ReturnType FrameLog_OpenSegment(FrameLog* log, uint32_t segment)
+{
+    char path[FRAMELOG_MAX_PATH + 32];
+    void* map;
+
+    log->index_size = sizeof(FrameLog_IndexHeader) + (size_t)log->config.segment_frames * sizeof(FrameLog_Record);
+
+    snprintf(path, sizeof(path), FRAMELOG_DATA_FMT, log->prefix, segment);
+    log->data_fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (-1 == log->data_fd)
+        return E_NOT_OK;
+
+    /** Preallocation is an optimization, file systems without fallocate grow on demand */
+    if (0 != fallocate(log->data_fd, 0, 0, (off_t)log->config.segment_bytes) && EOPNOTSUPP != errno)
+    {
+        close(log->data_fd);
+        log->data_fd = -1;
+        return E_NOT_OK;
+    }
+
+    snprintf(path, sizeof(path), FRAMELOG_INDEX_FMT, log->prefix, segment);
+    log->index_fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (-1 == log->index_fd ||
+        (0 != fallocate(log->index_fd, 0, 0, (off_t)log->index_size) && 0 != ftruncate(log->index_fd, (off_t)log->index_size)))
+    {
+        if (-1 != log->index_fd)
+            close(log->index_fd);
+        close(log->data_fd);
+        log->data_fd = -1;
+        return E_NOT_OK;
+    }
+
+    map = mmap(NULL, log->index_size, PROT_READ | PROT_WRITE, MAP_SHARED, log->index_fd, 0);
+    if (MAP_FAILED == map)
+    {
+        close(log->index_fd);
+        close(log->data_fd);
+        log->data_fd = -1;
+        return E_NOT_OK;
+    }
+
+    log->header = map;
+    log->records = (FrameLog_Record*)(log->header + 1);
+    log->segment = segment;
+
+    memset(log->header, 0, sizeof(FrameLog_IndexHeader));
+    log->header->version = FRAMELOG_VERSION;
+    log->header->record_size = sizeof(FrameLog_Record);
+    log->header->capacity = log->config.segment_frames;
+    log->header->segment = segment;
+    log->header->first_sequence = log->sequence;
+    __atomic_store_n(&log->header->magic, FRAMELOG_MAGIC, __ATOMIC_RELEASE);
+
+    return E_OK;
+
+}/* End of function FrameLog_OpenSegment */
+
+/** Truncates data and index files to their used size, which also releases the preallocated
+ * blocks beyond the last frame.
+ */
+static inline void FrameLog_CloseSegment(FrameLog* log)
+{
+    uint64_t count = log->header->count;
+    size_t used = sizeof(FrameLog_IndexHeader) + (size_t)count * sizeof(FrameLog_Record);
+
+    log->header->capacity = (uint32_t)count;
+    __atomic_or_fetch(&log->header->flags, FRAMELOG_INDEX_CLOSED, __ATOMIC_RELEASE);
+
+    if (0 != ftruncate(log->data_fd, (off_t)log->header->data_size))
+        fprintf(stderr, "Could not truncate segment %u, error %d, %s\n", log->segment, errno, strerror(errno));
+
+    munmap(log->header, log->index_size);
+    if (0 != ftruncate(log->index_fd, (off_t)used))
+        fprintf(stderr, "Could not truncate index %u, error %d, %s\n", log->segment, errno, strerror(errno));
+
+    close(log->index_fd);
+    close(log->data_fd);
+
+    log->header = NULL;
+    log->records = NULL;
+    log->data_fd = -1;
+    log->index_fd = -1;
+
+}/* End of function FrameLog_CloseSegment */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** Skips segments already present with the same prefix and continues the sequence numbers
+ * of the last one.
+ */
+Std_ReturnType FrameLog_Open(FrameLog* log, const FrameLog_Config* config)
+{
+    Std_ReturnType validate = E_OK;
+    char path[FRAMELOG_MAX_PATH + 32];
+    uint32_t segment = 0;
+
+    validate += ValidateParam(log);
+    validate += ValidateParam((void*)config);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateParam((void*)config->prefix);
+        validate += (config->segment_bytes > 0) ? E_OK : E_NOT_OK;
+        validate += (config->segment_seconds >= 0) ? E_OK : E_NOT_OK;
+        validate += (config->segment_frames >= 1 && config->segment_frames <= FRAMELOG_MAX_FRAMES) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK == validate)
+        validate += (strlen(config->prefix) + 16 < FRAMELOG_MAX_PATH) ? E_OK : E_NOT_OK;
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    memset(log, 0, sizeof(FrameLog));
+    log->config = *config;
+    strcpy(log->prefix, config->prefix);
+    log->config.prefix = log->prefix;
+    log->data_fd = -1;
+    log->index_fd = -1;
+
+    for (;;)
+    {
+        snprintf(path, sizeof(path), FRAMELOG_INDEX_FMT, log->prefix, segment);
+        if (0 != access(path, F_OK))
+            break;
+        segment++;
+    }
+
+    if (segment > 0)
+    {
+        FrameLog_IndexHeader last;
+        int fd;
+
+        snprintf(path, sizeof(path), FRAMELOG_INDEX_FMT, log->prefix, segment - 1);
+        fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (-1 != fd)
+        {
+            if (sizeof(last) == pread(fd, &last, sizeof(last), 0) && FRAMELOG_MAGIC == last.magic)
+                log->sequence = last.first_sequence + last.count;
+            close(fd);
+        }
+    }
+
+    return FrameLog_OpenSegment(log, segment);
+
+}/* End of function FrameLog_Open */
+
+/** Writes the frame behind the previous one, then fills its record and publishes it by
+ * incrementing the record count.
+ */
+Std_ReturnType FrameLog_Append(FrameLog* log, const unsigned char* data, size_t length, int64_t timestamp, uint32_t flags)
+{
+    FrameLog_IndexHeader* header;
+    FrameLog_Record* record;
+    uint64_t offset;
+    size_t done = 0;
+
+    if (-1 == log->data_fd || NULL == data || length > UINT32_MAX)
+        return E_NOT_OK;
+
+    header = log->header;
+    if (header->count > 0 &&
+        (header->count == header->capacity ||
+         header->data_size + length > log->config.segment_bytes ||
+         (log->config.segment_seconds > 0 && timestamp - header->first_timestamp >= (int64_t)log->config.segment_seconds * 1000000)))
+    {
+        FrameLog_CloseSegment(log);
+        if (E_OK != FrameLog_OpenSegment(log, log->segment + 1))
+            return E_NOT_OK;
+        header = log->header;
+    }
+
+    offset = header->data_size;
+    while (done < length)
+    {
+        ssize_t r = pwrite(log->data_fd, data + done, length - done, (off_t)(offset + done));
+        if (r < 0 && EINTR == errno)
+            continue;
+        if (r <= 0)
+            return E_NOT_OK;
+        done += (size_t)r;
+    }
+
+    record = &log->records[header->count];
+    record->sequence = log->sequence;
+    record->timestamp = timestamp;
+    record->offset = offset;
+    record->length = (uint32_t)length;
+    record->flags = flags;
+
+    if (0 == header->count)
+        header->first_timestamp = timestamp;
+    header->last_timestamp = timestamp;
+    header->data_size = offset + length;
+    __atomic_store_n(&header->count, header->count + 1, __ATOMIC_RELEASE);
+
+    log->sequence++;
+
+    return E_OK;
+
+}/* End of function FrameLog_Append */
+
+/** Appends with the capture time, so the index stays ordered for FrameReader_FindTime, and
+ * releases the buffer. Frames without a capture time get the current monotonic time.
+ */
+Std_ReturnType FrameLog_Submit(void* log, const char* filename, unsigned char* data, size_t length, int64_t captured)
+{
+    struct timespec now;
+    Std_ReturnType status;
+
+    (void)filename;
+    if (captured <= 0)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        captured = (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+    }
+    status = FrameLog_Append((FrameLog*)log, data, length, captured, FRAMELOG_FLAG_JPEG);
+    free(data);
+
+    return status;
+
+}/* End of function FrameLog_Submit */
+
+/** Flushes the data file before the index, so a synced record never refers to lost data.
+ */
+Std_ReturnType FrameLog_Sync(FrameLog* log)
+{
+    if (-1 == log->data_fd)
+        return E_NOT_OK;
+
+    if (0 != fdatasync(log->data_fd))
+        return E_NOT_OK;
+
+    if (0 != msync(log->header, log->index_size, MS_SYNC))
+        return E_NOT_OK;
+
+    return E_OK;
+
+}/* End of function FrameLog_Sync */
+
+/** Closes the open segment.
+ */
+void FrameLog_Close(FrameLog* log)
+{
+    if (-1 != log->data_fd)
+        FrameLog_CloseSegment(log);
+
+}/* End of function FrameLog_Close */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
@@ -0,0 +1,233 @@
+/**
+ * @file FrameLog.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for append-only frame log with preallocated segments and index </b>
+ * @version
+ * @date 2026-10-18 Initial template for segmented frame log
+ * @date 2026-10-19 Take the capture time of submitted frames
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef FRAMELOG_H
+#define  FRAMELOG_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdint.h>
+#include "Common_PiCam.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Magic number at the start of an index file, "FLOG" in little endian */
+#define FRAMELOG_MAGIC          (0x474F4C46u)
+
+/** Version of the segment and index file layout */
+#define FRAMELOG_VERSION        (1)
+
+/** Maximum length of segment and index file paths, including terminating zero */
+#define FRAMELOG_MAX_PATH       (256)
+
+/** Maximum number of frames per segment */
+#define FRAMELOG_MAX_FRAMES     (1u << 24)
+
+/** Filename format of segment data files, arguments are prefix and segment number */
+#define FRAMELOG_DATA_FMT       "%s_%06u.seg"
+
+/** Filename format of segment index files, arguments are prefix and segment number */
+#define FRAMELOG_INDEX_FMT      "%s_%06u.idx"
+
+/** Frame flag: frame is a complete JPEG image */
+#define FRAMELOG_FLAG_JPEG      (0x1u)
+
+/** Frame flag: frame is an uncompressed image */
+#define FRAMELOG_FLAG_RAW       (0x2u)
+
+/** Frame flag: frames were dropped between the previous frame and this frame */
+#define FRAMELOG_FLAG_GAP       (0x4u)
+
+/** Index flag: segment was closed and will not grow */
+#define FRAMELOG_INDEX_CLOSED   (0x1u)
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Header at the start of an index file, 64 bytes */
+typedef struct
+{
+    /** FRAMELOG_MAGIC */
+    uint32_t magic;
+    /** FRAMELOG_VERSION */
+    uint16_t version;
+    /** Size of FrameLog_Record in bytes */
+    uint16_t record_size;
+    /** Number of records the index file has room for */
+    uint32_t capacity;
+    /** Segment number */
+    uint32_t segment;
+    /** Sequence number of the first frame of the segment */
+    uint64_t first_sequence;
+    /** Number of valid records, updated after the record is complete */
+    uint64_t count;
+    /** Number of valid bytes in the data file */
+    uint64_t data_size;
+    /** Timestamp of the first frame in microseconds */
+    int64_t first_timestamp;
+    /** Timestamp of the last frame in microseconds */
+    int64_t last_timestamp;
+    /** Index flags, FRAMELOG_INDEX_CLOSED */
+    uint32_t flags;
+    /** Reserved, zero */
+    uint32_t reserved;
+} FrameLog_IndexHeader;
+
+/** Index record of a single frame, 32 bytes */
+typedef struct
+{
+    /** Sequence number of the frame, consecutive across segments */
+    uint64_t sequence;
+    /** Capture timestamp in microseconds of CLOCK_MONOTONIC */
+    int64_t timestamp;
+    /** Offset of the frame in the data file */
+    uint64_t offset;
+    /** Size of the frame in bytes */
+    uint32_t length;
+    /** Frame flags, FRAMELOG_FLAG_* */
+    uint32_t flags;
+} FrameLog_Record;
+
+/** Configuration of a frame log */
+typedef struct
+{
+    /** Path prefix of segment files, segment number and extension are appended */
+    const char* prefix;
+    /** Size of a segment data file, preallocated when the segment is opened */
+    uint64_t segment_bytes;
+    /** Maximum time span of a segment in seconds, 0 to rotate by size only */
+    int segment_seconds;
+    /** Maximum number of frames of a segment (1 to FRAMELOG_MAX_FRAMES) */
+    uint32_t segment_frames;
+} FrameLog_Config;
+
+/** Append-only frame log writing concatenated frames into preallocated segment files. Every
+ *  segment has a memory mapped index file with a fixed-size record per frame.
+ */
+typedef struct
+{
+    /** Configuration of the log */
+    FrameLog_Config config;
+    /** Copy of the path prefix */
+    char prefix[FRAMELOG_MAX_PATH];
+    /** Number of the open segment */
+    uint32_t segment;
+    /** Descriptor of the open data file, -1 if no segment is open */
+    int data_fd;
+    /** Descriptor of the open index file */
+    int index_fd;
+    /** Mapping of the open index file */
+    FrameLog_IndexHeader* header;
+    /** Records of the open index file, following the header */
+    FrameLog_Record* records;
+    /** Size of the index file mapping in bytes */
+    size_t index_size;
+    /** Sequence number of the next frame */
+    uint64_t sequence;
+} FrameLog;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Opens a frame log. Recording continues after existing segments with the same prefix,
+ *          keeping sequence numbers consecutive.
+ *
+ * @param[inout] log    Frame log to open
+ * @param[in] config    Configuration of the log
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType FrameLog_Open(FrameLog* log, const FrameLog_Config* config);
+
+/**
+ * @brief   Appends a frame to the log, starting a new segment if the open segment is full by
+ *          size, frame count or time span.
+ *
+ * @param[inout] log        Frame log
+ * @param[in] data          Encoded frame
+ * @param[in] length        Size of the frame in bytes
+ * @param[in] timestamp     Capture timestamp in microseconds
+ * @param[in] flags         Frame flags, FRAMELOG_FLAG_*
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType FrameLog_Append(FrameLog* log, const unsigned char* data, size_t length, int64_t timestamp, uint32_t flags);
+
+/**
+ * @brief   Appends a JPEG file handed over by the write functions, signature matches
+ *          Sink_SubmitFunc. The filename is ignored, the frame is timestamped with its capture
+ *          time and the data is released. Must be called from a single thread.
+ *
+ * @param[inout] log    Pointer to FrameLog
+ * @param[in] filename  Ignored
+ * @param[in] data      Encoded frame allocated with malloc
+ * @param[in] length    Size of the frame in bytes
+ * @param[in] captured  Capture time in microseconds of CLOCK_MONOTONIC, 0 if unknown
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType FrameLog_Submit(void* log, const char* filename, unsigned char* data, size_t length, int64_t captured);
+
+/**
+ * @brief   Flushes frames and index of the open segment to storage.
+ *
+ * @param[inout] log    Frame log
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType FrameLog_Sync(FrameLog* log);
+
+/**
+ * @brief   Closes the open segment and the frame log.
+ *
+ * @param[inout] log    Frame log to close
+ *
+ */
+void FrameLog_Close(FrameLog* log);
+
+/** @} */
+
+#endif /** FRAMELOG_H **/
+
+/*==============================[  End of File  ]======================================*/
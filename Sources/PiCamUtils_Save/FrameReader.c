@@ -0,0 +1,379 @@
+/**
+ * @file FrameReader.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of random-access reader of frame log recordings </b>
+ * @version
+ * @date 2026-10-18 Initial template for frame log reader
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glob.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <jpeglib.h>
+#include "FrameReader.h"
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to map the index and data files of a segment and validate the
+ *          index header.
+ *
+ * @param[inout] seg        Segment to map
+ * @param[in] prefix        Path prefix of the segment files
+ * @param[in] segment       Segment number
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType FrameReader_MapSegment(FrameReader_Segment* seg, const char* prefix, uint32_t segment);
+
+/**
+ * @brief   Helper function to find the segment containing a frame position.
+ *
+ * @param[in] reader    Frame reader
+ * @param[in] index     Frame position within the recording
+ *
+ * @return const FrameReader_Segment*   Segment containing the frame
+ *
+ */
+static inline const FrameReader_Segment* FrameReader_FindSegment(const FrameReader* reader, uint64_t index);
+
+/**
+ * @brief   Error exit handler of libjpeg, jumps back to the decoding function.
+ *
+ * @param[in] cinfo     libjpeg decompressor object
+ *
+ */
+static void FrameReader_ErrorExit(j_common_ptr cinfo);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** Maps both files read-only. The number of records is limited by the size of the index
+ * file, so a segment which is still recorded or was not closed can be read.
+ */
+static inline Std_ReturnType FrameReader_MapSegment(FrameReader_Segment* seg, const char* prefix, uint32_t segment)
+{
+    char path[FRAMELOG_MAX_PATH + 32];
+    struct stat st;
+    void* map;
+    uint64_t records;
+    int fd;
+
+    memset(seg, 0, sizeof(FrameReader_Segment));
+    seg->segment = segment;
+
+    snprintf(path, sizeof(path), FRAMELOG_INDEX_FMT, prefix, segment);
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (-1 == fd)
+        return E_NOT_OK;
+
+    if (0 != fstat(fd, &st) || (size_t)st.st_size < sizeof(FrameLog_IndexHeader))
+    {
+        close(fd);
+        return E_NOT_OK;
+    }
+
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (MAP_FAILED == map)
+        return E_NOT_OK;
+
+    seg->header = map;
+    seg->index_size = st.st_size;
+    seg->records = (const FrameLog_Record*)(seg->header + 1);
+
+    if (FRAMELOG_MAGIC != seg->header->magic || FRAMELOG_VERSION != seg->header->version ||
+        sizeof(FrameLog_Record) != seg->header->record_size)
+    {
+        munmap(map, seg->index_size);
+        seg->header = NULL;
+        return E_NOT_OK;
+    }
+
+    records = (seg->index_size - sizeof(FrameLog_IndexHeader)) / sizeof(FrameLog_Record);
+    seg->count = __atomic_load_n(&seg->header->count, __ATOMIC_ACQUIRE);
+    if (seg->count > records)
+        seg->count = records;
+
+    snprintf(path, sizeof(path), FRAMELOG_DATA_FMT, prefix, segment);
+    fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (-1 == fd || 0 != fstat(fd, &st))
+    {
+        if (-1 != fd)
+            close(fd);
+        munmap((void*)seg->header, seg->index_size);
+        seg->header = NULL;
+        return E_NOT_OK;
+    }
+
+    if (st.st_size > 0)
+    {
+        map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (MAP_FAILED != map)
+        {
+            seg->data = map;
+            seg->data_size = st.st_size;
+            /** Frames are read in order when extracting ranges */
+            madvise(map, st.st_size, MADV_SEQUENTIAL);
+        }
+    }
+    close(fd);
+
+    if (NULL == seg->data)
+        seg->count = 0;
+
+    return E_OK;
+
+}/* End of function FrameReader_MapSegment */
+
+/** Binary search for the last segment starting at or before the position.
+ */
+static inline const FrameReader_Segment* FrameReader_FindSegment(const FrameReader* reader, uint64_t index)
+{
+    uint32_t low = 0;
+    uint32_t high = reader->segment_count - 1;
+
+    while (low < high)
+    {
+        uint32_t mid = (low + high + 1) / 2;
+        if (reader->segments[mid].first <= index)
+            low = mid;
+        else
+            high = mid - 1;
+    }
+
+    return &reader->segments[low];
+
+}/* End of function FrameReader_FindSegment */
+
+/** Returns to the setjmp point of FrameReader_Decode.
+ */
+static void FrameReader_ErrorExit(j_common_ptr cinfo)
+{
+    FrameReader_ErrorMgr* err = (FrameReader_ErrorMgr*)cinfo->err;
+    longjmp(err->jump, 1);
+
+}/* End of function FrameReader_ErrorExit */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** Collects the index files of the prefix in segment order and maps each segment. Segments
+ * which cannot be mapped are skipped.
+ */
+Std_ReturnType FrameReader_Open(FrameReader* reader, const char* prefix)
+{
+    char pattern[FRAMELOG_MAX_PATH + 32];
+    glob_t files;
+    size_t i;
+
+    if (NULL == reader || NULL == prefix || strlen(prefix) + 16 >= FRAMELOG_MAX_PATH)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    memset(reader, 0, sizeof(FrameReader));
+
+    snprintf(pattern, sizeof(pattern), "%s_[0-9][0-9][0-9][0-9][0-9][0-9]*.idx", prefix);
+    if (0 != glob(pattern, 0, NULL, &files))
+        return E_NOT_OK;
+
+    reader->segments = calloc(files.gl_pathc, sizeof(FrameReader_Segment));
+    if (NULL == reader->segments)
+    {
+        globfree(&files);
+        return E_NOT_OK;
+    }
+
+    /** glob sorts names, the zero padded segment numbers sort numerically */
+    for (i = 0; i < files.gl_pathc; i++)
+    {
+        FrameReader_Segment* seg = &reader->segments[reader->segment_count];
+        const char* number = files.gl_pathv[i] + strlen(prefix) + 1;
+
+        if (E_OK != FrameReader_MapSegment(seg, prefix, (uint32_t)strtoul(number, NULL, 10)))
+            continue;
+
+        seg->first = reader->frame_count;
+        reader->frame_count += seg->count;
+        reader->segment_count++;
+    }
+
+    globfree(&files);
+
+    if (0 == reader->segment_count)
+    {
+        FrameReader_Close(reader);
+        return E_NOT_OK;
+    }
+
+    return E_OK;
+
+}/* End of function FrameReader_Open */
+
+/** Unmaps data and index files of every segment.
+ */
+void FrameReader_Close(FrameReader* reader)
+{
+    uint32_t i;
+
+    for (i = 0; i < reader->segment_count; i++)
+    {
+        if (NULL != reader->segments[i].data)
+            munmap((void*)reader->segments[i].data, reader->segments[i].data_size);
+        if (NULL != reader->segments[i].header)
+            munmap((void*)reader->segments[i].header, reader->segments[i].index_size);
+    }
+
+    free(reader->segments);
+    memset(reader, 0, sizeof(FrameReader));
+
+}/* End of function FrameReader_Close */
+
+/** Locates the segment, then the record directly by its position within the segment.
+ */
+Std_ReturnType FrameReader_Get(const FrameReader* reader, uint64_t index, FrameReader_Frame* frame)
+{
+    const FrameReader_Segment* seg;
+    const FrameLog_Record* record;
+
+    if (index >= reader->frame_count)
+        return E_NOT_OK;
+
+    seg = FrameReader_FindSegment(reader, index);
+    record = &seg->records[index - seg->first];
+
+    if (record->offset > seg->data_size || record->length > seg->data_size - record->offset)
+        return E_NOT_OK;
+
+    frame->data = seg->data + record->offset;
+    frame->length = record->length;
+    frame->sequence = record->sequence;
+    frame->timestamp = record->timestamp;
+    frame->flags = record->flags;
+
+    return E_OK;
+
+}/* End of function FrameReader_Get */
+
+/** Lower bound over frame positions, only index records are touched.
+ */
+uint64_t FrameReader_FindTime(const FrameReader* reader, int64_t timestamp)
+{
+    uint64_t low = 0;
+    uint64_t high = reader->frame_count;
+
+    while (low < high)
+    {
+        uint64_t mid = low + (high - low) / 2;
+        const FrameReader_Segment* seg = FrameReader_FindSegment(reader, mid);
+
+        if (seg->records[mid - seg->first].timestamp < timestamp)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    return low;
+
+}/* End of function FrameReader_FindTime */
+
+/** Decodes from the mapped frame with jpeg_mem_src. Scaled decoding also uses the fast DCT
+ * and plain upsampling, which are not visible at thumbnail size.
+ */
+Std_ReturnType FrameReader_Decode(const FrameReader_Frame* frame, int denom, Image_Planar* image)
+{
+    struct jpeg_decompress_struct cinfo;
+    FrameReader_ErrorMgr jerr;
+    unsigned char* volatile pixels = NULL;
+    JSAMPROW rows[16];
+    int stride, i;
+
+    if (NULL == frame || NULL == image || (1 != denom && 2 != denom && 4 != denom && 8 != denom))
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    cinfo.err = jpeg_std_error(&jerr.pub);
+    jerr.pub.error_exit = FrameReader_ErrorExit;
+    if (setjmp(jerr.jump))
+    {
+        jpeg_destroy_decompress(&cinfo);
+        free(pixels);
+        return E_NOT_OK;
+    }
+
+    jpeg_create_decompress(&cinfo);
+    jpeg_mem_src(&cinfo, frame->data, frame->length);
+    jpeg_read_header(&cinfo, TRUE);
+
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = denom;
+    cinfo.out_color_space = (1 == cinfo.num_components) ? JCS_GRAYSCALE : JCS_RGB;
+    if (denom > 1)
+    {
+        cinfo.dct_method = JDCT_IFAST;
+        cinfo.do_fancy_upsampling = FALSE;
+    }
+    jpeg_start_decompress(&cinfo);
+
+    stride = cinfo.output_width * cinfo.output_components;
+    pixels = malloc((size_t)stride * cinfo.output_height);
+    if (NULL == pixels)
+    {
+        jpeg_destroy_decompress(&cinfo);
+        return E_NOT_OK;
+    }
+
+    while (cinfo.output_scanline < cinfo.output_height)
+    {
+        int count = cinfo.output_height - cinfo.output_scanline;
+        if (count > 16)
+            count = 16;
+        for (i = 0; i < count; i++)
+            rows[i] = pixels + (size_t)(cinfo.output_scanline + i) * stride;
+        jpeg_read_scanlines(&cinfo, rows, count);
+    }
+
+    Image_SetPlanar(image, (1 == cinfo.output_components) ? PIXFMT_GRAY : PIXFMT_RGB24, cinfo.output_width, cinfo.output_height, pixels);
+
+    jpeg_finish_decompress(&cinfo);
+    jpeg_destroy_decompress(&cinfo);
+
+    return E_OK;
+
+}/* End of function FrameReader_Decode */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
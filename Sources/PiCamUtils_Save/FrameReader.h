@@ -0,0 +1,171 @@
+/**
+ * @file FrameReader.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for random-access reader of frame log recordings </b>
+ * @version
+ * @date 2026-10-18 Initial template for frame log reader
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef FRAMEREADER_H
+#define  FRAMEREADER_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <setjmp.h>
+#include <jpeglib.h>
+#include "Common_PiCam.h"
+#include "FrameLog.h"
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Memory mapped segment of a recording */
+typedef struct
+{
+    /** Segment number */
+    uint32_t segment;
+    /** Mapping of the data file */
+    const unsigned char* data;
+    /** Size of the data file mapping in bytes */
+    size_t data_size;
+    /** Mapping of the index file */
+    const FrameLog_IndexHeader* header;
+    /** Records following the index header */
+    const FrameLog_Record* records;
+    /** Size of the index file mapping in bytes */
+    size_t index_size;
+    /** Number of valid records when the segment was opened */
+    uint64_t count;
+    /** Position of the first frame of the segment within the recording */
+    uint64_t first;
+} FrameReader_Segment;
+
+/** Reader of all segments of a recording sharing a path prefix */
+typedef struct
+{
+    /** Segments ordered by segment number */
+    FrameReader_Segment* segments;
+    /** Number of segments */
+    uint32_t segment_count;
+    /** Number of frames of all segments */
+    uint64_t frame_count;
+} FrameReader;
+
+/** Frame of a recording. The data points into the mapped segment and stays valid until the
+ *  reader is closed.
+ */
+typedef struct
+{
+    /** Encoded frame */
+    const unsigned char* data;
+    /** Size of the frame in bytes */
+    size_t length;
+    /** Sequence number of the frame */
+    uint64_t sequence;
+    /** Capture timestamp in microseconds */
+    int64_t timestamp;
+    /** Frame flags, FRAMELOG_FLAG_* */
+    uint32_t flags;
+} FrameReader_Frame;
+
+/** libjpeg error handler returning to the decoding function instead of terminating the
+ *  program, since recorded frames may be truncated.
+ */
+typedef struct
+{
+    /** Standard libjpeg error handler */
+    struct jpeg_error_mgr pub;
+    /** Return point of the decoding function */
+    jmp_buf jump;
+} FrameReader_ErrorMgr;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Opens all segments of a recording with memory mapped index and data files. Frames
+ *          appended to the last segment after opening are not visible.
+ *
+ * @param[inout] reader     Frame reader to open
+ * @param[in] prefix        Path prefix of the segment files
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType FrameReader_Open(FrameReader* reader, const char* prefix);
+
+/**
+ * @brief   Unmaps all segments of a recording.
+ *
+ * @param[inout] reader     Frame reader to close
+ *
+ */
+void FrameReader_Close(FrameReader* reader);
+
+/**
+ * @brief   Returns a frame without copying its data.
+ *
+ * @param[in] reader    Frame reader
+ * @param[in] index     Frame position within the recording (0 to frame_count - 1)
+ * @param[out] frame    Frame description
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType FrameReader_Get(const FrameReader* reader, uint64_t index, FrameReader_Frame* frame);
+
+/**
+ * @brief   Finds the first frame captured at or after a timestamp with binary search over
+ *          segments and records. Timestamps are expected in capture order.
+ *
+ * @param[in] reader        Frame reader
+ * @param[in] timestamp     Timestamp in microseconds
+ *
+ * @return uint64_t         Frame position, frame_count if all frames are older
+ *
+ */
+uint64_t FrameReader_FindTime(const FrameReader* reader, int64_t timestamp);
+
+/**
+ * @brief   Decodes a JPEG frame with DCT scaling, decoding at 1/2, 1/4 or 1/8 size skips most of
+ *          the inverse transform work. The image buffer is allocated and must be released with
+ *          free(image->plane[0]).
+ *
+ * @param[in] frame     JPEG frame
+ * @param[in] denom     Scale denominator (1, 2, 4 or 8)
+ * @param[out] image    Decoded PIXFMT_RGB24 or PIXFMT_GRAY image
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType FrameReader_Decode(const FrameReader_Frame* frame, int denom, Image_Planar* image);
+
+/** @} */
+
+#endif /** FRAMEREADER_H **/
+
+/*==============================[  End of File  ]======================================*/
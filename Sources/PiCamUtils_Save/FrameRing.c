@@ -0,0 +1,587 @@
+/**
+ * @file FrameRing.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of a shared memory frame ring read by other processes without copies </b>
+ * @version
+ * @date 2026-10-18 Initial template for the shared memory frame ring
+ * @date 2026-10-19 Take the capture time of submitted frames
+ * @date 2026-10-19 Lease frames to readers and lend slots for frames copied in place
+ * @date 2026-10-19 Keep private helpers out of the header
+ * @date 2026-10-19 Worker threads block the signals of the application
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include "FrameRing.h"
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Thread function sending the shared memory descriptor to every connecting reader.
+ *
+ * @param[in] arg   Pointer to FrameRing
+ *
+ * @return void*    NULL
+ *
+ */
+static void* FrameRing_Acceptor(void* arg);
+
+/**
+ * @brief   Helper function to wake readers waiting for a frame.
+ *
+ * @param[inout] header Header of the ring
+ *
+ */
+static inline void FrameRing_Wake(FrameRing_Header* header);
+
+/**
+ * @brief   Helper function returning the time in microseconds of CLOCK_MONOTONIC.
+ *
+ * @return uint64_t Current time in microseconds
+ *
+ */
+static inline uint64_t FrameRing_Now(void);
+
+/**
+ * @brief   Helper function to take the oldest slot no reader holds for writing, taking back
+ *          slots whose lease expired. The slot is empty afterwards.
+ *
+ * @param[inout] ring   Frame ring
+ *
+ * @return int  Slot taken, -1 if readers hold every slot
+ *
+ */
+static inline int FrameRing_Take(FrameRing* ring);
+
+/**
+ * @brief   Helper function to publish the frame written into a taken slot and wake readers.
+ *
+ * @param[inout] ring   Frame ring
+ * @param[in] s         Slot taken with FrameRing_Take
+ * @param[in] captured  Capture time in microseconds of CLOCK_MONOTONIC
+ *
+ */
+static inline void FrameRing_Publish(FrameRing* ring, int s, int64_t captured);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** The size of the ring travels with the descriptor, so readers map it without fstat.
+ */
+static void* FrameRing_Acceptor(void* arg)
+{
+    FrameRing* ring = (FrameRing*)arg;
+
+    Thread_BlockSignals();
+
+    for (;;)
+    {
+        char control[CMSG_SPACE(sizeof(int))];
+        uint64_t size = ring->size;
+        struct iovec iov = { &size, sizeof(size) };
+        struct msghdr msg;
+        struct cmsghdr* cmsg;
+        int fd;
+
+        fd = accept4(ring->fd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0)
+        {
+            if (EINTR == errno || ECONNABORTED == errno)
+                continue;
+            break;
+        }
+
+        memset(&msg, 0, sizeof(msg));
+        memset(control, 0, sizeof(control));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &ring->memfd, sizeof(int));
+
+        (void)sendmsg(fd, &msg, MSG_NOSIGNAL);
+        close(fd);
+    }
+
+    return NULL;
+
+}/* End of function FrameRing_Acceptor */
+
+/** The system call is skipped while no reader waits.
+ */
+static inline void FrameRing_Wake(FrameRing_Header* header)
+{
+    if (__atomic_load_n(&header->waiters, __ATOMIC_SEQ_CST) > 0)
+        syscall(SYS_futex, &header->futex, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+
+}/* End of function FrameRing_Wake */
+
+/** Leases run on CLOCK_MONOTONIC like the timestamps of V4L2 buffers.
+ */
+static inline uint64_t FrameRing_Now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+
+}/* End of function FrameRing_Now */
+
+/** A slot is claimed by clearing its sequence number before its readers are checked, while
+ * readers register before they check the sequence number. With sequentially consistent
+ * operations on both sides, either the producer sees the reader or the reader sees the
+ * cleared slot. Taking a slot back starts a new generation with no readers, the exchange
+ * fails if a reader registered meanwhile.
+ */
+static inline int FrameRing_Take(FrameRing* ring)
+{
+    FrameRing_Header* header = ring->header;
+    uint64_t now = FrameRing_Now();
+    uint64_t lease_us = (uint64_t)ring->config.lease_ms * 1000;
+    int i;
+
+    for (i = 0; i < ring->config.slots; i++)
+    {
+        int s = (ring->next + i) % ring->config.slots;
+        FrameRing_Slot* slot = &header->slot[s];
+        uint64_t lease = __atomic_load_n(&slot->lease, __ATOMIC_SEQ_CST);
+        uint64_t previous;
+
+        if (0 != (uint32_t)lease)
+        {
+            if ((int64_t)(now - __atomic_load_n(&slot->acquired, __ATOMIC_SEQ_CST)) < (int64_t)lease_us ||
+                !__atomic_compare_exchange_n(&slot->lease, &lease, ((lease >> 32) + 1) << 32, 0,
+                                             __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST))
+                continue;
+            ring->reclaimed++;
+        }
+
+        previous = __atomic_exchange_n(&slot->sequence, 0, __ATOMIC_SEQ_CST);
+        if (0 != (uint32_t)__atomic_load_n(&slot->lease, __ATOMIC_SEQ_CST))
+        {
+            /** The reader validated the previous frame, which is still intact */
+            __atomic_store_n(&slot->sequence, previous, __ATOMIC_SEQ_CST);
+            continue;
+        }
+
+        return s;
+    }
+
+    return -1;
+
+}/* End of function FrameRing_Take */
+
+/** The timestamp is written before the sequence number is, readers validating the sequence
+ * number see it.
+ */
+static inline void FrameRing_Publish(FrameRing* ring, int s, int64_t captured)
+{
+    FrameRing_Header* header = ring->header;
+
+    ring->sequence++;
+    header->slot[s].timestamp = (uint64_t)captured;
+    __atomic_store_n(&header->slot[s].sequence, ring->sequence, __ATOMIC_RELEASE);
+    __atomic_store_n(&header->head, (ring->sequence << 8) | (uint64_t)s, __ATOMIC_RELEASE);
+    __atomic_store_n(&header->futex, (uint32_t)ring->sequence, __ATOMIC_SEQ_CST);
+    FrameRing_Wake(header);
+
+    ring->next = (s + 1) % ring->config.slots;
+    ring->frames++;
+
+}/* End of function FrameRing_Publish */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** The memfd is sealed against resizing, so no reader can truncate it under the others.
+ */
+Std_ReturnType FrameRing_Open(FrameRing* ring, const FrameRing_Config* config)
+{
+    Std_ReturnType validate = E_OK;
+    struct sockaddr_un addr;
+    size_t frame_size, slot_size, data_offset;
+
+    validate += ValidateParam(ring);
+    validate += ValidateParam((void*)config);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateParam((void*)config->path);
+        validate += ValidateValue(config->slots, 2, FRAMERING_MAX_SLOTS);
+        validate += (config->lease_ms > 0) ? E_OK : E_NOT_OK;
+        validate += ((config->width > 0) && (config->height > 0) && !(config->width & 1) && !(config->height & 1)) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK == validate)
+        validate += (strlen(config->path) < sizeof(addr.sun_path)) ? E_OK : E_NOT_OK;
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    memset(ring, 0, sizeof(FrameRing));
+    ring->config = *config;
+    ring->fd = -1;
+    ring->claimed = -1;
+
+    frame_size = (size_t)config->width * config->height * 3 / 2;
+    slot_size = (frame_size + FRAMERING_ALIGN - 1) & ~(size_t)(FRAMERING_ALIGN - 1);
+    data_offset = (sizeof(FrameRing_Header) + FRAMERING_ALIGN - 1) & ~(size_t)(FRAMERING_ALIGN - 1);
+    ring->size = data_offset + slot_size * config->slots;
+
+    ring->memfd = memfd_create("picam-ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (-1 == ring->memfd)
+        return E_NOT_OK;
+
+    if (-1 == ftruncate(ring->memfd, (off_t)ring->size) ||
+        -1 == fcntl(ring->memfd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL))
+    {
+        FrameRing_Close(ring);
+        return E_NOT_OK;
+    }
+
+    ring->header = mmap(NULL, ring->size, PROT_READ | PROT_WRITE, MAP_SHARED, ring->memfd, 0);
+    if (MAP_FAILED == ring->header)
+    {
+        ring->header = NULL;
+        FrameRing_Close(ring);
+        return E_NOT_OK;
+    }
+
+    ring->header->version = FRAMERING_VERSION;
+    ring->header->slots = (uint16_t)config->slots;
+    ring->header->width = (uint32_t)config->width;
+    ring->header->height = (uint32_t)config->height;
+    ring->header->frame_size = frame_size;
+    ring->header->slot_size = slot_size;
+    ring->header->data_offset = data_offset;
+    ring->header->lease_ms = (uint32_t)config->lease_ms;
+    __atomic_store_n(&ring->header->magic, FRAMERING_MAGIC, __ATOMIC_RELEASE);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, config->path);
+
+    ring->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    unlink(config->path);
+    if (-1 == ring->fd ||
+        -1 == bind(ring->fd, (struct sockaddr*)&addr, sizeof(addr)) ||
+        -1 == listen(ring->fd, 16) ||
+        0 != pthread_create(&ring->thread, NULL, FrameRing_Acceptor, ring))
+    {
+        FrameRing_Close(ring);
+        return E_NOT_OK;
+    }
+    ring->thread_running = 1;
+
+    return E_OK;
+
+}/* End of function FrameRing_Open */
+
+/** The slot stays lent until a frame is published, a capture which stopped before submitting
+ * its frame gets the same slot back.
+ */
+unsigned char* FrameRing_Claim(void* sink, size_t length)
+{
+    FrameRing* ring = (FrameRing*)sink;
+    FrameRing_Header* header = ring->header;
+
+    if (NULL == header || length != header->frame_size)
+        return NULL;
+
+    if (-1 == ring->claimed)
+        ring->claimed = FrameRing_Take(ring);
+    if (-1 == ring->claimed)
+        return NULL;
+
+    return (unsigned char*)header + header->data_offset + (size_t)ring->claimed * header->slot_size;
+
+}/* End of function FrameRing_Claim */
+
+/** Frames from FrameRing_Claim are already in place, other frames are copied and released.
+ */
+Std_ReturnType FrameRing_Submit(void* sink, const char* filename, unsigned char* data, size_t length, int64_t captured)
+{
+    FrameRing* ring = (FrameRing*)sink;
+    FrameRing_Header* header = ring->header;
+    int s;
+
+    (void)filename;
+
+    if (NULL != header && -1 != ring->claimed &&
+        data == (unsigned char*)header + header->data_offset + (size_t)ring->claimed * header->slot_size)
+    {
+        FrameRing_Publish(ring, ring->claimed, captured);
+        ring->claimed = -1;
+        return E_OK;
+    }
+
+    if (NULL == header || NULL == data || length != header->frame_size)
+    {
+        free(data);
+        ring->dropped++;
+        return E_NOT_OK;
+    }
+
+    s = (-1 != ring->claimed) ? ring->claimed : FrameRing_Take(ring);
+    if (-1 == s)
+    {
+        free(data);
+        ring->dropped++;
+        return E_NOT_OK;
+    }
+
+    memcpy((unsigned char*)header + header->data_offset + (size_t)s * header->slot_size, data, length);
+    free(data);
+    FrameRing_Publish(ring, s, captured);
+    ring->claimed = -1;
+    return E_OK;
+
+}/* End of function FrameRing_Submit */
+
+/** Shutting down the listening socket wakes the thread blocked in accept.
+ */
+void FrameRing_Close(FrameRing* ring)
+{
+    if (ring->thread_running)
+    {
+        shutdown(ring->fd, SHUT_RDWR);
+        pthread_join(ring->thread, NULL);
+        ring->thread_running = 0;
+    }
+
+    if (-1 != ring->fd)
+    {
+        close(ring->fd);
+        unlink(ring->config.path);
+        ring->fd = -1;
+    }
+
+    if (NULL != ring->header)
+    {
+        __atomic_or_fetch(&ring->header->flags, FRAMERING_CLOSED, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&ring->header->futex, 1, __ATOMIC_SEQ_CST);
+        FrameRing_Wake(ring->header);
+        munmap(ring->header, ring->size);
+        ring->header = NULL;
+    }
+
+    if (-1 != ring->memfd)
+        close(ring->memfd);
+    ring->memfd = -1;
+
+}/* End of function FrameRing_Close */
+
+/** The descriptor is closed once mapped, the mapping keeps the memory alive.
+ */
+Std_ReturnType FrameRing_Attach(FrameRing_Reader* reader, const char* path)
+{
+    Std_ReturnType validate = E_OK;
+    char control[CMSG_SPACE(sizeof(int))];
+    uint64_t size = 0;
+    struct iovec iov = { &size, sizeof(size) };
+    struct sockaddr_un addr;
+    struct msghdr msg;
+    struct cmsghdr* cmsg;
+    int fd, memfd = -1;
+
+    validate += ValidateParam(reader);
+    validate += ValidateParam((void*)path);
+
+    if (E_OK == validate)
+        validate += (strlen(path) < sizeof(addr.sun_path)) ? E_OK : E_NOT_OK;
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    memset(reader, 0, sizeof(FrameRing_Reader));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (-1 == fd)
+        return E_NOT_OK;
+    if (-1 == connect(fd, (struct sockaddr*)&addr, sizeof(addr)))
+    {
+        close(fd);
+        return E_NOT_OK;
+    }
+
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    if (sizeof(size) == recvmsg(fd, &msg, MSG_CMSG_CLOEXEC))
+    {
+        cmsg = CMSG_FIRSTHDR(&msg);
+        if (NULL != cmsg && SOL_SOCKET == cmsg->cmsg_level && SCM_RIGHTS == cmsg->cmsg_type)
+            memcpy(&memfd, CMSG_DATA(cmsg), sizeof(int));
+    }
+    close(fd);
+
+    if (-1 == memfd)
+        return E_NOT_OK;
+
+    reader->header = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+    close(memfd);
+    if (MAP_FAILED == reader->header)
+    {
+        reader->header = NULL;
+        return E_NOT_OK;
+    }
+    reader->size = (size_t)size;
+
+    if (FRAMERING_MAGIC != __atomic_load_n(&reader->header->magic, __ATOMIC_ACQUIRE) ||
+        FRAMERING_VERSION != reader->header->version)
+    {
+        FrameRing_Detach(reader);
+        return E_NOT_OK;
+    }
+
+    return E_OK;
+
+}/* End of function FrameRing_Attach */
+
+/** The futex word is read before the head, so a frame published in between makes the wait
+ * return at once.
+ */
+Std_ReturnType FrameRing_Acquire(FrameRing_Reader* reader, FrameRing_Frame* frame, int timeout_ms)
+{
+    FrameRing_Header* header = reader->header;
+    struct timespec timeout = { timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000 };
+    int waited = 0;
+
+    for (;;)
+    {
+        uint32_t word = __atomic_load_n(&header->futex, __ATOMIC_SEQ_CST);
+        uint64_t head = __atomic_load_n(&header->head, __ATOMIC_ACQUIRE);
+        uint64_t sequence = head >> 8;
+        int s = (int)(head & 0xFF);
+
+        if (__atomic_load_n(&header->flags, __ATOMIC_ACQUIRE) & FRAMERING_CLOSED)
+            return E_NOT_OK;
+
+        if (0 != sequence && sequence != reader->last && s < header->slots)
+        {
+            FrameRing_Slot* slot = &header->slot[s];
+            uint64_t lease;
+
+            /** The lease starts before the reader is counted, so the producer never sees the
+             *  reader with the time of an earlier acquire */
+            __atomic_store_n(&slot->acquired, FrameRing_Now(), __ATOMIC_SEQ_CST);
+            lease = __atomic_add_fetch(&slot->lease, 1, __ATOMIC_SEQ_CST);
+            frame->slot = s;
+            frame->generation = (uint32_t)(lease >> 32);
+            if (sequence == __atomic_load_n(&slot->sequence, __ATOMIC_SEQ_CST))
+            {
+                reader->last = sequence;
+                frame->sequence = sequence;
+                frame->timestamp = slot->timestamp;
+                Image_SetPlanar(&frame->image, PIXFMT_YUV420, (int)header->width, (int)header->height,
+                    (unsigned char*)header + header->data_offset + (size_t)s * header->slot_size);
+                return E_OK;
+            }
+
+            /** Overwritten meanwhile, a newer frame is published */
+            (void)FrameRing_Release(reader, frame);
+            continue;
+        }
+
+        if (0 == timeout_ms || waited)
+            return E_NOT_OK;
+
+        __atomic_add_fetch(&header->waiters, 1, __ATOMIC_SEQ_CST);
+        if (word == __atomic_load_n(&header->futex, __ATOMIC_SEQ_CST))
+            syscall(SYS_futex, &header->futex, FUTEX_WAIT, word, (timeout_ms < 0) ? NULL : &timeout, NULL, 0);
+        __atomic_sub_fetch(&header->waiters, 1, __ATOMIC_SEQ_CST);
+        waited = 1;
+    }
+
+}/* End of function FrameRing_Acquire */
+
+/** After the release the producer may overwrite the frame. A slot taken back belongs to a
+ * newer generation, its readers are not counted down.
+ */
+Std_ReturnType FrameRing_Release(FrameRing_Reader* reader, const FrameRing_Frame* frame)
+{
+    FrameRing_Slot* slot = &reader->header->slot[frame->slot];
+    uint64_t lease = __atomic_load_n(&slot->lease, __ATOMIC_RELAXED);
+
+    do
+    {
+        if ((uint32_t)(lease >> 32) != frame->generation || 0 == (uint32_t)lease)
+            return E_NOT_OK;
+    } while (!__atomic_compare_exchange_n(&slot->lease, &lease, lease - 1, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    return E_OK;
+
+}/* End of function FrameRing_Release */
+
+/** Readers stop acquiring frames of a closed ring.
+ */
+int FrameRing_IsClosed(const FrameRing_Reader* reader)
+{
+    return (__atomic_load_n(&reader->header->flags, __ATOMIC_ACQUIRE) & FRAMERING_CLOSED) ? 1 : 0;
+
+}/* End of function FrameRing_IsClosed */
+
+/** Frames still acquired must be released before.
+ */
+void FrameRing_Detach(FrameRing_Reader* reader)
+{
+    if (NULL != reader->header)
+        munmap(reader->header, reader->size);
+    reader->header = NULL;
+    reader->size = 0;
+
+}/* End of function FrameRing_Detach */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
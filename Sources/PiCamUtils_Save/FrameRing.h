@@ -0,0 +1,315 @@
+/**
+ * @file FrameRing.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for a shared memory frame ring read by other processes without copies </b>
+ * @version
+ * @date 2026-10-18 Initial template for the shared memory frame ring
+ * @date 2026-10-19 Take the capture time of submitted frames
+ * @date 2026-10-19 Lease frames to readers and lend slots for frames copied in place
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef FRAMERING_H
+#define  FRAMERING_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "Common_PiCam.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Identifier at the start of the ring, "FRNG" */
+#define FRAMERING_MAGIC         (0x474E5246u)
+
+/** Version of the ring layout */
+#define FRAMERING_VERSION       (2)
+
+/** Maximum number of frames in the ring */
+#define FRAMERING_MAX_SLOTS     (64)
+
+/** Alignment of frames in the ring, frames start on separate pages */
+#define FRAMERING_ALIGN         (4096)
+
+/** Set in the flags of the header once the producer closed the ring */
+#define FRAMERING_CLOSED        (0x1u)
+
+/** Default time a reader may hold a frame before the producer can take its slot back */
+#define FRAMERING_LEASE_MS      (1000)
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** State of one frame in the ring, shared between processes */
+typedef struct
+{
+    /** Sequence number of the frame, 0 while the slot is empty or being written */
+    uint64_t sequence;
+    /** Capture time of the V4L2 buffer in microseconds of CLOCK_MONOTONIC */
+    uint64_t timestamp;
+    /** Generation of the slot shifted left by 32 or-ed with the number of readers holding the
+     *  frame. The producer does not overwrite a held frame until its lease expired, then it
+     *  starts a new generation, which the late readers cannot release anymore. */
+    uint64_t lease;
+    /** Time of the latest acquire in microseconds of CLOCK_MONOTONIC, the lease runs from it */
+    uint64_t acquired;
+} FrameRing_Slot;
+
+/** Header at the start of the shared memory, followed by the frames. Fields after head are
+ *  changed with atomic operations only.
+ */
+typedef struct
+{
+    /** FRAMERING_MAGIC */
+    uint32_t magic;
+    /** FRAMERING_VERSION */
+    uint16_t version;
+    /** Number of slots */
+    uint16_t slots;
+    /** Width of frames in pixels */
+    uint32_t width;
+    /** Height of frames in pixels */
+    uint32_t height;
+    /** Size of an I420 frame in bytes */
+    uint64_t frame_size;
+    /** Distance between two frames in bytes */
+    uint64_t slot_size;
+    /** Offset of the first frame from the start of the shared memory */
+    uint64_t data_offset;
+    /** Latest frame, sequence number shifted left by 8 or-ed with its slot, 0 before the first */
+    uint64_t head;
+    /** Low 32 bits of the latest sequence number, readers wait on it with futex */
+    uint32_t futex;
+    /** Number of readers waiting on futex */
+    uint32_t waiters;
+    /** FRAMERING_CLOSED once the producer stopped */
+    uint32_t flags;
+    /** Time a reader may hold a frame in milliseconds */
+    uint32_t lease_ms;
+    /** State of the frames */
+    FrameRing_Slot slot[FRAMERING_MAX_SLOTS];
+} FrameRing_Header;
+
+/** Configuration of a frame ring */
+typedef struct
+{
+    /** Path of the Unix domain socket handing out the ring */
+    const char* path;
+    /** Number of frames in the ring (2 to FRAMERING_MAX_SLOTS) */
+    int slots;
+    /** Width of frames in pixels, even */
+    int width;
+    /** Height of frames in pixels, even */
+    int height;
+    /** Time a reader may hold a frame in milliseconds before its slot is taken back, a dead
+     *  reader blocks its slot no longer */
+    int lease_ms;
+} FrameRing_Config;
+
+/** Producer side of a frame ring. The frames live in a sealed memfd which readers receive
+ *  over a Unix domain socket, so every process maps the same pages once.
+ */
+typedef struct
+{
+    /** Configuration of the ring */
+    FrameRing_Config config;
+    /** Shared memory descriptor, -1 if closed */
+    int memfd;
+    /** Listening socket handing out memfd */
+    int fd;
+    /** Mapped shared memory */
+    FrameRing_Header* header;
+    /** Size of the shared memory in bytes */
+    size_t size;
+    /** Slot after the last written one */
+    int next;
+    /** Slot lent by FrameRing_Claim and not yet published, -1 if none */
+    int claimed;
+    /** Sequence number of the last published frame */
+    uint64_t sequence;
+    /** Thread accepting readers */
+    pthread_t thread;
+    /** Set while thread runs */
+    int thread_running;
+    /** Number of published frames */
+    unsigned long frames;
+    /** Number of frames dropped because readers held every slot */
+    unsigned long dropped;
+    /** Number of slots taken back from readers whose lease expired */
+    unsigned long reclaimed;
+} FrameRing;
+
+/** Reader side of a frame ring in another process */
+typedef struct
+{
+    /** Mapped shared memory, NULL if detached */
+    FrameRing_Header* header;
+    /** Size of the shared memory in bytes */
+    size_t size;
+    /** Sequence number of the last acquired frame */
+    uint64_t last;
+} FrameRing_Reader;
+
+/** Frame acquired from a frame ring */
+typedef struct
+{
+    /** I420 image pointing into the shared memory, valid until released */
+    Image_Planar image;
+    /** Sequence number, frames missed by the reader leave gaps */
+    uint64_t sequence;
+    /** Capture time of the V4L2 buffer in microseconds of CLOCK_MONOTONIC */
+    uint64_t timestamp;
+    /** Slot of the frame */
+    int slot;
+    /** Generation of the slot when the frame was acquired */
+    uint32_t generation;
+} FrameRing_Frame;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Creates the shared memory and the socket handing it out. An existing socket file
+ *          at the path is replaced.
+ *
+ * @param[inout] ring   Frame ring to open
+ * @param[in] config    Configuration of the ring
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType FrameRing_Open(FrameRing* ring, const FrameRing_Config* config);
+
+/**
+ * @brief   Lends the slot the next frame is written into, signature matches Sink_ClaimFunc.
+ *          Capture copies the frame straight into the shared memory and submits the returned
+ *          pointer, which publishes it without another copy. Claiming again before the submit
+ *          returns the same slot. Must be called from the thread submitting frames.
+ *
+ * @param[inout] sink   Pointer to FrameRing
+ * @param[in] length    Size of the frame in bytes, width * height * 3 / 2
+ *
+ * @return unsigned char*   Frame in the shared memory, NULL if readers hold every slot
+ *
+ */
+unsigned char* FrameRing_Claim(void* sink, size_t length);
+
+/**
+ * @brief   Publishes an I420 frame, signature matches Sink_SubmitFunc. A frame written into the
+ *          slot lent by FrameRing_Claim is published in place, other frames are copied into
+ *          the oldest slot no reader holds and released. Must be called from a single thread.
+ *
+ * @param[inout] sink   Pointer to FrameRing
+ * @param[in] filename  Ignored
+ * @param[in] data      I420 frame from FrameRing_Claim or allocated with malloc
+ * @param[in] length    Size of the frame in bytes, width * height * 3 / 2
+ * @param[in] captured  Capture time of the V4L2 buffer in microseconds of CLOCK_MONOTONIC
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Frame was dropped
+ *
+ */
+Std_ReturnType FrameRing_Submit(void* sink, const char* filename, unsigned char* data, size_t length, int64_t captured);
+
+/**
+ * @brief   Marks the ring closed for readers, stops handing it out and removes the socket.
+ *          Readers keep their mapping until they detach.
+ *
+ * @param[inout] ring   Frame ring to close
+ *
+ */
+void FrameRing_Close(FrameRing* ring);
+
+/**
+ * @brief   Connects to the socket of a ring and maps its shared memory.
+ *
+ * @param[out] reader   Reader to attach
+ * @param[in] path      Path of the socket
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType FrameRing_Attach(FrameRing_Reader* reader, const char* path);
+
+/**
+ * @brief   Acquires the latest frame if it is newer than the last acquired one. The producer
+ *          does not overwrite the frame until it is released or its lease of lease_ms expired,
+ *          so slots of a reader which exits without releasing its frames are taken back.
+ *
+ * @param[inout] reader     Attached reader
+ * @param[out] frame        Acquired frame
+ * @param[in] timeout_ms    Maximum time to wait for a new frame in milliseconds, 0 to return
+ *                          at once, negative to wait forever
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Frame acquired
+ * @retval E_NOT_OK         No new frame within the timeout or the ring is closed
+ *
+ */
+Std_ReturnType FrameRing_Acquire(FrameRing_Reader* reader, FrameRing_Frame* frame, int timeout_ms);
+
+/**
+ * @brief   Releases an acquired frame.
+ *
+ * @param[inout] reader Attached reader
+ * @param[in] frame     Acquired frame
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Frame was intact until released
+ * @retval E_NOT_OK         Lease expired and the slot was taken back, the frame read may be
+ *                          partly overwritten
+ *
+ */
+Std_ReturnType FrameRing_Release(FrameRing_Reader* reader, const FrameRing_Frame* frame);
+
+/**
+ * @brief   Checks if the producer closed the ring.
+ *
+ * @param[in] reader    Attached reader
+ *
+ * @return int  1 if closed, 0 otherwise
+ *
+ */
+int FrameRing_IsClosed(const FrameRing_Reader* reader);
+
+/**
+ * @brief   Unmaps the shared memory of a reader.
+ *
+ * @param[inout] reader Reader to detach
+ *
+ */
+void FrameRing_Detach(FrameRing_Reader* reader);
+
+/** @} */
+
+#endif /** FRAMERING_H **/
+
+/*==============================[  End of File  ]======================================*/
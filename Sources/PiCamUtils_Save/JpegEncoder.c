@@ -0,0 +1,576 @@
+/**
+ * @file JpegEncoder.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of reusable JPEG encoder with in-memory destination </b>
+ * @version
+ * @date 2026-10-18 Initial template for persistent JPEG encoder
+ * @date 2026-10-18 Add detaching the output buffer for asynchronous sinks
+ * @date 2026-10-18 Add restart interval for slice encoding
+ * @date 2026-10-18 Add EXIF segment of the next frame
+ * @date 2026-10-19 Time encoding for the stage histograms
+ * @date 2026-10-19 Return libjpeg errors instead of exiting and free the grown buffer
+ * @date 2026-10-19 Keep private helpers out of the header and grow the buffer in place
+ * @date 2026-10-19 Leave out the JFIF segment of images with EXIF
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <jpeglib.h>
+#include <jerror.h>
+#include "JpegEncoder.h"
+#include "Metrics.h"
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Error handler of libjpeg printing the message and returning to the running call of
+ *          the encoder instead of exiting the process.
+ *
+ * @param[in] cinfo     libjpeg object which failed
+ *
+ */
+static inline void JpegEncoder_ErrorExit(j_common_ptr cinfo);
+
+/**
+ * @brief   Destination callback of libjpeg starting a compression at the beginning of the
+ *          output buffer.
+ *
+ * @param[inout] cinfo  libjpeg compressor object
+ *
+ */
+static void JpegEncoder_InitDestination(j_compress_ptr cinfo);
+
+/**
+ * @brief   Destination callback of libjpeg enlarging the output buffer once it is full.
+ *
+ * @param[inout] cinfo  libjpeg compressor object
+ *
+ * @return boolean      TRUE, a failed allocation raises a libjpeg error
+ *
+ */
+static boolean JpegEncoder_EmptyDestination(j_compress_ptr cinfo);
+
+/**
+ * @brief   Destination callback of libjpeg storing the size of the finished image.
+ *
+ * @param[inout] cinfo  libjpeg compressor object
+ *
+ */
+static void JpegEncoder_TermDestination(j_compress_ptr cinfo);
+
+/**
+ * @brief   Helper function to configure the compressor for an input format. Default parameters
+ *          are only set again if the format changed since the previous frame.
+ *
+ * @param[inout] enc    JPEG encoder
+ * @param[in] format    Pixel format of the input image
+ *
+ */
+static inline void JpegEncoder_Configure(JpegEncoder* enc, Image_Format format);
+
+/**
+ * @brief   Helper function to feed interleaved rows to the compressor, passing all remaining
+ *          rows with each call.
+ *
+ * @param[inout] enc    JPEG encoder
+ * @param[in] image     Interleaved input image
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType Feed_Scanlines(JpegEncoder* enc, const Image_Planar* image);
+
+/**
+ * @brief   Helper function to feed planes of a YUV420 image to the compressor as raw data.
+ *
+ * @param[inout] enc    JPEG encoder
+ * @param[in] image     Planar YUV420 input image
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType Feed_RawYUV420(JpegEncoder* enc, const Image_Planar* image);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** The encoder is found through client_data, variables the running call keeps across the
+ * jump live in the encoder.
+ */
+static inline void JpegEncoder_ErrorExit(j_common_ptr cinfo)
+{
+    JpegEncoder* enc = (JpegEncoder*)cinfo->client_data;
+
+    (*cinfo->err->output_message)(cinfo);
+    longjmp(enc->error_jump, 1);
+
+}/* End of function JpegEncoder_ErrorExit */
+
+/** Output starts at the beginning of the buffer owned by the encoder.
+ */
+static void JpegEncoder_InitDestination(j_compress_ptr cinfo)
+{
+    JpegEncoder* enc = (JpegEncoder*)cinfo->client_data;
+
+    enc->dest.next_output_byte = enc->buffer;
+    enc->dest.free_in_buffer = enc->capacity;
+
+}/* End of function JpegEncoder_InitDestination */
+
+/** libjpeg calls this with the whole buffer filled. The buffer is enlarged in place, so it
+ * stays owned by the encoder even if the frame fails later on.
+ */
+static boolean JpegEncoder_EmptyDestination(j_compress_ptr cinfo)
+{
+    JpegEncoder* enc = (JpegEncoder*)cinfo->client_data;
+    unsigned long size = (0 != enc->capacity) ? enc->capacity * 2 : 4096;
+    unsigned char* buffer = realloc(enc->buffer, size);
+
+    if (NULL == buffer)
+        ERREXIT1(cinfo, JERR_OUT_OF_MEMORY, 10);
+
+    enc->dest.next_output_byte = buffer + enc->capacity;
+    enc->dest.free_in_buffer = size - enc->capacity;
+    enc->buffer = buffer;
+    enc->capacity = size;
+
+    return TRUE;
+
+}/* End of function JpegEncoder_EmptyDestination */
+
+/** Everything up to the free space was written.
+ */
+static void JpegEncoder_TermDestination(j_compress_ptr cinfo)
+{
+    JpegEncoder* enc = (JpegEncoder*)cinfo->client_data;
+
+    enc->length = enc->capacity - enc->dest.free_in_buffer;
+
+}/* End of function JpegEncoder_TermDestination */
+
+/** Sets in_color_space and defaults on a format change and applies pending parameters. Both
+ * are skipped for consecutive frames of the same format, so the quantization tables are
+ * only scaled once.
+ */
+static inline void JpegEncoder_Configure(JpegEncoder* enc, Image_Format format)
+{
+    struct jpeg_compress_struct* cinfo = &enc->cinfo;
+
+    if (enc->format != (int)format)
+    {
+        switch (format)
+        {
+            case PIXFMT_GRAY:
+                cinfo->input_components = 1;
+                cinfo->in_color_space = JCS_GRAYSCALE;
+                break;
+
+            case PIXFMT_RGB24:
+                cinfo->input_components = 3;
+                cinfo->in_color_space = JCS_RGB;
+                break;
+
+            default:
+                cinfo->input_components = 3;
+                cinfo->in_color_space = JCS_YCbCr;
+                break;
+        }
+
+        jpeg_set_defaults(cinfo);
+
+        if (PIXFMT_YUV420 == format)
+        {
+            cinfo->raw_data_in = TRUE;
+#if JPEG_LIB_VERSION >= 70
+            cinfo->do_fancy_downsampling = FALSE;
+#endif
+            cinfo->comp_info[0].h_samp_factor = 2;
+            cinfo->comp_info[0].v_samp_factor = 2;
+            cinfo->comp_info[1].h_samp_factor = 1;
+            cinfo->comp_info[1].v_samp_factor = 1;
+            cinfo->comp_info[2].h_samp_factor = 1;
+            cinfo->comp_info[2].v_samp_factor = 1;
+        }
+
+        enc->format = (int)format;
+        enc->dirty = 1;
+    }
+
+    if (enc->dirty)
+    {
+        jpeg_set_quality(cinfo, enc->quality, TRUE);
+        cinfo->dct_method = enc->fast_dct ? JDCT_IFAST : JDCT_ISLOW;
+        cinfo->optimize_coding = enc->optimize_coding ? TRUE : FALSE;
+        /** libjpeg derives restart_interval from restart_in_rows and keeps it */
+        cinfo->restart_interval = 0;
+        cinfo->restart_in_rows = enc->restart_rows;
+        enc->dirty = 0;
+    }
+
+}/* End of function JpegEncoder_Configure */
+
+/** Passes pointers to all remaining rows, libjpeg consumes as many as fit in its buffers.
+ */
+static inline Std_ReturnType Feed_Scanlines(JpegEncoder* enc, const Image_Planar* image)
+{
+    struct jpeg_compress_struct* cinfo = &enc->cinfo;
+    int row;
+
+    if (enc->rows_capacity < image->height)
+    {
+        JSAMPROW* rows = realloc(enc->rows, (size_t)image->height * sizeof(JSAMPROW));
+        if (NULL == rows)
+            return E_NOT_OK;
+        enc->rows = rows;
+        enc->rows_capacity = image->height;
+    }
+
+    for (row = 0; row < image->height; row++)
+        enc->rows[row] = image->plane[0] + (size_t)row * image->stride[0];
+
+    while (cinfo->next_scanline < cinfo->image_height)
+    {
+        JDIMENSION next = cinfo->next_scanline;
+        jpeg_write_scanlines(cinfo, &enc->rows[next], cinfo->image_height - next);
+    }
+
+    return E_OK;
+
+}/* End of function Feed_Scanlines */
+
+/** Feeds planes of a YUV420 image to the compressor in groups of 16 luminance rows. Rows
+ * below the image are replicated from the last row. If the width is not a multiple of 16
+ * rows are copied to padded line buffers, since libjpeg reads complete DCT blocks.
+ */
+static inline Std_ReturnType Feed_RawYUV420(JpegEncoder* enc, const Image_Planar* image)
+{
+    struct jpeg_compress_struct* cinfo = &enc->cinfo;
+    const int rows = cinfo->max_v_samp_factor * DCTSIZE;
+    const int chroma_width = (image->width + 1) / 2;
+    const int chroma_height = (image->height + 1) / 2;
+    const int luma_padded = ((image->width + 2*DCTSIZE - 1) / (2*DCTSIZE)) * 2*DCTSIZE;
+    const int chroma_padded = luma_padded / 2;
+    const int pad = (luma_padded != image->width);
+    JSAMPROW y_rows[2*DCTSIZE], u_rows[DCTSIZE], v_rows[DCTSIZE];
+    JSAMPARRAY planes[3] = { y_rows, u_rows, v_rows };
+    int row, i;
+
+    if (pad)
+    {
+        size_t size = (size_t)rows * luma_padded + 2 * (size_t)(rows / 2) * chroma_padded;
+        if (enc->scratch_size < size)
+        {
+            unsigned char* scratch = realloc(enc->scratch, size);
+            if (NULL == scratch)
+                return E_NOT_OK;
+            enc->scratch = scratch;
+            enc->scratch_size = size;
+        }
+    }
+
+    for (row = 0; row < image->height; row += rows)
+    {
+        for (i = 0; i < rows; i++)
+        {
+            int y = (row + i < image->height) ? row + i : image->height - 1;
+            y_rows[i] = image->plane[0] + (size_t)y * image->stride[0];
+        }
+        for (i = 0; i < rows / 2; i++)
+        {
+            int y = (row / 2 + i < chroma_height) ? row / 2 + i : chroma_height - 1;
+            u_rows[i] = image->plane[1] + (size_t)y * image->stride[1];
+            v_rows[i] = image->plane[2] + (size_t)y * image->stride[2];
+        }
+
+        if (pad)
+        {
+            /** Copy into padded line buffers and replicate the last column */
+            unsigned char* line = enc->scratch;
+            for (i = 0; i < rows; i++, line += luma_padded)
+            {
+                memcpy(line, y_rows[i], image->width);
+                memset(line + image->width, y_rows[i][image->width - 1], luma_padded - image->width);
+                y_rows[i] = line;
+            }
+            for (i = 0; i < rows / 2; i++)
+            {
+                memcpy(line, u_rows[i], chroma_width);
+                memset(line + chroma_width, u_rows[i][chroma_width - 1], chroma_padded - chroma_width);
+                u_rows[i] = line;
+                line += chroma_padded;
+                memcpy(line, v_rows[i], chroma_width);
+                memset(line + chroma_width, v_rows[i][chroma_width - 1], chroma_padded - chroma_width);
+                v_rows[i] = line;
+                line += chroma_padded;
+            }
+        }
+
+        jpeg_write_raw_data(cinfo, planes, rows);
+    }
+
+    return E_OK;
+
+}/* End of function Feed_RawYUV420 */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** Creates the compressor object, tables are set up with the first frame.
+ */
+Std_ReturnType JpegEncoder_Init(JpegEncoder* enc, int quality)
+{
+    Std_ReturnType validate = E_OK;
+
+    validate += ValidateParam(enc);
+    validate += ValidateValue(quality, 1, 100);
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    memset(enc, 0, sizeof(JpegEncoder));
+    enc->cinfo.err = jpeg_std_error(&enc->jerr);
+    enc->jerr.error_exit = JpegEncoder_ErrorExit;
+    enc->cinfo.client_data = enc;
+    if (setjmp(enc->error_jump))
+        return E_NOT_OK;
+    jpeg_create_compress(&enc->cinfo);
+
+    enc->dest.init_destination = JpegEncoder_InitDestination;
+    enc->dest.empty_output_buffer = JpegEncoder_EmptyDestination;
+    enc->dest.term_destination = JpegEncoder_TermDestination;
+    enc->cinfo.dest = &enc->dest;
+
+    enc->format = -1;
+    enc->quality = quality;
+    enc->dirty = 1;
+
+    return E_OK;
+
+}/* End of function JpegEncoder_Init */
+
+/** Destroys the compressor object and frees all buffers.
+ */
+void JpegEncoder_DeInit(JpegEncoder* enc)
+{
+    jpeg_destroy_compress(&enc->cinfo);
+
+    free(enc->buffer);
+    free(enc->rows);
+    free(enc->scratch);
+
+    enc->buffer = NULL;
+    enc->rows = NULL;
+    enc->scratch = NULL;
+    enc->capacity = 0;
+    enc->length = 0;
+    enc->rows_capacity = 0;
+    enc->scratch_size = 0;
+    enc->format = -1;
+
+}/* End of function JpegEncoder_DeInit */
+
+/** Stores the quality, tables are scaled with the next frame.
+ */
+void JpegEncoder_SetQuality(JpegEncoder* enc, int quality)
+{
+    quality = (quality < 1) ? 1 : ((quality > 100) ? 100 : quality);
+
+    if (enc->quality != quality)
+    {
+        enc->quality = quality;
+        enc->dirty = 1;
+    }
+
+}/* End of function JpegEncoder_SetQuality */
+
+/** Stores the DCT method, applied with the next frame.
+ */
+void JpegEncoder_SetFastDCT(JpegEncoder* enc, int enable)
+{
+    enc->fast_dct = (0 != enable);
+    enc->dirty = 1;
+
+}/* End of function JpegEncoder_SetFastDCT */
+
+/** Stores the Huffman optimization setting, applied with the next frame.
+ */
+void JpegEncoder_SetOptimizeCoding(JpegEncoder* enc, int enable)
+{
+    enc->optimize_coding = (0 != enable);
+    enc->dirty = 1;
+
+}/* End of function JpegEncoder_SetOptimizeCoding */
+
+/** Stores the restart interval, applied with the next frame.
+ */
+void JpegEncoder_SetRestartRows(JpegEncoder* enc, int rows)
+{
+    rows = (rows < 0) ? 0 : rows;
+
+    if (enc->restart_rows != rows)
+    {
+        enc->restart_rows = rows;
+        enc->dirty = 1;
+    }
+
+}/* End of function JpegEncoder_SetRestartRows */
+
+/** Stores a reference to the segment, it is dropped once written.
+ */
+void JpegEncoder_SetExif(JpegEncoder* enc, const unsigned char* data, unsigned int length)
+{
+    enc->exif = (length <= 65533) ? data : NULL;
+    enc->exif_length = (NULL != enc->exif) ? length : 0;
+
+}/* End of function JpegEncoder_SetExif */
+
+/** Encodes into the buffer owned by the encoder, which the destination manager enlarges in
+ * place when it fills up. The enlarged buffer is kept, so the following frames of similar
+ * size fit without further allocations. A failed frame leaves the encoder usable.
+ */
+Std_ReturnType JpegEncoder_Encode(JpegEncoder* enc, const Image_Planar* image)
+{
+    Std_ReturnType validate = E_OK;
+    Std_ReturnType status;
+    unsigned long size;
+    int64_t start;
+
+    validate += ValidateParam(enc);
+    validate += ValidateParam((void*)image);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateParam(image->plane[0]);
+        validate += (image->width > 0 && image->height > 0) ? E_OK : E_NOT_OK;
+        validate += (PIXFMT_YUV420 == image->format || PIXFMT_YUV444 == image->format ||
+                     PIXFMT_RGB24 == image->format || PIXFMT_GRAY == image->format) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    start = Metrics_Begin();
+
+    /** Start with a quarter of the uncompressed luminance size, or the size of the previous
+    image after the buffer has been detached */
+    if (NULL == enc->buffer)
+    {
+        if (0 != enc->length)
+            size = enc->length + enc->length / 4;
+        else
+            size = (unsigned long)image->width * image->height / 4 + 4096;
+        enc->buffer = malloc(size);
+        enc->capacity = (NULL != enc->buffer) ? size : 0;
+    }
+
+    /** libjpeg errors of this frame return here */
+    if (setjmp(enc->error_jump))
+        status = E_NOT_OK;
+    else
+    {
+        JpegEncoder_Configure(enc, image->format);
+        enc->cinfo.image_width = image->width;
+        enc->cinfo.image_height = image->height;
+        /** EXIF files carry APP1 directly after SOI instead of a JFIF segment */
+        enc->cinfo.write_JFIF_header = (NULL != enc->exif) ? FALSE : TRUE;
+
+        jpeg_start_compress(&enc->cinfo, TRUE);
+
+        if (NULL != enc->exif)
+        {
+            jpeg_write_marker(&enc->cinfo, JPEG_APP0 + 1, enc->exif, enc->exif_length);
+            enc->exif = NULL;
+            enc->exif_length = 0;
+        }
+
+        if (PIXFMT_YUV420 == image->format)
+            status = Feed_RawYUV420(enc, image);
+        else
+            status = Feed_Scanlines(enc, image);
+
+        if (E_OK == status)
+            jpeg_finish_compress(&enc->cinfo);
+    }
+
+    if (E_OK != status)
+    {
+        jpeg_abort_compress(&enc->cinfo);
+        enc->exif = NULL;
+        enc->exif_length = 0;
+        enc->length = 0;
+        return E_NOT_OK;
+    }
+
+    Metrics_End(METRIC_ENCODE, start);
+
+    return E_OK;
+
+}/* End of function JpegEncoder_Encode */
+
+/** Hands the buffer to the caller, a new one is allocated with the next frame.
+ */
+unsigned char* JpegEncoder_Detach(JpegEncoder* enc, size_t* length)
+{
+    unsigned char* data = enc->buffer;
+
+    *length = (NULL != data) ? enc->length : 0;
+    enc->buffer = NULL;
+    enc->capacity = 0;
+
+    return data;
+
+}/* End of function JpegEncoder_Detach */
+
+/** Writes the whole encoded image with one call.
+ */
+Std_ReturnType JpegEncoder_WriteFile(const JpegEncoder* enc, const char* filename)
+{
+    FILE* file;
+    size_t written;
+
+    file = fopen(filename, "wb");
+    if (NULL == file)
+        return E_NOT_OK;
+
+    written = fwrite(enc->buffer, 1, enc->length, file);
+
+    if (0 != fclose(file) || written != enc->length)
+        return E_NOT_OK;
+
+    return E_OK;
+
+}/* End of function JpegEncoder_WriteFile */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
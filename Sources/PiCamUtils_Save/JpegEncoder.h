@@ -0,0 +1,208 @@
+/**
+ * @file JpegEncoder.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for reusable JPEG encoder with in-memory destination </b>
+ * @version
+ * @date 2026-10-18 Initial template for persistent JPEG encoder
+ * @date 2026-10-18 Add detaching the output buffer for asynchronous sinks
+ * @date 2026-10-18 Add restart interval for slice encoding
+ * @date 2026-10-18 Add EXIF segment of the next frame
+ * @date 2026-10-19 Return libjpeg errors instead of exiting
+ * @date 2026-10-19 Note that slices joined by the encoder pool use standard Huffman tables
+ * @date 2026-10-19 Keep private helpers out of the header and grow the buffer in place
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef JPEGENCODER_H
+#define  JPEGENCODER_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <setjmp.h>
+#include <jpeglib.h>
+#include "Common_PiCam.h"
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Reusable JPEG encoder. The compressor object, quantization and Huffman tables are kept
+ *  across frames and only rebuilt when the input format or a parameter changes. Encoded
+ *  data is written to a memory buffer owned by the encoder which grows as required.
+ */
+typedef struct
+{
+    /** libjpeg compressor object */
+    struct jpeg_compress_struct cinfo;
+    /** libjpeg error handler */
+    struct jpeg_error_mgr jerr;
+    /** Return point of libjpeg errors in the running call */
+    jmp_buf error_jump;
+    /** Input format the compressor is configured for, -1 before the first frame */
+    int format;
+    /** Compression quality (1 to 100) */
+    int quality;
+    /** Use fast integer DCT instead of accurate integer DCT */
+    int fast_dct;
+    /** Compute optimal Huffman tables for every frame */
+    int optimize_coding;
+    /** Number of MCU rows between restart markers, 0 for no restart markers */
+    int restart_rows;
+    /** Contents of the APP1 EXIF segment of the next frame, NULL for none */
+    const unsigned char* exif;
+    /** Size of the EXIF segment contents in bytes */
+    unsigned int exif_length;
+    /** Set when a parameter changed and has to be applied before the next frame */
+    int dirty;
+    /** Output buffer containing the last encoded image */
+    unsigned char* buffer;
+    /** Allocated size of the output buffer in bytes */
+    unsigned long capacity;
+    /** libjpeg destination manager writing to the output buffer */
+    struct jpeg_destination_mgr dest;
+    /** Size of the last encoded image in bytes */
+    unsigned long length;
+    /** Row pointers passed to the compressor */
+    JSAMPROW* rows;
+    /** Number of allocated row pointers */
+    int rows_capacity;
+    /** Padded line buffers for raw YUV420 input */
+    unsigned char* scratch;
+    /** Allocated size of the padded line buffers in bytes */
+    size_t scratch_size;
+} JpegEncoder;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Initializes a JPEG encoder.
+ *
+ * @param[inout] enc    JPEG encoder to initialize
+ * @param[in] quality   Compression quality (1 to 100)
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType JpegEncoder_Init(JpegEncoder* enc, int quality);
+
+/**
+ * @brief   Releases the compressor object and buffers of a JPEG encoder.
+ *
+ * @param[inout] enc    JPEG encoder to release
+ *
+ */
+void JpegEncoder_DeInit(JpegEncoder* enc);
+
+/**
+ * @brief   Sets compression quality of subsequent frames.
+ *
+ * @param[inout] enc    JPEG encoder
+ * @param[in] quality   Compression quality (1 to 100)
+ *
+ */
+void JpegEncoder_SetQuality(JpegEncoder* enc, int quality);
+
+/**
+ * @brief   Selects fast integer DCT for subsequent frames. Fast DCT is less accurate at high
+ *          quality settings.
+ *
+ * @param[inout] enc    JPEG encoder
+ * @param[in] enable    1 for fast integer DCT, 0 for accurate integer DCT
+ *
+ */
+void JpegEncoder_SetFastDCT(JpegEncoder* enc, int enable);
+
+/**
+ * @brief   Enables optimized Huffman tables for subsequent frames. Optimized tables reduce file
+ *          size at the cost of an additional pass over the coefficients. Slices joined by the
+ *          encoder pool always use standard tables, as only the first slice header is kept.
+ *
+ * @param[inout] enc    JPEG encoder
+ * @param[in] enable    1 to compute optimal tables, 0 to use standard tables
+ *
+ */
+void JpegEncoder_SetOptimizeCoding(JpegEncoder* enc, int enable);
+
+/**
+ * @brief   Sets the restart interval of subsequent frames in MCU rows. Restart markers reset
+ *          the entropy coder, so independently encoded bands of rows can be joined.
+ *
+ * @param[inout] enc    JPEG encoder
+ * @param[in] rows      Number of MCU rows between restart markers, 0 for no restart markers
+ *
+ */
+void JpegEncoder_SetRestartRows(JpegEncoder* enc, int rows);
+
+/**
+ * @brief   Sets the EXIF segment written behind the JFIF header of the next frame only. The
+ *          data is referenced, not copied, and must stay valid until the frame is encoded.
+ *
+ * @param[inout] enc    JPEG encoder
+ * @param[in] data      Segment contents starting with "Exif", NULL for none
+ * @param[in] length    Size of the segment contents in bytes, at most 65533
+ *
+ */
+void JpegEncoder_SetExif(JpegEncoder* enc, const unsigned char* data, unsigned int length);
+
+/**
+ * @brief   Encodes an image into the output buffer of the encoder. Supported formats are
+ *          PIXFMT_YUV420, PIXFMT_YUV444, PIXFMT_RGB24 and PIXFMT_GRAY. The encoded image is
+ *          available in enc->buffer with enc->length bytes until the next call.
+ *
+ * @param[inout] enc    JPEG encoder
+ * @param[in] image     Image to encode
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType JpegEncoder_Encode(JpegEncoder* enc, const Image_Planar* image);
+
+/**
+ * @brief   Transfers ownership of the last encoded image to the caller, for example to pass it
+ *          to an output sink without copying. The returned buffer must be released with free.
+ *
+ * @param[inout] enc    JPEG encoder
+ * @param[out] length   Size of the encoded image in bytes
+ *
+ * @return unsigned char*   Encoded image, NULL if no image was encoded since the last call
+ *
+ */
+unsigned char* JpegEncoder_Detach(JpegEncoder* enc, size_t* length);
+
+/**
+ * @brief   Writes the last encoded image to a file with a single write.
+ *
+ * @param[in] enc       JPEG encoder
+ * @param[in] filename  Filename for image to save
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType JpegEncoder_WriteFile(const JpegEncoder* enc, const char* filename);
+
+/** @} */
+
+#endif /** JPEGENCODER_H **/
+
+/*==============================[  End of File  ]======================================*/
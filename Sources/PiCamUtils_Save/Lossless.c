@@ -0,0 +1,340 @@
+/**
+ * @file Lossless.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of lossless QOI and PGM/PPM image encoding </b>
+ * @version
+ * @date 2026-10-18 Initial template for lossless image encoding
+ * @date 2026-10-19 Time QOI encoding for the stage histograms
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Lossless.h"
+#include "Metrics.h"
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to expand a row of an RGB24, BGR24 or GRAY image to RGBA.
+ *
+ * @param[in] image     Source image descriptor
+ * @param[in] row       Row index
+ * @param[out] rgba     Destination row, 4 bytes per pixel
+ *
+ */
+static inline void Lossless_LoadRow(const Image_Planar* image, int row, unsigned char* rgba);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** Alpha of expanded pixels is opaque.
+ */
+static inline void Lossless_LoadRow(const Image_Planar* image, int row, unsigned char* rgba)
+{
+    const unsigned char* src = image->plane[0] + (size_t)row * image->stride[0];
+    int x;
+
+    switch (image->format)
+    {
+        case PIXFMT_RGB24:
+            for (x = 0; x < image->width; x++, src += 3, rgba += 4)
+            {
+                rgba[0] = src[0];
+                rgba[1] = src[1];
+                rgba[2] = src[2];
+                rgba[3] = 255;
+            }
+            break;
+
+        case PIXFMT_BGR24:
+            for (x = 0; x < image->width; x++, src += 3, rgba += 4)
+            {
+                rgba[0] = src[2];
+                rgba[1] = src[1];
+                rgba[2] = src[0];
+                rgba[3] = 255;
+            }
+            break;
+
+        case PIXFMT_GRAY:
+        default:
+            for (x = 0; x < image->width; x++, src++, rgba += 4)
+            {
+                rgba[0] = *src;
+                rgba[1] = *src;
+                rgba[2] = *src;
+                rgba[3] = 255;
+            }
+            break;
+    }
+
+}/* End of function Lossless_LoadRow */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** Pixels are compared as 32 bit words, so runs, which dominate flat areas and static scenes,
+ * cost a single comparison per pixel. Rows are expanded to RGBA one at a time.
+ */
+Std_ReturnType Qoi_Encode(const Image_Planar* image, unsigned char** data, size_t* length)
+{
+    Std_ReturnType validate = E_OK;
+    uint32_t index[64];
+    uint32_t prev = 0xFF000000u;
+    unsigned char* scratch = NULL;
+    unsigned char* out;
+    unsigned char* p;
+    int channels, run = 0, row, x;
+    int64_t start;
+
+    validate += ValidateParam((void*)image);
+    validate += ValidateParam(data);
+    validate += ValidateParam(length);
+
+    if (E_OK == validate)
+    {
+        validate += (image->width > 0 && image->height > 0) ? E_OK : E_NOT_OK;
+        validate += ValidateParam(image->plane[0]);
+        validate += ((PIXFMT_RGB24 == image->format) || (PIXFMT_BGR24 == image->format) ||
+                     (PIXFMT_RGBA == image->format) || (PIXFMT_GRAY == image->format)) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    start = Metrics_Begin();
+    channels = (PIXFMT_RGBA == image->format) ? 4 : 3;
+    out = malloc((size_t)image->width * image->height * (channels + 1) + QOI_HEADER_SIZE + QOI_END_SIZE);
+    if (PIXFMT_RGBA != image->format)
+        scratch = malloc((size_t)image->width * 4);
+    if (NULL == out || (PIXFMT_RGBA != image->format && NULL == scratch))
+    {
+        free(out);
+        free(scratch);
+        return E_NOT_OK;
+    }
+
+    memset(index, 0, sizeof(index));
+
+    p = out;
+    memcpy(p, "qoif", 4);
+    p[4] = (unsigned char)(image->width >> 24);
+    p[5] = (unsigned char)(image->width >> 16);
+    p[6] = (unsigned char)(image->width >> 8);
+    p[7] = (unsigned char)image->width;
+    p[8] = (unsigned char)(image->height >> 24);
+    p[9] = (unsigned char)(image->height >> 16);
+    p[10] = (unsigned char)(image->height >> 8);
+    p[11] = (unsigned char)image->height;
+    p[12] = (unsigned char)channels;
+    p[13] = 0;
+    p += QOI_HEADER_SIZE;
+
+    for (row = 0; row < image->height; row++)
+    {
+        const unsigned char* src;
+
+        if (NULL == scratch)
+        {
+            src = image->plane[0] + (size_t)row * image->stride[0];
+        }
+        else
+        {
+            Lossless_LoadRow(image, row, scratch);
+            src = scratch;
+        }
+
+        for (x = 0; x < image->width; x++, src += 4)
+        {
+            uint32_t px = (uint32_t)src[0] | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+            int hash;
+
+            if (px == prev)
+            {
+                if (++run == QOI_MAX_RUN)
+                {
+                    *p++ = (unsigned char)(0xC0 | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+
+            if (run > 0)
+            {
+                *p++ = (unsigned char)(0xC0 | (run - 1));
+                run = 0;
+            }
+
+            hash = (src[0] * 3 + src[1] * 5 + src[2] * 7 + src[3] * 11) & 63;
+
+            if (index[hash] == px)
+            {
+                *p++ = (unsigned char)hash;
+            }
+            else
+            {
+                index[hash] = px;
+
+                if ((px >> 24) == (prev >> 24))
+                {
+                    signed char dr = (signed char)(src[0] - (unsigned char)prev);
+                    signed char dg = (signed char)(src[1] - (unsigned char)(prev >> 8));
+                    signed char db = (signed char)(src[2] - (unsigned char)(prev >> 16));
+                    signed char dr_dg = (signed char)(dr - dg);
+                    signed char db_dg = (signed char)(db - dg);
+
+                    if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2)
+                    {
+                        *p++ = (unsigned char)(0x40 | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));
+                    }
+                    else if (dg > -33 && dg < 32 && dr_dg > -9 && dr_dg < 8 && db_dg > -9 && db_dg < 8)
+                    {
+                        *p++ = (unsigned char)(0x80 | (dg + 32));
+                        *p++ = (unsigned char)(((dr_dg + 8) << 4) | (db_dg + 8));
+                    }
+                    else
+                    {
+                        *p++ = 0xFE;
+                        *p++ = src[0];
+                        *p++ = src[1];
+                        *p++ = src[2];
+                    }
+                }
+                else
+                {
+                    *p++ = 0xFF;
+                    *p++ = src[0];
+                    *p++ = src[1];
+                    *p++ = src[2];
+                    *p++ = src[3];
+                }
+            }
+
+            prev = px;
+        }
+    }
+
+    if (run > 0)
+        *p++ = (unsigned char)(0xC0 | (run - 1));
+
+    memset(p, 0, QOI_END_SIZE - 1);
+    p[QOI_END_SIZE - 1] = 1;
+    p += QOI_END_SIZE;
+
+    free(scratch);
+
+    *data = out;
+    *length = (size_t)(p - out);
+    Metrics_End(METRIC_ENCODE, start);
+
+    return E_OK;
+
+}/* End of function Qoi_Encode */
+
+/** Maximum value is 255, both formats store 8 bit samples.
+ */
+size_t Pnm_Header(const Image_Planar* image, char* header)
+{
+    switch (image->format)
+    {
+        case PIXFMT_YUV420:
+        case PIXFMT_NV12:
+        case PIXFMT_YUYV:
+        case PIXFMT_GRAY:
+            return (size_t)snprintf(header, PNM_HEADER_SIZE, "P5\n%d %d\n255\n", image->width, image->height);
+
+        case PIXFMT_RGB24:
+            return (size_t)snprintf(header, PNM_HEADER_SIZE, "P6\n%d %d\n255\n", image->width, image->height);
+
+        default:
+            return 0;
+    }
+
+}/* End of function Pnm_Header */
+
+/** Rows are copied from the first plane, luminance of YUYV is picked from every second byte.
+ */
+Std_ReturnType Pnm_Encode(const Image_Planar* image, unsigned char** data, size_t* length)
+{
+    Std_ReturnType validate = E_OK;
+    char header[PNM_HEADER_SIZE];
+    size_t header_length = 0;
+    size_t row_size;
+    unsigned char* out;
+    int row, x;
+
+    validate += ValidateParam((void*)image);
+    validate += ValidateParam(data);
+    validate += ValidateParam(length);
+
+    if (E_OK == validate)
+    {
+        validate += (image->width > 0 && image->height > 0) ? E_OK : E_NOT_OK;
+        validate += ValidateParam(image->plane[0]);
+        header_length = Pnm_Header(image, header);
+        validate += (header_length > 0) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    row_size = (size_t)image->width * ((PIXFMT_RGB24 == image->format) ? 3 : 1);
+    out = malloc(header_length + row_size * image->height);
+    if (NULL == out)
+        return E_NOT_OK;
+
+    memcpy(out, header, header_length);
+
+    for (row = 0; row < image->height; row++)
+    {
+        const unsigned char* src = image->plane[0] + (size_t)row * image->stride[0];
+        unsigned char* dst = out + header_length + row_size * row;
+
+        if (PIXFMT_YUYV == image->format)
+        {
+            for (x = 0; x < image->width; x++)
+                dst[x] = src[2 * x];
+        }
+        else
+        {
+            memcpy(dst, src, row_size);
+        }
+    }
+
+    *data = out;
+    *length = header_length + row_size * image->height;
+
+    return E_OK;
+
+}/* End of function Pnm_Encode */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
@@ -0,0 +1,97 @@
+/**
+ * @file Lossless.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for lossless QOI and PGM/PPM image encoding </b>
+ * @version
+ * @date 2026-10-18 Initial template for lossless image encoding
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef LOSSLESS_H
+#define  LOSSLESS_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Common_PiCam.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Size of the QOI file header */
+#define QOI_HEADER_SIZE     (14)
+
+/** Size of the QOI end marker */
+#define QOI_END_SIZE        (8)
+
+/** Maximum length of a run of identical pixels in a single QOI operation */
+#define QOI_MAX_RUN         (62)
+
+/** Maximum length of a PGM/PPM header */
+#define PNM_HEADER_SIZE     (32)
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Encodes an RGB24, BGR24, RGBA or GRAY image as QOI in a single pass. RGBA images are
+ *          written with 4 channels, all others with 3.
+ *
+ * @param[in] image     Source image descriptor
+ * @param[out] data     Encoded image allocated with malloc
+ * @param[out] length   Size of the encoded image in bytes
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType Qoi_Encode(const Image_Planar* image, unsigned char** data, size_t* length);
+
+/**
+ * @brief   Formats the binary PGM or PPM header of an image. YUV420, NV12, YUYV and GRAY images
+ *          are written as PGM from the luminance, RGB24 as PPM.
+ *
+ * @param[in] image     Source image descriptor
+ * @param[out] header   Header text of at least PNM_HEADER_SIZE bytes
+ *
+ * @return size_t       Length of the header, 0 if the format is not supported
+ *
+ */
+size_t Pnm_Header(const Image_Planar* image, char* header);
+
+/**
+ * @brief   Encodes an image as binary PGM (P5) or PPM (P6), see Pnm_Header for formats.
+ *
+ * @param[in] image     Source image descriptor
+ * @param[out] data     Encoded image allocated with malloc
+ * @param[out] length   Size of the encoded image in bytes
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType Pnm_Encode(const Image_Planar* image, unsigned char** data, size_t* length);
+
+/** @} */
+
+#endif /** LOSSLESS_H **/
+
+/*==============================[  End of File  ]======================================*/
@@ -0,0 +1,330 @@
+/**
+ * @file OutputSink.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of asynchronous output sink writing files on worker threads </b>
+ * @version
+ * @date 2026-10-18 Initial template for asynchronous output sink
+ * @date 2026-10-19 Time file writes for the stage histograms
+ * @date 2026-10-19 Tag traced file writes with the frame of the submitting thread
+ * @date 2026-10-19 Take the capture time of submitted frames
+ * @date 2026-10-19 Keep private helpers out of the header, forward files to a single output
+ * @date 2026-10-19 Worker threads block the signals of the application
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "OutputSink.h"
+#include "Metrics.h"
+#include "Trace.h"
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to create a file and write its contents.
+ *
+ * @param[in] item      File to write
+ *
+ * @return int          Descriptor of the written file, -1 on failure
+ *
+ */
+static inline int Sink_WriteFile(const Sink_Item* item);
+
+/**
+ * @brief   Helper function to synchronize and close a batch of written files.
+ *
+ * @param[inout] sink   Output sink
+ * @param[in] fds       Descriptors of written files
+ * @param[in] count     Number of descriptors
+ *
+ */
+static inline void Sink_SyncBatch(OutputSink* sink, const int* fds, int count);
+
+/**
+ * @brief   Thread entry of a writer thread.
+ *
+ * @param[in] arg   Pointer to OutputSink
+ *
+ * @return void*    Always NULL
+ *
+ */
+static void* Sink_Worker(void* arg);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** Creates the file and writes the contents, retrying partial and interrupted writes.
+ */
+static inline int Sink_WriteFile(const Sink_Item* item)
+{
+    const unsigned char* data = item->data;
+    size_t remaining = item->length;
+    int fd;
+
+    fd = open(item->filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (-1 == fd)
+        return -1;
+
+    while (remaining > 0)
+    {
+        ssize_t r = write(fd, data, remaining);
+        if (-1 == r)
+        {
+            if (EINTR == errno)
+                continue;
+            close(fd);
+            return -1;
+        }
+        data += r;
+        remaining -= (size_t)r;
+    }
+
+    return fd;
+
+}/* End of function Sink_WriteFile */
+
+/** Flushes data of all files in the batch, then closes them.
+ */
+static inline void Sink_SyncBatch(OutputSink* sink, const int* fds, int count)
+{
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        fdatasync(fds[i]);
+        close(fds[i]);
+    }
+
+    pthread_mutex_lock(&sink->lock);
+    sink->synced++;
+    pthread_mutex_unlock(&sink->lock);
+
+}/* End of function Sink_SyncBatch */
+
+/** Writes queued files until the queue is closed and empty. Written files are kept open
+ * until the batch is full or the queue runs empty, then synchronized together. Files for a
+ * forward output are handed on in the order they were queued.
+ */
+static void* Sink_Worker(void* arg)
+{
+    OutputSink* sink = (OutputSink*)arg;
+    int fds[SINK_MAX_SYNC_BATCH];
+    int pending = 0;
+
+    Thread_BlockSignals();
+
+    for (;;)
+    {
+        Sink_Item* item = BoundedQueue_Pop(&sink->queue, (0 == pending));
+        int64_t start;
+        int fd;
+
+        if (NULL == item)
+        {
+            if (0 == pending)
+                break;
+            Sink_SyncBatch(sink, fds, pending);
+            pending = 0;
+            continue;
+        }
+
+        Trace_SetFrame(item->frame);
+
+        /** The output takes ownership of the data and reports its own errors */
+        if (NULL != sink->config.forward)
+        {
+            Std_ReturnType status = sink->config.forward(sink->config.target, item->filename, item->data, item->length, item->captured);
+            free(item);
+
+            pthread_mutex_lock(&sink->lock);
+            if (E_OK != status)
+                sink->failed++;
+            else
+                sink->written++;
+            pthread_mutex_unlock(&sink->lock);
+            continue;
+        }
+
+        start = Metrics_Begin();
+        fd = Sink_WriteFile(item);
+        if (-1 != fd)
+            Metrics_End(METRIC_WRITE, start);
+        if (-1 == fd)
+            fprintf(stderr, "Could not write file %s, error %d, %s\n", item->filename, errno, strerror(errno));
+
+        free(item->data);
+        free(item);
+
+        pthread_mutex_lock(&sink->lock);
+        if (-1 == fd)
+            sink->failed++;
+        else
+            sink->written++;
+        pthread_mutex_unlock(&sink->lock);
+
+        if (-1 == fd)
+            continue;
+
+        if (0 == sink->config.sync_batch)
+        {
+            close(fd);
+            continue;
+        }
+
+        fds[pending++] = fd;
+        if (pending == sink->config.sync_batch)
+        {
+            Sink_SyncBatch(sink, fds, pending);
+            pending = 0;
+        }
+    }
+
+    return NULL;
+
+}/* End of function Sink_Worker */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** Creates the queue and starts the writer threads.
+ */
+Std_ReturnType OutputSink_Init(OutputSink* sink, const OutputSink_Config* config)
+{
+    Std_ReturnType validate = E_OK;
+    int i;
+
+    validate += ValidateParam(sink);
+    validate += ValidateParam((void*)config);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateValue(config->threads, 1, SINK_MAX_THREADS);
+        validate += (config->queue_depth > 0) ? E_OK : E_NOT_OK;
+        validate += ValidateValue(config->sync_batch, 0, SINK_MAX_SYNC_BATCH);
+        validate += (NULL == config->forward || 1 == config->threads) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    memset(sink, 0, sizeof(OutputSink));
+    sink->config = *config;
+
+    if (E_OK != BoundedQueue_Init(&sink->queue, config->queue_depth))
+        return E_NOT_OK;
+    pthread_mutex_init(&sink->lock, NULL);
+
+    for (i = 0; i < config->threads; i++)
+    {
+        if (0 != pthread_create(&sink->thread[i], NULL, Sink_Worker, sink))
+        {
+            OutputSink_Close(sink);
+            return E_NOT_OK;
+        }
+        sink->started++;
+    }
+
+    return E_OK;
+
+}/* End of function OutputSink_Init */
+
+/** Copies the filename into a queue item and pushes it with the configured policy. Dropped
+ * files are released immediately.
+ */
+Std_ReturnType OutputSink_Submit(void* sink, const char* filename, unsigned char* data, size_t length, int64_t captured)
+{
+    OutputSink* out = (OutputSink*)sink;
+    Sink_Item* item;
+    Sink_Item* evicted = NULL;
+    Std_ReturnType status;
+
+    if (NULL == filename || strlen(filename) >= SINK_MAX_FILENAME)
+    {
+        printf("Invalid input parameters provided.\n");
+        free(data);
+        return E_NOT_OK;
+    }
+
+    item = malloc(sizeof(Sink_Item));
+    if (NULL == item)
+    {
+        free(data);
+        return E_NOT_OK;
+    }
+
+    strcpy(item->filename, filename);
+    item->data = data;
+    item->length = length;
+    item->captured = captured;
+    item->frame = Trace_GetFrame();
+
+    status = BoundedQueue_Push(&out->queue, item, out->config.policy, (void**)&evicted);
+
+    if (E_OK != status)
+    {
+        free(item->data);
+        free(item);
+    }
+    if (NULL != evicted)
+    {
+        free(evicted->data);
+        free(evicted);
+    }
+
+    if (E_OK != status || NULL != evicted)
+    {
+        pthread_mutex_lock(&out->lock);
+        out->dropped++;
+        pthread_mutex_unlock(&out->lock);
+    }
+
+    return status;
+
+}/* End of function OutputSink_Submit */
+
+/** Closes the queue so the writer threads exit after writing the remaining files, then joins
+ * them.
+ */
+void OutputSink_Close(OutputSink* sink)
+{
+    int i;
+
+    BoundedQueue_Close(&sink->queue);
+
+    for (i = 0; i < sink->started; i++)
+        pthread_join(sink->thread[i], NULL);
+    sink->started = 0;
+
+    BoundedQueue_DeInit(&sink->queue);
+    pthread_mutex_destroy(&sink->lock);
+
+}/* End of function OutputSink_Close */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
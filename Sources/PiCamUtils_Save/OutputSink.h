@@ -0,0 +1,175 @@
+/**
+ * @file OutputSink.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for asynchronous output sink writing files on worker threads </b>
+ * @version
+ * @date 2026-10-18 Initial template for asynchronous output sink
+ * @date 2026-10-19 Carry the frame sequence number of queued files for traces
+ * @date 2026-10-19 Take the capture time of submitted frames
+ * @date 2026-10-19 Add claiming memory of outputs for frames written in place
+ * @date 2026-10-19 Keep private helpers out of the header, forward files to a single output
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef OUTPUTSINK_H
+#define  OUTPUTSINK_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <pthread.h>
+#include <stdint.h>
+#include "Common_PiCam.h"
+#include "BoundedQueue.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Maximum number of writer threads of an output sink */
+#define SINK_MAX_THREADS        (4)
+
+/** Maximum number of files synchronized together by a writer thread */
+#define SINK_MAX_SYNC_BATCH     (64)
+
+/** Maximum length of a filename passed to an output sink, including terminating zero */
+#define SINK_MAX_FILENAME       (256)
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Function to hand over an encoded file to an output sink. The sink takes ownership of the
+ *  data, which must be allocated with malloc, and releases it once written or dropped. The
+ *  capture time of the frame is given in microseconds of CLOCK_MONOTONIC, 0 if unknown.
+ */
+typedef Std_ReturnType (*Sink_SubmitFunc)(void* sink, const char* filename, unsigned char* data, size_t length, int64_t captured);
+
+/** Function lending memory of an output for the next frame, so the frame is written in place
+ *  and handed back with the submit function of the output without a copy. Returns NULL if the
+ *  output has no memory free.
+ */
+typedef unsigned char* (*Sink_ClaimFunc)(void* sink, size_t length);
+
+/** Configuration of an output sink */
+typedef struct
+{
+    /** Number of writer threads (1 to SINK_MAX_THREADS) */
+    int threads;
+    /** Maximum number of files waiting to be written */
+    int queue_depth;
+    /** Action if a file is submitted while the queue is full */
+    Queue_Policy policy;
+    /** Number of files written before they are synchronized with fdatasync, 0 leaves
+     *  writeback to the kernel (0 to SINK_MAX_SYNC_BATCH) */
+    int sync_batch;
+    /** Output the files are handed to in submission order instead of being written as
+     *  individual files, NULL to write files. Requires a single writer thread. */
+    Sink_SubmitFunc forward;
+    /** Output passed to the forward function */
+    void* target;
+} OutputSink_Config;
+
+/** File waiting in the queue of an output sink */
+typedef struct
+{
+    /** Name of file to create */
+    char filename[SINK_MAX_FILENAME];
+    /** File contents */
+    unsigned char* data;
+    /** Size of file contents in bytes */
+    size_t length;
+    /** Capture time of the frame in microseconds of CLOCK_MONOTONIC, 0 if unknown */
+    int64_t captured;
+    /** Sequence number of the frame for traces */
+    uint32_t frame;
+} Sink_Item;
+
+/** Output sink writing files on worker threads, so storage latency does not stall the
+ *  thread submitting the files. With a forward function a single writer thread passes the
+ *  files on to a recording output such as an AVI file or a frame log.
+ */
+typedef struct
+{
+    /** Configuration of the sink */
+    OutputSink_Config config;
+    /** Files waiting to be written */
+    BoundedQueue queue;
+    /** Writer threads */
+    pthread_t thread[SINK_MAX_THREADS];
+    /** Number of started writer threads */
+    int started;
+    /** Lock protecting the statistics */
+    pthread_mutex_t lock;
+    /** Number of files written */
+    unsigned long written;
+    /** Number of files dropped because the queue was full */
+    unsigned long dropped;
+    /** Number of files which could not be written */
+    unsigned long failed;
+    /** Number of fdatasync batches */
+    unsigned long synced;
+} OutputSink;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Initializes an output sink and starts its writer threads.
+ *
+ * @param[inout] sink   Output sink to initialize
+ * @param[in] config    Configuration of the sink
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType OutputSink_Init(OutputSink* sink, const OutputSink_Config* config);
+
+/**
+ * @brief   Queues a file to be written, signature matches Sink_SubmitFunc. Depending on the
+ *          overflow policy a full queue blocks, drops this file or drops the oldest file.
+ *
+ * @param[inout] sink   Pointer to OutputSink
+ * @param[in] filename  Name of file to create
+ * @param[in] data      File contents allocated with malloc, ownership passes to the sink
+ * @param[in] length    Size of file contents in bytes
+ * @param[in] captured  Capture time in microseconds of CLOCK_MONOTONIC, 0 if unknown
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             File queued
+ * @retval E_NOT_OK         File dropped
+ *
+ */
+Std_ReturnType OutputSink_Submit(void* sink, const char* filename, unsigned char* data, size_t length, int64_t captured);
+
+/**
+ * @brief   Writes all queued files, stops the writer threads and releases the sink.
+ *
+ * @param[inout] sink   Output sink to close
+ *
+ */
+void OutputSink_Close(OutputSink* sink);
+
+/** @} */
+
+#endif /** OUTPUTSINK_H **/
+
+/*==============================[  End of File  ]======================================*/
@@ -0,0 +1,307 @@
+/**
+ * @file Preview.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of downscaled JPEG outputs and EXIF thumbnails from one image pyramid </b>
+ * @version
+ * @date 2026-10-18 Initial template for downscaled outputs and EXIF thumbnails
+ * @date 2026-10-19 Add resolution entries to both EXIF IFDs
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Preview.h"
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to store a big endian IFD entry with a single value.
+ *
+ * @param[out] p        Destination of 12 bytes
+ * @param[in] tag       Tag of the entry
+ * @param[in] type      3 for SHORT, 4 for LONG, 5 for RATIONAL
+ * @param[in] value     Value of the entry, offset of the value for RATIONAL
+ *
+ * @return unsigned char*   Position behind the entry
+ *
+ */
+static inline unsigned char* Preview_PutEntry(unsigned char* p, unsigned int tag, unsigned int type, unsigned int value);
+
+/**
+ * @brief   Helper function to create the EXIF segment around an encoded thumbnail.
+ *
+ * @param[inout] preview    Preview with allocated EXIF buffer
+ * @param[in] thumb         Encoded thumbnail
+ * @param[in] length        Size of the thumbnail in bytes
+ *
+ */
+static inline void Preview_BuildExif(Preview* preview, const unsigned char* thumb, size_t length);
+
+/**
+ * @brief   Helper function to store the XResolution, YResolution and ResolutionUnit entries
+ *          of an IFD and the resolution values they refer to.
+ *
+ * @param[out] p        Destination of the three entries
+ * @param[out] values   Destination of the two RATIONAL values
+ * @param[in] offset    Offset of values from the TIFF header
+ *
+ * @return unsigned char*   Position behind the entries
+ *
+ */
+static inline unsigned char* Preview_PutResolution(unsigned char* p, unsigned char* values, unsigned int offset);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** Values shorter than 4 bytes are left aligned in the value field.
+ */
+static inline unsigned char* Preview_PutEntry(unsigned char* p, unsigned int tag, unsigned int type, unsigned int value)
+{
+    p[0] = (unsigned char)(tag >> 8);
+    p[1] = (unsigned char)tag;
+    p[2] = 0;
+    p[3] = (unsigned char)type;
+    p[4] = 0;
+    p[5] = 0;
+    p[6] = 0;
+    p[7] = 1;
+
+    if (3 == type)
+    {
+        p[8] = (unsigned char)(value >> 8);
+        p[9] = (unsigned char)value;
+        p[10] = 0;
+        p[11] = 0;
+    }
+    else
+    {
+        p[8] = (unsigned char)(value >> 24);
+        p[9] = (unsigned char)(value >> 16);
+        p[10] = (unsigned char)(value >> 8);
+        p[11] = (unsigned char)value;
+    }
+
+    return p + 12;
+
+}/* End of function Preview_PutEntry */
+
+/** Both resolutions are PREVIEW_EXIF_DPI / 1 in inches, as the camera has no physical size.
+ */
+static inline unsigned char* Preview_PutResolution(unsigned char* p, unsigned char* values, unsigned int offset)
+{
+    static const unsigned char dpi[8] = { 0, 0, 0, PREVIEW_EXIF_DPI, 0, 0, 0, 1 };
+
+    memcpy(values, dpi, 8);
+    memcpy(values + 8, dpi, 8);
+    p = Preview_PutEntry(p, 0x011A, 5, offset);
+    p = Preview_PutEntry(p, 0x011B, 5, offset + 8);
+    return Preview_PutEntry(p, 0x0128, 3, 2);
+
+}/* End of function Preview_PutResolution */
+
+/** Big endian TIFF structure with orientation in IFD0 and the JPEG thumbnail in IFD1, both
+ * with the resolution entries TIFF requires. Entries are sorted by tag, the resolution values
+ * follow their IFD. Offsets count from the TIFF header, IFD0 is at 8, IFD1 at 78 and the
+ * thumbnail at 172.
+ */
+static inline void Preview_BuildExif(Preview* preview, const unsigned char* thumb, size_t length)
+{
+    unsigned char* p = preview->exif;
+    unsigned char* tiff = p + 6;
+
+    memcpy(p, "Exif\0\0MM\0\x2A\0\0\0\x08", 14);
+    p += 14;
+
+    /** IFD0 with orientation and resolution, followed by the offset of IFD1 */
+    p[0] = 0;
+    p[1] = 4;
+    p = Preview_PutEntry(p + 2, 0x0112, 3, 1);
+    p = Preview_PutResolution(p, tiff + 62, 62);
+    memcpy(p, "\0\0\0\x4E", 4);
+    p = tiff + 78;
+
+    /** IFD1 with resolution and the thumbnail, no further IFD */
+    p[0] = 0;
+    p[1] = 6;
+    p = Preview_PutEntry(p + 2, 0x0103, 3, 6);
+    p = Preview_PutResolution(p, tiff + 156, 156);
+    p = Preview_PutEntry(p, 0x0201, 4, PREVIEW_EXIF_HEADER - 6);
+    p = Preview_PutEntry(p, 0x0202, 4, (unsigned int)length);
+    memset(p, 0, 4);
+    p = preview->exif + PREVIEW_EXIF_HEADER;
+
+    memcpy(p, thumb, length);
+    preview->exif_length = (unsigned int)(PREVIEW_EXIF_HEADER + length);
+
+}/* End of function Preview_BuildExif */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** The EXIF buffer is allocated once with the maximum segment size.
+ */
+Std_ReturnType Preview_Init(Preview* preview, const Preview_Config* config)
+{
+    Std_ReturnType validate = E_OK;
+
+    validate += ValidateParam(preview);
+    validate += ValidateParam((void*)config);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateValue(config->scales, 0, (1 << PYRAMID_MAX_LEVELS) - 1);
+        validate += ValidateValue(config->quality, 1, 100);
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    memset(preview, 0, sizeof(Preview));
+    preview->config = *config;
+
+    if (config->thumbnail)
+    {
+        preview->exif = malloc(PREVIEW_EXIF_SIZE);
+        if (NULL == preview->exif)
+            return E_NOT_OK;
+    }
+
+    return E_OK;
+
+}/* End of function Preview_Init */
+
+/** Outputs not taken by the caller are not released.
+ */
+void Preview_DeInit(Preview* preview)
+{
+    Pyramid_Free(&preview->pyramid);
+    free(preview->exif);
+    preview->exif = NULL;
+    preview->exif_length = 0;
+    preview->outputs = 0;
+
+}/* End of function Preview_DeInit */
+
+/** Builds only as many levels as the smallest requested output needs. Outputs are copied out
+ * of the encoder buffer so it keeps the size of full size images.
+ */
+Std_ReturnType Preview_Encode(Preview* preview, JpegEncoder* enc, const Image_Planar* image)
+{
+    const int quality = enc->quality;
+    int levels = 0, thumb = -1, w, l;
+
+    preview->outputs = 0;
+    preview->exif_length = 0;
+
+    if ((PIXFMT_YUV420 != image->format) && (PIXFMT_GRAY != image->format))
+        return E_OK;
+
+    for (l = 0; l < PYRAMID_MAX_LEVELS; l++)
+        if (preview->config.scales & (1 << l))
+            levels = l + 1;
+
+    if (preview->config.thumbnail)
+    {
+        for (w = image->width, l = 0; l < PYRAMID_MAX_LEVELS && thumb < 0; l++)
+        {
+            w = (w / 2) & ~1;
+            if (w <= PREVIEW_THUMB_WIDTH)
+                thumb = l;
+        }
+        if (thumb < 0)
+            thumb = PYRAMID_MAX_LEVELS - 1;
+        if (levels < thumb + 1)
+            levels = thumb + 1;
+    }
+
+    if (0 == levels)
+        return E_OK;
+
+    if (E_OK != Pyramid_Build(&preview->pyramid, image, levels))
+        return E_NOT_OK;
+
+    JpegEncoder_SetQuality(enc, preview->config.quality);
+
+    for (l = 0; l < preview->pyramid.levels; l++)
+    {
+        const Image_Planar* level = &preview->pyramid.level[l];
+
+        if (!(preview->config.scales & (1 << l)) && l != thumb)
+            continue;
+
+        if (E_OK != JpegEncoder_Encode(enc, level))
+        {
+            JpegEncoder_SetQuality(enc, quality);
+            return E_NOT_OK;
+        }
+
+        if (l == thumb && enc->length + PREVIEW_EXIF_HEADER <= PREVIEW_EXIF_SIZE)
+            Preview_BuildExif(preview, enc->buffer, enc->length);
+
+        if (preview->config.scales & (1 << l))
+        {
+            Preview_Output* out = &preview->output[preview->outputs];
+
+            out->data = malloc(enc->length);
+            if (NULL == out->data)
+                continue;
+            memcpy(out->data, enc->buffer, enc->length);
+            out->length = enc->length;
+            out->width = level->width;
+            out->height = level->height;
+            preview->outputs++;
+        }
+    }
+
+    JpegEncoder_SetQuality(enc, quality);
+    if (preview->exif_length > 0)
+        JpegEncoder_SetExif(enc, preview->exif, preview->exif_length);
+
+    return E_OK;
+
+}/* End of function Preview_Encode */
+
+/** The extension starts at the last dot of the last path component.
+ */
+Std_ReturnType Preview_Filename(char* dst, size_t size, const char* filename, const Preview_Output* output)
+{
+    const char* slash = strrchr(filename, '/');
+    const char* dot = strrchr(filename, '.');
+    int base = (int)strlen(filename);
+    int n;
+
+    if (NULL != dot && (NULL == slash || dot > slash))
+        base = (int)(dot - filename);
+
+    n = snprintf(dst, size, "%.*s_%dx%d.jpg", base, filename, output->width, output->height);
+
+    return (n > 0 && (size_t)n < size) ? E_OK : E_NOT_OK;
+
+}/* End of function Preview_Filename */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
@@ -0,0 +1,166 @@
+/**
+ * @file Preview.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for downscaled JPEG outputs and EXIF thumbnails from one image pyramid </b>
+ * @version
+ * @date 2026-10-18 Initial template for downscaled outputs and EXIF thumbnails
+ * @date 2026-10-19 Add resolution entries to both EXIF IFDs
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef PREVIEW_H
+#define  PREVIEW_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stddef.h>
+#include "Common_PiCam.h"
+#include "JpegEncoder.h"
+#include "Pyramid.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Widest pyramid level used as EXIF thumbnail, the first level not wider is taken */
+#define PREVIEW_THUMB_WIDTH     (256)
+
+/** Default quality of downscaled outputs and thumbnails */
+#define PREVIEW_QUALITY         (75)
+
+/** Maximum size of the contents of an APP1 segment */
+#define PREVIEW_EXIF_SIZE       (65533)
+
+/** Size of the EXIF identifier, TIFF header and both IFDs with their resolution values in
+ *  front of the thumbnail */
+#define PREVIEW_EXIF_HEADER     (178)
+
+/** Resolution stored in both IFDs in pixels per inch */
+#define PREVIEW_EXIF_DPI        (72)
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Configuration of downscaled outputs */
+typedef struct
+{
+    /** Bit mask of downscaled outputs, bit n requests a JPEG image of 1/2^(n+1) size */
+    int scales;
+    /** 1 to embed a thumbnail into the EXIF segment of the full size image */
+    int thumbnail;
+    /** Compression quality of downscaled outputs and the thumbnail (1 to 100) */
+    int quality;
+} Preview_Config;
+
+/** Downscaled JPEG image */
+typedef struct
+{
+    /** Encoded image allocated with malloc */
+    unsigned char* data;
+    /** Size of the encoded image in bytes */
+    size_t length;
+    /** Width of the image */
+    int width;
+    /** Height of the image */
+    int height;
+} Preview_Output;
+
+/** Downscaled outputs of one encoder. The pyramid is computed once per image and its levels
+ *  are encoded with the encoder of the full size image.
+ */
+typedef struct
+{
+    /** Configuration of the outputs */
+    Preview_Config config;
+    /** Halved images of the last image */
+    Pyramid pyramid;
+    /** Downscaled outputs of the last image, largest first */
+    Preview_Output output[PYRAMID_MAX_LEVELS];
+    /** Number of downscaled outputs of the last image */
+    int outputs;
+    /** EXIF segment contents with the thumbnail of the last image */
+    unsigned char* exif;
+    /** Size of the EXIF segment contents, 0 if there is no thumbnail */
+    unsigned int exif_length;
+} Preview;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Initializes downscaled outputs.
+ *
+ * @param[inout] preview    Preview to initialize
+ * @param[in] config        Configuration of the outputs
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType Preview_Init(Preview* preview, const Preview_Config* config);
+
+/**
+ * @brief   Releases the pyramid and EXIF buffer of downscaled outputs.
+ *
+ * @param[inout] preview    Preview to release
+ *
+ */
+void Preview_DeInit(Preview* preview);
+
+/**
+ * @brief   Encodes the downscaled outputs of a YUV420 or GRAY image with the given encoder and
+ *          sets the EXIF segment of the next frame of the encoder to the thumbnail. Other
+ *          formats produce no outputs. The caller takes ownership of the output data.
+ *
+ * @param[inout] preview    Preview
+ * @param[inout] enc        Encoder of the full size image, quality is restored afterwards
+ * @param[in] image         Full size image
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType Preview_Encode(Preview* preview, JpegEncoder* enc, const Image_Planar* image);
+
+/**
+ * @brief   Derives the filename of a downscaled output by replacing the extension of the full
+ *          size image with the dimensions, for example capture_320x240.jpg.
+ *
+ * @param[out] dst      Filename of the downscaled output
+ * @param[in] size      Size of dst in bytes
+ * @param[in] filename  Filename of the full size image
+ * @param[in] output    Downscaled output
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Filename does not fit
+ *
+ */
+Std_ReturnType Preview_Filename(char* dst, size_t size, const char* filename, const Preview_Output* output);
+
+/** @} */
+
+#endif /** PREVIEW_H **/
+
+/*==============================[  End of File  ]======================================*/
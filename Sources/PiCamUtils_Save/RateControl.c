@@ -0,0 +1,194 @@
+/**
+ * @file RateControl.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of adaptive JPEG quality targeting a data rate or encode time budget </b>
+ * @version
+ * @date 2026-10-18 Initial template for JPEG rate control
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "RateControl.h"
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to update an exponential moving average.
+ *
+ * @param[in] average   Current average
+ * @param[in] value     New sample
+ * @param[in] first     1 if the sample is the first one
+ *
+ * @return float        Updated average
+ *
+ */
+static inline float RateControl_Average(float average, float value, int first);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** The first sample initializes the average.
+ */
+static inline float RateControl_Average(float average, float value, int first)
+{
+    if (first)
+        return value;
+
+    return average + RATE_SMOOTHING * (value - average);
+
+}/* End of function RateControl_Average */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** Starts at the highest quality with accurate DCT.
+ */
+Std_ReturnType RateControl_Init(RateControl* rate, const RateControl_Config* config)
+{
+    Std_ReturnType validate = E_OK;
+
+    validate += ValidateParam(rate);
+    validate += ValidateParam((void*)config);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateValue(config->min_quality, 1, 100);
+        validate += ValidateValue(config->max_quality, config->min_quality, 100);
+        validate += (config->fps >= 0) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    memset(rate, 0, sizeof(RateControl));
+    rate->config = *config;
+    rate->quality = (float)config->max_quality;
+    rate->time_cap = (float)config->max_quality;
+    pthread_mutex_init(&rate->lock, NULL);
+
+    return E_OK;
+
+}/* End of function RateControl_Init */
+
+/** Destroys the lock.
+ */
+void RateControl_DeInit(RateControl* rate)
+{
+    pthread_mutex_destroy(&rate->lock);
+
+}/* End of function RateControl_DeInit */
+
+/** Quality is the lower of both loops.
+ */
+void RateControl_Get(RateControl* rate, int* quality, int* fast_dct)
+{
+    float q;
+
+    pthread_mutex_lock(&rate->lock);
+    q = (rate->quality < rate->time_cap) ? rate->quality : rate->time_cap;
+    *quality = (int)lrintf(q);
+    *fast_dct = rate->fast_dct;
+    pthread_mutex_unlock(&rate->lock);
+
+}/* End of function RateControl_Get */
+
+/** JPEG size grows roughly exponentially with quality in the usual range, so the data rate
+ * loop steps quality by the logarithm of the size error. Averaging and the step limit keep
+ * it stable with frames still in flight at the previous settings. The time loop degrades in
+ * order of visual cost and restores in reverse order only with headroom, so it does not
+ * toggle between two settings.
+ */
+void RateControl_Update(RateControl* rate, size_t length, int64_t encode_us)
+{
+    const float min = (float)rate->config.min_quality;
+    const float max = (float)rate->config.max_quality;
+    int64_t now = RateControl_Now();
+    int first;
+
+    pthread_mutex_lock(&rate->lock);
+
+    first = (0 == rate->frames);
+    if (!first && now > rate->last_time)
+        rate->interval_avg = RateControl_Average(rate->interval_avg, (float)(now - rate->last_time), (0.0f == rate->interval_avg));
+    rate->last_time = now;
+    rate->size_avg = RateControl_Average(rate->size_avg, (float)length, first);
+    rate->time_avg = RateControl_Average(rate->time_avg, (float)encode_us, first);
+    rate->frames++;
+
+    if (rate->config.bitrate > 0 && rate->size_avg > 0.0f)
+    {
+        float frame_us = (rate->config.fps > 0) ? 1000000.0f / rate->config.fps : rate->interval_avg;
+
+        if (frame_us > 0.0f)
+        {
+            float target = (float)rate->config.bitrate * frame_us / 1000000.0f;
+            float step = RATE_GAIN * log2f(target / rate->size_avg);
+
+            step = (step > RATE_MAX_STEP) ? RATE_MAX_STEP : ((step < -RATE_MAX_STEP) ? -RATE_MAX_STEP : step);
+            rate->quality += step;
+            rate->quality = (rate->quality < min) ? min : ((rate->quality > max) ? max : rate->quality);
+        }
+    }
+
+    if (rate->config.budget_us > 0)
+    {
+        if (rate->time_avg > (float)rate->config.budget_us)
+        {
+            if (!rate->fast_dct)
+                rate->fast_dct = 1;
+            else if (rate->time_cap > min)
+                rate->time_cap = (rate->time_cap - RATE_TIME_STEP < min) ? min : rate->time_cap - RATE_TIME_STEP;
+        }
+        else if (rate->time_avg < RATE_TIME_HEADROOM * rate->config.budget_us)
+        {
+            if (rate->time_cap < max)
+                rate->time_cap = (rate->time_cap + 1.0f > max) ? max : rate->time_cap + 1.0f;
+            else
+                rate->fast_dct = 0;
+        }
+    }
+
+    pthread_mutex_unlock(&rate->lock);
+
+}/* End of function RateControl_Update */
+
+/** Reads the monotonic clock, not affected by changes of the wall clock.
+ */
+int64_t RateControl_Now(void)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+
+}/* End of function RateControl_Now */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
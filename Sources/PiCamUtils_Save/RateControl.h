@@ -0,0 +1,165 @@
+/**
+ * @file RateControl.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for adaptive JPEG quality targeting a data rate or encode time budget </b>
+ * @version
+ * @date 2026-10-18 Initial template for JPEG rate control
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef RATECONTROL_H
+#define  RATECONTROL_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stddef.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "Common_PiCam.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Lowest quality selected by default */
+#define RATE_MIN_QUALITY        (10)
+
+/** Change of quality when the encoded size is off by a factor of two */
+#define RATE_GAIN               (8.0f)
+
+/** Maximum change of quality per frame */
+#define RATE_MAX_STEP           (5.0f)
+
+/** Reduction of the quality cap per frame over the time budget */
+#define RATE_TIME_STEP          (2.0f)
+
+/** Fraction of the time budget below which quality and accurate DCT are restored */
+#define RATE_TIME_HEADROOM      (0.7f)
+
+/** Weight of the latest frame in the averages of size, encode time and frame interval */
+#define RATE_SMOOTHING          (0.3f)
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Configuration of a rate controller. At least one of bitrate and budget_us should be set */
+typedef struct
+{
+    /** Target data rate in bytes per second, 0 for no limit */
+    uint32_t bitrate;
+    /** Frame rate used to convert the data rate to bytes per frame, 0 to measure it */
+    int fps;
+    /** Encode time budget per frame in microseconds, 0 for no limit */
+    uint32_t budget_us;
+    /** Lowest quality (1 to 100) */
+    int min_quality;
+    /** Highest quality and quality of the first frame (1 to 100) */
+    int max_quality;
+} RateControl_Config;
+
+/** Controller selecting JPEG quality and DCT method per frame from the size and encode time of
+ *  previous frames. The data rate loop steps quality by the logarithm of the ratio between
+ *  target and averaged frame size. The time loop switches to fast DCT first and caps quality
+ *  if that is not sufficient. Both loops may be fed from several encoder threads.
+ */
+typedef struct
+{
+    /** Configuration of the controller */
+    RateControl_Config config;
+    /** Lock protecting the state */
+    pthread_mutex_t lock;
+    /** Quality selected by the data rate loop */
+    float quality;
+    /** Highest quality allowed by the time loop */
+    float time_cap;
+    /** Set if the time loop selected fast integer DCT */
+    int fast_dct;
+    /** Average size of encoded frames in bytes */
+    float size_avg;
+    /** Average encode time in microseconds */
+    float time_avg;
+    /** Average time between frames in microseconds, 0 until measured */
+    float interval_avg;
+    /** Monotonic time of the last update in microseconds */
+    int64_t last_time;
+    /** Number of frames fed back */
+    unsigned long frames;
+} RateControl;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Initializes a rate controller.
+ *
+ * @param[inout] rate   Rate controller to initialize
+ * @param[in] config    Configuration of the controller
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType RateControl_Init(RateControl* rate, const RateControl_Config* config);
+
+/**
+ * @brief   Releases a rate controller.
+ *
+ * @param[inout] rate   Rate controller to release
+ *
+ */
+void RateControl_DeInit(RateControl* rate);
+
+/**
+ * @brief   Gets the encoder settings for the next frame.
+ *
+ * @param[inout] rate       Rate controller
+ * @param[out] quality      Compression quality (1 to 100)
+ * @param[out] fast_dct     1 for fast integer DCT, 0 for accurate integer DCT
+ *
+ */
+void RateControl_Get(RateControl* rate, int* quality, int* fast_dct);
+
+/**
+ * @brief   Feeds back the result of an encoded frame and adjusts the settings of the following
+ *          frames.
+ *
+ * @param[inout] rate       Rate controller
+ * @param[in] length        Size of the encoded frame in bytes
+ * @param[in] encode_us     Time spent encoding the frame in microseconds
+ *
+ */
+void RateControl_Update(RateControl* rate, size_t length, int64_t encode_us);
+
+/**
+ * @brief   Gets the monotonic time to measure encode times.
+ *
+ * @return int64_t  Monotonic time in microseconds
+ *
+ */
+int64_t RateControl_Now(void);
+
+/** @} */
+
+#endif /** RATECONTROL_H **/
+
+/*==============================[  End of File  ]======================================*/
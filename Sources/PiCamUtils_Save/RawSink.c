@@ -0,0 +1,340 @@
+/**
+ * @file RawSink.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of raw planar frame output to files and pipes </b>
+ * @version
+ * @date 2026-10-18 Initial template for raw planar frame output
+ * @date 2026-10-19 Take the capture time of submitted frames
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include "RawSink.h"
+
+/*============================[  Global Variables  ]====================================*/
+
+/** \addtogroup global_constants
+ *  @{
+ */
+
+/** Header of every YUV4MPEG2 frame. Constant, so pipes may reference it. */
+static const char RawFrameHeader[] = "FRAME\n";
+
+/** @}*/
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to write all bytes described by an I/O vector, with vmsplice
+ *          for pipes and writev otherwise. Partial writes are continued.
+ *
+ * @param[inout] sink   Raw sink
+ * @param[inout] iov    I/O vector, modified while writing
+ * @param[in] count     Number of elements of iov
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType RawSink_Output(RawSink* sink, struct iovec* iov, int count);
+
+/**
+ * @brief   Helper function to keep a buffer referenced by the pipe, releasing the oldest
+ *          buffer which the reader consumed for certain.
+ *
+ * @param[inout] sink   Raw sink
+ * @param[in] buffer    Buffer allocated with malloc
+ *
+ */
+static inline void RawSink_Hold(RawSink* sink, unsigned char* buffer);
+
+/**
+ * @brief   Helper function to convert an I420 frame to NV12.
+ *
+ * @param[in] sink      Raw sink
+ * @param[in] src       I420 frame
+ *
+ * @return unsigned char*   NV12 frame allocated with malloc, NULL on failure
+ *
+ */
+static inline unsigned char* RawSink_ToNV12(const RawSink* sink, const unsigned char* src);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** vmsplice maps the pages of the vector into the pipe instead of copying them.
+ */
+static inline Std_ReturnType RawSink_Output(RawSink* sink, struct iovec* iov, int count)
+{
+    while (count > 0)
+    {
+        ssize_t r = sink->pipe ? vmsplice(sink->fd, iov, count, 0) : writev(sink->fd, iov, count);
+        if (r < 0 && EINTR == errno)
+            continue;
+        if (r <= 0)
+            return E_NOT_OK;
+
+        while (count > 0 && (size_t)r >= iov->iov_len)
+        {
+            r -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0)
+        {
+            iov->iov_base = (char*)iov->iov_base + r;
+            iov->iov_len -= r;
+        }
+    }
+
+    return E_OK;
+
+}/* End of function RawSink_Output */
+
+/** The pipe holds at most its capacity, so a frame followed by more than capacity bytes
+ * was read and its buffer can be reused.
+ */
+static inline void RawSink_Hold(RawSink* sink, unsigned char* buffer)
+{
+    if (sink->held_count == sink->held_limit)
+    {
+        free(sink->held[0]);
+        memmove(sink->held, sink->held + 1, (sink->held_count - 1) * sizeof(unsigned char*));
+        sink->held_count--;
+    }
+
+    sink->held[sink->held_count++] = buffer;
+
+}/* End of function RawSink_Hold */
+
+/** Y plane is copied, the U and V rows are interleaved.
+ */
+static inline unsigned char* RawSink_ToNV12(const RawSink* sink, const unsigned char* src)
+{
+    size_t luma = (size_t)sink->config.width * sink->config.height;
+    size_t chroma = luma / 4;
+    const unsigned char* u = src + luma;
+    const unsigned char* v = u + chroma;
+    unsigned char* dst = malloc(sink->frame_size);
+    unsigned char* uv;
+    size_t i;
+
+    if (NULL == dst)
+        return NULL;
+
+    memcpy(dst, src, luma);
+    uv = dst + luma;
+    for (i = 0; i < chroma; i++)
+    {
+        uv[2 * i] = u[i];
+        uv[2 * i + 1] = v[i];
+    }
+
+    return dst;
+
+}/* End of function RawSink_ToNV12 */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** Pipes are enlarged to hold a frame if the system allows it. When the buffers needed to
+ * cover the pipe capacity exceed RAW_MAX_HELD, frames are copied into the pipe with writev.
+ */
+Std_ReturnType RawSink_Open(RawSink* sink, const RawSink_Config* config)
+{
+    Std_ReturnType validate = E_OK;
+    struct stat st;
+    size_t out;
+
+    validate += ValidateParam(sink);
+    validate += ValidateParam((void*)config);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateParam((void*)config->path);
+        validate += (config->width > 0 && 0 == (config->width & 1)) ? E_OK : E_NOT_OK;
+        validate += (config->height > 0 && 0 == (config->height & 1)) ? E_OK : E_NOT_OK;
+        validate += (config->format >= RAW_Y4M && config->format <= RAW_NV12) ? E_OK : E_NOT_OK;
+        validate += (config->fps >= 0) ? E_OK : E_NOT_OK;
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    memset(sink, 0, sizeof(RawSink));
+    sink->config = *config;
+    sink->frame_size = (size_t)config->width * config->height * 3 / 2;
+
+    if (0 == strcmp(config->path, "-"))
+    {
+        /** Frames keep the real standard output, messages go to standard error */
+        fflush(stdout);
+        sink->fd = dup(STDOUT_FILENO);
+        if (-1 != sink->fd)
+            dup2(STDERR_FILENO, STDOUT_FILENO);
+    }
+    else
+    {
+        sink->fd = open(config->path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    }
+
+    if (-1 == sink->fd)
+        return E_NOT_OK;
+
+    if (0 == fstat(sink->fd, &st) && S_ISFIFO(st.st_mode))
+    {
+        int capacity;
+
+        out = sink->frame_size + ((RAW_Y4M == config->format) ? sizeof(RawFrameHeader) - 1 : 0);
+        fcntl(sink->fd, F_SETPIPE_SZ, (int)out);
+        capacity = fcntl(sink->fd, F_GETPIPE_SZ);
+
+        if (capacity > 0 && (size_t)capacity / out + 2 <= RAW_MAX_HELD)
+        {
+            sink->pipe = 1;
+            sink->held_limit = (int)((size_t)capacity / out + 2);
+        }
+    }
+
+    if (RAW_Y4M == config->format)
+    {
+        char header[96];
+        struct iovec iov;
+
+        iov.iov_base = header;
+        iov.iov_len = snprintf(header, sizeof(header), "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n",
+            config->width, config->height, (config->fps > 0) ? config->fps : RAW_DEFAULT_FPS);
+
+        /** The header is on the stack, it must be copied */
+        if (iov.iov_len != (size_t)write(sink->fd, header, iov.iov_len))
+        {
+            close(sink->fd);
+            sink->fd = -1;
+            return E_NOT_OK;
+        }
+    }
+
+    return E_OK;
+
+}/* End of function RawSink_Open */
+
+/** NV12 needs a converted copy, I420 and YUV4MPEG2 frames are written from the captured
+ * buffer itself.
+ */
+Std_ReturnType RawSink_Submit(void* sink, const char* filename, unsigned char* data, size_t length, int64_t captured)
+{
+    RawSink* raw = (RawSink*)sink;
+    unsigned char* frame = data;
+    struct iovec iov[2];
+    int count = 0;
+    Std_ReturnType status;
+
+    (void)filename;
+    (void)captured;
+
+    if (-1 == raw->fd || NULL == data || length != raw->frame_size)
+    {
+        free(data);
+        raw->failed++;
+        return E_NOT_OK;
+    }
+
+    if (RAW_NV12 == raw->config.format)
+    {
+        frame = RawSink_ToNV12(raw, data);
+        free(data);
+        if (NULL == frame)
+        {
+            raw->failed++;
+            return E_NOT_OK;
+        }
+    }
+
+    if (RAW_Y4M == raw->config.format)
+    {
+        iov[count].iov_base = (void*)RawFrameHeader;
+        iov[count].iov_len = sizeof(RawFrameHeader) - 1;
+        count++;
+    }
+    iov[count].iov_base = frame;
+    iov[count].iov_len = raw->frame_size;
+    count++;
+
+    status = RawSink_Output(raw, iov, count);
+
+    /** Spliced pages are read from the buffer later, even after a partial write */
+    if (raw->pipe)
+        RawSink_Hold(raw, frame);
+    else
+        free(frame);
+
+    if (E_OK == status)
+        raw->frames++;
+    else
+        raw->failed++;
+
+    return status;
+
+}/* End of function RawSink_Submit */
+
+/** Held buffers are released after the reader emptied the pipe, or gave up reading.
+ */
+void RawSink_Close(RawSink* sink)
+{
+    int pending = 0;
+    int wait;
+    int i;
+
+    if (-1 == sink->fd)
+        return;
+
+    for (wait = 0; sink->pipe && wait < 2000; wait++)
+    {
+        if (0 != ioctl(sink->fd, FIONREAD, &pending) || 0 == pending)
+            break;
+        usleep(1000);
+    }
+
+    close(sink->fd);
+    sink->fd = -1;
+
+    for (i = 0; i < sink->held_count; i++)
+        free(sink->held[i]);
+    sink->held_count = 0;
+
+}/* End of function RawSink_Close */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
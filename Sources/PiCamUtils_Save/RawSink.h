@@ -0,0 +1,152 @@
+/**
+ * @file RawSink.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for raw planar frame output to files and pipes </b>
+ * @version
+ * @date 2026-10-18 Initial template for raw planar frame output
+ * @date 2026-10-19 Take the capture time of submitted frames
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef RAWSINK_H
+#define  RAWSINK_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stddef.h>
+#include <sys/uio.h>
+#include "Common_PiCam.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Maximum number of frames held until the reader of a pipe consumed them */
+#define RAW_MAX_HELD            (32)
+
+/** Frame rate written to the YUV4MPEG2 header when none is configured */
+#define RAW_DEFAULT_FPS         (30)
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Layout of frames written by the raw sink */
+typedef enum
+{
+    /** YUV4MPEG2 stream, stream header and FRAME header before I420 planes */
+    RAW_Y4M,
+    /** I420 planes without headers */
+    RAW_I420,
+    /** Y plane followed by interleaved UV plane without headers */
+    RAW_NV12,
+} Raw_Format;
+
+/** Configuration of a raw sink */
+typedef struct
+{
+    /** Output path, FIFO or regular file, "-" for standard output */
+    const char* path;
+    /** Layout of written frames */
+    Raw_Format format;
+    /** Width of frames in pixels, even */
+    int width;
+    /** Height of frames in pixels, even */
+    int height;
+    /** Frame rate written to the YUV4MPEG2 header, 0 for RAW_DEFAULT_FPS */
+    int fps;
+} RawSink_Config;
+
+/** Output of uncompressed YUV420 frames. Frames are moved into pipes with vmsplice and the
+ *  buffers are held until the pipe has drained past them, other outputs are written with
+ *  writev.
+ */
+typedef struct
+{
+    /** Configuration of the sink */
+    RawSink_Config config;
+    /** Output descriptor, -1 if closed */
+    int fd;
+    /** Set if the output is a pipe */
+    int pipe;
+    /** Size of an I420 frame in bytes */
+    size_t frame_size;
+    /** Buffers referenced by the pipe, oldest first */
+    unsigned char* held[RAW_MAX_HELD];
+    /** Number of held buffers */
+    int held_count;
+    /** Number of buffers to hold, enough to cover the pipe capacity */
+    int held_limit;
+    /** Number of frames written */
+    unsigned long frames;
+    /** Number of frames which could not be written */
+    unsigned long failed;
+} RawSink;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Opens the output of a raw sink and writes the YUV4MPEG2 stream header. For standard
+ *          output, console messages are redirected to standard error so they do not mix with
+ *          frames.
+ *
+ * @param[inout] sink   Raw sink to open
+ * @param[in] config    Configuration of the sink
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType RawSink_Open(RawSink* sink, const RawSink_Config* config);
+
+/**
+ * @brief   Writes an I420 frame, signature matches Sink_SubmitFunc. The sink takes ownership of
+ *          the frame and releases it once it is no longer referenced. Must be called from a
+ *          single thread.
+ *
+ * @param[inout] sink   Pointer to RawSink
+ * @param[in] filename  Ignored
+ * @param[in] data      I420 frame allocated with malloc
+ * @param[in] length    Size of the frame in bytes, width * height * 3 / 2
+ * @param[in] captured  Ignored
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType RawSink_Submit(void* sink, const char* filename, unsigned char* data, size_t length, int64_t captured);
+
+/**
+ * @brief   Closes the output and releases held buffers.
+ *
+ * @param[inout] sink   Raw sink to close
+ *
+ */
+void RawSink_Close(RawSink* sink);
+
+/** @} */
+
+#endif /** RAWSINK_H **/
+
+/*==============================[  End of File  ]======================================*/
@@ -0,0 +1,841 @@
+/**
+ * @file UringSink.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of output sink batching file writes with io_uring </b>
+ * @version
+ * @date 2026-10-18 Initial template for io_uring output sink
+ * @date 2026-10-19 Reap submitted entries before falling back and report errors per file
+ * @date 2026-10-19 Take the capture time of submitted frames
+ * @date 2026-10-19 Keep private helpers out of the header, wait for all completions
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include "UringSink.h"
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to set up an io_uring instance and map its rings.
+ *
+ * @param[inout] ring   io_uring instance
+ * @param[in] entries   Number of submission queue entries
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType Uring_Setup(Uring* ring, unsigned entries);
+
+/**
+ * @brief   Helper function to unmap the rings and close an io_uring instance.
+ *
+ * @param[inout] ring   io_uring instance
+ *
+ */
+static inline void Uring_Release(Uring* ring);
+
+/**
+ * @brief   Helper function to check if the kernel supports an io_uring operation.
+ *
+ * @param[in] probe     Probe result of IORING_REGISTER_PROBE
+ * @param[in] op        Operation code
+ *
+ * @return int          1 if supported, 0 otherwise
+ *
+ */
+static inline int Uring_Supports(const struct io_uring_probe* probe, int op);
+
+/**
+ * @brief   Helper function to prepare the next submission queue entry.
+ *
+ * @param[inout] ring   io_uring instance
+ *
+ * @return struct io_uring_sqe*     Cleared submission queue entry
+ *
+ */
+static inline struct io_uring_sqe* Uring_GetSqe(Uring* ring);
+
+/**
+ * @brief   Helper function to submit all prepared entries with one system call and wait for
+ *          completions. On failure entries the kernel did not consume are withdrawn and the
+ *          completions of the consumed ones are awaited.
+ *
+ * @param[inout] ring       io_uring instance
+ * @param[in] wait          Number of completions to wait for
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+static inline Std_ReturnType Uring_Submit(Uring* ring, unsigned wait);
+
+/**
+ * @brief   Helper function to consume one completion.
+ *
+ * @param[inout] ring       io_uring instance
+ * @param[out] user_data    User data of the completed entry
+ * @param[out] res          Result of the completed entry
+ *
+ * @return int              1 if a completion was consumed, 0 if the queue is empty
+ *
+ */
+static inline int Uring_Reap(Uring* ring, unsigned long long* user_data, int* res);
+
+/**
+ * @brief   Helper function to find the registered region containing a buffer.
+ *
+ * @param[in] sink      io_uring output sink
+ * @param[in] data      Start of buffer
+ * @param[in] length    Size of buffer in bytes
+ *
+ * @return int          Index of registered region, -1 if not registered
+ *
+ */
+static inline int Uring_FindBuffer(const UringSink* sink, const unsigned char* data, size_t length);
+
+/**
+ * @brief   Helper function to write a batch of files with io_uring.
+ *
+ * @param[inout] sink   io_uring output sink
+ * @param[in] items     Files to write
+ * @param[in] data      Buffers to write for each file, staging buffers for O_DIRECT
+ * @param[in] length    Number of bytes to write for each file
+ * @param[in] count     Number of files
+ * @param[out] error    Error number for each file, 0 if the file was written
+ *
+ */
+static inline void Uring_WriteBatch(UringSink* sink, Sink_Item** items, unsigned char** data, const size_t* length, int count, int* error);
+
+/**
+ * @brief   Helper function to close the files opened by a failed batch and write it with
+ *          pwrite instead.
+ *
+ * @param[inout] sink   io_uring output sink
+ * @param[in] items     Files to write
+ * @param[in] data      Buffers to write for each file, staging buffers for O_DIRECT
+ * @param[in] length    Number of bytes to write for each file
+ * @param[in] count     Number of files
+ * @param[out] error    Error number for each file, 0 if the file was written
+ * @param[in] fds       File descriptors opened by io_uring, negative if not opened
+ * @param[in] closed    Set for files already closed by io_uring
+ *
+ */
+static inline void Uring_Fallback(UringSink* sink, Sink_Item** items, unsigned char** data, const size_t* length, int count, int* error, const int* fds, const int* closed);
+
+/**
+ * @brief   Helper function to write a batch of files with open, pwrite and close.
+ *
+ * @param[inout] sink   io_uring output sink
+ * @param[in] items     Files to write
+ * @param[in] data      Buffers to write for each file, staging buffers for O_DIRECT
+ * @param[in] length    Number of bytes to write for each file
+ * @param[in] count     Number of files
+ * @param[out] error    Error number for each file, 0 if the file was written
+ *
+ */
+static inline void Pwrite_WriteBatch(UringSink* sink, Sink_Item** items, unsigned char** data, const size_t* length, int count, int* error);
+
+/**
+ * @brief   Thread entry of the worker thread, collecting and writing batches of files.
+ *
+ * @param[in] arg   Pointer to UringSink
+ *
+ * @return void*    Always NULL
+ *
+ */
+static void* Uring_Worker(void* arg);
+
+/** @} */
+
+/*===========================[  Function definitions  ]===================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/** Creates the instance with io_uring_setup and maps submission ring, completion ring and
+ * submission entries. Rings share one mapping if the kernel supports it.
+ */
+static inline Std_ReturnType Uring_Setup(Uring* ring, unsigned entries)
+{
+    struct io_uring_params params;
+    unsigned char* sq;
+    unsigned char* cq;
+
+    memset(ring, 0, sizeof(Uring));
+    memset(&params, 0, sizeof(params));
+
+    ring->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (ring->fd < 0)
+    {
+        ring->fd = -1;
+        return E_NOT_OK;
+    }
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        if (ring->cq_ring_size > ring->sq_ring_size)
+            ring->sq_ring_size = ring->cq_ring_size;
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (MAP_FAILED == ring->sq_ring)
+    {
+        ring->sq_ring = NULL;
+        Uring_Release(ring);
+        return E_NOT_OK;
+    }
+
+    if (params.features & IORING_FEAT_SINGLE_MMAP)
+    {
+        ring->cq_ring = ring->sq_ring;
+    }
+    else
+    {
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+        if (MAP_FAILED == ring->cq_ring)
+        {
+            ring->cq_ring = NULL;
+            Uring_Release(ring);
+            return E_NOT_OK;
+        }
+    }
+
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+    if (MAP_FAILED == ring->sqes)
+    {
+        ring->sqes = NULL;
+        Uring_Release(ring);
+        return E_NOT_OK;
+    }
+
+    sq = ring->sq_ring;
+    cq = ring->cq_ring;
+    ring->sq_head = (unsigned*)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+    ring->cq_head = (unsigned*)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    ring->sq_entries = params.sq_entries;
+
+    return E_OK;
+
+}/* End of function Uring_Setup */
+
+/** Unmaps whatever was mapped and closes the instance.
+ */
+static inline void Uring_Release(Uring* ring)
+{
+    if (NULL != ring->sqes)
+        munmap(ring->sqes, ring->sqes_size);
+    if (NULL != ring->cq_ring && ring->cq_ring != ring->sq_ring)
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    if (NULL != ring->sq_ring)
+        munmap(ring->sq_ring, ring->sq_ring_size);
+    if (ring->fd >= 0)
+        close(ring->fd);
+
+    memset(ring, 0, sizeof(Uring));
+    ring->fd = -1;
+
+}/* End of function Uring_Release */
+
+/** Checks the supported flag of the operation in the probe result.
+ */
+static inline int Uring_Supports(const struct io_uring_probe* probe, int op)
+{
+    return (op <= probe->last_op) && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+
+}/* End of function Uring_Supports */
+
+/** Returns the entry after the prepared ones, the tail is only published on submission.
+ */
+static inline struct io_uring_sqe* Uring_GetSqe(Uring* ring)
+{
+    unsigned index = (*ring->sq_tail + ring->pending) & *ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+
+    ring->sq_array[index] = index;
+    ring->pending++;
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+
+    return sqe;
+
+}/* End of function Uring_GetSqe */
+
+/** Publishes the prepared entries and enters the kernel to submit them and wait for the
+ * completions. A signal can end the wait after the entries were consumed, so the kernel is
+ * entered again until all awaited completions are in the ring. The kernel counts every
+ * completion in the ring towards min_complete, so the full number is passed each time.
+ * After a failure the completions of consumed entries are still awaited, so none of them is
+ * read as a result of a later batch.
+ */
+static inline Std_ReturnType Uring_Submit(Uring* ring, unsigned wait)
+{
+    unsigned start = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    unsigned tail = *ring->sq_tail + ring->pending;
+    unsigned head;
+
+    __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+    ring->pending = 0;
+
+    for (;;)
+    {
+        unsigned submit = tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+        unsigned ready = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE) - *ring->cq_head;
+        long r;
+
+        if (0 == submit && ready >= wait)
+        {
+            ring->inflight += tail - start;
+            return E_OK;
+        }
+
+        r = syscall(__NR_io_uring_enter, ring->fd, submit, wait, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (r < 0 && EINTR != errno)
+            break;
+    }
+
+    /** Withdraw the entries the kernel did not consume */
+    head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    __atomic_store_n(ring->sq_tail, head, __ATOMIC_RELEASE);
+    ring->inflight += head - start;
+
+    for (;;)
+    {
+        unsigned ready = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE) - *ring->cq_head;
+        long r;
+
+        if (ready >= ring->inflight)
+            break;
+
+        r = syscall(__NR_io_uring_enter, ring->fd, 0, ring->inflight, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (r < 0 && EINTR != errno)
+            break;
+    }
+
+    return E_NOT_OK;
+
+}/* End of function Uring_Submit */
+
+/** Reads the entry at the completion queue head and releases it to the kernel.
+ */
+static inline int Uring_Reap(Uring* ring, unsigned long long* user_data, int* res)
+{
+    unsigned head = *ring->cq_head;
+    struct io_uring_cqe* cqe;
+
+    if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+        return 0;
+
+    cqe = &ring->cqes[head & *ring->cq_mask];
+    *user_data = cqe->user_data;
+    *res = cqe->res;
+    __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+    if (ring->inflight > 0)
+        ring->inflight--;
+
+    return 1;
+
+}/* End of function Uring_Reap */
+
+/** Searches the caller owned regions for one containing the complete buffer.
+ */
+static inline int Uring_FindBuffer(const UringSink* sink, const unsigned char* data, size_t length)
+{
+    int i;
+
+    for (i = 0; i < sink->buffer_count; i++)
+    {
+        const unsigned char* base = sink->buffers[i].iov_base;
+        if (data >= base && data + length <= base + sink->buffers[i].iov_len)
+            return i;
+    }
+
+    return -1;
+
+}/* End of function Uring_FindBuffer */
+
+/** Writes the batch with two submissions. The first opens all files, the second writes each
+ * file linked with its close. O_DIRECT files are truncated to their size and closed after the
+ * writes complete. Short writes break the link, such files are completed with pwrite. If a
+ * submission fails, all of its completions are consumed and the files which were opened are
+ * closed before the batch is written with pwrite.
+ */
+static inline void Uring_WriteBatch(UringSink* sink, Sink_Item** items, unsigned char** data, const size_t* length, int count, int* error)
+{
+    Uring* ring = &sink->ring;
+    const int direct = sink->config.direct;
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | (direct ? O_DIRECT : 0);
+    int fds[URING_MAX_BATCH];
+    ssize_t done[URING_MAX_BATCH];
+    int closed[URING_MAX_BATCH];
+    unsigned long long user_data;
+    unsigned submitted = 0;
+    int i, res, failed;
+
+    /** Open all files */
+    for (i = 0; i < count; i++)
+    {
+        struct io_uring_sqe* sqe = Uring_GetSqe(ring);
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = (uintptr_t)items[i]->filename;
+        sqe->len = 0644;
+        sqe->open_flags = flags;
+        sqe->user_data = i;
+        fds[i] = -1;
+        done[i] = 0;
+        closed[i] = 0;
+    }
+
+    failed = (E_OK != Uring_Submit(ring, count));
+
+    while (Uring_Reap(ring, &user_data, &res))
+    {
+        i = (int)user_data;
+        fds[i] = res;
+
+        /** File system without O_DIRECT support, fall back to buffered writes */
+        if (!failed && direct && -EINVAL == res)
+        {
+            fds[i] = open(items[i]->filename, flags & ~O_DIRECT, 0644);
+            if (fds[i] < 0)
+                fds[i] = -errno;
+        }
+    }
+
+    if (failed)
+    {
+        Uring_Fallback(sink, items, data, length, count, error, fds, closed);
+        return;
+    }
+
+    /** Write opened files, buffered files are closed in the same chain */
+    for (i = 0; i < count; i++)
+    {
+        struct io_uring_sqe* sqe;
+        int index = direct ? -1 : Uring_FindBuffer(sink, data[i], length[i]);
+
+        if (fds[i] < 0)
+            continue;
+
+        sqe = Uring_GetSqe(ring);
+        sqe->opcode = (sink->registered && index >= 0) ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->fd = fds[i];
+        sqe->addr = (uintptr_t)data[i];
+        sqe->len = (unsigned)length[i];
+        sqe->off = 0;
+        sqe->buf_index = (sink->registered && index >= 0) ? index : 0;
+        sqe->user_data = (unsigned long long)i << 1;
+        submitted++;
+
+        if (!direct)
+        {
+            sqe->flags = IOSQE_IO_LINK;
+            sqe = Uring_GetSqe(ring);
+            sqe->opcode = IORING_OP_CLOSE;
+            sqe->fd = fds[i];
+            sqe->user_data = ((unsigned long long)i << 1) | 1;
+            submitted++;
+        }
+    }
+
+    failed = (submitted > 0 && E_OK != Uring_Submit(ring, submitted));
+
+    while (Uring_Reap(ring, &user_data, &res))
+    {
+        i = (int)(user_data >> 1);
+        if (user_data & 1)
+            closed[i] = (-ECANCELED != res);
+        else
+            done[i] = res;
+    }
+
+    if (failed)
+    {
+        Uring_Fallback(sink, items, data, length, count, error, fds, closed);
+        return;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if (fds[i] < 0)
+        {
+            error[i] = -fds[i];
+            continue;
+        }
+
+        /** Complete short writes */
+        while (done[i] >= 0 && (size_t)done[i] < length[i])
+        {
+            ssize_t r = pwrite(fds[i], data[i] + done[i], length[i] - done[i], done[i]);
+            if (r < 0 && EINTR == errno)
+                continue;
+            done[i] = (r < 0) ? -errno : (0 == r) ? -EIO : done[i] + r;
+        }
+
+        error[i] = (done[i] < 0) ? (int)-done[i] : 0;
+        if (0 == error[i] && direct && 0 != ftruncate(fds[i], items[i]->length))
+            error[i] = errno;
+
+        if (!closed[i])
+            close(fds[i]);
+    }
+
+}/* End of function Uring_WriteBatch */
+
+/** Completions still outstanding after a failed submission would be read as results of a
+ * later batch, io_uring is then no longer used by the sink.
+ */
+static inline void Uring_Fallback(UringSink* sink, Sink_Item** items, unsigned char** data, const size_t* length, int count, int* error, const int* fds, const int* closed)
+{
+    int i;
+
+    for (i = 0; i < count; i++)
+        if (fds[i] >= 0 && !closed[i])
+            close(fds[i]);
+
+    if (0 != sink->ring.inflight)
+    {
+        fprintf(stderr, "io_uring submission failed, writing files with pwrite\n");
+        sink->use_uring = 0;
+    }
+
+    Pwrite_WriteBatch(sink, items, data, length, count, error);
+
+}/* End of function Uring_Fallback */
+
+/** Writes the batch one file at a time with plain system calls.
+ */
+static inline void Pwrite_WriteBatch(UringSink* sink, Sink_Item** items, unsigned char** data, const size_t* length, int count, int* error)
+{
+    const int direct = sink->config.direct;
+    int flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | (direct ? O_DIRECT : 0);
+    int i;
+
+    for (i = 0; i < count; i++)
+    {
+        size_t done = 0;
+        int fd = open(items[i]->filename, flags, 0644);
+
+        if (fd < 0 && direct && EINVAL == errno)
+            fd = open(items[i]->filename, flags & ~O_DIRECT, 0644);
+
+        error[i] = (fd < 0) ? errno : 0;
+        if (fd < 0)
+            continue;
+
+        while (done < length[i])
+        {
+            ssize_t r = pwrite(fd, data[i] + done, length[i] - done, done);
+            if (r < 0 && EINTR == errno)
+                continue;
+            if (r <= 0)
+            {
+                error[i] = (r < 0) ? errno : EIO;
+                break;
+            }
+            done += (size_t)r;
+        }
+
+        if (0 == error[i] && direct && 0 != ftruncate(fd, items[i]->length))
+            error[i] = errno;
+
+        close(fd);
+    }
+
+}/* End of function Pwrite_WriteBatch */
+
+/** Collects up to config.batch queued files without waiting after the first one, so a burst
+ * is written with few submissions while a single file is not delayed. Process signals are
+ * left to the application threads.
+ */
+static void* Uring_Worker(void* arg)
+{
+    UringSink* sink = (UringSink*)arg;
+    Sink_Item* items[URING_MAX_BATCH];
+    unsigned char* data[URING_MAX_BATCH];
+    size_t length[URING_MAX_BATCH];
+    int error[URING_MAX_BATCH];
+    int count, i, written;
+
+    Thread_BlockSignals();
+
+    for (;;)
+    {
+        items[0] = BoundedQueue_Pop(&sink->queue, 1);
+        if (NULL == items[0])
+            break;
+
+        for (count = 1; count < sink->config.batch; count++)
+        {
+            items[count] = BoundedQueue_Pop(&sink->queue, 0);
+            if (NULL == items[count])
+                break;
+        }
+
+        for (i = 0; i < count; i++)
+        {
+            data[i] = items[i]->data;
+            length[i] = items[i]->length;
+
+            /** Copy into aligned staging buffer padded to complete blocks */
+            if (sink->config.direct)
+            {
+                size_t size = (items[i]->length + URING_DIRECT_ALIGN - 1) & ~(size_t)(URING_DIRECT_ALIGN - 1);
+                if (sink->staging_size[i] < size)
+                {
+                    void* staging = NULL;
+                    if (0 == posix_memalign(&staging, URING_DIRECT_ALIGN, size))
+                    {
+                        free(sink->staging[i]);
+                        sink->staging[i] = staging;
+                        sink->staging_size[i] = size;
+                    }
+                }
+                if (sink->staging_size[i] >= size)
+                {
+                    memcpy(sink->staging[i], items[i]->data, items[i]->length);
+                    memset(sink->staging[i] + items[i]->length, 0, size - items[i]->length);
+                    data[i] = sink->staging[i];
+                    length[i] = size;
+                }
+            }
+        }
+
+        if (sink->use_uring)
+            Uring_WriteBatch(sink, items, data, length, count, error);
+        else
+            Pwrite_WriteBatch(sink, items, data, length, count, error);
+
+        written = 0;
+        for (i = 0; i < count; i++)
+        {
+            if (0 == error[i])
+                written++;
+            else
+                fprintf(stderr, "Could not write file %s, error %d, %s\n", items[i]->filename, error[i], strerror(error[i]));
+
+            if (Uring_FindBuffer(sink, items[i]->data, items[i]->length) < 0)
+                free(items[i]->data);
+            free(items[i]);
+        }
+
+        pthread_mutex_lock(&sink->lock);
+        sink->written += written;
+        sink->failed += count - written;
+        sink->completed += count;
+        sink->batches++;
+        pthread_cond_broadcast(&sink->done);
+        pthread_mutex_unlock(&sink->lock);
+    }
+
+    return NULL;
+
+}/* End of function Uring_Worker */
+
+/** @} */
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/** Sets up the ring and probes for open, write and close operations. Without them or
+ * without io_uring the sink uses the pwrite fallback. Registration failures, for example due
+ * to the locked memory limit, only disable fixed buffer writes.
+ */
+Std_ReturnType UringSink_Init(UringSink* sink, const UringSink_Config* config)
+{
+    Std_ReturnType validate = E_OK;
+    struct io_uring_probe* probe;
+    size_t probe_size = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+    int i;
+
+    validate += ValidateParam(sink);
+    validate += ValidateParam((void*)config);
+
+    if (E_OK == validate)
+    {
+        validate += ValidateValue(config->batch, 1, URING_MAX_BATCH);
+        validate += (config->queue_depth > 0) ? E_OK : E_NOT_OK;
+        validate += ValidateValue(config->buffer_count, 0, URING_MAX_BUFFERS);
+        if (config->buffer_count > 0)
+            validate += ValidateParam((void*)config->buffers);
+    }
+
+    if (E_OK != validate)
+    {
+        printf("Invalid input parameters provided.\n");
+        return E_NOT_OK;
+    }
+
+    memset(sink, 0, sizeof(UringSink));
+    sink->config = *config;
+    sink->config.buffers = sink->buffers;
+    sink->buffer_count = config->buffer_count;
+    for (i = 0; i < config->buffer_count; i++)
+        sink->buffers[i] = config->buffers[i];
+
+    if (E_OK == Uring_Setup(&sink->ring, 2 * URING_MAX_BATCH))
+    {
+        probe = calloc(1, probe_size);
+        if (NULL != probe && 0 == syscall(__NR_io_uring_register, sink->ring.fd, IORING_REGISTER_PROBE, probe, 256))
+        {
+            sink->use_uring = Uring_Supports(probe, IORING_OP_OPENAT) &&
+                              Uring_Supports(probe, IORING_OP_WRITE) &&
+                              Uring_Supports(probe, IORING_OP_WRITE_FIXED) &&
+                              Uring_Supports(probe, IORING_OP_CLOSE);
+        }
+        free(probe);
+
+        if (sink->use_uring && sink->buffer_count > 0)
+            sink->registered = (0 == syscall(__NR_io_uring_register, sink->ring.fd, IORING_REGISTER_BUFFERS, sink->buffers, sink->buffer_count));
+
+        if (!sink->use_uring)
+            Uring_Release(&sink->ring);
+    }
+    else
+    {
+        sink->ring.fd = -1;
+    }
+
+    if (E_OK != BoundedQueue_Init(&sink->queue, config->queue_depth))
+    {
+        Uring_Release(&sink->ring);
+        return E_NOT_OK;
+    }
+    pthread_mutex_init(&sink->lock, NULL);
+    pthread_cond_init(&sink->done, NULL);
+
+    if (0 != pthread_create(&sink->thread, NULL, Uring_Worker, sink))
+    {
+        UringSink_Close(sink);
+        return E_NOT_OK;
+    }
+    sink->started = 1;
+
+    return E_OK;
+
+}/* End of function UringSink_Init */
+
+/** Queues the file with the configured policy. Dropped files are released immediately unless
+ * they belong to a caller owned region.
+ */
+Std_ReturnType UringSink_Submit(void* sink, const char* filename, unsigned char* data, size_t length, int64_t captured)
+{
+    UringSink* out = (UringSink*)sink;
+    Sink_Item* item = NULL;
+    Sink_Item* evicted = NULL;
+    Std_ReturnType status = E_NOT_OK;
+
+    (void)captured;
+    if (NULL != filename && strlen(filename) < SINK_MAX_FILENAME && length <= UINT32_MAX)
+        item = malloc(sizeof(Sink_Item));
+    else
+        printf("Invalid input parameters provided.\n");
+
+    if (NULL != item)
+    {
+        strcpy(item->filename, filename);
+        item->data = data;
+        item->length = length;
+        status = BoundedQueue_Push(&out->queue, item, out->config.policy, (void**)&evicted);
+    }
+
+    if (E_OK != status)
+    {
+        if (Uring_FindBuffer(out, data, length) < 0)
+            free(data);
+        free(item);
+    }
+    if (NULL != evicted)
+    {
+        if (Uring_FindBuffer(out, evicted->data, evicted->length) < 0)
+            free(evicted->data);
+        free(evicted);
+    }
+
+    pthread_mutex_lock(&out->lock);
+    if (E_OK == status)
+        out->accepted++;
+    if (NULL != evicted)
+        out->completed++;
+    if (E_OK != status || NULL != evicted)
+        out->dropped++;
+    pthread_mutex_unlock(&out->lock);
+
+    return status;
+
+}/* End of function UringSink_Submit */
+
+/** Waits on the completion counter of the worker thread.
+ */
+void UringSink_Flush(UringSink* sink)
+{
+    pthread_mutex_lock(&sink->lock);
+    while (sink->completed < sink->accepted)
+        pthread_cond_wait(&sink->done, &sink->lock);
+    pthread_mutex_unlock(&sink->lock);
+
+}/* End of function UringSink_Flush */
+
+/** Closes the queue, joins the worker thread after it wrote the remaining files and releases
+ * the ring and staging buffers.
+ */
+void UringSink_Close(UringSink* sink)
+{
+    int i;
+
+    BoundedQueue_Close(&sink->queue);
+    if (sink->started)
+        pthread_join(sink->thread, NULL);
+    sink->started = 0;
+
+    for (i = 0; i < URING_MAX_BATCH; i++)
+    {
+        free(sink->staging[i]);
+        sink->staging[i] = NULL;
+        sink->staging_size[i] = 0;
+    }
+
+    Uring_Release(&sink->ring);
+    BoundedQueue_DeInit(&sink->queue);
+    pthread_cond_destroy(&sink->done);
+    pthread_mutex_destroy(&sink->lock);
+
+}/* End of function UringSink_Close */
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
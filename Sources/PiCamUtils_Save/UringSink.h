@@ -0,0 +1,219 @@
+/**
+ * @file UringSink.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header for output sink batching file writes with io_uring </b>
+ * @version
+ * @date 2026-10-18 Initial template for io_uring output sink
+ * @date 2026-10-19 Reap submitted entries before falling back and report errors per file
+ * @date 2026-10-19 Take the capture time of submitted frames
+ * @date 2026-10-19 Keep private helpers out of the header
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef URINGSINK_H
+#define  URINGSINK_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <pthread.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+#include "Common_PiCam.h"
+#include "BoundedQueue.h"
+#include "OutputSink.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines
+ *  @{
+ */
+
+/** Maximum number of files written with one batch of submissions */
+#define URING_MAX_BATCH         (32)
+
+/** Maximum number of buffer regions registered with the kernel */
+#define URING_MAX_BUFFERS       (16)
+
+/** Alignment of buffer address, file offset and length for O_DIRECT writes */
+#define URING_DIRECT_ALIGN      (4096)
+
+/** @} */
+
+/*============================[  Data Types  ]============================================*/
+
+/** \addtogroup data_types
+ *  @{
+ */
+
+/** Configuration of an io_uring output sink */
+typedef struct
+{
+    /** Maximum number of files written with one batch of submissions (1 to URING_MAX_BATCH) */
+    int batch;
+    /** Maximum number of files waiting to be written */
+    int queue_depth;
+    /** Action if a file is submitted while the queue is full */
+    Queue_Policy policy;
+    /** Bypass the page cache with O_DIRECT. Files are written from aligned staging buffers
+     *  padded to URING_DIRECT_ALIGN and truncated to their size afterwards. */
+    int direct;
+    /** Buffer regions to register, for example a pool of frame buffers. Files with contents
+     *  inside a region are written with IORING_OP_WRITE_FIXED and are not released. */
+    const struct iovec* buffers;
+    /** Number of buffer regions (0 to URING_MAX_BUFFERS) */
+    int buffer_count;
+} UringSink_Config;
+
+/** Submission and completion rings of an io_uring instance mapped into user space */
+typedef struct
+{
+    /** io_uring file descriptor, -1 if not set up */
+    int fd;
+    /** Submission queue head, advanced by the kernel */
+    unsigned* sq_head;
+    /** Submission queue tail, advanced by the application */
+    unsigned* sq_tail;
+    /** Submission queue index mask */
+    unsigned* sq_mask;
+    /** Submission queue index array */
+    unsigned* sq_array;
+    /** Submission queue entries */
+    struct io_uring_sqe* sqes;
+    /** Completion queue head, advanced by the application */
+    unsigned* cq_head;
+    /** Completion queue tail, advanced by the kernel */
+    unsigned* cq_tail;
+    /** Completion queue index mask */
+    unsigned* cq_mask;
+    /** Completion queue entries */
+    struct io_uring_cqe* cqes;
+    /** Number of submission queue entries */
+    unsigned sq_entries;
+    /** Submission queue entries prepared but not yet submitted */
+    unsigned pending;
+    /** Submitted entries whose completion was not consumed yet */
+    unsigned inflight;
+    /** Mapping of submission queue ring */
+    void* sq_ring;
+    /** Size of submission queue ring mapping */
+    size_t sq_ring_size;
+    /** Mapping of completion queue ring, same as sq_ring with IORING_FEAT_SINGLE_MMAP */
+    void* cq_ring;
+    /** Size of completion queue ring mapping */
+    size_t cq_ring_size;
+    /** Size of submission queue entries mapping */
+    size_t sqes_size;
+} Uring;
+
+/** Output sink writing batches of files with io_uring on a worker thread. Falls back to open,
+ *  pwrite and close if io_uring or the required operations are not available.
+ */
+typedef struct
+{
+    /** Configuration of the sink */
+    UringSink_Config config;
+    /** io_uring instance */
+    Uring ring;
+    /** Set if files are written with io_uring, cleared for the pwrite fallback */
+    int use_uring;
+    /** Buffer regions owned by the caller */
+    struct iovec buffers[URING_MAX_BUFFERS];
+    /** Number of buffer regions owned by the caller */
+    int buffer_count;
+    /** Set if the buffer regions are registered with the kernel */
+    int registered;
+    /** Aligned staging buffers for O_DIRECT writes, one per file of a batch */
+    unsigned char* staging[URING_MAX_BATCH];
+    /** Allocated size of staging buffers in bytes */
+    size_t staging_size[URING_MAX_BATCH];
+    /** Files waiting to be written */
+    BoundedQueue queue;
+    /** Worker thread */
+    pthread_t thread;
+    /** Set if the worker thread was started */
+    int started;
+    /** Lock protecting the statistics */
+    pthread_mutex_t lock;
+    /** Signalled when a batch of files completed */
+    pthread_cond_t done;
+    /** Number of files accepted by the queue */
+    unsigned long accepted;
+    /** Number of accepted files written, failed or dropped from the queue */
+    unsigned long completed;
+    /** Number of files written */
+    unsigned long written;
+    /** Number of files dropped because the queue was full */
+    unsigned long dropped;
+    /** Number of files which could not be written */
+    unsigned long failed;
+    /** Number of batches */
+    unsigned long batches;
+} UringSink;
+
+/** @} */
+
+/*===========================[  Function declarations  ]==================================*/
+
+/** \addtogroup interface_functions Interface Functions
+ *  @{
+ */
+
+/**
+ * @brief   Initializes an io_uring output sink, registers buffer regions and starts the worker
+ *          thread.
+ *
+ * @param[inout] sink   io_uring output sink to initialize
+ * @param[in] config    Configuration of the sink
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType UringSink_Init(UringSink* sink, const UringSink_Config* config);
+
+/**
+ * @brief   Queues a file to be written, signature matches Sink_SubmitFunc. Contents inside a
+ *          registered region remain owned by the caller and must not be modified before
+ *          UringSink_Flush returns, other contents are released by the sink.
+ *
+ * @param[inout] sink   Pointer to UringSink
+ * @param[in] filename  Name of file to create
+ * @param[in] data      File contents
+ * @param[in] length    Size of file contents in bytes
+ * @param[in] captured  Ignored
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             File queued
+ * @retval E_NOT_OK         File dropped
+ *
+ */
+Std_ReturnType UringSink_Submit(void* sink, const char* filename, unsigned char* data, size_t length, int64_t captured);
+
+/**
+ * @brief   Waits until all queued files are written.
+ *
+ * @param[inout] sink   io_uring output sink
+ *
+ */
+void UringSink_Flush(UringSink* sink);
+
+/**
+ * @brief   Writes all queued files, stops the worker thread and releases the sink.
+ *
+ * @param[inout] sink   io_uring output sink to close
+ *
+ */
+void UringSink_Close(UringSink* sink);
+
+/** @} */
+
+#endif /** URINGSINK_H **/
+
+/*==============================[  End of File  ]======================================*/
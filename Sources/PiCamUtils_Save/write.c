@@ -8,6 +8,20 @@
  * @date 2022-03-23 Updates for Gaussian filter and Edge detection
  * @date 2022-03-24 Remove unused variable
  * @date 2022-04-05 Add saving images for JPEG RGB
+ * @date 2026-10-18 Add saving planar YUV420 images as JPEG using raw data
+ * @date 2026-10-18 Encode JPEG images with a persistent in-memory encoder
+ * @date 2026-10-18 Pass encoded files to an asynchronous output sink if selected
+ * @date 2026-10-18 Pass uncompressed frames to a raw output if selected
+ * @date 2026-10-18 Add lossless QOI and PGM/PPM images
+ * @date 2026-10-18 Encode JPEG images on an encoder pool if selected
+ * @date 2026-10-18 Adapt JPEG quality with a rate controller if selected
+ * @date 2026-10-18 Add downscaled JPEG outputs and EXIF thumbnails if selected
+ * @date 2026-10-18 Move writer state into a save context passed to every function
+ * @date 2026-10-18 Add writing planar images and encoded files of processing pipelines
+ * @date 2026-10-19 Time file writes for the stage histograms
+ * @date 2026-10-19 Hand the capture time of frames to the outputs
+ * @date 2026-10-19 Return errors of writing images to the caller instead of exiting
+ * @date 2026-10-19 Let raw outputs lend memory for frames copied in place
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -22,26 +36,151 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
-#include <jpeglib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
+#include "Common_PiCam.h"
+#include "JpegEncoder.h"
+#include "EncoderPool.h"
+#include "RateControl.h"
+#include "Preview.h"
+#include "Lossless.h"
+#include "YUVtoRGB.h"
+#include "OutputSink.h"
+#include "Metrics.h"
 #include "write.h"
 
+/*============================[  Global Variables  ]====================================*/
+
 /*===========================[  Function definitions  ]===================================*/
 
 /** \addtogroup interface_functions Interface Functions	  
  *  @{
  */
 
+/**	Print error message and return E_NOT_OK, library functions report errors to the caller.
+*/
+Std_ReturnType errno_print(const char* string_ptr)
+{
+	fprintf(stderr, "%s error %d, %s\n", string_ptr, errno, strerror(errno));
+	return E_NOT_OK;
+}
+
 /**	Print error message and terminate program with EXIT_FAILURE return code.
 */
 void errno_exit(const char* string_ptr)
 {
-	fprintf(stderr, "%s error %d, %s\n", string_ptr, errno, strerror(errno));
+	errno_print(string_ptr);
 	exit(EXIT_FAILURE);
 }
 
+/** Starts with JPEG images of default quality written on the calling thread. 
+ */ 
+void Save_Init(Save_Context* save)
+{
+	memset(save, 0, sizeof(Save_Context));
+	save->quality = SAVE_DEFAULT_QUALITY;
+	save->format = SAVE_JPEG;
+}
+
+/** Releases the encoder and downscaled outputs, outputs and pools are owned by the caller. 
+ */ 
+void Save_DeInit(Save_Context* save)
+{
+	if (save->encoder_ready)
+		JpegEncoder_DeInit(&save->encoder);
+	save->encoder_ready = 0;
+
+	Save_SetPreview(save, NULL);
+}
+
+/** Selects where the write functions put encoded files. 
+ */ 
+void Save_SetOutput(Save_Context* save, Sink_SubmitFunc submit, void* sink)
+{
+	save->submit = submit;
+	save->sink = sink;
+}
+
+/** Selects where uncompressed frames go. 
+ */ 
+void Save_SetRawOutput(Save_Context* save, Sink_SubmitFunc submit, Sink_ClaimFunc claim, void* sink)
+{
+	save->raw_submit = submit;
+	save->raw_claim = claim;
+	save->raw = sink;
+}
+
+/** Lets capture copy frames straight into the raw output. 
+ */ 
+unsigned char* Save_ClaimRawFrame(Save_Context* save, size_t length)
+{
+	if (NULL == save->raw_claim)
+		return NULL;
+
+	return save->raw_claim(save->raw, length);
+}
+
+/** Stores the capture time handed to the outputs with the following frames. 
+ */ 
+void Save_SetCaptureTime(Save_Context* save, int64_t captured)
+{
+	save->captured = captured;
+}
+
+/** This function hands a captured frame to the raw output without copying it. 
+ */ 
+int writerawimageYUV420(Save_Context* save, int width, int height, unsigned char* img, char* filename)
+{
+	if (NULL == save->raw_submit)
+		return 0;
+
+	save->raw_submit(save->raw, filename, img, (size_t)width * height * 3 / 2, save->captured);
+	return 1;
+}
+
+/** Selects the encoder pool of the JPEG write functions. 
+ */ 
+void Save_SetEncoderPool(Save_Context* save, EncoderPool* pool)
+{
+	save->pool = pool;
+}
+
+/** Selects the rate controller of the JPEG write functions. 
+ */ 
+void Save_SetRateControl(Save_Context* save, RateControl* rate)
+{
+	save->rate = rate;
+}
+
+/** Selects the downscaled outputs of the JPEG write functions. 
+ */ 
+void Save_SetPreview(Save_Context* save, const Preview_Config* config)
+{
+	if (save->preview_ready)
+		Preview_DeInit(&save->preview);
+
+	save->preview_ready = (NULL != config) && (config->scales || config->thumbnail) 
+		&& (E_OK == Preview_Init(&save->preview, config));
+}
+
+/** This function hands a captured frame to the encoder pool without copying it. 
+ */ 
+int writepooledimageYUV420(Save_Context* save, int width, int height, unsigned char* img, char* filename)
+{
+	Image_Planar image;
+
+	if (NULL == save->pool || SAVE_JPEG != save->format)
+		return 0;
+
+	Image_SetPlanar(&image, PIXFMT_YUV420, width, height, img);
+	EncoderPool_Submit(save->pool, &image, img, filename, save->captured);
+	return 1;
+}
+
 /** This function writes captured buffer as a bitmap format. 
  */ 
-void writebitmapimage(int width, int height, unsigned char* src, char* filename)
+void writebitmapimage(Save_Context* save, int width, int height, unsigned char* src, char* filename)
 {
 	BITMAPFILEHEADER bfh;
 	BITMAPINFOHEADER bih;
@@ -69,6 +208,28 @@ void writebitmapimage(int width, int height, unsigned char* src, char* filename)
 	bih.biClrUsed = 0;
 	bih.biClrImportant = 0;
 
+	/* Hand headers and pixel values over to the output sink as one buffer */
+	if (NULL != save->submit)
+	{
+		size_t size = sizeof(bfType) + sizeof(bfh) + sizeof(bih) + (size_t)width * height * 3;
+		unsigned char* data = malloc(size);
+		unsigned char* pos = data;
+		if (NULL == data)
+		{
+			printf("Could not write file\n");
+			return;
+		}
+		memcpy(pos, &bfType, sizeof(bfType));
+		pos += sizeof(bfType);
+		memcpy(pos, &bfh, sizeof(bfh));
+		pos += sizeof(bfh);
+		memcpy(pos, &bih, sizeof(bih));
+		pos += sizeof(bih);
+		memcpy(pos, src, (size_t)width * height * 3);
+		save->submit(save->sink, filename, data, size, save->captured);
+		return;
+	}
+
 	FILE *file = fopen(filename, "wb");
 	if (!file)
     {
@@ -85,137 +246,327 @@ void writebitmapimage(int width, int height, unsigned char* src, char* filename)
 	fclose(file);
 }
 
-/** This function writes captured image buffer as JPEG format. 
+/** Passes an encoded file to the output sink or writes it with a single write, the buffer is 
+ * released either way. 
  */ 
-void writejpegimageYUV(int width, int height, unsigned char* img, char* filename)
+static Std_ReturnType Save_Buffer(Save_Context* save, unsigned char* data, size_t length, char* filename)
 {
-	struct jpeg_compress_struct cinfo;
-	struct jpeg_error_mgr jerr;
+	size_t done = 0;
+	int64_t start;
+	int fd;
 
-	JSAMPROW row_pointer[1];
-	FILE *outfile = fopen( filename, "wb" );
-	if (!outfile) {
-		errno_exit("jpeg");
+	/* Outputs count the images they drop, capture goes on */
+	if (NULL != save->submit)
+	{
+		save->submit(save->sink, filename, data, length, save->captured);
+		return E_OK;
 	}
 
-	/* Create JPEG data */
-	cinfo.err = jpeg_std_error( &jerr );
-	jpeg_create_compress(&cinfo);
-	jpeg_stdio_dest(&cinfo, outfile);
-
-	/* Set image parameters */
-	cinfo.image_width = width;
-	cinfo.image_height = height;
-	cinfo.input_components = 3;
-	cinfo.in_color_space = JCS_YCbCr;
-
-	/* Set JPEG compression parameters to default, adjust quality setting and start conpression */
-	jpeg_set_defaults(&cinfo);
-	jpeg_set_quality(&cinfo, jpegQuality, TRUE);
-	jpeg_start_compress(&cinfo, TRUE);
+	start = Metrics_Begin();
+	fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	if (-1 == fd)
+	{
+		free(data);
+		return errno_print(filename);
+	}
 
-	/* Feed pixel data */
-	while (cinfo.next_scanline < cinfo.image_height) 
+	while (done < length)
 	{
-		row_pointer[0] = &img[cinfo.next_scanline * cinfo.image_width *  cinfo.input_components];
-		jpeg_write_scanlines(&cinfo, row_pointer, 1);
+		ssize_t r = write(fd, data + done, length - done);
+		if (r < 0 && EINTR == errno)
+			continue;
+		if (r <= 0)
+			break;
+		done += (size_t)r;
 	}
 
-	/* Finish compression */
-	jpeg_finish_compress(&cinfo);
-	jpeg_destroy_compress(&cinfo);
+	close(fd);
+	free(data);
 
-	/* Close output image file */
-	fclose(outfile);
+	if (done != length)
+		return errno_print(filename);
+	Metrics_End(METRIC_WRITE, start);
+
+	return E_OK;
 }
 
+/** Saves the downscaled outputs of the last image next to it. 
+ */ 
+static Std_ReturnType Save_Previews(Save_Context* save, char* filename)
+{
+	char name[SINK_MAX_FILENAME];
+	Std_ReturnType saved = E_OK;
+	int i;
 
-/** This function writes captured image buffer as JPEG format. 
+	for (i = 0; i < save->preview.outputs; i++)
+	{
+		if (E_OK == Preview_Filename(name, sizeof(name), filename, &save->preview.output[i]))
+			saved |= Save_Buffer(save, save->preview.output[i].data, save->preview.output[i].length, name);
+		else
+			free(save->preview.output[i].data);
+	}
+	save->preview.outputs = 0;
+
+	return saved;
+}
+
+/** Encodes an image with the shared encoder and either passes it to the output sink or writes 
+ * it to a file with a single write. With an encoder pool the image is encoded in slices on all 
+ * encoder threads. A rate controller overrides the requested quality and is fed back with the 
+ * size and encode time of the image. Downscaled outputs are encoded with the same encoder 
+ * before the image and saved first. 
  */ 
-void writejpegimageRGB(int width, int height, unsigned char* img, char* filename)
+static Std_ReturnType Save_Jpeg(Save_Context* save, int quality, const Image_Planar* image, char* filename)
 {
-	struct jpeg_compress_struct cinfo;
-	struct jpeg_error_mgr jerr;
+	unsigned char* data;
+	size_t length;
+	int fast_dct = 0;
+	int64_t start = 0;
+	Std_ReturnType saved = E_OK;
+
+	if (NULL != save->rate)
+	{
+		RateControl_Get(save->rate, &quality, &fast_dct);
+		start = RateControl_Now();
+	}
+
+	if (NULL != save->pool)
+	{
+		if (E_OK != EncoderPool_EncodeSlices(save->pool, image, quality, fast_dct, 
+				save->preview_ready ? &save->preview : NULL, &data, &length))
+			return errno_print("jpeg");
+		saved = Save_Previews(save, filename);
+		if (NULL != save->rate)
+			RateControl_Update(save->rate, length, RateControl_Now() - start);
+		return saved | Save_Buffer(save, data, length, filename);
+	}
 
-	JSAMPROW row_pointer[1];
-	FILE *outfile = fopen( filename, "wb" );
-	if (!outfile) {
-		errno_exit("jpeg");
+	if (!save->encoder_ready)
+	{
+		if (E_OK != JpegEncoder_Init(&save->encoder, quality))
+			return errno_print("jpeg");
+		save->encoder_ready = 1;
 	}
 
-	/* Create JPEG data */
-	cinfo.err = jpeg_std_error( &jerr );
-	jpeg_create_compress(&cinfo);
-	jpeg_stdio_dest(&cinfo, outfile);
+	JpegEncoder_SetQuality(&save->encoder, quality);
+	JpegEncoder_SetFastDCT(&save->encoder, fast_dct);
+
+	if (save->preview_ready && E_OK == Preview_Encode(&save->preview, &save->encoder, image))
+		saved = Save_Previews(save, filename);
 
-	/* Set image parameters */
-	cinfo.image_width = width;
-	cinfo.image_height = height;
-	cinfo.input_components = 3;
-	cinfo.in_color_space = JCS_RGB;
+	if (E_OK != JpegEncoder_Encode(&save->encoder, image))
+		return errno_print("jpeg");
 
-	/* Set JPEG compression parameters to default, adjust quality setting and start conpression */
-	jpeg_set_defaults(&cinfo);
-	jpeg_set_quality(&cinfo, jpegQuality, TRUE);
-	jpeg_start_compress(&cinfo, TRUE);
+	if (NULL != save->rate)
+		RateControl_Update(save->rate, save->encoder.length, RateControl_Now() - start);
 
-	/* Feed pixel data */
-	while (cinfo.next_scanline < cinfo.image_height) 
+	if (NULL != save->submit)
 	{
-		row_pointer[0] = &img[cinfo.next_scanline * cinfo.image_width *  cinfo.input_components];
-		jpeg_write_scanlines(&cinfo, row_pointer, 1);
+		data = JpegEncoder_Detach(&save->encoder, &length);
+		save->submit(save->sink, filename, data, length, save->captured);
+		return saved;
 	}
 
-	/* Finish compression */
-	jpeg_finish_compress(&cinfo);
-	jpeg_destroy_compress(&cinfo);
+	if (E_OK != JpegEncoder_WriteFile(&save->encoder, filename))
+		return errno_print("jpeg");
+
+	return saved;
+}
+
+/** This function writes captured image buffer as JPEG format. 
+ */ 
+Std_ReturnType writejpegimageYUV(Save_Context* save, int width, int height, unsigned char* img, char* filename)
+{
+	Image_Planar image;
+
+	Image_SetPlanar(&image, PIXFMT_YUV444, width, height, img);
+	return Save_Jpeg(save, save->quality, &image, filename);
+}
+
+/** This function writes planar YUV420 image buffer as JPEG format without upsampling the 
+ * chrominance planes. 
+ */ 
+Std_ReturnType writejpegimageYUV420(Save_Context* save, int width, int height, unsigned char* img, char* filename)
+{
+	Image_Planar image;
+
+	Image_SetPlanar(&image, PIXFMT_YUV420, width, height, img);
+	return Save_Jpeg(save, save->quality, &image, filename);
+}
+
+/** This function writes captured image buffer as JPEG format. 
+ */ 
+Std_ReturnType writejpegimageRGB(Save_Context* save, int width, int height, unsigned char* img, char* filename)
+{
+	Image_Planar image;
 
-	/* Close output image file */
-	fclose(outfile);
+	Image_SetPlanar(&image, PIXFMT_RGB24, width, height, img);
+	return Save_Jpeg(save, save->quality, &image, filename);
 }
 
 /** This function writes captured image buffer as JPEG format. 
  */ 
-void writejpeggrayscale(int width, int height, unsigned char* img, char* filename)
+Std_ReturnType writejpeggrayscale(Save_Context* save, int width, int height, unsigned char* img, char* filename)
+{
+	Image_Planar image;
+
+	Image_SetPlanar(&image, PIXFMT_GRAY, width, height, img);
+	return Save_Jpeg(save, save->quality, &image, filename);
+}
+
+/** Converts YUV images to full range RGB24, JFIF interpretation as for the JPEG images. 
+ */ 
+static unsigned char* Save_ToRGB(const Image_Planar* image, Image_Planar* rgb)
+{
+	unsigned char* pixels = malloc((size_t)image->width * image->height * 3);
+
+	if (NULL == pixels)
+		return NULL;
+
+	Image_SetPlanar(rgb, PIXFMT_RGB24, image->width, image->height, pixels);
+	if (E_OK != Convert_YUVtoRGB(image, rgb, YUV_BT601_FULL))
+	{
+		free(pixels);
+		return NULL;
+	}
+
+	return pixels;
+}
+
+/** This function writes an image as lossless QOI format. 
+ */ 
+Std_ReturnType writeqoiimage(Save_Context* save, const Image_Planar* image, char* filename)
 {
-	struct jpeg_compress_struct cinfo;
-	struct jpeg_error_mgr jerr;
+	Image_Planar rgb;
+	unsigned char* pixels = NULL;
+	unsigned char* data;
+	size_t length;
+
+	if ((PIXFMT_YUV420 == image->format) || (PIXFMT_NV12 == image->format) || (PIXFMT_YUYV == image->format))
+	{
+		pixels = Save_ToRGB(image, &rgb);
+		if (NULL == pixels)
+			return errno_print("qoi");
+		image = &rgb;
+	}
 
-	JSAMPROW row_pointer[1];
-	FILE *outfile = fopen( filename, "wb" );
-	if (!outfile) {
-		errno_exit("jpeg");
+	if (E_OK != Qoi_Encode(image, &data, &length))
+	{
+		free(pixels);
+		return errno_print("qoi");
 	}
+	free(pixels);
+
+	return Save_Buffer(save, data, length, filename);
+}
+
+/** This function writes an image as binary PGM or PPM format. Contiguous planes are written 
+ * behind the header without copying. 
+ */ 
+Std_ReturnType writepnmimage(Save_Context* save, const Image_Planar* image, char* filename)
+{
+	char header[PNM_HEADER_SIZE];
+	size_t header_length = Pnm_Header(image, header);
+	size_t row_size = (size_t)image->width * ((PIXFMT_RGB24 == image->format) ? 3 : 1);
+	unsigned char* data;
+	size_t length;
+
+	if (NULL == save->submit && header_length > 0 && PIXFMT_YUYV != image->format && 
+		(size_t)image->stride[0] == row_size)
+	{
+		struct iovec iov[2];
+		ssize_t total = (ssize_t)(header_length + row_size * image->height);
+		int64_t start = Metrics_Begin();
+		int fd = open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+		if (-1 == fd)
+			return errno_print(filename);
+
+		iov[0].iov_base = header;
+		iov[0].iov_len = header_length;
+		iov[1].iov_base = image->plane[0];
+		iov[1].iov_len = row_size * image->height;
+
+		if (total != writev(fd, iov, 2))
+		{
+			close(fd);
+			return errno_print(filename);
+		}
+		close(fd);
+		Metrics_End(METRIC_WRITE, start);
+		return E_OK;
+	}
+
+	if (E_OK != Pnm_Encode(image, &data, &length))
+		return errno_print("pnm");
 
-	/* Create JPEG data */
-	cinfo.err = jpeg_std_error( &jerr );
-	jpeg_create_compress(&cinfo);
-	jpeg_stdio_dest(&cinfo, outfile);
+	return Save_Buffer(save, data, length, filename);
+}
+
+/** Selects the file format of writeimageYUV420. 
+ */ 
+void Save_SetFormat(Save_Context* save, Save_Format format)
+{
+	save->format = format;
+}
 
-	/* Set image parameters */
-	cinfo.image_width = width;
-	cinfo.image_height = height;
-	cinfo.input_components = 1;
-	cinfo.in_color_space = JCS_GRAYSCALE;
+/** Returns the filename extension of the selected file format. 
+ */ 
+const char* Save_GetExtension(const Save_Context* save)
+{
+	static const char* const extensions[] = { ".jpg", ".qoi", ".pgm", ".ppm" };
+
+	return extensions[save->format];
+}
 
-	/* Set JPEG compression parameters to default, adjust quality setting and start conpression */
-	jpeg_set_defaults(&cinfo);
-	jpeg_set_quality(&cinfo, 100, TRUE);
-	jpeg_start_compress(&cinfo, TRUE);
+/** This function writes a planar image in the selected file format. Images the format cannot 
+ * hold directly are converted to RGB24 first. 
+ */ 
+Std_ReturnType writeimage(Save_Context* save, const Image_Planar* image, char* filename)
+{
+	Image_Planar rgb;
+	unsigned char* pixels;
+	Std_ReturnType saved;
 
-	/* Feed pixel data */
-	while (cinfo.next_scanline < cinfo.image_height) 
+	switch (save->format)
 	{
-		row_pointer[0] = &img[cinfo.next_scanline * cinfo.image_width *  cinfo.input_components];
-		jpeg_write_scanlines(&cinfo, row_pointer, 1);
+		case SAVE_QOI:
+			return writeqoiimage(save, image, filename);
+
+		case SAVE_PGM:
+			return writepnmimage(save, image, filename);
+
+		case SAVE_PPM:
+			if (PIXFMT_RGB24 == image->format)
+				return writepnmimage(save, image, filename);
+			pixels = Save_ToRGB(image, &rgb);
+			if (NULL == pixels)
+				return errno_print("ppm");
+			saved = writepnmimage(save, &rgb, filename);
+			free(pixels);
+			return saved;
+
+		case SAVE_JPEG:
+		default:
+			return Save_Jpeg(save, save->quality, image, filename);
 	}
+}
 
-	/* Finish compression */
-	jpeg_finish_compress(&cinfo);
-	jpeg_destroy_compress(&cinfo);
+/** This function writes planar YUV420 image buffer in the selected file format. 
+ */ 
+Std_ReturnType writeimageYUV420(Save_Context* save, int width, int height, unsigned char* img, char* filename)
+{
+	Image_Planar image;
 
-	/* Close output image file */
-	fclose(outfile);
+	Image_SetPlanar(&image, PIXFMT_YUV420, width, height, img);
+	return writeimage(save, &image, filename);
+}
+
+/** This function writes a file encoded elsewhere like the encoded images of the save context. 
+ */ 
+Std_ReturnType writeencodedimage(Save_Context* save, unsigned char* data, size_t length, char* filename)
+{
+	return Save_Buffer(save, data, length, filename);
 }
 
 /*==============================[  End of File  ]======================================*/
@@ -7,6 +7,19 @@
  * @date 2022-03-21 Updates for saving BMP image
  * @date 2033-03-23 Updates for Gaussian filter and Edge detection
  * @date 2022-04-05 Add saving images for JPEG RGB
+ * @date 2026-10-18 Add saving planar YUV420 images as JPEG using raw data
+ * @date 2026-10-18 Encode JPEG images with a persistent in-memory encoder
+ * @date 2026-10-18 Pass encoded files to an asynchronous output sink if selected
+ * @date 2026-10-18 Pass uncompressed frames to a raw output if selected
+ * @date 2026-10-18 Add lossless QOI and PGM/PPM images
+ * @date 2026-10-18 Encode JPEG images on an encoder pool if selected
+ * @date 2026-10-18 Adapt JPEG quality with a rate controller if selected
+ * @date 2026-10-18 Add downscaled JPEG outputs and EXIF thumbnails if selected
+ * @date 2026-10-18 Move writer state into a save context passed to every function
+ * @date 2026-10-18 Add writing planar images and encoded files of processing pipelines
+ * @date 2026-10-19 Hand the capture time of frames to the outputs
+ * @date 2026-10-19 Return errors of writing images to the caller instead of exiting
+ * @date 2026-10-19 Let raw outputs lend memory for frames copied in place
  * 
  * @copyright Copyright (c) 2022
  * 
@@ -14,8 +27,28 @@
 
 /** Doxygen compliant formatting for comments */
 
+/*===========================[  Compile Flags  ]==========================================*/
+
+#ifndef WRITE_H
+#define  WRITE_H
+
 /*===========================[  Inclusions  ]=============================================*/
 
+#include "OutputSink.h"
+#include "EncoderPool.h"
+#include "RateControl.h"
+#include "Preview.h"
+
+/*============================[  Defines  ]===============================================*/
+
+/** \addtogroup picam_defines	  
+ *  @{
+ */
+
+/** Default image quality for JPEG compression */
+#define SAVE_DEFAULT_QUALITY    (70)
+
+/** @} */
 
 /*============================[  Data Types  ]============================================*/
 
@@ -64,22 +97,54 @@ typedef struct
     unsigned int   biClrImportant;   
 } BITMAPINFOHEADER;
 
-/** @} */
-
-/*============================[  Global Variables  ]=======================================*/
+/** Enumeration of file formats written by writeimageYUV420 */
+typedef enum
+{
+    /** Lossy JPEG, .jpg */
+    SAVE_JPEG,
+    /** Lossless QOI, .qoi */
+    SAVE_QOI,
+    /** Binary PGM of the luminance plane, .pgm */
+    SAVE_PGM,
+    /** Binary PPM, .ppm */
+    SAVE_PPM
+} Save_Format;
 
-/** \addtogroup global_variables	  
- *  @{
+/** State of the write functions. Every capture pipeline owns one, so pipelines running on 
+ *  different threads share no encoder, output or settings. 
  */
-
-/** Image quality for JPEG compression */
-static unsigned char jpegQuality = 70;
-
-/** Pointer to store image filename */
-static char* filename = NULL;
-
-/** Filename extension */
-static char* filenamePart = NULL;
+typedef struct
+{
+    /** Image quality for JPEG compression (1 to 100) */
+    int quality;
+    /** File format written by writeimageYUV420 */
+    Save_Format format;
+    /** Encoder of the JPEG write functions, kept across frames */
+    JpegEncoder encoder;
+    /** Set once encoder has been initialized */
+    int encoder_ready;
+    /** Function handing encoded files to an output sink, NULL to write synchronously */
+    Sink_SubmitFunc submit;
+    /** Output sink passed to submit */
+    void* sink;
+    /** Function handing uncompressed frames to a raw output, NULL to encode frames */
+    Sink_SubmitFunc raw_submit;
+    /** Function lending memory of the raw output for the next frame, NULL if it has none */
+    Sink_ClaimFunc raw_claim;
+    /** Raw output passed to raw_submit */
+    void* raw;
+    /** Capture time in microseconds of CLOCK_MONOTONIC of the frame being written, 0 if 
+     *  unknown */
+    int64_t captured;
+    /** Encoder pool for JPEG images, NULL to encode on the calling thread */
+    EncoderPool* pool;
+    /** Rate controller selecting JPEG quality, NULL to use quality */
+    RateControl* rate;
+    /** Downscaled outputs and thumbnail of JPEG images */
+    Preview preview;
+    /** Set while preview is initialized */
+    int preview_ready;
+} Save_Context;
 
 /** @} */
 
@@ -90,56 +155,320 @@ static char* filenamePart = NULL;
  */
 
 /**
- * @brief Print error message and terminate program with EXIT_FAILURE return code. 
+ * @brief Print error message with the error of the last system call.
+ * 
+ * @param[in] string_ptr    Error message to print
+ * 
+ * @return Std_ReturnType   Always E_NOT_OK, so callers can return it
+ *  
+ */
+Std_ReturnType errno_print(const char* string_ptr);
+
+/**
+ * @brief Print error message and terminate program with EXIT_FAILURE return code. Only used 
+ * by programs, library functions return errors with errno_print.
  * 
  * @param[in] string_ptr    Error message to print
  *  
  */
 void errno_exit(const char* string_ptr);
 
+/**
+ * @brief Initialize a save context for JPEG images of default quality written on the calling 
+ * thread.
+ * 
+ * @param[out] save     Save context
+ * 
+ */
+void Save_Init(Save_Context* save);
+
+/**
+ * @brief Release the encoder and downscaled outputs of a save context. Outputs, encoder pool 
+ * and rate controller selected into it are released by their owners.
+ * 
+ * @param[inout] save   Save context
+ * 
+ */
+void Save_DeInit(Save_Context* save);
+
+/**
+ * @brief Select output sink for the write functions. Encoded files are passed to the sink 
+ * instead of being written on the calling thread. Files the sink drops are counted by the 
+ * sink, the write functions do not report them as errors.
+ * 
+ * @param[inout] save   Save context
+ * @param[in] submit    Function to hand over encoded files, NULL to write synchronously
+ * @param[in] sink      Output sink passed to submit, for example a pointer to OutputSink
+ * 
+ */
+void Save_SetOutput(Save_Context* save, Sink_SubmitFunc submit, void* sink);
+
+/**
+ * @brief Select output for uncompressed frames. Frames given to writerawimageYUV420 are 
+ * passed to the output instead of being encoded as JPEG.
+ * 
+ * @param[inout] save   Save context
+ * @param[in] submit    Function to hand over YUV420 frames, NULL to encode frames
+ * @param[in] claim     Function lending memory of the output for frames, NULL if frames are 
+ *                      always allocated with malloc
+ * @param[in] sink      Output passed to submit and claim, for example a pointer to RawSink
+ * 
+ */
+void Save_SetRawOutput(Save_Context* save, Sink_SubmitFunc submit, Sink_ClaimFunc claim, void* sink);
+
+/**
+ * @brief Borrow memory of the raw output for the next frame. A frame copied into it is 
+ * handed back with writerawimageYUV420 without another copy and must not be freed.
+ * 
+ * @param[inout] save   Save context
+ * @param[in] length    Size of the frame in bytes
+ * 
+ * @return unsigned char*   Memory for the frame, NULL if the output lends none
+ */
+unsigned char* Save_ClaimRawFrame(Save_Context* save, size_t length);
+
+/**
+ * @brief Set the capture time of the frame written next. Outputs receive it with the files 
+ * of the frame, so a frame log indexes frames by capture time instead of write time.
+ * 
+ * @param[inout] save   Save context
+ * @param[in] captured  Capture time in microseconds of CLOCK_MONOTONIC, 0 if unknown
+ * 
+ */
+void Save_SetCaptureTime(Save_Context* save, int64_t captured);
+
+/**
+ * @brief Hand a planar YUV420 frame to the raw output. The output takes ownership of the 
+ * frame buffer.
+ * 
+ * @param[inout] save   Save context
+ * @param[in] width     Width of image
+ * @param[in] height    Height of image
+ * @param[in] img       Input pointer containing image buffer allocated with malloc or from 
+ *                      Save_ClaimRawFrame
+ * @param[in] filename  Filename of image, passed to the output
+ * 
+ * @return int  1 if the frame was handed to the raw output, 0 if no raw output is selected
+ */
+int writerawimageYUV420(Save_Context* save, int width, int height, unsigned char* img, char* filename);
+
+/**
+ * @brief Select encoder pool for the JPEG write functions. Single images are split into slices 
+ * encoded on all threads of the pool.
+ * 
+ * @param[inout] save   Save context
+ * @param[in] pool      Encoder pool, NULL to encode on the calling thread
+ * 
+ */
+void Save_SetEncoderPool(Save_Context* save, EncoderPool* pool);
+
+/**
+ * @brief Select rate controller for the JPEG write functions. Quality and DCT method of every 
+ * image are taken from the controller instead of the requested quality.
+ * 
+ * @param[inout] save   Save context
+ * @param[in] rate      Rate controller, NULL to encode with the requested quality
+ * 
+ */
+void Save_SetRateControl(Save_Context* save, RateControl* rate);
+
+/**
+ * @brief Select downscaled outputs of the JPEG write functions. Each YUV420 or grayscale image 
+ * is halved repeatedly once, the requested levels are saved next to it with their dimensions 
+ * appended to the filename and a thumbnail is embedded into its EXIF segment. 
+ * 
+ * @param[inout] save   Save context
+ * @param[in] config    Downscaled outputs, NULL to disable them
+ * 
+ */
+void Save_SetPreview(Save_Context* save, const Preview_Config* config);
+
+/**
+ * @brief Hand a planar YUV420 frame to the encoder pool if one is selected and the selected file 
+ * format is JPEG. The pool takes ownership of the frame buffer and delivers encoded frames in 
+ * the order they were handed over.
+ * 
+ * @param[inout] save   Save context
+ * @param[in] width     Width of image
+ * @param[in] height    Height of image
+ * @param[in] img       Input pointer containing image buffer allocated with malloc
+ * @param[in] filename  Filename of image
+ * 
+ * @return int  1 if the frame was handed to the encoder pool, 0 otherwise
+ */
+int writepooledimageYUV420(Save_Context* save, int width, int height, unsigned char* img, char* filename);
+
 /**
  * @brief Write image as a bmp file format.
  * 
+ * @param[inout] save   Save context
  * @param[in] width     Width of image to be saved
  * @param[in] height    Height of image to be saved 
  * @param[in] src       Input pointer containing image buffer
  * @param[in] filename  Filename for image to save
  */
-void writebitmapimage(int width, int height, unsigned char* src, char* filename);
+void writebitmapimage(Save_Context* save, int width, int height, unsigned char* src, char* filename);
 
 /**
  * @brief Write image as a JPEG file format.
  * 
+ * @param[inout] save   Save context
  * @param[in] width     Width of image to be saved
  * @param[in] height    Height of image to be saved
  * @param[in] img       Input pointer containing image buffer
  * @param[in] filename  Filename for image to save
  * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Encoding or writing failed, the error is printed
+ * 
  */
-void writejpegimageYUV(int width, int height, unsigned char* img, char* filename);
+Std_ReturnType writejpegimageYUV(Save_Context* save, int width, int height, unsigned char* img, char* filename);
+
+/**
+ * @brief Write planar YUV420 image as a JPEG file format. The planes are passed to the 
+ * compressor as raw data with 2x2 chroma subsampling, no YUV444 buffer is required.
+ * 
+ * @param[inout] save   Save context
+ * @param[in] width     Width of image to be saved
+ * @param[in] height    Height of image to be saved
+ * @param[in] img       Input pointer containing YUV420 image buffer
+ * @param[in] filename  Filename for image to save
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Encoding or writing failed, the error is printed
+ * 
+ */
+Std_ReturnType writejpegimageYUV420(Save_Context* save, int width, int height, unsigned char* img, char* filename);
 
 /**
  * @brief Write image as a JPEG file format.
  * 
+ * @param[inout] save   Save context
  * @param[in] width     Width of image to be saved
  * @param[in] height    Height of image to be saved
  * @param[in] img       Input pointer containing image buffer
  * @param[in] filename  Filename for image to save
  * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Encoding or writing failed, the error is printed
+ * 
  */
-void writejpegimageRGB(int width, int height, unsigned char* img, char* filename);
+Std_ReturnType writejpegimageRGB(Save_Context* save, int width, int height, unsigned char* img, char* filename);
 
 /**
  * @brief Write image as a JPEG file format.
  * 
+ * @param[inout] save   Save context
+ * @param[in] width     Width of image to be saved
+ * @param[in] height    Height of image to be saved
+ * @param[in] img       Input pointer containing image buffer
+ * @param[in] filename  Filename for image to save
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Encoding or writing failed, the error is printed
+ * 
+ */
+Std_ReturnType writejpeggrayscale(Save_Context* save, int width, int height, unsigned char* img, char* filename);
+
+/**
+ * @brief Write image as a lossless QOI file format. YUV images are converted to RGB.
+ * 
+ * @param[inout] save   Save context
+ * @param[in] image     Image descriptor of a YUV420, NV12, YUYV, RGB24, BGR24, RGBA or GRAY image
+ * @param[in] filename  Filename for image to save
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Encoding or writing failed, the error is printed
+ * 
+ */
+Std_ReturnType writeqoiimage(Save_Context* save, const Image_Planar* image, char* filename);
+
+/**
+ * @brief Write image as a binary PGM or PPM file format. The luminance plane of YUV images is 
+ * written as PGM without conversion, RGB24 images as PPM.
+ * 
+ * @param[inout] save   Save context
+ * @param[in] image     Image descriptor of a YUV420, NV12, YUYV, GRAY or RGB24 image
+ * @param[in] filename  Filename for image to save
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Encoding or writing failed, the error is printed
+ * 
+ */
+Std_ReturnType writepnmimage(Save_Context* save, const Image_Planar* image, char* filename);
+
+/**
+ * @brief Select the file format written by writeimageYUV420.
+ * 
+ * @param[inout] save   Save context
+ * @param[in] format    File format
+ * 
+ */
+void Save_SetFormat(Save_Context* save, Save_Format format);
+
+/**
+ * @brief Get the filename extension of the selected file format.
+ * 
+ * @param[in] save      Save context
+ * 
+ * @return const char*  Extension including the leading dot
+ */
+const char* Save_GetExtension(const Save_Context* save);
+
+/**
+ * @brief Write planar YUV420 image in the selected file format.
+ * 
+ * @param[inout] save   Save context
  * @param[in] width     Width of image to be saved
  * @param[in] height    Height of image to be saved
  * @param[in] img       Input pointer containing image buffer
  * @param[in] filename  Filename for image to save
  * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Encoding or writing failed, the error is printed
+ * 
+ */
+Std_ReturnType writeimageYUV420(Save_Context* save, int width, int height, unsigned char* img, char* filename);
+
+/**
+ * @brief Write a planar image in the selected file format. JPEG takes YUV420, YUV444, RGB24 
+ *        and gray images, QOI and PPM convert YUV420 to RGB24, PGM takes gray and YUV420.
+ * 
+ * @param[inout] save   Save context
+ * @param[in] image     Image to be saved
+ * @param[in] filename  Filename for image to save
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Encoding or writing failed, the error is printed
+ * 
  */
-void writejpeggrayscale(int width, int height, unsigned char* img, char* filename);
+Std_ReturnType writeimage(Save_Context* save, const Image_Planar* image, char* filename);
+
+/**
+ * @brief Write an encoded file through the output sink or to a file.
+ * 
+ * @param[inout] save   Save context
+ * @param[in] data      Encoded file allocated with malloc, released by this function
+ * @param[in] length    Size of data in bytes
+ * @param[in] filename  Filename for image to save
+ * 
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Encoding or writing failed, the error is printed
+ * 
+ */
+Std_ReturnType writeencodedimage(Save_Context* save, unsigned char* data, size_t length, char* filename);
 
 /** @} */
 
+#endif /** WRITE_H **/
+
 /*==============================[  End of File  ]======================================*/
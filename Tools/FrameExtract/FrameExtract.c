@@ -0,0 +1,361 @@
+/**
+ * @file FrameExtract.c
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Implementation of frame log extraction tool </b>
+ * @version
+ * @date 2026-10-18 Initial template for frame log extraction tool
+ * @date 2026-10-19 Build output filenames without passing the pattern as format string
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <getopt.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "FrameExtract.h"
+#include "JpegEncoder.h"
+
+/*============================[  Global Variables  ]====================================*/
+
+/** \addtogroup global_constants
+ *  @{
+ */
+
+/** Usage of arguments passed to extraction tool */
+static const struct option extract_long_options [] =
+{
+	{ "help",       no_argument,            NULL,           'h' },
+	{ "list",       no_argument,            NULL,           'l' },
+	{ "index",      required_argument,      NULL,           'i' },
+	{ "range",      required_argument,      NULL,           'r' },
+	{ "begin",      required_argument,      NULL,           'b' },
+	{ "end",        required_argument,      NULL,           'e' },
+	{ "every",      required_argument,      NULL,           'n' },
+	{ "scale",      required_argument,      NULL,           's' },
+	{ "quality",    required_argument,      NULL,           'q' },
+	{ "output",     required_argument,      NULL,           'o' },
+	{ 0, 0, 0, 0 }
+};
+
+/** @}*/
+
+/** \addtogroup global_variables
+ *  @{
+ */
+
+/** Encoder for thumbnails, kept across frames */
+static JpegEncoder ThumbEncoder;
+
+/** Set once ThumbEncoder has been initialized */
+static int ThumbEncoderReady = 0;
+
+/** @}*/
+
+/*===========================[  Function definitions  ]=================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+void ExtractUsage(FILE* fp, char** argv)
+{
+	fprintf(fp,
+		"Usage: %s [options] prefix\n\n"
+		"Options:\n"
+		"-h | --help          Print this message\n"
+		"-l | --list          List frames of the recording (default)\n"
+		"-i | --index N       Extract frame at position N\n"
+		"-r | --range A:B     Extract frames at positions A to B\n"
+		"-b | --begin us      Extract frames captured at or after timestamp\n"
+		"-e | --end us        Extract frames captured at or before timestamp\n"
+		"-n | --every N       Extract every Nth frame of the selection\n"
+		"-s | --scale D       Decode at 1/D size (1, 2, 4, 8) and save thumbnails\n"
+		"-q | --quality       Set JPEG quality of thumbnails (1-100) [75]\n"
+		"-o | --output fmt    Output filename with one %%d or %%u conversion for the\n"
+		"                     sequence number [frame_%%08llu.jpg],\n"
+		"                     - writes all frames to standard output\n"
+		"",
+		argv[0]);
+}
+
+
+Std_ReturnType FormatName(char* name, size_t size, const char* output, unsigned long long sequence)
+{
+	size_t used = 0;
+	int conversions = 0;
+
+	/** Copy the pattern, %% becomes % and the single conversion the padded sequence number */
+	while ('\0' != *output)
+	{
+		int width = 0, zero = 0, n;
+
+		if ('%' != *output || '%' == output[1])
+		{
+			if (used + 1 >= size)
+				return E_NOT_OK;
+			name[used++] = *output;
+			output += ('%' == *output) ? 2 : 1;
+			continue;
+		}
+
+		output++;
+		if ('0' == *output)
+		{
+			zero = 1;
+			output++;
+		}
+		while (*output >= '0' && *output <= '9' && width < FRAMELOG_MAX_PATH)
+			width = width * 10 + (*output++ - '0');
+		while ('l' == *output)
+			output++;
+		if (('d' != *output && 'u' != *output) || ++conversions > 1)
+			return E_NOT_OK;
+		output++;
+
+		n = snprintf(name + used, size - used, zero ? "%0*llu" : "%*llu", width, sequence);
+		if (n < 0 || (size_t)n >= size - used)
+			return E_NOT_OK;
+		used += (size_t)n;
+	}
+
+	name[used] = '\0';
+	return (1 == conversions) ? E_OK : E_NOT_OK;
+}
+
+
+void ListFrames(const FrameReader* reader)
+{
+	FrameReader_Frame frame;
+	uint32_t s;
+	uint64_t i;
+
+	for (s = 0; s < reader->segment_count; s++)
+	{
+		const FrameReader_Segment* seg = &reader->segments[s];
+		printf("segment %u: frames %llu, bytes %llu%s\n", seg->segment, (unsigned long long)seg->count,
+			(unsigned long long)seg->header->data_size, (seg->header->flags & FRAMELOG_INDEX_CLOSED) ? "" : ", open");
+	}
+
+	for (i = 0; i < reader->frame_count; i++)
+	{
+		if (E_OK != FrameReader_Get(reader, i, &frame))
+			continue;
+		printf("%8llu  seq %8llu  time %lld.%06lld  length %8zu  flags 0x%x\n", (unsigned long long)i,
+			(unsigned long long)frame.sequence, (long long)(frame.timestamp / 1000000),
+			(long long)(frame.timestamp % 1000000), frame.length, frame.flags);
+	}
+}
+
+
+Std_ReturnType ExtractFrame(const FrameReader_Frame* frame, const char* output, int denom, int quality)
+{
+	const unsigned char* data = frame->data;
+	size_t length = frame->length;
+	char name[FRAMELOG_MAX_PATH];
+	int fd = STDOUT_FILENO;
+
+	/** Decode scaled and encode again */
+	if (denom > 0)
+	{
+		Image_Planar image;
+
+		if (E_OK != FrameReader_Decode(frame, denom, &image))
+			return E_NOT_OK;
+
+		if (!ThumbEncoderReady)
+		{
+			if (E_OK != JpegEncoder_Init(&ThumbEncoder, quality))
+			{
+				free(image.plane[0]);
+				return E_NOT_OK;
+			}
+			ThumbEncoderReady = 1;
+		}
+
+		if (E_OK != JpegEncoder_Encode(&ThumbEncoder, &image))
+		{
+			free(image.plane[0]);
+			return E_NOT_OK;
+		}
+		free(image.plane[0]);
+
+		data = ThumbEncoder.buffer;
+		length = ThumbEncoder.length;
+	}
+
+	if (0 != strcmp(output, "-"))
+	{
+		if (E_OK != FormatName(name, sizeof(name), output, (unsigned long long)frame->sequence))
+			return E_NOT_OK;
+		fd = open(name, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+		if (-1 == fd)
+			return E_NOT_OK;
+	}
+
+	/** Write straight from the mapping, the page cache is the only copy */
+	while (length > 0)
+	{
+		ssize_t r = write(fd, data, length);
+		if (r < 0 && EINTR == errno)
+			continue;
+		if (r <= 0)
+			break;
+		data += r;
+		length -= (size_t)r;
+	}
+
+	if (STDOUT_FILENO != fd)
+		close(fd);
+
+	return (0 == length) ? E_OK : E_NOT_OK;
+}
+
+/** @} */
+
+/*=======================[  Main Application  ]===============================*/
+
+/** \addtogroup mainapp	Main Application
+ *  @{
+ */
+
+/**
+ * @brief Extraction tool for frame log recordings.
+ *
+ * @param[inout] argc	Input argument count
+ * @param[inout] argv 	Input argument vector
+ *
+ * @return int Return Status
+ * @retval EXIT_SUCCESS	Returned successfully
+ * @retval EXIT_FAILURE	Error encountered
+ *
+ */
+
+int main(int argc, char **argv)
+{
+	FrameReader reader;
+	FrameReader_Frame frame;
+	const char* output = "frame_%08llu.jpg";
+	char name[FRAMELOG_MAX_PATH];
+	long long first = -1, last = -1;
+	long long begin = -1, end = -1;
+	int list = 0, every = 1, denom = 0, quality = 75;
+	unsigned long long count = 0, failed = 0;
+	uint64_t i, stop;
+
+	for (;;)
+	{
+		int index, c;
+		c = getopt_long(argc, argv, extract_short_options, extract_long_options, &index);
+		if (-1 == c)
+			break;
+
+		switch (c)
+		{
+			case 'h':
+				ExtractUsage(stdout, argv);
+				exit(EXIT_SUCCESS);
+
+			case 'l':
+				list = 1;
+				break;
+
+			case 'i':
+				first = last = atoll(optarg);
+				break;
+
+			case 'r':
+				if (2 != sscanf(optarg, "%lld:%lld", &first, &last))
+				{
+					ExtractUsage(stderr, argv);
+					exit(EXIT_FAILURE);
+				}
+				break;
+
+			case 'b':
+				begin = atoll(optarg);
+				break;
+
+			case 'e':
+				end = atoll(optarg);
+				break;
+
+			case 'n':
+				every = atoi(optarg);
+				break;
+
+			case 's':
+				denom = atoi(optarg);
+				break;
+
+			case 'q':
+				quality = atoi(optarg);
+				break;
+
+			case 'o':
+				output = optarg;
+				break;
+
+			default:
+				ExtractUsage(stderr, argv);
+				exit(EXIT_FAILURE);
+		}
+	}
+
+	if (optind >= argc || every < 1 || (0 != denom && 1 != denom && 2 != denom && 4 != denom && 8 != denom) ||
+		(0 != strcmp(output, "-") && E_OK != FormatName(name, sizeof(name), output, 0)))
+	{
+		ExtractUsage(stderr, argv);
+		exit(EXIT_FAILURE);
+	}
+
+	if (E_OK != FrameReader_Open(&reader, argv[optind]))
+	{
+		fprintf(stderr, "Could not open recording %s\n", argv[optind]);
+		exit(EXIT_FAILURE);
+	}
+
+	if (list || (first < 0 && begin < 0 && end < 0))
+	{
+		ListFrames(&reader);
+		FrameReader_Close(&reader);
+		exit(EXIT_SUCCESS);
+	}
+
+	/** Selection by position, narrowed by timestamps */
+	i = (first >= 0) ? (uint64_t)first : 0;
+	stop = (last >= 0 && (uint64_t)last < reader.frame_count) ? (uint64_t)last + 1 : reader.frame_count;
+	if (begin >= 0 && FrameReader_FindTime(&reader, begin) > i)
+		i = FrameReader_FindTime(&reader, begin);
+	if (end >= 0 && FrameReader_FindTime(&reader, end + 1) < stop)
+		stop = FrameReader_FindTime(&reader, end + 1);
+
+	for (; i < stop; i += every)
+	{
+		if (E_OK == FrameReader_Get(&reader, i, &frame) && E_OK == ExtractFrame(&frame, output, denom, quality))
+			count++;
+		else
+			failed++;
+	}
+
+	fprintf(stderr, "Extracted %llu frames, %llu failed\n", count, failed);
+
+	if (ThumbEncoderReady)
+		JpegEncoder_DeInit(&ThumbEncoder);
+	FrameReader_Close(&reader);
+
+	exit((0 == failed) ? EXIT_SUCCESS : EXIT_FAILURE);
+	return EXIT_SUCCESS;
+}
+
+/** @} */
+
+/*==============================[  End of File  ]======================================*/
@@ -0,0 +1,96 @@
+/**
+ * @file FrameExtract.h
+ * @author Prakash Dhungana (dhunganaprakas@gmail.com)
+ * @brief <b> Header file for frame log extraction tool </b>
+ * @version
+ * @date 2026-10-18 Initial template for frame log extraction tool
+ * @date 2026-10-19 Build output filenames without passing the pattern as format string
+ *
+ * @copyright Copyright (c) 2022
+ *
+ */
+
+/** Doxygen compliant formatting for comments */
+
+/*===========================[  Compile Flags  ]=========================================*/
+
+#ifndef FRAMEEXTRACT_H
+#define  FRAMEEXTRACT_H
+
+/*===========================[  Inclusions  ]=============================================*/
+
+#include <stddef.h>
+#include <stdio.h>
+#include "FrameReader.h"
+
+/*============================[  Global Variables  ]=====================================*/
+/** \addtogroup global_constants
+ *  @{
+ */
+
+/** Usage of arguments passed to extraction tool for option */
+const char extract_short_options [] = "hli:r:b:e:n:s:q:o:";
+
+/** @} */
+
+/*===========================[  Function declarations  ]=================================*/
+
+/** \addtogroup internal_functions Internal Functions
+ *  @{
+ */
+
+/**
+ * @brief   Helper function to print usage information of the extraction tool.
+ *
+ * @param[in] fp    File pointer
+ * @param[in] argv  Input argument vector
+ *
+ */
+void ExtractUsage(FILE* fp, char** argv);
+
+/**
+ * @brief   Helper function to build an output filename from a pattern. The pattern holds
+ *          exactly one %d or %u conversion with optional zero flag, width and l or ll length,
+ *          %% for a percent sign and no other conversions. It is never used as a format string.
+ *
+ * @param[out] name     Filename
+ * @param[in] size      Size of name in bytes
+ * @param[in] output    Output filename pattern
+ * @param[in] sequence  Sequence number of the frame
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Invalid pattern or filename too long
+ *
+ */
+Std_ReturnType FormatName(char* name, size_t size, const char* output, unsigned long long sequence);
+
+/**
+ * @brief   Helper function to print all frames of a recording.
+ *
+ * @param[in] reader    Frame reader
+ *
+ */
+void ListFrames(const FrameReader* reader);
+
+/**
+ * @brief   Helper function to write a frame to a file or to standard output. Frames are
+ *          written directly from the mapped segment unless a scale is selected.
+ *
+ * @param[in] frame     Frame to write
+ * @param[in] output    Output filename pattern with sequence number, "-" for standard output
+ * @param[in] denom     Scale denominator for thumbnails, 0 writes the recorded frame
+ * @param[in] quality   JPEG quality of thumbnails
+ *
+ * @return Std_ReturnType   Operation Status
+ * @retval E_OK             Operation successful
+ * @retval E_NOT_OK         Operation unsuccessful
+ *
+ */
+Std_ReturnType ExtractFrame(const FrameReader_Frame* frame, const char* output, int denom, int quality);
+
+/** @} */
+
+#endif
+
+/*==============================[  End of File  ]========================================*/